@@ -0,0 +1,568 @@
+#define BENCH_HARNESS_IMPLEMENTATION
+#include "bench_harness.h"
+
+#include <renderer/gl_instrumentation.h>
+#include <renderer/gpu_profiler.h>
+
+#ifdef BENCH_HAS_EGL
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#endif
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#ifndef BENCH_SCENE
+#define BENCH_SCENE "exercise"
+#endif
+
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+// the few GL functions the harness calls itself, loaded separately so glad's callbacks never see them
+// ---------------------------------------------------------------------------------------------------
+struct RawGL {
+    PFNGLGENFRAMEBUFFERSPROC GenFramebuffers;
+    PFNGLBINDFRAMEBUFFERPROC BindFramebuffer;
+    PFNGLGENRENDERBUFFERSPROC GenRenderbuffers;
+    PFNGLBINDRENDERBUFFERPROC BindRenderbuffer;
+    PFNGLRENDERBUFFERSTORAGEPROC RenderbufferStorage;
+    PFNGLFRAMEBUFFERRENDERBUFFERPROC FramebufferRenderbuffer;
+    PFNGLDELETEFRAMEBUFFERSPROC DeleteFramebuffers;
+    PFNGLDELETERENDERBUFFERSPROC DeleteRenderbuffers;
+    PFNGLVIEWPORTPROC Viewport;
+    PFNGLGETINTEGERVPROC GetIntegerv;
+    PFNGLBINDBUFFERPROC BindBuffer;
+    PFNGLREADPIXELSPROC ReadPixels;
+    PFNGLGETSTRINGPROC GetString;
+};
+
+struct FrameRecord {
+    double cpuMilliseconds;
+    unsigned long glCalls;
+    std::uint64_t checksum;
+    // from the GL instrumentation, zero without it
+    unsigned long redundant, thrashing, orphans, stalls;
+};
+
+// a frame or a scope timed by a GpuProfiler of the exercise
+struct ProfilerRecord {
+    double cpuMilliseconds, gpuMilliseconds;
+};
+
+struct Harness {
+    bool useEGL = false;
+    GLFWwindow *glfwWindow = nullptr;
+    std::vector<std::pair<int, int> > hints;
+    int width = 0, height = 0;
+    int glMajor = 1, glMinor = 0;
+    bool coreProfile = false;
+
+#ifdef BENCH_HAS_EGL
+    EGLDisplay display = EGL_NO_DISPLAY;
+    EGLContext context = EGL_NO_CONTEXT;
+#endif
+    RawGL gl = {};
+    bool glLoaded = false;
+    GLuint framebuffer = 0, colorBuffer = 0, depthBuffer = 0;
+
+    unsigned long frameLimit = 300;
+    // count the calls with the renderer's GLInstrumentation (redundant binds, stalls...) or just count them
+    bool instrumented = true;
+    bool closeRequested = false;
+    std::vector<FrameRecord> frames;
+    std::vector<unsigned char> pixels;
+    Clock::time_point frameStart;
+    unsigned long frameCalls = 0;
+    std::unordered_map<const char *, unsigned long> callsByFunction;
+    std::unordered_map<std::string, unsigned long> stallReasons;
+    // what the exercise's GpuProfiler measured, if it has one, scopes in the order they first appeared
+    std::vector<ProfilerRecord> profilerFrames;
+    std::vector<std::pair<const char *, std::vector<ProfilerRecord> > > profilerScopes;
+    unsigned long profilerDropped = 0;
+    bool written = false;
+};
+
+Harness harness;
+
+
+// without instrumentation, glad calls this after every GL call the exercise makes (instead of its default,
+// which calls glGetError)
+// ---------------------------------------------------------------------------------------------------------
+void countCall(const char *name, void *, int, ...){
+    ++harness.frameCalls;
+    ++harness.callsByFunction[name];
+}
+
+
+void ignoreCall(const char *, void *, int, ...){
+}
+
+
+// every GpuProfiler of the exercise calls this with each frame it got the GPU times of
+// -----------------------------------------------------------------------------------
+void recordProfilerFrame(const GpuProfiler &profiler, const GpuProfiler::FrameTiming &frame){
+    harness.profilerFrames.push_back({frame.cpuMilliseconds, frame.gpuMilliseconds});
+    harness.profilerDropped = profiler.droppedFrames();
+    for (const GpuProfiler::ScopeTiming &scope : frame.scopes) {
+        auto records = std::find_if(harness.profilerScopes.begin(), harness.profilerScopes.end(),
+                                    [&scope](const std::pair<const char *, std::vector<ProfilerRecord> > &entry){
+                                        return std::strcmp(entry.first, scope.name) == 0;
+                                    });
+        if (records == harness.profilerScopes.end()) {
+            harness.profilerScopes.emplace_back(scope.name, std::vector<ProfilerRecord>());
+            records = harness.profilerScopes.end() - 1;
+        }
+        records->second.push_back({scope.cpuMilliseconds, scope.gpuMilliseconds});
+    }
+}
+
+
+GLFWglproc loadProc(const char *name){
+#ifdef BENCH_HAS_EGL
+    if (harness.useEGL)
+        return (GLFWglproc) eglGetProcAddress(name);
+#endif
+    return glfwGetProcAddress(name);
+}
+
+
+void loadRawGL(){
+    RawGL &gl = harness.gl;
+    gl.GenFramebuffers = (PFNGLGENFRAMEBUFFERSPROC) loadProc("glGenFramebuffers");
+    gl.BindFramebuffer = (PFNGLBINDFRAMEBUFFERPROC) loadProc("glBindFramebuffer");
+    gl.GenRenderbuffers = (PFNGLGENRENDERBUFFERSPROC) loadProc("glGenRenderbuffers");
+    gl.BindRenderbuffer = (PFNGLBINDRENDERBUFFERPROC) loadProc("glBindRenderbuffer");
+    gl.RenderbufferStorage = (PFNGLRENDERBUFFERSTORAGEPROC) loadProc("glRenderbufferStorage");
+    gl.FramebufferRenderbuffer = (PFNGLFRAMEBUFFERRENDERBUFFERPROC) loadProc("glFramebufferRenderbuffer");
+    gl.DeleteFramebuffers = (PFNGLDELETEFRAMEBUFFERSPROC) loadProc("glDeleteFramebuffers");
+    gl.DeleteRenderbuffers = (PFNGLDELETERENDERBUFFERSPROC) loadProc("glDeleteRenderbuffers");
+    gl.Viewport = (PFNGLVIEWPORTPROC) loadProc("glViewport");
+    gl.GetIntegerv = (PFNGLGETINTEGERVPROC) loadProc("glGetIntegerv");
+    gl.BindBuffer = (PFNGLBINDBUFFERPROC) loadProc("glBindBuffer");
+    gl.ReadPixels = (PFNGLREADPIXELSPROC) loadProc("glReadPixels");
+    gl.GetString = (PFNGLGETSTRINGPROC) loadProc("glGetString");
+    harness.glLoaded = true;
+}
+
+
+// a surfaceless context has no default framebuffer, render to a framebuffer object of the window size instead
+// -------------------------------------------------------------------------------------------------------------
+void createOffscreenFramebuffer(){
+    RawGL &gl = harness.gl;
+    gl.GenRenderbuffers(1, &harness.colorBuffer);
+    gl.BindRenderbuffer(GL_RENDERBUFFER, harness.colorBuffer);
+    gl.RenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, harness.width, harness.height);
+    gl.GenRenderbuffers(1, &harness.depthBuffer);
+    gl.BindRenderbuffer(GL_RENDERBUFFER, harness.depthBuffer);
+    gl.RenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, harness.width, harness.height);
+    gl.BindRenderbuffer(GL_RENDERBUFFER, 0);
+
+    gl.GenFramebuffers(1, &harness.framebuffer);
+    gl.BindFramebuffer(GL_FRAMEBUFFER, harness.framebuffer);
+    gl.FramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, harness.colorBuffer);
+    gl.FramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, harness.depthBuffer);
+    // a window's viewport starts at the window size, a surfaceless context's at 0x0
+    gl.Viewport(0, 0, harness.width, harness.height);
+}
+
+
+#ifdef BENCH_HAS_EGL
+bool createEGLContext(){
+    PFNEGLGETPLATFORMDISPLAYEXTPROC getPlatformDisplay =
+            (PFNEGLGETPLATFORMDISPLAYEXTPROC) eglGetProcAddress("eglGetPlatformDisplayEXT");
+    if (!getPlatformDisplay)
+        return false;
+    harness.display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+    if (harness.display == EGL_NO_DISPLAY || !eglInitialize(harness.display, nullptr, nullptr))
+        return false;
+    if (!eglBindAPI(EGL_OPENGL_API))
+        return false;
+
+    EGLint attributes[] = {
+            EGL_CONTEXT_MAJOR_VERSION, harness.glMajor,
+            EGL_CONTEXT_MINOR_VERSION, harness.glMinor,
+            EGL_CONTEXT_OPENGL_PROFILE_MASK,
+            harness.coreProfile ? EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT : EGL_CONTEXT_OPENGL_COMPATIBILITY_PROFILE_BIT,
+            EGL_NONE
+    };
+    harness.context = eglCreateContext(harness.display, EGL_NO_CONFIG_KHR, EGL_NO_CONTEXT, attributes);
+    if (harness.context == EGL_NO_CONTEXT) {
+        eglTerminate(harness.display);
+        harness.display = EGL_NO_DISPLAY;
+        return false;
+    }
+    return true;
+}
+#endif
+
+
+// FNV-1a over the pixels of the frame
+// -----------------------------------
+std::uint64_t frameChecksum(){
+    RawGL &gl = harness.gl;
+    GLint readFramebuffer = 0, packBuffer = 0;
+    gl.GetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &readFramebuffer);
+    gl.GetIntegerv(GL_PIXEL_PACK_BUFFER_BINDING, &packBuffer);
+    gl.BindFramebuffer(GL_READ_FRAMEBUFFER, harness.framebuffer);
+    if (packBuffer)
+        gl.BindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    // RGBA rows are always 4-byte aligned, whatever GL_PACK_ALIGNMENT is
+    harness.pixels.resize((size_t) harness.width * harness.height * 4);
+    gl.ReadPixels(0, 0, harness.width, harness.height, GL_RGBA, GL_UNSIGNED_BYTE, harness.pixels.data());
+
+    gl.BindFramebuffer(GL_READ_FRAMEBUFFER, readFramebuffer);
+    if (packBuffer)
+        gl.BindBuffer(GL_PIXEL_PACK_BUFFER, packBuffer);
+
+    std::uint64_t hash = 14695981039346656037ull;
+    for (unsigned char value : harness.pixels) {
+        hash ^= value;
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+
+struct Summary {
+    double mean, p50, p95, p99, max;
+};
+
+template<typename T, typename F>
+Summary summarize(const std::vector<T> &records, F value){
+    // the first frame also does all the setup, leave it out unless it is the only one
+    std::vector<double> values;
+    for (size_t i = records.size() > 1 ? 1 : 0; i < records.size(); i++)
+        values.push_back(value(records[i]));
+    Summary summary = {0, 0, 0, 0, 0};
+    if (values.empty())
+        return summary;
+
+    std::sort(values.begin(), values.end());
+    double sum = 0;
+    for (double v : values)
+        sum += v;
+    auto percentile = [&values](double p){
+        size_t rank = (size_t) std::ceil(p * values.size());
+        return values[rank > 0 ? rank - 1 : 0];
+    };
+    summary.mean = sum / values.size();
+    summary.p50 = percentile(0.50);
+    summary.p95 = percentile(0.95);
+    summary.p99 = percentile(0.99);
+    summary.max = values.back();
+    return summary;
+}
+
+
+std::string jsonString(const char *text){
+    std::string result = "\"";
+    for (const char *c = text ? text : ""; *c; ++c) {
+        if (*c == '"' || *c == '\\')
+            result += '\\';
+        if ((unsigned char) *c >= 0x20)
+            result += *c;
+    }
+    return result + "\"";
+}
+
+
+std::string summaryJson(const Summary &summary){
+    char json[160];
+    std::snprintf(json, sizeof(json), "{\"mean\": %.4f, \"p50\": %.4f, \"p95\": %.4f, \"p99\": %.4f, \"max\": %.4f}",
+                  summary.mean, summary.p50, summary.p95, summary.p99, summary.max);
+    return json;
+}
+
+
+void writeSummary(FILE *file, const char *name, const Summary &summary){
+    std::fprintf(file, "  \"%s\": %s,\n", name, summaryJson(summary).c_str());
+}
+
+
+// CPU and GPU times of the frames and of every scope the exercise's GpuProfiler measured
+void writeProfilerResults(FILE *file){
+    auto cpu = [](const ProfilerRecord &r){ return r.cpuMilliseconds; };
+    auto gpu = [](const ProfilerRecord &r){ return r.gpuMilliseconds; };
+    std::fprintf(file, "  \"gpu_profiler\": {\n");
+    std::fprintf(file, "    \"frames\": %lu,\n    \"dropped_frames\": %lu,\n",
+                 (unsigned long) harness.profilerFrames.size(), harness.profilerDropped);
+    std::fprintf(file, "    \"cpu_ms\": %s,\n", summaryJson(summarize(harness.profilerFrames, cpu)).c_str());
+    std::fprintf(file, "    \"gpu_ms\": %s,\n", summaryJson(summarize(harness.profilerFrames, gpu)).c_str());
+    std::fprintf(file, "    \"scopes\": {");
+    for (size_t i = 0; i < harness.profilerScopes.size(); i++) {
+        const std::vector<ProfilerRecord> &records = harness.profilerScopes[i].second;
+        std::fprintf(file, "%s\n      %s: {\"count\": %lu, \"cpu_ms\": %s, \"gpu_ms\": %s}", i ? "," : "",
+                     jsonString(harness.profilerScopes[i].first).c_str(), (unsigned long) records.size(),
+                     summaryJson(summarize(records, cpu)).c_str(), summaryJson(summarize(records, gpu)).c_str());
+    }
+    std::fprintf(file, "\n    }\n  },\n");
+}
+
+
+void writeResults(){
+    if (harness.written)
+        return;
+    harness.written = true;
+
+    const char *path = std::getenv("BENCH_OUTPUT");
+    std::string defaultPath = std::string(BENCH_SCENE) + ".json";
+    FILE *file = std::fopen(path ? path : defaultPath.c_str(), "w");
+    if (!file) {
+        std::fprintf(stderr, "bench: cannot write %s\n", path ? path : defaultPath.c_str());
+        return;
+    }
+
+    const char *renderer = harness.glLoaded ? (const char *) harness.gl.GetString(GL_RENDERER) : nullptr;
+    std::fprintf(file, "{\n");
+    std::fprintf(file, "  \"scene\": %s,\n", jsonString(BENCH_SCENE).c_str());
+    std::fprintf(file, "  \"backend\": %s,\n", jsonString(harness.useEGL ? "egl-surfaceless" : "glfw").c_str());
+    std::fprintf(file, "  \"renderer\": %s,\n", jsonString(renderer).c_str());
+    std::fprintf(file, "  \"width\": %d,\n  \"height\": %d,\n", harness.width, harness.height);
+    std::fprintf(file, "  \"frames\": %lu,\n", (unsigned long) harness.frames.size());
+    std::fprintf(file, "  \"gl_instrumentation\": %s,\n", harness.instrumented ? "true" : "false");
+    writeSummary(file, "cpu_ms", summarize(harness.frames, [](const FrameRecord &f){ return f.cpuMilliseconds; }));
+    writeSummary(file, "gl_calls", summarize(harness.frames, [](const FrameRecord &f){ return (double) f.glCalls; }));
+    if (harness.instrumented) {
+        writeSummary(file, "redundant_binds",
+                     summarize(harness.frames, [](const FrameRecord &f){ return (double) f.redundant; }));
+        writeSummary(file, "thrashing_binds",
+                     summarize(harness.frames, [](const FrameRecord &f){ return (double) f.thrashing; }));
+        writeSummary(file, "orphans", summarize(harness.frames, [](const FrameRecord &f){ return (double) f.orphans; }));
+        writeSummary(file, "stalls", summarize(harness.frames, [](const FrameRecord &f){ return (double) f.stalls; }));
+
+        // total stalls per reason, most frequent first
+        std::vector<std::pair<std::string, unsigned long> > reasons(harness.stallReasons.begin(),
+                                                                   harness.stallReasons.end());
+        std::sort(reasons.begin(), reasons.end(), [](const std::pair<std::string, unsigned long> &a,
+                                                     const std::pair<std::string, unsigned long> &b){
+            return a.second > b.second;
+        });
+        std::fprintf(file, "  \"stall_reasons\": {");
+        for (size_t i = 0; i < reasons.size(); i++)
+            std::fprintf(file, "%s\n    %s: %lu", i ? "," : "", jsonString(reasons[i].first.c_str()).c_str(),
+                         reasons[i].second);
+        std::fprintf(file, "\n  },\n");
+    }
+    if (!harness.profilerFrames.empty())
+        writeProfilerResults(file);
+    std::fprintf(file, "  \"final_checksum\": \"%016llx\",\n",
+                 harness.frames.empty() ? 0ull : (unsigned long long) harness.frames.back().checksum);
+
+    // total calls per GL function, most called first
+    std::vector<std::pair<const char *, unsigned long> > calls(harness.callsByFunction.begin(),
+                                                              harness.callsByFunction.end());
+    std::sort(calls.begin(), calls.end(), [](const std::pair<const char *, unsigned long> &a,
+                                             const std::pair<const char *, unsigned long> &b){
+        return a.second > b.second;
+    });
+    std::fprintf(file, "  \"calls_by_function\": {");
+    for (size_t i = 0; i < calls.size(); i++)
+        std::fprintf(file, "%s\n    %s: %lu", i ? "," : "", jsonString(calls[i].first).c_str(), calls[i].second);
+    std::fprintf(file, "\n  },\n");
+
+    std::fprintf(file, "  \"per_frame\": [");
+    for (size_t i = 0; i < harness.frames.size(); i++) {
+        const FrameRecord &frame = harness.frames[i];
+        std::fprintf(file, "%s\n    {\"cpu_ms\": %.4f, \"gl_calls\": %lu, \"checksum\": \"%016llx\"", i ? "," : "",
+                     frame.cpuMilliseconds, frame.glCalls, (unsigned long long) frame.checksum);
+        if (harness.instrumented)
+            std::fprintf(file, ", \"redundant\": %lu, \"thrashing\": %lu, \"orphans\": %lu, \"stalls\": %lu",
+                         frame.redundant, frame.thrashing, frame.orphans, frame.stalls);
+        std::fprintf(file, "}");
+    }
+    std::fprintf(file, "\n  ]\n}\n");
+    std::fclose(file);
+}
+
+} // namespace
+
+
+int benchInit(){
+    const char *frames = std::getenv("BENCH_FRAMES");
+    if (frames && std::atol(frames) > 0)
+        harness.frameLimit = (unsigned long) std::atol(frames);
+    const char *instrumentation = std::getenv("BENCH_GL_INSTRUMENTATION");
+    if (instrumentation && std::strcmp(instrumentation, "0") == 0)
+        harness.instrumented = false;
+    return GLFW_TRUE;
+}
+
+
+void benchWindowHint(int hint, int value){
+    harness.hints.emplace_back(hint, value);
+    if (hint == GLFW_CONTEXT_VERSION_MAJOR)
+        harness.glMajor = value;
+    else if (hint == GLFW_CONTEXT_VERSION_MINOR)
+        harness.glMinor = value;
+    else if (hint == GLFW_OPENGL_PROFILE)
+        harness.coreProfile = value == GLFW_OPENGL_CORE_PROFILE;
+}
+
+
+GLFWwindow *benchCreateWindow(int width, int height, const char *title, GLFWmonitor *monitor, GLFWwindow *share){
+    harness.width = width;
+    harness.height = height;
+
+#ifdef BENCH_HAS_EGL
+    if (createEGLContext()) {
+        harness.useEGL = true;
+        // any non-null handle will do, the exercises only pass it back to the functions above
+        return (GLFWwindow *) &harness;
+    }
+#endif
+
+    // no surfaceless EGL, let glfw create the context (OSMesa when glfw is built for its null platform)
+    if (!glfwInit())
+        return nullptr;
+    for (const std::pair<int, int> &hint : harness.hints)
+        glfwWindowHint(hint.first, hint.second);
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+    harness.glfwWindow = glfwCreateWindow(width, height, title, monitor, share);
+    return harness.glfwWindow;
+}
+
+
+void benchMakeContextCurrent(GLFWwindow *window){
+#ifdef BENCH_HAS_EGL
+    if (harness.useEGL)
+        eglMakeCurrent(harness.display, EGL_NO_SURFACE, EGL_NO_SURFACE, harness.context);
+    else
+#endif
+        glfwMakeContextCurrent(window);
+
+    if (!harness.glLoaded) {
+        loadRawGL();
+        if (harness.useEGL)
+            createOffscreenFramebuffer();
+        if (harness.instrumented)
+            GLInstrumentation::instance().setEnabled(true);
+        else
+            glad_set_post_callback(countCall);
+        GpuProfiler::setFrameCallback(recordProfilerFrame);
+        harness.frameStart = Clock::now();
+    }
+}
+
+
+GLFWglproc benchGetProcAddress(const char *procname){
+    return loadProc(procname);
+}
+
+
+GLFWframebuffersizefun benchSetFramebufferSizeCallback(GLFWwindow *window, GLFWframebuffersizefun callback){
+    // the offscreen framebuffer never changes size
+    return harness.useEGL ? nullptr : glfwSetFramebufferSizeCallback(window, callback);
+}
+
+
+int benchWindowShouldClose(GLFWwindow *){
+    return harness.closeRequested || harness.frames.size() >= harness.frameLimit;
+}
+
+
+void benchSetWindowShouldClose(GLFWwindow *, int value){
+    harness.closeRequested = value != 0;
+}
+
+
+void benchSwapBuffers(GLFWwindow *window){
+    FrameRecord frame = {};
+    frame.cpuMilliseconds = std::chrono::duration<double, std::milli>(Clock::now() - harness.frameStart).count();
+    if (harness.instrumented) {
+        GLInstrumentation &instrumentation = GLInstrumentation::instance();
+        instrumentation.endFrame();
+        const GLFrameStats &stats = instrumentation.lastFrame();
+        frame.glCalls = stats.calls;
+        frame.redundant = stats.redundant;
+        frame.thrashing = stats.thrashing;
+        frame.orphans = stats.orphans;
+        frame.stalls = stats.stalls;
+        for (const GLCallStats &entryPoint : stats.entryPoints)
+            harness.callsByFunction[entryPoint.name] += entryPoint.calls;
+        for (const std::pair<std::string, unsigned long> &reason : stats.stallReasons)
+            harness.stallReasons[reason.first] += reason.second;
+    }
+    else
+        frame.glCalls = harness.frameCalls;
+    frame.checksum = frameChecksum();
+    harness.frames.push_back(frame);
+
+    if (!harness.useEGL)
+        glfwSwapBuffers(window);
+
+    // the readback and the swap are not part of the next frame
+    harness.frameCalls = 0;
+    harness.frameStart = Clock::now();
+}
+
+
+void benchPollEvents(){
+}
+
+
+int benchGetKey(GLFWwindow *, int){
+    return GLFW_RELEASE;
+}
+
+
+int benchGetMouseButton(GLFWwindow *, int button){
+    return button == GLFW_MOUSE_BUTTON_LEFT ? GLFW_PRESS : GLFW_RELEASE;
+}
+
+
+void benchGetCursorPos(GLFWwindow *, double *xpos, double *ypos){
+    // a Lissajous curve over the window, one step per frame
+    double step = (double) harness.frames.size();
+    if (xpos)
+        *xpos = harness.width * (0.5 + 0.4 * std::sin(step * 0.05));
+    if (ypos)
+        *ypos = harness.height * (0.5 + 0.4 * std::sin(step * 0.07));
+}
+
+
+void benchGetWindowSize(GLFWwindow *, int *width, int *height){
+    if (width)
+        *width = harness.width;
+    if (height)
+        *height = harness.height;
+}
+
+
+double benchGetTime(){
+    return harness.frames.size() / 60.0;
+}
+
+
+void benchTerminate(){
+    writeResults();
+
+    GpuProfiler::setFrameCallback(nullptr);
+    GLInstrumentation::instance().setEnabled(false);
+    glad_set_post_callback(ignoreCall);
+#ifdef BENCH_HAS_EGL
+    if (harness.useEGL) {
+        RawGL &gl = harness.gl;
+        gl.DeleteFramebuffers(1, &harness.framebuffer);
+        gl.DeleteRenderbuffers(1, &harness.colorBuffer);
+        gl.DeleteRenderbuffers(1, &harness.depthBuffer);
+        eglMakeCurrent(harness.display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+        eglDestroyContext(harness.display, harness.context);
+        eglTerminate(harness.display);
+        return;
+    }
+#endif
+    glfwTerminate();
+}
@@ -0,0 +1,57 @@
+#ifndef BENCH_HARNESS_H
+#define BENCH_HARNESS_H
+
+// Headless benchmark harness for the exercise programs.
+//
+// The benchmark targets compile the exercise sources with this header force-included, which redirects the
+// glfw functions the exercises use to the bench* functions below. The window becomes an offscreen context
+// (EGL surfaceless when available, else whatever glfw provides, its null platform with OSMesa in benchmark
+// builds), glfwWindowShouldClose returns true after BENCH_FRAMES frames (default 300), time is a fixed 60Hz
+// clock and the mouse button is held down while the cursor follows a fixed path, so every run renders the
+// same frames. Each glfwSwapBuffers closes a frame: its CPU time, GL call count and a checksum of its pixels
+// are recorded, and glfwTerminate writes them all as JSON to BENCH_OUTPUT (default <scene>.json). The calls
+// are counted by the renderer's GLInstrumentation, which also records redundant and thrashing binds, buffer
+// orphaning and stalls per frame; its callbacks time every call, so set BENCH_GL_INSTRUMENTATION=0 to only
+// count calls (with glad's post call callback) when the CPU times matter most. The frames and scopes timed by
+// a GpuProfiler of the exercise are summarized in the JSON as well.
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+int benchInit();
+void benchWindowHint(int hint, int value);
+GLFWwindow *benchCreateWindow(int width, int height, const char *title, GLFWmonitor *monitor, GLFWwindow *share);
+void benchMakeContextCurrent(GLFWwindow *window);
+GLFWglproc benchGetProcAddress(const char *procname);
+GLFWframebuffersizefun benchSetFramebufferSizeCallback(GLFWwindow *window, GLFWframebuffersizefun callback);
+int benchWindowShouldClose(GLFWwindow *window);
+void benchSetWindowShouldClose(GLFWwindow *window, int value);
+void benchSwapBuffers(GLFWwindow *window);
+void benchPollEvents();
+int benchGetKey(GLFWwindow *window, int key);
+int benchGetMouseButton(GLFWwindow *window, int button);
+void benchGetCursorPos(GLFWwindow *window, double *xpos, double *ypos);
+void benchGetWindowSize(GLFWwindow *window, int *width, int *height);
+double benchGetTime();
+void benchTerminate();
+
+#ifndef BENCH_HARNESS_IMPLEMENTATION
+#define glfwInit benchInit
+#define glfwWindowHint benchWindowHint
+#define glfwCreateWindow benchCreateWindow
+#define glfwMakeContextCurrent benchMakeContextCurrent
+#define glfwGetProcAddress benchGetProcAddress
+#define glfwSetFramebufferSizeCallback benchSetFramebufferSizeCallback
+#define glfwWindowShouldClose benchWindowShouldClose
+#define glfwSetWindowShouldClose benchSetWindowShouldClose
+#define glfwSwapBuffers benchSwapBuffers
+#define glfwPollEvents benchPollEvents
+#define glfwGetKey benchGetKey
+#define glfwGetMouseButton benchGetMouseButton
+#define glfwGetCursorPos benchGetCursorPos
+#define glfwGetWindowSize benchGetWindowSize
+#define glfwGetTime benchGetTime
+#define glfwTerminate benchTerminate
+#endif
+
+#endif
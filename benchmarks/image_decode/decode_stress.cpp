@@ -0,0 +1,200 @@
+// Multithreaded stress test of stb_image's *_ex entry points (per-call options and failure reason).
+//
+// Every image given on the command line is first decoded on one thread with the legacy API (global flip
+// setting), flipped and not, and the pixels hashed. Then BENCH_THREADS threads (default: one per hardware
+// thread, at least 4) each decode all of them BENCH_ROUNDS times (default 2) with stbi_load_ex, flipping
+// every other decode (staggered between threads, so flipped and unflipped decodes run at the same time), and
+// between two images decode a truncated and a garbage buffer that must fail. Every decode is checked against
+// the single-threaded hash and every failure against the reason that input gives on its own, so a reason
+// clobbered by another thread is a mismatch (a successful call may still hold the reason a format probe gave,
+// as with the legacy API). The results are written as JSON to BENCH_OUTPUT (default decode_stress.json); the
+// exit code is 1 on any mismatch.
+
+#include <stb_image.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+double millisecondsSince(Clock::time_point start){
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+
+// FNV-1a over the size and the pixels of a decode
+// -----------------------------------------------
+std::uint64_t imageHash(const unsigned char *pixels, int width, int height, int channels){
+    std::uint64_t hash = 14695981039346656037ull;
+    auto add = [&hash](unsigned char value){
+        hash ^= value;
+        hash *= 1099511628211ull;
+    };
+    int header[3] = {width, height, channels};
+    for (int value : header)
+        for (int i = 0; i < 4; i++)
+            add((unsigned char) (value >> (8 * i)));
+    size_t size = (size_t) width * height * channels;
+    for (size_t i = 0; i < size; i++)
+        add(pixels[i]);
+    return hash;
+}
+
+
+std::vector<unsigned char> readFile(const char *path){
+    std::vector<unsigned char> contents;
+    FILE *file = std::fopen(path, "rb");
+    if (!file)
+        return contents;
+    unsigned char buffer[1 << 16];
+    size_t read;
+    while ((read = std::fread(buffer, 1, sizeof(buffer), file)) > 0)
+        contents.insert(contents.end(), buffer, buffer + read);
+    std::fclose(file);
+    return contents;
+}
+
+
+// an input that must fail to decode, and the reason it gives when decoded alone
+// ------------------------------------------------------------------------------
+struct Corrupt {
+    const char *name;
+    std::vector<unsigned char> bytes;
+    std::string reason;
+};
+
+
+struct Counters {
+    std::atomic<unsigned long> decodes{0};
+    std::atomic<unsigned long> failures{0};
+    std::atomic<unsigned long> mismatches{0};
+    std::atomic<unsigned long> reasonMismatches{0};
+};
+
+
+unsigned long environmentCount(const char *name, unsigned long fallback){
+    const char *value = std::getenv(name);
+    return value && std::atol(value) > 0 ? (unsigned long) std::atol(value) : fallback;
+}
+
+} // namespace
+
+
+int main(int argc, char **argv){
+    if (argc < 2) {
+        std::fprintf(stderr, "usage: %s image...\n", argv[0]);
+        return 2;
+    }
+    std::vector<const char *> images(argv + 1, argv + argc);
+    unsigned long threadCount = environmentCount("BENCH_THREADS", std::max(4u, std::thread::hardware_concurrency()));
+    unsigned long rounds = environmentCount("BENCH_ROUNDS", 2);
+
+    // reference hashes with the legacy API, on this thread only
+    Clock::time_point start = Clock::now();
+    std::vector<std::uint64_t> reference[2];
+    for (int flip = 0; flip < 2; flip++) {
+        stbi_set_flip_vertically_on_load(flip);
+        for (const char *image : images) {
+            int width, height, channels;
+            unsigned char *pixels = stbi_load(image, &width, &height, &channels, 0);
+            if (!pixels) {
+                std::fprintf(stderr, "decode_stress: cannot decode %s: %s\n", image, stbi_failure_reason());
+                return 2;
+            }
+            reference[flip].push_back(imageHash(pixels, width, height, channels));
+            stbi_image_free(pixels);
+        }
+    }
+    stbi_set_flip_vertically_on_load(0);
+    double singleThreadMilliseconds = millisecondsSince(start);
+
+    std::vector<Corrupt> corrupts(2);
+    corrupts[0].name = "truncated";
+    corrupts[0].bytes = readFile(images[0]);
+    corrupts[0].bytes.resize(corrupts[0].bytes.size() / 2);
+    corrupts[1].name = "garbage";
+    corrupts[1].bytes.assign(4096, 0x5a);
+    for (Corrupt &corrupt : corrupts) {
+        stbi_options options;
+        stbi_options_init(&options);
+        int width, height, channels;
+        unsigned char *pixels = stbi_load_from_memory_ex(&options, corrupt.bytes.data(), (int) corrupt.bytes.size(),
+                                                         &width, &height, &channels, 0);
+        if (pixels || !options.failure_reason) {
+            std::fprintf(stderr, "decode_stress: the %s input does not fail\n", corrupt.name);
+            stbi_image_free(pixels);
+            return 2;
+        }
+        corrupt.reason = options.failure_reason;
+    }
+
+    Counters counters;
+    auto work = [&](unsigned long thread){
+        for (unsigned long round = 0; round < rounds; round++)
+            for (size_t i = 0; i < images.size(); i++) {
+                int flip = (int) ((thread + round + i) % 2);
+                stbi_options options;
+                stbi_options_init(&options);
+                options.flip_vertically = flip;
+                int width, height, channels;
+                unsigned char *pixels = stbi_load_ex(&options, images[i], &width, &height, &channels, 0);
+                ++counters.decodes;
+                if (!pixels || imageHash(pixels, width, height, channels) != reference[flip][i])
+                    ++counters.mismatches;
+                stbi_image_free(pixels);
+
+                const Corrupt &corrupt = corrupts[(thread + i) % corrupts.size()];
+                stbi_options_init(&options);
+                options.flip_vertically = flip;
+                pixels = stbi_load_from_memory_ex(&options, corrupt.bytes.data(), (int) corrupt.bytes.size(),
+                                                  &width, &height, &channels, 0);
+                ++counters.failures;
+                if (pixels)
+                    ++counters.mismatches;
+                if (!options.failure_reason || corrupt.reason != options.failure_reason)
+                    ++counters.reasonMismatches;
+                stbi_image_free(pixels);
+            }
+    };
+
+    start = Clock::now();
+    std::vector<std::thread> threads;
+    for (unsigned long thread = 0; thread < threadCount; thread++)
+        threads.emplace_back(work, thread);
+    for (std::thread &thread : threads)
+        thread.join();
+    double multiThreadMilliseconds = millisecondsSince(start);
+
+    bool passed = counters.mismatches == 0 && counters.reasonMismatches == 0;
+    const char *path = std::getenv("BENCH_OUTPUT");
+    FILE *file = std::fopen(path ? path : "decode_stress.json", "w");
+    if (file) {
+        std::fprintf(file, "{\n");
+        std::fprintf(file, "  \"scene\": \"decode_stress\",\n");
+        std::fprintf(file, "  \"images\": %lu,\n  \"threads\": %lu,\n  \"rounds\": %lu,\n",
+                     (unsigned long) images.size(), threadCount, rounds);
+        std::fprintf(file, "  \"decodes\": %lu,\n  \"expected_failures\": %lu,\n",
+                     counters.decodes.load(), counters.failures.load());
+        std::fprintf(file, "  \"pixel_mismatches\": %lu,\n  \"failure_reason_mismatches\": %lu,\n",
+                     counters.mismatches.load(), counters.reasonMismatches.load());
+        std::fprintf(file, "  \"single_thread_ms\": %.3f,\n  \"multi_thread_ms\": %.3f,\n",
+                     singleThreadMilliseconds, multiThreadMilliseconds);
+        std::fprintf(file, "  \"passed\": %s\n}\n", passed ? "true" : "false");
+        std::fclose(file);
+    }
+
+    std::printf("decode_stress: %lu decodes and %lu failing ones on %lu threads, %lu pixel and %lu failure reason "
+                "mismatches\n", counters.decodes.load(), counters.failures.load(), threadCount,
+                counters.mismatches.load(), counters.reasonMismatches.load());
+    return passed ? 0 : 1;
+}
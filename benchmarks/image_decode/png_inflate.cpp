@@ -0,0 +1,197 @@
+// Benchmark of stb_image's PNG inflate, checked against zlib's.
+//
+// The IDAT streams of every PNG given on the command line are inflated with stb_image
+// (stbi_zlib_decode_buffer) and with zlib's reference inflate (uncompress, from assimp's contrib/zlib), both
+// into buffers of the exact size IHDR asks for, and the outputs compared byte for byte: any correct inflate
+// gives the same bytes, so this checks stb_image's fast path is still bit-exact. Then the inflate of all files
+// with both and the full stbi_load_from_memory decode are timed, best of BENCH_ROUNDS runs (default 7). The
+// results are written as JSON to BENCH_OUTPUT (default png_inflate.json); the exit code is 1 if any output
+// differs.
+
+#include <stb_image.h>
+#include <zlib.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+double millisecondsSince(Clock::time_point start){
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+
+std::vector<unsigned char> readFile(const char *path){
+    std::vector<unsigned char> contents;
+    FILE *file = std::fopen(path, "rb");
+    if (!file)
+        return contents;
+    unsigned char buffer[1 << 16];
+    size_t read;
+    while ((read = std::fread(buffer, 1, sizeof(buffer), file)) > 0)
+        contents.insert(contents.end(), buffer, buffer + read);
+    std::fclose(file);
+    return contents;
+}
+
+
+unsigned bigEndian32(const unsigned char *p){
+    return (unsigned) p[0] << 24 | (unsigned) p[1] << 16 | (unsigned) p[2] << 8 | p[3];
+}
+
+
+// a PNG split into what the benchmark needs
+// -----------------------------------------
+struct Png {
+    std::string path;
+    std::vector<unsigned char> file;
+    // all IDAT chunks after one another, the zlib stream
+    std::vector<unsigned char> idat;
+    // the inflated size: a filter byte and the packed pixels of every row, of every Adam7 pass if interlaced
+    size_t rawSize = 0;
+};
+
+
+size_t rawSize(unsigned width, unsigned height, int bitDepth, int colorType, bool interlaced){
+    static const int channelsByType[7] = {1, 0, 3, 1, 2, 0, 4};
+    size_t bitsPerPixel = (size_t) channelsByType[colorType < 7 ? colorType : 1] * bitDepth;
+    auto passSize = [bitsPerPixel](size_t w, size_t h){
+        return w && h ? h * (1 + (w * bitsPerPixel + 7) / 8) : 0;
+    };
+    if (!interlaced)
+        return passSize(width, height);
+    static const int xOrigin[7] = {0, 4, 0, 2, 0, 1, 0}, yOrigin[7] = {0, 0, 4, 0, 2, 0, 1};
+    static const int xSpacing[7] = {8, 8, 4, 4, 2, 2, 1}, ySpacing[7] = {8, 8, 8, 4, 4, 2, 2};
+    size_t size = 0;
+    for (int pass = 0; pass < 7; pass++)
+        size += passSize((width - xOrigin[pass] + xSpacing[pass] - 1) / xSpacing[pass],
+                         (height - yOrigin[pass] + ySpacing[pass] - 1) / ySpacing[pass]);
+    return size;
+}
+
+
+bool parsePng(const char *path, Png &png){
+    png.path = path;
+    png.file = readFile(path);
+    const std::vector<unsigned char> &file = png.file;
+    static const unsigned char signature[8] = {137, 80, 78, 71, 13, 10, 26, 10};
+    if (file.size() < 8 || std::memcmp(file.data(), signature, 8) != 0)
+        return false;
+    for (size_t at = 8; at + 12 <= file.size();) {
+        unsigned length = bigEndian32(&file[at]);
+        const unsigned char *type = &file[at + 4], *data = &file[at + 8];
+        if (length > file.size() - at - 12)
+            return false;
+        if (std::memcmp(type, "IHDR", 4) == 0 && length >= 13)
+            png.rawSize = rawSize(bigEndian32(data), bigEndian32(data + 4), data[8], data[9], data[12] != 0);
+        else if (std::memcmp(type, "IDAT", 4) == 0)
+            png.idat.insert(png.idat.end(), data, data + length);
+        at += 12 + length;
+    }
+    return png.rawSize > 0 && !png.idat.empty();
+}
+
+
+// best (lowest) wall clock of running f rounds times
+template<typename F>
+double bestOf(unsigned long rounds, F f){
+    double best = 0.0;
+    for (unsigned long round = 0; round < rounds; round++) {
+        Clock::time_point start = Clock::now();
+        f();
+        double milliseconds = millisecondsSince(start);
+        if (round == 0 || milliseconds < best)
+            best = milliseconds;
+    }
+    return best;
+}
+
+} // namespace
+
+
+int main(int argc, char **argv){
+    if (argc < 2) {
+        std::fprintf(stderr, "usage: %s image.png...\n", argv[0]);
+        return 2;
+    }
+    const char *roundsValue = std::getenv("BENCH_ROUNDS");
+    unsigned long rounds = roundsValue && std::atol(roundsValue) > 0 ? (unsigned long) std::atol(roundsValue) : 7;
+
+    std::vector<Png> pngs(argc - 1);
+    size_t totalRaw = 0, largest = 0;
+    for (int i = 1; i < argc; i++) {
+        if (!parsePng(argv[i], pngs[i - 1])) {
+            std::fprintf(stderr, "png_inflate: %s is not a PNG this benchmark can read\n", argv[i]);
+            return 2;
+        }
+        totalRaw += pngs[i - 1].rawSize;
+        largest = std::max(largest, pngs[i - 1].rawSize);
+    }
+
+    // both inflates must give the same bytes, of the size IHDR gives
+    std::vector<char> stbOutput(largest);
+    std::vector<unsigned char> zlibOutput(largest);
+    unsigned long differing = 0;
+    for (const Png &png : pngs) {
+        int stbSize = stbi_zlib_decode_buffer(stbOutput.data(), (int) png.rawSize, (const char *) png.idat.data(),
+                                              (int) png.idat.size());
+        uLongf zlibSize = (uLongf) png.rawSize;
+        int zlibResult = uncompress(zlibOutput.data(), &zlibSize, png.idat.data(), (uLong) png.idat.size());
+        if (zlibResult != Z_OK || stbSize != (int) png.rawSize || zlibSize != png.rawSize ||
+            std::memcmp(stbOutput.data(), zlibOutput.data(), png.rawSize) != 0) {
+            std::fprintf(stderr, "png_inflate: %s inflates differently (stb_image %d bytes, zlib %lu bytes, "
+                                 "%zu expected)\n", png.path.c_str(), stbSize, (unsigned long) zlibSize, png.rawSize);
+            ++differing;
+        }
+    }
+
+    double stbMilliseconds = bestOf(rounds, [&](){
+        for (const Png &png : pngs)
+            stbi_zlib_decode_buffer(stbOutput.data(), (int) png.rawSize, (const char *) png.idat.data(),
+                                    (int) png.idat.size());
+    });
+    double zlibMilliseconds = bestOf(rounds, [&](){
+        for (const Png &png : pngs) {
+            uLongf size = (uLongf) png.rawSize;
+            uncompress(zlibOutput.data(), &size, png.idat.data(), (uLong) png.idat.size());
+        }
+    });
+    double loadMilliseconds = bestOf(rounds, [&](){
+        for (const Png &png : pngs) {
+            int width, height, channels;
+            stbi_image_free(stbi_load_from_memory(png.file.data(), (int) png.file.size(), &width, &height,
+                                                  &channels, 0));
+        }
+    });
+
+    double megabytes = totalRaw / 1e6;
+    const char *path = std::getenv("BENCH_OUTPUT");
+    FILE *file = std::fopen(path ? path : "png_inflate.json", "w");
+    if (file) {
+        std::fprintf(file, "{\n");
+        std::fprintf(file, "  \"scene\": \"png_inflate\",\n");
+        std::fprintf(file, "  \"images\": %lu,\n  \"rounds\": %lu,\n  \"inflated_bytes\": %lu,\n",
+                     (unsigned long) pngs.size(), rounds, (unsigned long) totalRaw);
+        std::fprintf(file, "  \"differing_outputs\": %lu,\n", differing);
+        std::fprintf(file, "  \"stb_inflate_ms\": %.3f,\n  \"stb_inflate_mb_per_s\": %.1f,\n",
+                     stbMilliseconds, megabytes / (stbMilliseconds / 1000.0));
+        std::fprintf(file, "  \"zlib_inflate_ms\": %.3f,\n  \"zlib_inflate_mb_per_s\": %.1f,\n",
+                     zlibMilliseconds, megabytes / (zlibMilliseconds / 1000.0));
+        std::fprintf(file, "  \"stb_load_ms\": %.3f,\n", loadMilliseconds);
+        std::fprintf(file, "  \"passed\": %s\n}\n", differing ? "false" : "true");
+        std::fclose(file);
+    }
+
+    std::printf("png_inflate: %lu images, %.1f MB inflated; stb_image %.1f ms, zlib %.1f ms, full decode %.1f ms; "
+                "%lu differing outputs\n", (unsigned long) pngs.size(), megabytes, stbMilliseconds,
+                zlibMilliseconds, loadMilliseconds, differing);
+    return differing ? 1 : 0;
+}
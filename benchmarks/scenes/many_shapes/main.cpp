@@ -0,0 +1,145 @@
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+#include <renderer/shape_batch.h>
+
+// Benchmark scene: thousands of animated circles, squares and triangles drawn with a ShapeBatch, refilled
+// every frame, so the frame time is the cost of add() per shape, one instance buffer upload per kind of
+// shape and one instanced draw per kind (three draw calls, however many shapes there are).
+
+
+// glfw functions
+// --------------
+void framebufferSizeCallback(GLFWwindow* window, int width, int height);
+void processInput(GLFWwindow *window);
+
+
+// settings
+// --------
+const unsigned int SCR_WIDTH = 800;
+const unsigned int SCR_HEIGHT = 800;
+const unsigned int SHAPE_COUNT = 10000;
+// triangles of a circle, small shapes do not need more
+const int CIRCLE_SEGMENTS = 16;
+
+
+// where a shape starts and how it moves, fixed for the whole run
+// --------------------------------------------------------------
+struct ShapeMotion {
+    ShapeBatch::Shape shape;
+    float x, y, size, speed, phase;
+    glm::vec4 color;
+};
+
+
+// the same pseudo random shapes on every platform (std::rand is not), values between 0 and 1
+// ------------------------------------------------------------------------------------------
+float nextRandom(unsigned int &state){
+    state = state * 1664525u + 1013904223u;
+    return (float) (state >> 8) / (float) (1u << 24);
+}
+
+
+std::vector<ShapeMotion> createShapes(unsigned int count){
+    std::vector<ShapeMotion> shapes(count);
+    unsigned int state = 12345u;
+    for (ShapeMotion &motion : shapes) {
+        motion.shape = (ShapeBatch::Shape) (unsigned int) (nextRandom(state) * ShapeBatch::SHAPE_COUNT);
+        motion.x = nextRandom(state) * 2.0f - 1.0f;
+        motion.y = nextRandom(state) * 2.0f - 1.0f;
+        motion.size = 0.01f + 0.03f * nextRandom(state);
+        motion.speed = 0.5f + 2.0f * nextRandom(state);
+        motion.phase = 6.2831853f * nextRandom(state);
+        motion.color = glm::vec4(nextRandom(state), nextRandom(state), nextRandom(state), 1.0f);
+    }
+    return shapes;
+}
+
+
+int main()
+{
+
+    // glfw: initialize and configure
+    // ------------------------------
+    glfwInit();
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+
+#ifdef __APPLE__
+    glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
+#endif
+
+
+    // glfw window creation
+    // --------------------
+    GLFWwindow* window = glfwCreateWindow(SCR_WIDTH, SCR_HEIGHT, "Many shapes", NULL, NULL);
+    if (window == NULL)
+    {
+        std::cout << "Failed to create GLFW window" << std::endl;
+        glfwTerminate();
+        return -1;
+    }
+    glfwMakeContextCurrent(window);
+    glfwSetFramebufferSizeCallback(window, framebufferSizeCallback);
+
+
+    // glad: load all OpenGL function pointers
+    // ---------------------------------------
+    if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
+    {
+        std::cout << "Failed to initialize GLAD" << std::endl;
+        return -1;
+    }
+
+    std::vector<ShapeMotion> shapes = createShapes(SHAPE_COUNT);
+
+    // render loop (the batch owns GL objects, it goes out of scope before the context is destroyed)
+    // -----------------------------------------------------------------------------------------------
+    {
+        ShapeBatch batch(CIRCLE_SEGMENTS);
+        while (!glfwWindowShouldClose(window)) {
+            processInput(window);
+
+            glClearColor(.2f, .2f, .2f, 1.0f);
+            glClear(GL_COLOR_BUFFER_BIT);
+
+            // every shape circles around its start position and spins
+            float time = (float) glfwGetTime();
+            batch.clear();
+            for (const ShapeMotion &motion : shapes) {
+                float angle = motion.phase + motion.speed * time;
+                glm::vec2 position(motion.x + 0.05f * std::cos(angle), motion.y + 0.05f * std::sin(angle));
+                batch.add(motion.shape, position, glm::vec2(motion.size), angle, motion.color);
+            }
+            batch.draw();
+
+            glfwSwapBuffers(window);
+            glfwPollEvents();
+        }
+    }
+
+    glfwTerminate();
+    return 0;
+}
+
+
+// process all input: query GLFW whether relevant keys are pressed/released this frame and react accordingly
+// ---------------------------------------------------------------------------------------------------------
+void processInput(GLFWwindow *window)
+{
+    if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
+        glfwSetWindowShouldClose(window, true);
+}
+
+
+// glfw: whenever the window size changed (by OS or user resize) this callback function executes
+// ---------------------------------------------------------------------------------------------
+void framebufferSizeCallback(GLFWwindow* /*window*/, int width, int height)
+{
+    glViewport(0, 0, width, height);
+}
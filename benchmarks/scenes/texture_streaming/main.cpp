@@ -0,0 +1,230 @@
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <renderer/compressed_texture_cache.h>
+#include <renderer/cubemap_loader.h>
+#include <renderer/shader_program.h>
+#include <renderer/texture_loader.h>
+#include <renderer/vertex_array.h>
+
+// Benchmark scene: the textures of the car model, all of them streamed in by a TextureLoader (decoded by its
+// workers, uploaded within its per frame budget by update(), so the first frames show placeholders and the
+// frame times show the uploads), and some also block compressed from a CompressedTextureCache (compressed on
+// the first run, read from the cache after), in front of a skybox loaded as a cubemap by a CubemapLoader.
+// Which frame a streamed texture shows up in depends on how fast the workers decode, so only the frames after
+// all of them are ready are the same from run to run. The loaders' own statistics are printed at the end.
+
+
+// glfw functions
+// --------------
+void framebufferSizeCallback(GLFWwindow* window, int width, int height);
+void processInput(GLFWwindow *window);
+
+
+// settings
+// --------
+const unsigned int SCR_WIDTH = 800;
+const unsigned int SCR_HEIGHT = 800;
+// textures per row and column of the grid they are drawn in
+const int GRID_SIZE = 6;
+
+#ifndef MODELS_DIR
+#define MODELS_DIR "../../common/models"
+#endif
+// where the compressed textures are cached, relative to the working directory
+const char *CACHE_DIRECTORY = "texture_cache";
+
+const char *carTextures[] = {
+        "BodyAlbedo.png", "BodyAo.png", "BodyMetalness.png",
+        "InteriorAlbedo.png", "InteriorAo.png", "InteriorMetalness.png", "InteriorNormal.png",
+        "LightAlbedo.png", "LightAo.png", "LightMetalness.png", "LightNormal.png",
+        "Misc_Albedo.png", "Misc_AO.png", "MiscMetalness.png", "Misc_Normal.png",
+        "WheelAlbedo.png", "WheelAo.png", "WheelMetalness.png", "WheelNormal.png",
+        "WindowAlbedo.png", "WindowAo.png", "WindowMetalness.png", "WindowNormal.png"
+};
+// BC1, BC4 and BC5 from the cache
+const char *compressedTextures[] = {"BodyAlbedo.png", "BodyAo.png", "Misc_Normal.png"};
+const char *skyboxFaces[] = {"right.tga", "left.tga", "top.tga", "bottom.tga", "front.tga", "back.tga"};
+
+
+// shader programs
+// ---------------
+// a quad (a triangle strip of 4 vertices, no vertex buffer needed) covering rect = (x, y, width, height)
+const char *quadVertexSource = "#version 330 core\n"
+                               "uniform vec4 rect;\n"
+                               "out vec2 texCoord;\n"
+                               "void main()\n"
+                               "{\n"
+                               "   texCoord = vec2(gl_VertexID & 1, gl_VertexID >> 1);\n"
+                               "   gl_Position = vec4(rect.xy + texCoord * rect.zw, 0.0, 1.0);\n"
+                               "}\0";
+const char *quadFragmentSource = "#version 330 core\n"
+                                 "uniform sampler2D image;\n"
+                                 "in  vec2 texCoord;\n"
+                                 "out vec4 FragColor;\n"
+                                 "void main()\n"
+                                 "{\n"
+                                 "   FragColor = vec4(texture(image, texCoord).rgb, 1.0);\n"
+                                 "}\n\0";
+// a triangle covering the screen, looking around the y axis into the cubemap
+const char *skyVertexSource = "#version 330 core\n"
+                              "uniform float angle;\n"
+                              "out vec3 direction;\n"
+                              "void main()\n"
+                              "{\n"
+                              "   vec2 pos = vec2((gl_VertexID << 1) & 2, gl_VertexID & 2) * 2.0 - 1.0;\n"
+                              "   float c = cos(angle), s = sin(angle);\n"
+                              "   direction = vec3(c * pos.x + s, pos.y, s * pos.x - c);\n"
+                              "   gl_Position = vec4(pos, 0.0, 1.0);\n"
+                              "}\0";
+const char *skyFragmentSource = "#version 330 core\n"
+                                "uniform samplerCube sky;\n"
+                                "in  vec3 direction;\n"
+                                "out vec4 FragColor;\n"
+                                "void main()\n"
+                                "{\n"
+                                "   FragColor = texture(sky, direction);\n"
+                                "}\n\0";
+
+
+int main()
+{
+
+    // glfw: initialize and configure
+    // ------------------------------
+    glfwInit();
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+
+#ifdef __APPLE__
+    glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
+#endif
+
+
+    // glfw window creation
+    // --------------------
+    GLFWwindow* window = glfwCreateWindow(SCR_WIDTH, SCR_HEIGHT, "Texture streaming", NULL, NULL);
+    if (window == NULL)
+    {
+        std::cout << "Failed to create GLFW window" << std::endl;
+        glfwTerminate();
+        return -1;
+    }
+    glfwMakeContextCurrent(window);
+    glfwSetFramebufferSizeCallback(window, framebufferSizeCallback);
+
+
+    // glad: load all OpenGL function pointers
+    // ---------------------------------------
+    if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
+    {
+        std::cout << "Failed to initialize GLAD" << std::endl;
+        return -1;
+    }
+
+    const std::string carDirectory = std::string(MODELS_DIR) + "/car/";
+    const std::string skyboxDirectory = std::string(MODELS_DIR) + "/skybox/";
+
+    // everything owning GL objects goes out of scope before the context is destroyed
+    {
+        // request all the streamed textures, they come in while the frames are drawn
+        TextureLoader loader;
+        std::vector<GLuint> textures;
+        std::vector<TextureLoader::Handle> handles;
+        for (const char *name : carTextures)
+            handles.push_back(loader.load(carDirectory + name));
+
+        CompressedTextureCache cache(CACHE_DIRECTORY);
+        std::vector<GLuint> compressed;
+        for (const char *name : compressedTextures) {
+            GLuint texture = cache.load(carDirectory + name);
+            if (texture)
+                compressed.push_back(texture);
+        }
+
+        CubemapLoader cubemaps((GLADloadproc)glfwGetProcAddress);
+        std::vector<std::string> faces;
+        for (const char *name : skyboxFaces)
+            faces.push_back(skyboxDirectory + name);
+        GLuint sky = cubemaps.load(faces);
+
+        ShaderProgram quadProgram(quadVertexSource, quadFragmentSource);
+        ShaderProgram skyProgram(skyVertexSource, skyFragmentSource);
+        quadProgram.setInt("image", 0);
+        skyProgram.setInt("sky", 0);
+        // core profile draws need a vertex array, even without attributes
+        VertexArray emptyVertexArray;
+
+        // render loop
+        // -----------
+        while (!glfwWindowShouldClose(window)) {
+            processInput(window);
+
+            // upload what the workers decoded, within the budget
+            loader.update();
+
+            glClear(GL_COLOR_BUFFER_BIT);
+            glActiveTexture(GL_TEXTURE0);
+
+            skyProgram.setFloat("angle", 0.2f * (float) glfwGetTime());
+            glBindTexture(GL_TEXTURE_CUBE_MAP, sky);
+            emptyVertexArray.draw(GL_TRIANGLES, 0, 3);
+
+            // the streamed textures first, then the compressed ones, row by row from the top left
+            textures.clear();
+            for (TextureLoader::Handle handle : handles)
+                textures.push_back(loader.texture(handle));
+            textures.insert(textures.end(), compressed.begin(), compressed.end());
+
+            const float cell = 2.0f / GRID_SIZE, margin = 0.05f * cell;
+            for (size_t i = 0; i < textures.size(); i++) {
+                int column = (int) i % GRID_SIZE, row = (int) i / GRID_SIZE;
+                quadProgram.setVec4("rect", glm::vec4(-1.0f + column * cell + margin, 1.0f - (row + 1) * cell + margin,
+                                                      cell - 2 * margin, cell - 2 * margin));
+                glBindTexture(GL_TEXTURE_2D, textures[i]);
+                emptyVertexArray.draw(GL_TRIANGLE_STRIP, 0, 4);
+            }
+
+            glfwSwapBuffers(window);
+            glfwPollEvents();
+        }
+
+        const TextureLoader::Stats &streamed = loader.statistics();
+        std::cout << "streamed " << streamed.ready << " of " << streamed.requested << " textures ("
+                  << streamed.failed << " failed), first after " << streamed.firstReadyMilliseconds
+                  << " ms, all after " << streamed.allReadyMilliseconds << " ms; decode " << streamed.decodeMilliseconds
+                  << " ms over the workers, upload " << streamed.uploadMilliseconds << " ms" << std::endl;
+        std::cout << "compressed cache: " << cache.hits() << " hits, " << cache.misses() << " misses, "
+                  << cache.invalidated() << " invalidated" << std::endl;
+        std::cout << "cubemap: decode " << cubemaps.statistics().decodeMilliseconds << " ms, upload "
+                  << cubemaps.statistics().uploadMilliseconds << " ms" << std::endl;
+
+        glDeleteTextures((GLsizei) compressed.size(), compressed.data());
+        glDeleteTextures(1, &sky);
+    }
+
+    glfwTerminate();
+    return 0;
+}
+
+
+// process all input: query GLFW whether relevant keys are pressed/released this frame and react accordingly
+// ---------------------------------------------------------------------------------------------------------
+void processInput(GLFWwindow *window)
+{
+    if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
+        glfwSetWindowShouldClose(window, true);
+}
+
+
+// glfw: whenever the window size changed (by OS or user resize) this callback function executes
+// ---------------------------------------------------------------------------------------------
+void framebufferSizeCallback(GLFWwindow* /*window*/, int width, int height)
+{
+    glViewport(0, 0, width, height);
+}
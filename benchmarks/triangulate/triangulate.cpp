@@ -0,0 +1,252 @@
+// Benchmark of assimp's TriangulateProcess on large synthetic polygons.
+//
+// Each polygon is a star with a wavy inner radius, so most of its vertices are reflex, laid into a tilted
+// plane. It is triangulated by the TriangulateProcess with AI_CONFIG_PP_TRI_EARCUT_THRESHOLD at its default,
+// which sends it to the z-order hashed ear clipper, and, up to BENCH_NAIVE_LIMIT vertices (default 4000), with
+// the threshold above its size, which keeps it on the old quadratic ear search. A star with a grid of square
+// holes goes to the EarCutTriangulator directly. Every result must have the triangle count of a simple polygon,
+// cover its area exactly and keep its winding. The timings (best of BENCH_ROUNDS runs, default 3) are written
+// as JSON to BENCH_OUTPUT (default triangulate.json); the exit code is 1 if any check fails.
+
+#include <assimp/Importer.hpp>
+#include <assimp/config.h>
+#include <assimp/mesh.h>
+#include "Common/EarCutTriangulator.h"
+#include "PostProcessing/TriangulateProcess.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <limits>
+#include <string>
+#include <vector>
+
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+double millisecondsSince(Clock::time_point start){
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+
+unsigned long environmentCount(const char *name, unsigned long fallback){
+    const char *value = std::getenv(name);
+    return value && std::atol(value) > 0 ? (unsigned long) std::atol(value) : fallback;
+}
+
+
+// counter clockwise star in the plane, outer points on the unit circle, inner ones between 0.3 and 0.9
+// ----------------------------------------------------------------------------------------------------
+std::vector<aiVector2D> star(unsigned int vertices){
+    std::vector<aiVector2D> points(vertices);
+    for (unsigned int i = 0; i < vertices; i++) {
+        double angle = 2.0 * M_PI * i / vertices;
+        double radius = i % 2 ? 1.0 : 0.6 + 0.3 * std::sin(7.0 * angle);
+        points[i] = aiVector2D((ai_real) (radius * std::cos(angle)), (ai_real) (radius * std::sin(angle)));
+    }
+    return points;
+}
+
+
+double signedArea(const aiVector2D &a, const aiVector2D &b, const aiVector2D &c){
+    return 0.5 * ((double) (b.x - a.x) * (c.y - a.y) - (double) (b.y - a.y) * (c.x - a.x));
+}
+
+
+double polygonArea(const aiVector2D *points, unsigned int count){
+    double area = 0.0;
+    for (unsigned int i = 0, j = count - 1; i < count; j = i++)
+        area += 0.5 * ((double) points[j].x * points[i].y - (double) points[i].x * points[j].y);
+    return area;
+}
+
+
+// the plane the stars are laid into, tilted so the process has to project them
+const aiVector3D planeU = aiVector3D(0.8f, 0.0f, -0.6f);
+const aiVector3D planeV = aiVector3D(0.36f, 0.8f, 0.48f);
+
+
+// the star as a mesh of a single polygon face
+aiMesh *starMesh(const std::vector<aiVector2D> &points){
+    aiMesh *mesh = new aiMesh();
+    mesh->mPrimitiveTypes = aiPrimitiveType_POLYGON;
+    mesh->mNumVertices = (unsigned int) points.size();
+    mesh->mVertices = new aiVector3D[points.size()];
+    for (size_t i = 0; i < points.size(); i++)
+        mesh->mVertices[i] = planeU * points[i].x + planeV * points[i].y + aiVector3D(1.0f, 2.0f, 3.0f);
+    mesh->mNumFaces = 1;
+    mesh->mFaces = new aiFace[1];
+    mesh->mFaces[0].mNumIndices = mesh->mNumVertices;
+    mesh->mFaces[0].mIndices = new unsigned int[mesh->mNumVertices];
+    for (unsigned int i = 0; i < mesh->mNumVertices; i++)
+        mesh->mFaces[0].mIndices[i] = i;
+    return mesh;
+}
+
+
+// what a triangulation must satisfy
+// ---------------------------------
+struct Check {
+    size_t triangles = 0;
+    size_t expectedTriangles = 0;
+    // triangles against the winding of the input, and the covered area relative to the polygon's
+    size_t flipped = 0;
+    double areaError = 0.0;
+
+    bool passed() const {
+        return triangles == expectedTriangles && flipped == 0 && areaError < 1e-4;
+    }
+};
+
+
+Check checkTriangles(const aiVector2D *points, const std::vector<unsigned int> &indices, size_t expectedTriangles,
+                     double area){
+    Check check;
+    check.triangles = indices.size() / 3;
+    check.expectedTriangles = expectedTriangles;
+    double covered = 0.0;
+    for (size_t t = 0; t + 2 < indices.size(); t += 3) {
+        const aiVector2D &a = points[indices[t]], &b = points[indices[t + 1]], &c = points[indices[t + 2]];
+        double triangle = signedArea(a, b, c);
+        // slivers between nearly collinear vertices may come out flipped by rounding the vertices (all within
+        // the unit square) to ai_real, which moves the area by up to about epsilon times the perimeter
+        double tolerance = std::numeric_limits<ai_real>::epsilon() * ((b - a).Length() + (c - b).Length() +
+                                                                       (a - c).Length());
+        if (triangle * area < 0.0 && std::fabs(triangle) > tolerance)
+            ++check.flipped;
+        covered += triangle;
+    }
+    check.areaError = std::fabs(covered - area) / std::fabs(area);
+    return check;
+}
+
+
+// a triangulated star mesh, mapped back into the plane of the star
+Check checkMesh(const aiMesh *mesh, const std::vector<aiVector2D> &points){
+    std::vector<unsigned int> indices;
+    for (unsigned int f = 0; f < mesh->mNumFaces; f++) {
+        if (mesh->mFaces[f].mNumIndices != 3)
+            return Check();
+        indices.insert(indices.end(), mesh->mFaces[f].mIndices, mesh->mFaces[f].mIndices + 3);
+    }
+    return checkTriangles(points.data(), indices, points.size() - 2, polygonArea(points.data(),
+                                                                                (unsigned int) points.size()));
+}
+
+
+struct Result {
+    std::string name;
+    unsigned int vertices;
+    double milliseconds;
+    Check check;
+};
+
+
+// best time of triangulating the star through the process with the given threshold
+Result runProcess(const char *name, const std::vector<aiVector2D> &points, int threshold, unsigned long rounds){
+    Assimp::Importer importer;
+    importer.SetPropertyInteger(AI_CONFIG_PP_TRI_EARCUT_THRESHOLD, threshold);
+    Assimp::TriangulateProcess process;
+    process.SetupProperties(&importer);
+
+    Result result = {name, (unsigned int) points.size(), 0.0, Check()};
+    for (unsigned long round = 0; round < rounds; round++) {
+        aiMesh *mesh = starMesh(points);
+        Clock::time_point start = Clock::now();
+        process.TriangulateMesh(mesh);
+        double milliseconds = millisecondsSince(start);
+        if (round == 0 || milliseconds < result.milliseconds)
+            result.milliseconds = milliseconds;
+        if (round == 0)
+            result.check = checkMesh(mesh, points);
+        delete mesh;
+    }
+    return result;
+}
+
+
+// best time of triangulating a star with holes x holes square holes with the ear clipper directly
+Result runHoles(unsigned int vertices, unsigned int holes, unsigned long rounds){
+    std::vector<aiVector2D> points = star(vertices);
+    std::vector<unsigned int> holeStarts;
+    double area = polygonArea(points.data(), vertices);
+    // the holes fill the square within the smallest inner radius, each turned differently so no hole has
+    // vertices collinear with another's, which the ear clipper would merge
+    const double cell = 0.4 / holes, radius = 0.3 * cell;
+    for (unsigned int y = 0; y < holes; y++)
+        for (unsigned int x = 0; x < holes; x++) {
+            double centerX = -0.2 + (x + 0.5) * cell, centerY = -0.2 + (y + 0.5) * cell;
+            double turn = 0.1 + 0.37 * (y * holes + x);
+            holeStarts.push_back((unsigned int) points.size());
+            for (int corner = 0; corner < 4; corner++)
+                points.push_back(aiVector2D((ai_real) (centerX + radius * std::cos(turn + corner * M_PI / 2)),
+                                            (ai_real) (centerY + radius * std::sin(turn + corner * M_PI / 2))));
+            area -= polygonArea(&points[holeStarts.back()], 4);
+        }
+
+    Assimp::EarCutTriangulator earCut;
+    std::vector<unsigned int> indices;
+    Result result = {"earcut_holes", (unsigned int) points.size(), 0.0, Check()};
+    for (unsigned long round = 0; round < rounds; round++) {
+        Clock::time_point start = Clock::now();
+        bool complete = earCut.Triangulate(points.data(), (unsigned int) points.size(), holeStarts.data(),
+                                           (unsigned int) holeStarts.size(), indices);
+        double milliseconds = millisecondsSince(start);
+        if (round == 0 || milliseconds < result.milliseconds)
+            result.milliseconds = milliseconds;
+        if (round == 0) {
+            // every hole adds two triangles for the two vertices its bridge duplicates
+            result.check = checkTriangles(points.data(), indices, points.size() + 2 * holeStarts.size() - 2, area);
+            if (!complete)
+                result.check.triangles = 0;
+        }
+    }
+    return result;
+}
+
+} // namespace
+
+
+int main(){
+    unsigned long rounds = environmentCount("BENCH_ROUNDS", 3);
+    unsigned long naiveLimit = environmentCount("BENCH_NAIVE_LIMIT", 4000);
+
+    std::vector<Result> results;
+    for (unsigned int vertices : {1000u, 4000u, 16000u, 100000u}) {
+        std::vector<aiVector2D> points = star(vertices);
+        results.push_back(runProcess("earcut", points, AI_TRI_DEFAULT_EARCUT_THRESHOLD, rounds));
+        if (vertices <= naiveLimit)
+            results.push_back(runProcess("naive", points, (int) vertices + 1, rounds));
+    }
+    results.push_back(runHoles(20000, 32, rounds));
+
+    bool passed = true;
+    for (const Result &result : results) {
+        passed = passed && result.check.passed();
+        std::printf("triangulate: %-12s %6u vertices %9.2f ms, %zu of %zu triangles, %zu flipped, area error %.2g\n",
+                    result.name.c_str(), result.vertices, result.milliseconds, result.check.triangles,
+                    result.check.expectedTriangles, result.check.flipped, result.check.areaError);
+    }
+
+    const char *path = std::getenv("BENCH_OUTPUT");
+    FILE *file = std::fopen(path ? path : "triangulate.json", "w");
+    if (file) {
+        std::fprintf(file, "{\n");
+        std::fprintf(file, "  \"scene\": \"triangulate\",\n  \"rounds\": %lu,\n  \"polygons\": [\n", rounds);
+        for (size_t i = 0; i < results.size(); i++) {
+            const Result &result = results[i];
+            std::fprintf(file, "    {\"triangulator\": \"%s\", \"vertices\": %u, \"ms\": %.3f, \"triangles\": %lu, "
+                               "\"expected_triangles\": %lu, \"flipped\": %lu, \"area_error\": %g}%s\n",
+                         result.name.c_str(), result.vertices, result.milliseconds,
+                         (unsigned long) result.check.triangles, (unsigned long) result.check.expectedTriangles,
+                         (unsigned long) result.check.flipped, result.check.areaError,
+                         i + 1 < results.size() ? "," : "");
+        }
+        std::fprintf(file, "  ],\n  \"passed\": %s\n}\n", passed ? "true" : "false");
+        std::fclose(file);
+    }
+    return passed ? 0 : 1;
+}
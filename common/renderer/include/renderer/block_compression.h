@@ -0,0 +1,23 @@
+#ifndef RENDERER_BLOCK_COMPRESSION_H
+#define RENDERER_BLOCK_COMPRESSION_H
+
+#include <cstddef>
+
+
+// The block compressed formats of the texture cache, every 4x4 pixels in one block: BC1 (rgb, 8 bytes a block),
+// BC3 (rgba, 16), BC4 (one channel, 8) and BC5 (two channels, 16). S3TC DXT1/DXT5 and RGTC1/RGTC2 in OpenGL.
+// ------------------------------------------------------------------------------------------------------------
+enum BlockFormat { BC1, BC3, BC4, BC5 };
+
+size_t blockSize(BlockFormat format);
+// bytes of a width x height image, the blocks on the right and bottom edge count whole
+size_t compressedSize(BlockFormat format, int width, int height);
+
+// Compress an rgba8 image (4 bytes per pixel, rows as given) into out, compressedSize bytes. BC4 takes the red
+// channel, BC5 red and green. Fast rather than best: color endpoints come from the extremes of each block along
+// its principal axis, refitted once by least squares; single channels use their block's minimum and maximum.
+// Blocks past the right and bottom edge repeat the last column and row.
+// ------------------------------------------------------------------------------------------------------------
+void compressBlocks(BlockFormat format, const unsigned char *rgba, int width, int height, unsigned char *out);
+
+#endif
@@ -0,0 +1,52 @@
+#ifndef RENDERER_BUFFER_H
+#define RENDERER_BUFFER_H
+
+#include <glad/glad.h>
+
+#include <vector>
+
+
+// OpenGL buffer object, deleted with the object. target is where bind() puts it (GL_ARRAY_BUFFER for vertex
+// data, GL_ELEMENT_ARRAY_BUFFER for indices). Uploads go through GL_COPY_WRITE_BUFFER, so they never change
+// the element buffer of whatever vertex array happens to be bound.
+// ------------------------------------------------------------------------------------------------------------
+class Buffer {
+public:
+    explicit Buffer(GLenum target = GL_ARRAY_BUFFER);
+    template<typename T>
+    Buffer(GLenum target, const std::vector<T> &data, GLenum usage = GL_STATIC_DRAW)
+    : Buffer(target){
+        setData(data, usage);
+    }
+    ~Buffer();
+
+    Buffer(Buffer &&other) noexcept;
+    Buffer &operator=(Buffer &&other) noexcept;
+    Buffer(const Buffer &) = delete;
+    Buffer &operator=(const Buffer &) = delete;
+
+    GLuint id() const { return VBO; }
+    GLenum target() const { return bufferTarget; }
+    GLsizeiptr size() const { return bufferSize; }
+
+    void bind() const;
+
+    // (re)allocate the storage and fill it with size bytes from data (data may be null)
+    void setData(const void *data, GLsizeiptr size, GLenum usage = GL_STATIC_DRAW);
+    template<typename T>
+    void setData(const std::vector<T> &data, GLenum usage = GL_STATIC_DRAW){
+        setData(data.data(), data.size() * sizeof(T), usage);
+    }
+
+    // overwrite size bytes at offset, the storage must already be large enough
+    void setSubData(GLintptr offset, GLsizeiptr size, const void *data);
+
+private:
+    void release();
+
+    GLuint VBO = 0;
+    GLenum bufferTarget;
+    GLsizeiptr bufferSize = 0;
+};
+
+#endif
@@ -0,0 +1,71 @@
+#ifndef RENDERER_COMPRESSED_TEXTURE_CACHE_H
+#define RENDERER_COMPRESSED_TEXTURE_CACHE_H
+
+#include <renderer/block_compression.h>
+
+#include <glad/glad.h>
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+
+// On-disk cache of block compressed textures with their mip chains, so an image file is only decoded and
+// compressed the first time it is used: later runs map the cache file and hand it to glCompressedTexImage2D.
+// Entries are stored under a hash of the source file contents and the options, so an edited image is compressed
+// again. The format follows the last word of the file name unless given (after a '_', '-' or space, or where
+// lower case turns to upper case): BC5 for normal maps ("...Normal"), BC4 for single channel maps ("...Ao",
+// "..._AO", "...Metalness", "...Roughness"), BC1 for the rest, BC3 when they have alpha. BC4 textures read
+// as grey like the 1 channel ones of TextureLoader; BC5 normal maps only keep x and y (red and green), the
+// shader rebuilds z = sqrt(1 - x*x - y*y).
+// prepare() does not touch OpenGL and can run on any thread (an offline tool, or the workers on the first run);
+// load() needs a current context.
+// -------------------------------------------------------------------------------------------------------------
+class CompressedTextureCache {
+public:
+    struct Options {
+        // by the file name and alpha as above, format otherwise
+        bool chooseFormat = true;
+        BlockFormat format = BC1;
+        // OpenGL expects the bottom row first, image files store the top one first
+        bool flipVertically = true;
+        bool mipmaps = true;
+    };
+
+    // directory is created if it does not exist (its parent must)
+    explicit CompressedTextureCache(const std::string &directory);
+
+    CompressedTextureCache(const CompressedTextureCache &) = delete;
+    CompressedTextureCache &operator=(const CompressedTextureCache &) = delete;
+
+    // compress the image into the cache unless it is there already; false if the image cannot be read
+    bool prepare(const std::string &path, const Options &options);
+    bool prepare(const std::string &path){ return prepare(path, Options()); }
+    // a new texture from the cache, compressing the image first on a miss; 0 if the image cannot be read or
+    // the context lacks the format (S3TC for BC1 and BC3)
+    GLuint load(const std::string &path, const Options &options);
+    GLuint load(const std::string &path){ return load(path, Options()); }
+
+    unsigned long hits() const { return hitCount; }
+    unsigned long misses() const { return missCount; }
+    // cache entries found broken (truncated, or written by another version) and compressed again
+    unsigned long invalidated() const { return invalidatedCount; }
+
+private:
+    // the cache file of the image and its key, compressed into it if needed (empty if that failed)
+    std::string entry(const std::string &path, const Options &options, std::uint64_t &key);
+    bool compress(const std::string &path, const std::vector<unsigned char> &source, BlockFormat format,
+                  const Options &options, std::uint64_t key, const std::string &file);
+    std::string path(std::uint64_t key) const;
+
+    std::string directory;
+    // on the render thread, -1 until load() first asks the context
+    int s3tcSupported = -1;
+
+    std::atomic<unsigned long> hitCount{0};
+    std::atomic<unsigned long> missCount{0};
+    std::atomic<unsigned long> invalidatedCount{0};
+};
+
+#endif
@@ -0,0 +1,70 @@
+#ifndef RENDERER_CUBEMAP_LOADER_H
+#define RENDERER_CUBEMAP_LOADER_H
+
+#include <renderer/buffer.h>
+
+#include <glad/glad.h>
+
+#include <string>
+#include <vector>
+
+
+// immutable texture storage is OpenGL 4.2 (or ARB_texture_storage), newer than the 3.3 contexts of the exercises
+typedef void (APIENTRYP PFNCUBEMAPLOADERTEXSTORAGE2DPROC)(GLenum target, GLsizei levels, GLenum internalformat,
+                                                         GLsizei width, GLsizei height);
+
+
+// Loads the six faces of a cubemap (a skybox) into one texture. The headers are read first to size a single
+// pixel unpack buffer for all faces; it is mapped write only and worker threads decode the faces in parallel
+// into a buffer of their own (stb_image's caller-owned output, reused from face to face), each copied into
+// its slice of the mapping with one memcpy, as stb_image reads back what it writes. The storage of all mip
+// levels is allocated at once with glTexStorage2D where available (glTexImage2D per face otherwise), the
+// faces are uploaded from their offsets in the buffer and the mipmaps filtered by the driver.
+// The faces must be square, of the same size; grey faces are expanded to rgb, and any alpha makes all rgba.
+// Needs a current context when constructed and for load(); only the decoding leaves the calling thread.
+// -------------------------------------------------------------------------------------------------------------
+class CubemapLoader {
+public:
+    struct Options {
+        // cubemap faces are looked up with the top row first, as image files store them
+        bool flipVertically = false;
+        // box filtered mip chain, for sampling the sky minified (e.g. blurred reflections)
+        bool mipmaps = true;
+    };
+
+    // of the last load()
+    struct Stats {
+        // wall clock of the parallel decode, and of the uploads and mipmaps on the calling thread
+        double decodeMilliseconds = 0.0, uploadMilliseconds = 0.0;
+        size_t uploadedBytes = 0;
+    };
+
+    // load is the function loader given to glad; workerCount 0 uses one worker per hardware thread (at most
+    // one per face)
+    explicit CubemapLoader(GLADloadproc load, unsigned workerCount = 0);
+
+    CubemapLoader(const CubemapLoader &) = delete;
+    CubemapLoader &operator=(const CubemapLoader &) = delete;
+
+    bool hasTextureStorage() const { return texStorage2D != nullptr; }
+
+    // a new cubemap texture of the six faces in the order +X, -X, +Y, -Y, +Z, -Z (right, left, top, bottom,
+    // front, back), or 0 if one cannot be read or they do not fit together
+    GLuint load(const std::vector<std::string> &faces, const Options &options);
+    GLuint load(const std::vector<std::string> &faces){ return load(faces, Options()); }
+
+    const Stats &statistics() const { return stats; }
+
+private:
+    // decode the faces into pixels, size x size x channels each after one another; false (with the
+    // reason in failure) if one of them failed
+    bool decode(const std::vector<std::string> &faces, const Options &options, int size, int channels,
+                unsigned char *pixels, std::string &failure);
+
+    unsigned workerCount;
+    PFNCUBEMAPLOADERTEXSTORAGE2DPROC texStorage2D = nullptr;
+    Buffer staging;
+    Stats stats;
+};
+
+#endif
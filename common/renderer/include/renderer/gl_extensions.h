@@ -0,0 +1,9 @@
+#ifndef RENDERER_GL_EXTENSIONS_H
+#define RENDERER_GL_EXTENSIONS_H
+
+// true if the current context exposes the extension (e.g. "GL_KHR_parallel_shader_compile"). glad is generated
+// without extensions, so their functions still have to be loaded with the loader given to glad
+// ---------------------------------------------------------------------------------------------------------
+bool hasGLExtension(const char *name);
+
+#endif
@@ -0,0 +1,124 @@
+#ifndef RENDERER_GL_INSTRUMENTATION_H
+#define RENDERER_GL_INSTRUMENTATION_H
+
+#include <glad/glad.h>
+
+#include <cstdarg>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+
+// per GL entry point statistics of one frame
+// ------------------------------------------
+struct GLCallStats {
+    const char *name;
+    unsigned long calls;
+    double milliseconds;
+    // binds/enables that set what was already set
+    unsigned long redundant;
+};
+
+// statistics of one frame, entry points sorted by number of calls
+// ---------------------------------------------------------------
+struct GLFrameStats {
+    unsigned long calls = 0;
+    double milliseconds = 0.0;
+    unsigned long redundant = 0;
+    // binds that put back the value a binding had just before its last change (A -> B -> A)
+    unsigned long thrashing = 0;
+    // glBufferData with the size the buffer already had (with or without data): orphaning, the driver hands
+    // out new storage instead of waiting for the draws still reading the old one, so it is not a stall
+    unsigned long orphans = 0;
+    unsigned long stalls = 0;
+    std::vector<GLCallStats> entryPoints;
+    // calls that make the CPU wait for the GPU (or the driver thread), by reason
+    std::vector<std::pair<std::string, unsigned long> > stallReasons;
+};
+
+
+// Records every GL call made through glad (our glad is generated with debug callbacks, every gl function
+// calls a pre and a post callback around the real call). Counts and times the calls of each entry point,
+// shadows the bindings to spot redundant binds and thrashing, and flags the calls that stall the pipeline:
+// glGetError, glGet* round trips, glFinish, glReadPixels to client memory, synchronized buffer mapping,
+// and glBufferData changing the size of a buffer that already has storage (the same size orphans it, which
+// is counted apart, see GLFrameStats).
+// Switch it on and off with setEnabled, call endFrame once per frame (just before swapping buffers).
+// ------------------------------------------------------------------------------------------------------
+class GLInstrumentation {
+public:
+    static GLInstrumentation &instance();
+
+    // install (or remove) the glad callbacks. Disabled, glad is back to its default of checking
+    // glGetError after every call
+    void setEnabled(bool enabled);
+    bool isEnabled() const { return enabled; }
+
+    // close the current frame, its statistics become lastFrame()
+    void endFrame();
+    const GLFrameStats &lastFrame() const { return frameStats; }
+
+    // calls made while a Pause exists (e.g. rendering the overlay itself) update the shadowed state
+    // but are not counted
+    class Pause {
+    public:
+        Pause(){ ++GLInstrumentation::instance().paused; }
+        ~Pause(){ --GLInstrumentation::instance().paused; }
+        Pause(const Pause &) = delete;
+        Pause &operator=(const Pause &) = delete;
+    };
+
+private:
+    struct EntryPoint {
+        unsigned long calls = 0;
+        double milliseconds = 0.0;
+        unsigned long redundant = 0;
+    };
+
+    // a piece of bound state: what it is now and what it was before its last change
+    struct Binding {
+        GLuint current = ~0u;
+        GLuint previous = ~0u;
+    };
+
+    static void preCall(const char *name, void *funcptr, int argCount, ...);
+    static void postCall(const char *name, void *funcptr, int argCount, ...);
+
+    // returns true if the bind is redundant
+    bool bind(Binding &binding, GLuint value);
+    Binding &bufferBinding(GLenum target);
+    void stall(const char *reason);
+    int callKind(const char *name);
+    void analyze(const char *name, va_list args);
+
+    bool enabled = false;
+    int paused = 0;
+    double callStart = 0.0;
+
+    // what kind of call each entry point is, worked out from its name the first time it is seen
+    std::unordered_map<const char *, int> callKinds;
+    std::unordered_map<const char *, EntryPoint> entryPoints;
+    std::unordered_map<const char *, unsigned long> stallReasons;
+    unsigned long thrashing = 0;
+    unsigned long orphans = 0;
+    GLFrameStats frameStats;
+
+    // shadowed state
+    GLenum activeTexture = 0;
+    Binding program, vertexArray, drawFramebuffer, readFramebuffer;
+    std::unordered_map<GLenum, Binding> buffers;
+    std::unordered_map<unsigned long long, Binding> textures;
+    std::unordered_map<GLenum, Binding> capabilities;
+    // size of every buffer glBufferData has been called on
+    std::unordered_map<GLuint, GLsizeiptr> specifiedBuffers;
+};
+
+
+// imgui window with the statistics of the last frame and a switch to turn the instrumentation on and off.
+// Build it between ImGui::NewFrame and ImGui::Render, and render the imgui draw data under a
+// GLInstrumentation::Pause so the overlay does not measure itself
+// -------------------------------------------------------------------------------------------------------
+void drawGLInstrumentationOverlay(GLInstrumentation &instrumentation = GLInstrumentation::instance(),
+                                  unsigned int maxEntryPoints = 15);
+
+#endif
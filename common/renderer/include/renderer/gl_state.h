@@ -0,0 +1,75 @@
+#ifndef RENDERER_GL_STATE_H
+#define RENDERER_GL_STATE_H
+
+#include <glad/glad.h>
+
+#include <unordered_map>
+
+
+// Shadow copy of the OpenGL binding state of the current context. Every bind goes through it and is only
+// forwarded to OpenGL when it changes something, the ones that would not are counted as redundant.
+// The cache starts (and after invalidate() is) in an unknown state, so the first call always reaches OpenGL.
+// Code that changes the same state with raw gl calls must call invalidate() afterwards.
+// ---------------------------------------------------------------------------------------------------------
+class GLState {
+public:
+    // the cache of the current context (the exercises only ever create one)
+    static GLState &current();
+
+    void useProgram(GLuint program);
+    void bindVertexArray(GLuint vertexArray);
+    void bindBuffer(GLenum target, GLuint buffer);
+    void enable(GLenum capability);
+    void disable(GLenum capability);
+    void clearColor(float red, float green, float blue, float alpha);
+    void viewport(GLint x, GLint y, GLsizei width, GLsizei height);
+
+    // deleting an object resets the bindings that referenced it to 0, keep the cache in sync
+    void programDeleted(GLuint program);
+    void vertexArrayDeleted(GLuint vertexArray);
+    void bufferDeleted(GLuint buffer);
+
+    // forget everything, the next call to each function reaches OpenGL again
+    void invalidate();
+
+    // state changes forwarded to OpenGL, and the ones elided because the state was already set
+    unsigned long stateChanges() const { return issued; }
+    unsigned long redundantChanges() const { return redundant; }
+    void resetCounters(){ issued = redundant = 0; }
+
+private:
+    static const GLuint UNKNOWN = ~0u;
+
+    // returns true if value has to be sent to OpenGL, and records it as the new cached value
+    template<typename T>
+    bool change(T &cached, const T &value){
+        if (cached == value) {
+            ++redundant;
+            return false;
+        }
+        cached = value;
+        ++issued;
+        return true;
+    }
+
+    GLuint *bufferBinding(GLenum target);
+
+    GLuint program = UNKNOWN;
+    GLuint vertexArray = UNKNOWN;
+    // GL_ELEMENT_ARRAY_BUFFER is part of the vertex array state, it is unknown again after every VAO change
+    GLuint elementBuffer = UNKNOWN;
+    GLuint arrayBuffer = UNKNOWN;
+    GLuint copyReadBuffer = UNKNOWN;
+    GLuint copyWriteBuffer = UNKNOWN;
+    GLuint uniformBuffer = UNKNOWN;
+    GLuint pixelPackBuffer = UNKNOWN;
+    GLuint pixelUnpackBuffer = UNKNOWN;
+    std::unordered_map<GLenum, bool> capabilities;
+    float clearColorValue[4] = {-1.0f, -1.0f, -1.0f, -1.0f};
+    GLint viewportValue[4] = {-1, -1, -1, -1};
+
+    unsigned long issued = 0;
+    unsigned long redundant = 0;
+};
+
+#endif
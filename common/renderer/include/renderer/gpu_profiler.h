@@ -0,0 +1,116 @@
+#ifndef RENDERER_GPU_PROFILER_H
+#define RENDERER_GPU_PROFILER_H
+
+#include <glad/glad.h>
+
+#include <deque>
+#include <string>
+#include <vector>
+
+
+// CPU and GPU timings of named, nestable scopes, frame by frame.
+// GPU times come from GL_TIMESTAMP queries (a GL_TIME_ELAPSED query cannot be nested in another one) written
+// at the start and end of every scope. Their results are only read once the GPU has made them available,
+// usually a frame or two later, so profiling never waits for the GPU. Frames whose results are still not
+// there after maxPendingFrames newer frames are dropped rather than waited for.
+// ----------------------------------------------------------------------------------------------------------
+class GpuProfiler {
+public:
+    struct ScopeTiming {
+        const char *name;
+        int depth;
+        // milliseconds since the start of the frame, on the CPU and on the GPU
+        double cpuStart, cpuMilliseconds;
+        double gpuStart, gpuMilliseconds;
+    };
+
+    struct FrameTiming {
+        unsigned long frame;
+        double cpuMilliseconds, gpuMilliseconds;
+        // in the order they started, parents before their children
+        std::vector<ScopeTiming> scopes;
+    };
+
+    struct Percentiles {
+        double p50, p95, p99;
+    };
+
+    // called by every profiler with each frame whose results come in (e.g. to log them elsewhere)
+    typedef void (*FrameCallback)(const GpuProfiler &profiler, const FrameTiming &frame);
+    static void setFrameCallback(FrameCallback callback){ frameCallback = callback; }
+
+    explicit GpuProfiler(size_t historySize = 300, size_t maxPendingFrames = 3);
+    ~GpuProfiler();
+
+    GpuProfiler(const GpuProfiler &) = delete;
+    GpuProfiler &operator=(const GpuProfiler &) = delete;
+
+    // everything between beginFrame and endFrame is one frame; beginFrame also collects finished results
+    void beginFrame();
+    void endFrame();
+
+    // name must stay valid while the frame is in the history (use string literals)
+    void beginScope(const char *name);
+    void endScope();
+
+    // beginScope/endScope for the lifetime of the object
+    class Scope {
+    public:
+        Scope(GpuProfiler &profiler, const char *name) : profiler(profiler){ profiler.beginScope(name); }
+        ~Scope(){ profiler.endScope(); }
+        Scope(const Scope &) = delete;
+        Scope &operator=(const Scope &) = delete;
+    private:
+        GpuProfiler &profiler;
+    };
+
+    // finished frames, oldest first
+    const std::deque<FrameTiming> &history() const { return frames; }
+    Percentiles cpuPercentiles() const;
+    Percentiles gpuPercentiles() const;
+    unsigned long droppedFrames() const { return dropped; }
+
+    // one line per scope of every frame in the history; returns false if the file cannot be written
+    bool writeCsv(const std::string &path) const;
+
+private:
+    struct PendingScope {
+        const char *name;
+        int depth;
+        double cpuStart, cpuEnd;
+        GLuint beginQuery, endQuery;
+    };
+
+    struct PendingFrame {
+        unsigned long frame;
+        double cpuStart, cpuEnd;
+        GLuint beginQuery, endQuery;
+        std::vector<PendingScope> scopes;
+    };
+
+    GLuint timestamp();
+    void release(const PendingFrame &frame);
+    // read the results of the pending frames the GPU is done with, oldest first
+    void collect();
+
+    size_t historySize;
+    size_t maxPendingFrames;
+    std::vector<GLuint> freeQueries;
+    std::deque<PendingFrame> pending;
+    PendingFrame current;
+    bool inFrame = false;
+    std::vector<size_t> openScopes;
+    std::deque<FrameTiming> frames;
+    unsigned long frameCount = 0;
+    unsigned long dropped = 0;
+
+    static FrameCallback frameCallback;
+};
+
+
+// imgui window with the frame time percentiles, a timeline of the CPU and GPU scopes of the last finished
+// frame, and a button to export the history as CSV
+// -------------------------------------------------------------------------------------------------------
+void drawGpuProfilerOverlay(GpuProfiler &profiler);
+
+#endif
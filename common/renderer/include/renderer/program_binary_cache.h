@@ -0,0 +1,59 @@
+#ifndef RENDERER_PROGRAM_BINARY_CACHE_H
+#define RENDERER_PROGRAM_BINARY_CACHE_H
+
+#include <glad/glad.h>
+
+#include <cstdint>
+#include <string>
+
+
+// program binaries are OpenGL 4.1 (or ARB_get_program_binary), newer than the 3.3 contexts of the exercises
+typedef void (APIENTRYP PFNPROGRAMBINARYCACHEGETPROC)(GLuint program, GLsizei bufSize, GLsizei *length,
+                                                     GLenum *binaryFormat, void *binary);
+typedef void (APIENTRYP PFNPROGRAMBINARYCACHELOADPROC)(GLuint program, GLenum binaryFormat, const void *binary,
+                                                      GLsizei length);
+typedef void (APIENTRYP PFNPROGRAMBINARYCACHEPARAMETERIPROC)(GLuint program, GLenum pname, GLint value);
+
+
+// On-disk cache of linked program binaries, so a program is only compiled the first time it is used.
+// A binary is stored under a hash of its shader sources and of the driver (vendor, renderer, version) and
+// GL version of the context; on load the driver recorded in the file is checked again, and a binary the
+// driver refuses or that does not match anymore is deleted and the program rebuilt from source.
+// Needs a current context when constructed; without program binary support every load misses.
+// -------------------------------------------------------------------------------------------------------
+class ProgramBinaryCache {
+public:
+    // directory is created if it does not exist (its parent must), load is the function loader given to glad
+    ProgramBinaryCache(const std::string &directory, GLADloadproc load);
+
+    bool isSupported() const { return supported; }
+
+    // a new program linked from the cached binary of these sources, or 0 if there is none (or it is stale)
+    GLuint load(const char *vertexSource, const char *fragmentSource);
+    // call before linking a program that will be stored, so the driver keeps its binary around
+    void prepare(GLuint program);
+    // save the binary of a linked program built from these sources
+    void store(const char *vertexSource, const char *fragmentSource, GLuint program);
+
+    unsigned long hits() const { return hitCount; }
+    unsigned long misses() const { return missCount; }
+    // binaries deleted because the driver changed or refused them
+    unsigned long invalidated() const { return invalidatedCount; }
+
+private:
+    std::uint64_t sourceHash(const char *vertexSource, const char *fragmentSource) const;
+    std::string path(std::uint64_t hash) const;
+
+    std::string directory;
+    std::string driver;
+    bool supported = false;
+    PFNPROGRAMBINARYCACHEGETPROC getProgramBinary = nullptr;
+    PFNPROGRAMBINARYCACHELOADPROC programBinary = nullptr;
+    PFNPROGRAMBINARYCACHEPARAMETERIPROC programParameteri = nullptr;
+
+    unsigned long hitCount = 0;
+    unsigned long missCount = 0;
+    unsigned long invalidatedCount = 0;
+};
+
+#endif
@@ -0,0 +1,82 @@
+#ifndef RENDERER_SHADER_MANAGER_H
+#define RENDERER_SHADER_MANAGER_H
+
+#include <renderer/shader_program.h>
+
+#include <glad/glad.h>
+
+#include <deque>
+#include <string>
+
+class ProgramBinaryCache;
+
+
+// KHR_parallel_shader_compile (or ARB_parallel_shader_compile), not part of the glad we generate
+typedef void (APIENTRYP PFNSHADERMANAGERMAXTHREADSPROC)(GLuint count);
+
+
+// Builds many shader programs without blocking the frame. submit() only hands the sources to the driver;
+// nothing asks for a compile or link status until poll(), because that is what makes the driver finish the
+// work on the spot. With KHR_parallel_shader_compile the driver compiles on its own threads and poll() only
+// picks up programs whose GL_COMPLETION_STATUS says they are done. Without it a driver typically compiles
+// when the status is first queried, so poll() finishes at most `budget` programs per call to spread the
+// stalls over several frames. Until a program is ready (or when it failed) program() returns a magenta
+// placeholder, so submit everything at startup, call poll() between loading assets and every frame, and draw
+// with program(handle) from the start.
+// Needs a current context; all calls have to come from the thread that owns it.
+// ----------------------------------------------------------------------------------------------------------
+class ShaderManager {
+public:
+    typedef size_t Handle;
+
+    // load is the function loader given to glad; with a cache, programs it has are linked from their binary
+    // and the others are stored in it once they are ready
+    explicit ShaderManager(GLADloadproc load, ProgramBinaryCache *cache = nullptr);
+    ~ShaderManager();
+
+    ShaderManager(const ShaderManager &) = delete;
+    ShaderManager &operator=(const ShaderManager &) = delete;
+
+    // start building a program, the sources are copied
+    Handle submit(const char *vertexSource, const char *fragmentSource);
+
+    // check on the programs still building without waiting for any of them; returns how many became
+    // ready or failed. budget is only used without parallel compile, see above
+    size_t poll(size_t budget = 1);
+    // wait for every program (e.g. before a benchmark or a screenshot)
+    void finishAll();
+
+    bool isReady(Handle handle) const { return entries[handle].state == READY; }
+    bool hasFailed(Handle handle) const { return entries[handle].state == FAILED; }
+    // the program once it is ready, the placeholder until then; the reference stays valid across submit()
+    const ShaderProgram &program(Handle handle) const;
+    const ShaderProgram &placeholder() const { return fallback; }
+
+    size_t pendingCount() const { return pending; }
+    // true if the driver compiles in the background (KHR/ARB_parallel_shader_compile)
+    bool isParallel() const { return parallel; }
+
+private:
+    enum State { BUILDING, READY, FAILED };
+
+    struct Entry {
+        std::string vertexSource, fragmentSource;
+        GLuint vertexShader = 0, fragmentShader = 0;
+        GLuint building = 0;
+        ShaderProgram program{0};
+        State state = BUILDING;
+    };
+
+    // read the status of a program that is done building, report its errors and release its shaders
+    void finish(Entry &entry);
+    void release(Entry &entry);
+
+    ProgramBinaryCache *cache;
+    bool parallel = false;
+    ShaderProgram fallback;
+    // a deque, so growing it never moves the programs handed out by program()
+    std::deque<Entry> entries;
+    size_t pending = 0;
+};
+
+#endif
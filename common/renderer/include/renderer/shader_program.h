@@ -0,0 +1,65 @@
+#ifndef RENDERER_SHADER_PROGRAM_H
+#define RENDERER_SHADER_PROGRAM_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include <string>
+#include <unordered_map>
+
+class ProgramBinaryCache;
+
+
+// Shader program compiled and linked from source, deleted with the object. Compile and link errors are
+// printed with the full info log. Attribute and uniform locations are looked up once and then cached.
+// ----------------------------------------------------------------------------------------------------
+class ShaderProgram {
+public:
+    ShaderProgram(const char *vertexSource, const char *fragmentSource);
+    // same, but loaded from the binary cache when it has these sources, and saved to it otherwise
+    ShaderProgram(const char *vertexSource, const char *fragmentSource, ProgramBinaryCache &cache);
+    // take ownership of a program that was linked successfully somewhere else
+    explicit ShaderProgram(GLuint linkedProgram);
+    ~ShaderProgram();
+
+    ShaderProgram(ShaderProgram &&other) noexcept;
+    ShaderProgram &operator=(ShaderProgram &&other) noexcept;
+    ShaderProgram(const ShaderProgram &) = delete;
+    ShaderProgram &operator=(const ShaderProgram &) = delete;
+
+    GLuint id() const { return program; }
+    bool isLinked() const { return linked; }
+
+    // make it the active program (a no-op if it already is)
+    void use() const;
+
+    // -1 if the program has no active attribute/uniform with that name
+    GLint attributeLocation(const std::string &name) const;
+    GLint uniformLocation(const std::string &name) const;
+
+    // set a uniform value, the program is made active first
+    void setInt(const std::string &name, int value) const;
+    void setFloat(const std::string &name, float value) const;
+    void setVec2(const std::string &name, const glm::vec2 &value) const;
+    void setVec3(const std::string &name, const glm::vec3 &value) const;
+    void setVec4(const std::string &name, const glm::vec4 &value) const;
+    void setMat4(const std::string &name, const glm::mat4 &value) const;
+
+private:
+    void build(const char *vertexSource, const char *fragmentSource, ProgramBinaryCache *cache);
+    void release();
+
+    GLuint program = 0;
+    bool linked = false;
+    mutable std::unordered_map<std::string, GLint> attributeLocations;
+    mutable std::unordered_map<std::string, GLint> uniformLocations;
+};
+
+
+// print the info log of a shader that failed to compile (typeName is e.g. "VERTEX") or of a program that
+// failed to link, the way ShaderProgram reports its errors
+// -----------------------------------------------------------------------------------------------------
+void printShaderInfoLog(GLuint shader, const char *typeName);
+void printProgramInfoLog(GLuint program);
+
+#endif
@@ -0,0 +1,65 @@
+#ifndef RENDERER_SHAPE_BATCH_H
+#define RENDERER_SHAPE_BATCH_H
+
+#include <renderer/buffer.h>
+#include <renderer/shader_program.h>
+#include <renderer/vertex_array.h>
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include <vector>
+
+
+// Draws any number of 2D shapes with one instanced draw call per kind of shape. Every kind has a unit mesh
+// within -0.5 and 0.5 (the circle of exercise 1.8, a square, a triangle inside the circle), all of them in
+// one vertex and one element buffer created once. The shapes themselves are only a position, scale, rotation
+// and color in a per-kind instance buffer, filled from scratch every frame: clear(), add() every shape, draw().
+// --------------------------------------------------------------------------------------------------------
+class ShapeBatch {
+public:
+    enum Shape { CIRCLE, SQUARE, TRIANGLE, SHAPE_COUNT };
+
+    // the instance buffer layout, 24 bytes per shape
+    struct Instance {
+        glm::vec2 position;
+        glm::vec2 scale;
+        float rotation;
+        GLubyte color[4];
+    };
+
+    // circleSegments is the triangleCount of the circle of exercise 1.8, clamped to 3..65527 (the mesh has
+    // 16 bit indices)
+    explicit ShapeBatch(int circleSegments = 32);
+
+    ShapeBatch(const ShapeBatch &) = delete;
+    ShapeBatch &operator=(const ShapeBatch &) = delete;
+
+    void clear();
+    // rotation in radians, color components between 0 and 1
+    void add(Shape shape, const glm::vec2 &position, const glm::vec2 &scale, float rotation,
+             const glm::vec4 &color);
+    size_t size() const;
+
+    // upload this frame's instances and draw them, positions are transformed by projection
+    void draw(const glm::mat4 &projection = glm::mat4(1.0f));
+
+    // draw calls made by the last draw(), at most one per kind of shape
+    unsigned long drawCalls() const { return drawCount; }
+
+private:
+    struct Mesh {
+        GLsizei firstIndex, indexCount;
+    };
+
+    ShaderProgram shaderProgram;
+    Buffer vertices;
+    Buffer indices;
+    Mesh meshes[SHAPE_COUNT];
+    VertexArray vertexArrays[SHAPE_COUNT];
+    Buffer instanceBuffers[SHAPE_COUNT];
+    std::vector<Instance> instances[SHAPE_COUNT];
+    unsigned long drawCount = 0;
+};
+
+#endif
@@ -0,0 +1,142 @@
+#ifndef RENDERER_TEXTURE_LOADER_H
+#define RENDERER_TEXTURE_LOADER_H
+
+#include <renderer/buffer.h>
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <stb_image.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+// Loads textures in the background. Worker threads read and decode the files (stb_image with its per-call
+// options, so they do not share any state); a worker decoding a JPEG hands bands of it to the idle ones
+// through stb_image's parallel_for. update(), called once per frame on the render thread, uploads
+// what they decoded through a pixel unpack buffer, at most uploadBudget bytes per frame (big images are
+// uploaded a band of rows at a time) and then generates the mipmaps. Until a texture is ready, texture()
+// returns a 1x1 placeholder of the color given to load(), so the first frames can be drawn right away.
+// The textures are deleted with the loader. Needs a current context when constructed; everything but the
+// workers runs on the render thread.
+// -------------------------------------------------------------------------------------------------------
+class TextureLoader {
+public:
+    typedef size_t Handle;
+
+    struct Options {
+        // OpenGL expects the bottom row first, image files store the top one first
+        bool flipVertically = true;
+        bool mipmaps = true;
+        glm::vec4 placeholder = glm::vec4(0.5f, 0.5f, 0.5f, 1.0f);
+    };
+
+    struct Stats {
+        size_t requested = 0, ready = 0, failed = 0;
+        size_t uploadedBytes = 0;
+        // summed over the workers
+        double readMilliseconds = 0.0, decodeMilliseconds = 0.0;
+        // spent in update() on the render thread
+        double uploadMilliseconds = 0.0;
+        // since the loader was created, 0 while not there yet
+        double firstReadyMilliseconds = 0.0, allReadyMilliseconds = 0.0;
+    };
+
+    // workerCount 0 uses one worker per hardware thread (but at least one)
+    explicit TextureLoader(unsigned workerCount = 0, size_t uploadBudget = 8 << 20);
+    ~TextureLoader();
+
+    TextureLoader(const TextureLoader &) = delete;
+    TextureLoader &operator=(const TextureLoader &) = delete;
+
+    Handle load(const std::string &path, const Options &options);
+    Handle load(const std::string &path){ return load(path, Options()); }
+
+    // upload decoded images within the budget; returns how many textures became ready (or failed)
+    size_t update();
+    // wait for and upload everything, regardless of the budget
+    void finishAll();
+
+    // the texture once it is ready, its placeholder until then (and if it fails)
+    GLuint texture(Handle handle) const;
+    bool isReady(Handle handle) const { return entries[handle].state == READY; }
+    bool hasFailed(Handle handle) const { return entries[handle].state == FAILED; }
+    size_t pendingCount() const { return stats.requested - stats.ready - stats.failed; }
+    const Stats &statistics() const { return stats; }
+
+private:
+    enum State { DECODING, UPLOADING, READY, FAILED };
+
+    struct Entry {
+        std::string path;
+        Options options;
+        State state = DECODING;
+        GLuint id = 0;
+        GLuint placeholder = 0;
+    };
+
+    // what a worker hands back to the render thread
+    struct Decoded {
+        Handle handle;
+        unsigned char *pixels;
+        int width, height, channels;
+        std::string failure;
+    };
+
+    struct Job {
+        Handle handle;
+        std::string path;
+        bool flipVertically;
+    };
+
+    // the tasks of one parallel_for call of stb_image, claimed one at a time by the workers
+    struct Batch {
+        stbi_parallel_task *task;
+        void *data;
+        int count;
+        int claimed = 0, finished = 0;
+    };
+
+    void work();
+    void decode(const Job &job);
+    // stbi_parallel_for, with the loader as user data: the calling worker runs tasks until none is left to
+    // claim and then waits for the ones taken by other workers
+    static void runParallel(void *loader, stbi_parallel_task *task, void *data, int count);
+    // run one task of the oldest batch; call with the lock held, it is released while the task runs
+    void runBatchTask(std::unique_lock<std::mutex> &lock);
+    // start (or continue) uploading the front of the upload queue, using at most budget bytes of it
+    size_t upload(size_t budget, bool &finished);
+    void finish(Entry &entry, bool succeeded);
+    GLuint placeholderTexture(const glm::vec4 &color);
+    double elapsed() const;
+
+    std::vector<std::thread> workers;
+    // split single decodes across the workers, set before they start
+    bool parallelDecode = false;
+    std::mutex mutex;
+    std::condition_variable jobAdded;
+    std::condition_variable decodeFinished;
+    std::condition_variable batchFinished;
+    std::deque<Job> jobs;
+    std::deque<Batch *> batches;
+    std::vector<Decoded> decoded;
+    bool stopping = false;
+    double readTotal = 0.0, decodeTotal = 0.0;
+
+    std::deque<Entry> entries;
+    std::deque<Decoded> uploads;
+    int uploadedRows = 0;
+    size_t uploadBudget;
+    Buffer staging;
+    std::map<unsigned, GLuint> placeholders;
+    std::chrono::steady_clock::time_point created;
+    Stats stats;
+};
+
+#endif
@@ -0,0 +1,60 @@
+#ifndef RENDERER_VERTEX_ARRAY_H
+#define RENDERER_VERTEX_ARRAY_H
+
+#include <renderer/buffer.h>
+#include <renderer/shader_program.h>
+
+#include <glad/glad.h>
+
+#include <string>
+
+
+// Vertex array object (VAO), deleted with the object. It records where each attribute of a shader program
+// reads its data from, and which element buffer holds the indices of indexed draws.
+// --------------------------------------------------------------------------------------------------------
+class VertexArray {
+public:
+    VertexArray();
+    ~VertexArray();
+
+    VertexArray(VertexArray &&other) noexcept;
+    VertexArray &operator=(VertexArray &&other) noexcept;
+    VertexArray(const VertexArray &) = delete;
+    VertexArray &operator=(const VertexArray &) = delete;
+
+    GLuint id() const { return VAO; }
+
+    void bind() const;
+
+    // read attribute location from buffer: size components of type, stride bytes apart, starting at offset
+    void setAttribute(GLint location, const Buffer &buffer, GLint size, GLenum type = GL_FLOAT,
+                      bool normalized = false, GLsizei stride = 0, GLintptr offset = 0);
+    // same, with the (cached) location of the attribute called name in shaderProgram;
+    // returns false and changes nothing if the program has no such active attribute
+    bool setAttribute(const ShaderProgram &shaderProgram, const std::string &name, const Buffer &buffer,
+                      GLint size, GLenum type = GL_FLOAT, bool normalized = false, GLsizei stride = 0,
+                      GLintptr offset = 0);
+
+    // advance attribute location once every divisor instances instead of once per vertex (0 goes back to that)
+    void setAttributeDivisor(GLint location, GLuint divisor);
+
+    // indices of drawElements are read from buffer, with type GL_UNSIGNED_BYTE/SHORT/INT
+    void setElementBuffer(const Buffer &buffer, GLenum type = GL_UNSIGNED_INT);
+
+    // bind and draw, count vertices starting at first
+    void draw(GLenum mode, GLint first, GLsizei count) const;
+    // bind and draw, count indices starting at index first of the element buffer
+    void drawElements(GLenum mode, GLsizei count, GLsizei first = 0) const;
+    // same, instanceCount times
+    void drawElementsInstanced(GLenum mode, GLsizei count, GLsizei instanceCount, GLsizei first = 0) const;
+
+private:
+    // byte offset of index first in the element buffer, as the draw calls take it
+    void *indexOffset(GLsizei first) const;
+    void release();
+
+    GLuint VAO = 0;
+    GLenum indexType = GL_UNSIGNED_INT;
+};
+
+#endif
@@ -0,0 +1,14 @@
+#ifndef RENDERER_WINDOW_H
+#define RENDERER_WINDOW_H
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+
+// initialize glfw, open a window with an OpenGL 3.3 core context, make it current and load the OpenGL
+// functions with glad. The viewport follows the framebuffer size until another callback is installed.
+// Returns nullptr (after printing why and terminating glfw) on failure.
+// ---------------------------------------------------------------------------------------------------
+GLFWwindow *createWindow(int width, int height, const char *title);
+
+#endif
@@ -0,0 +1,237 @@
+#include <renderer/block_compression.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+
+namespace {
+
+// the 4x4 rgba pixels of block (bx, by), repeating the last column and row past the edges
+void loadBlock(const unsigned char *rgba, int width, int height, int bx, int by, unsigned char block[64]){
+    for (int y = 0; y < 4; y++) {
+        int sy = std::min(by * 4 + y, height - 1);
+        for (int x = 0; x < 4; x++) {
+            int sx = std::min(bx * 4 + x, width - 1);
+            std::memcpy(block + (y * 4 + x) * 4, rgba + ((size_t) sy * width + sx) * 4, 4);
+        }
+    }
+}
+
+int to565(const float color[3]){
+    int r = (int) (std::min(std::max(color[0], 0.0f), 255.0f) * 31.0f / 255.0f + 0.5f);
+    int g = (int) (std::min(std::max(color[1], 0.0f), 255.0f) * 63.0f / 255.0f + 0.5f);
+    int b = (int) (std::min(std::max(color[2], 0.0f), 255.0f) * 31.0f / 255.0f + 0.5f);
+    return r << 11 | g << 5 | b;
+}
+
+// as the decoder expands it, the high bits repeated into the low ones
+void from565(int color, int rgb[3]){
+    int r = (color >> 11) & 31, g = (color >> 5) & 63, b = color & 31;
+    rgb[0] = r << 3 | r >> 2;
+    rgb[1] = g << 2 | g >> 4;
+    rgb[2] = b << 3 | b >> 2;
+}
+
+// the nearest of the four colors between endpoints c0 and c1 for every pixel, two bits each in indices;
+// returns the squared error
+int chooseColorIndices(const unsigned char block[64], int c0, int c1, std::uint32_t &indices){
+    int palette[4][3];
+    from565(c0, palette[0]);
+    from565(c1, palette[1]);
+    for (int k = 0; k < 3; k++) {
+        palette[2][k] = (2 * palette[0][k] + palette[1][k]) / 3;
+        palette[3][k] = (palette[0][k] + 2 * palette[1][k]) / 3;
+    }
+    int error = 0;
+    indices = 0;
+    for (int i = 0; i < 16; i++) {
+        const unsigned char *p = block + i * 4;
+        int best = 0, bestDistance = 1 << 30;
+        for (int j = 0; j < 4; j++) {
+            int dr = p[0] - palette[j][0], dg = p[1] - palette[j][1], db = p[2] - palette[j][2];
+            int distance = dr * dr + dg * dg + db * db;
+            if (distance < bestDistance) {
+                bestDistance = distance;
+                best = j;
+            }
+        }
+        indices |= (std::uint32_t) best << (2 * i);
+        error += bestDistance;
+    }
+    return error;
+}
+
+// the endpoints that fit the pixels best (least squares) for the given indices; false if they are degenerate
+bool refitEndpoints(const unsigned char block[64], std::uint32_t indices, int &c0, int &c1){
+    // how much of c0 each index takes
+    static const float weights[4] = {1.0f, 0.0f, 2.0f / 3.0f, 1.0f / 3.0f};
+    float aa = 0.0f, ab = 0.0f, bb = 0.0f, ap[3] = {0.0f, 0.0f, 0.0f}, bp[3] = {0.0f, 0.0f, 0.0f};
+    for (int i = 0; i < 16; i++) {
+        float a = weights[(indices >> (2 * i)) & 3], b = 1.0f - a;
+        aa += a * a;
+        ab += a * b;
+        bb += b * b;
+        for (int k = 0; k < 3; k++) {
+            ap[k] += a * block[i * 4 + k];
+            bp[k] += b * block[i * 4 + k];
+        }
+    }
+    float determinant = aa * bb - ab * ab;
+    if (std::fabs(determinant) < 1e-6f)
+        return false;
+    float e0[3], e1[3];
+    for (int k = 0; k < 3; k++) {
+        e0[k] = (ap[k] * bb - bp[k] * ab) / determinant;
+        e1[k] = (bp[k] * aa - ap[k] * ab) / determinant;
+    }
+    c0 = to565(e0);
+    c1 = to565(e1);
+    return true;
+}
+
+// BC1 block of the rgb of the pixels, always in four color mode (as BC3 decodes it too)
+void compressColorBlock(const unsigned char block[64], unsigned char out[8]){
+    float mean[3] = {0.0f, 0.0f, 0.0f};
+    for (int i = 0; i < 16; i++)
+        for (int k = 0; k < 3; k++)
+            mean[k] += block[i * 4 + k] / 16.0f;
+    float covariance[6] = {0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f};
+    for (int i = 0; i < 16; i++) {
+        float r = block[i * 4] - mean[0], g = block[i * 4 + 1] - mean[1], b = block[i * 4 + 2] - mean[2];
+        covariance[0] += r * r;
+        covariance[1] += r * g;
+        covariance[2] += r * b;
+        covariance[3] += g * g;
+        covariance[4] += g * b;
+        covariance[5] += b * b;
+    }
+
+    // principal axis by power iteration, from the luminance direction
+    float axis[3] = {0.299f, 0.587f, 0.114f};
+    for (int iteration = 0; iteration < 4; iteration++) {
+        float x = covariance[0] * axis[0] + covariance[1] * axis[1] + covariance[2] * axis[2];
+        float y = covariance[1] * axis[0] + covariance[3] * axis[1] + covariance[4] * axis[2];
+        float z = covariance[2] * axis[0] + covariance[4] * axis[1] + covariance[5] * axis[2];
+        float length = std::max(std::max(std::fabs(x), std::fabs(y)), std::fabs(z));
+        if (length < 1e-6f)
+            break;
+        axis[0] = x / length;
+        axis[1] = y / length;
+        axis[2] = z / length;
+    }
+
+    // the extremes along the axis, pulled in by 1/16 of the range so the error is spread over both ends
+    int lowest = 0, highest = 0;
+    float lowestDot = 1e30f, highestDot = -1e30f;
+    for (int i = 0; i < 16; i++) {
+        float dot = block[i * 4] * axis[0] + block[i * 4 + 1] * axis[1] + block[i * 4 + 2] * axis[2];
+        if (dot < lowestDot) {
+            lowestDot = dot;
+            lowest = i;
+        }
+        if (dot > highestDot) {
+            highestDot = dot;
+            highest = i;
+        }
+    }
+    float e0[3], e1[3];
+    for (int k = 0; k < 3; k++) {
+        float high = block[highest * 4 + k], low = block[lowest * 4 + k], inset = (high - low) / 16.0f;
+        e0[k] = high - inset;
+        e1[k] = low + inset;
+    }
+    int c0 = to565(e0), c1 = to565(e1);
+    std::uint32_t indices;
+    int error = chooseColorIndices(block, c0, c1, indices);
+
+    int r0, r1;
+    std::uint32_t refitIndices;
+    if (c0 != c1 && refitEndpoints(block, indices, r0, r1)) {
+        int refitError = chooseColorIndices(block, r0, r1, refitIndices);
+        if (refitError < error) {
+            c0 = r0;
+            c1 = r1;
+            indices = refitIndices;
+        }
+    }
+
+    // four color mode needs c0 > c1: swapping the endpoints swaps indices 0 and 1, and 2 and 3
+    if (c0 < c1) {
+        std::swap(c0, c1);
+        indices ^= 0x55555555u;
+    } else if (c0 == c1)
+        indices = 0;
+
+    out[0] = (unsigned char) c0;
+    out[1] = (unsigned char) (c0 >> 8);
+    out[2] = (unsigned char) c1;
+    out[3] = (unsigned char) (c1 >> 8);
+    for (int i = 0; i < 4; i++)
+        out[4 + i] = (unsigned char) (indices >> (8 * i));
+}
+
+// BC4 block of one channel (the one at offset in each pixel), in eight value mode between its minimum and
+// maximum
+void compressChannelBlock(const unsigned char block[64], int offset, unsigned char out[8]){
+    int low = 255, high = 0;
+    for (int i = 0; i < 16; i++) {
+        low = std::min(low, (int) block[i * 4 + offset]);
+        high = std::max(high, (int) block[i * 4 + offset]);
+    }
+    out[0] = (unsigned char) high;
+    out[1] = (unsigned char) low;
+
+    std::uint64_t indices = 0;
+    if (high > low) {
+        int range = high - low;
+        for (int i = 0; i < 16; i++) {
+            // the nearest of the 8 steps from low (0) to high (7); index 0 is high, 1 low, and 2..7 the
+            // steps in between from high down
+            int step = ((block[i * 4 + offset] - low) * 14 + range) / (2 * range);
+            int index = step == 7 ? 0 : step == 0 ? 1 : 8 - step;
+            indices |= (std::uint64_t) index << (3 * i);
+        }
+    }
+    for (int i = 0; i < 6; i++)
+        out[2 + i] = (unsigned char) (indices >> (8 * i));
+}
+
+} // namespace
+
+
+size_t blockSize(BlockFormat format){
+    return format == BC1 || format == BC4 ? 8 : 16;
+}
+
+
+size_t compressedSize(BlockFormat format, int width, int height){
+    return (size_t) ((width + 3) / 4) * ((height + 3) / 4) * blockSize(format);
+}
+
+
+void compressBlocks(BlockFormat format, const unsigned char *rgba, int width, int height, unsigned char *out){
+    unsigned char block[64];
+    for (int by = 0; by < (height + 3) / 4; by++)
+        for (int bx = 0; bx < (width + 3) / 4; bx++) {
+            loadBlock(rgba, width, height, bx, by, block);
+            switch (format) {
+                case BC1:
+                    compressColorBlock(block, out);
+                    break;
+                case BC3:
+                    compressChannelBlock(block, 3, out);
+                    compressColorBlock(block, out + 8);
+                    break;
+                case BC4:
+                    compressChannelBlock(block, 0, out);
+                    break;
+                case BC5:
+                    compressChannelBlock(block, 0, out);
+                    compressChannelBlock(block, 1, out + 8);
+                    break;
+            }
+            out += blockSize(format);
+        }
+}
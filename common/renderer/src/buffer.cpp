@@ -0,0 +1,60 @@
+#include <renderer/buffer.h>
+#include <renderer/gl_state.h>
+
+
+Buffer::Buffer(GLenum target)
+: bufferTarget(target){
+    glGenBuffers(1, &VBO);
+}
+
+
+Buffer::~Buffer(){
+    release();
+}
+
+
+Buffer::Buffer(Buffer &&other) noexcept
+: VBO(other.VBO), bufferTarget(other.bufferTarget), bufferSize(other.bufferSize){
+    other.VBO = 0;
+    other.bufferSize = 0;
+}
+
+
+Buffer &Buffer::operator=(Buffer &&other) noexcept{
+    if (this != &other) {
+        release();
+        VBO = other.VBO;
+        bufferTarget = other.bufferTarget;
+        bufferSize = other.bufferSize;
+        other.VBO = 0;
+        other.bufferSize = 0;
+    }
+    return *this;
+}
+
+
+void Buffer::bind() const{
+    GLState::current().bindBuffer(bufferTarget, VBO);
+}
+
+
+void Buffer::setData(const void *data, GLsizeiptr size, GLenum usage){
+    GLState::current().bindBuffer(GL_COPY_WRITE_BUFFER, VBO);
+    glBufferData(GL_COPY_WRITE_BUFFER, size, data, usage);
+    bufferSize = size;
+}
+
+
+void Buffer::setSubData(GLintptr offset, GLsizeiptr size, const void *data){
+    GLState::current().bindBuffer(GL_COPY_WRITE_BUFFER, VBO);
+    glBufferSubData(GL_COPY_WRITE_BUFFER, offset, size, data);
+}
+
+
+void Buffer::release(){
+    if (VBO) {
+        GLState::current().bufferDeleted(VBO);
+        glDeleteBuffers(1, &VBO);
+        VBO = 0;
+    }
+}
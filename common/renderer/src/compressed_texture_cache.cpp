@@ -0,0 +1,395 @@
+#include <renderer/compressed_texture_cache.h>
+#include <renderer/gl_extensions.h>
+#include <renderer/gl_state.h>
+
+#include <stb_image.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <thread>
+
+#ifdef _WIN32
+#include <direct.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+
+#ifndef GL_COMPRESSED_RGB_S3TC_DXT1_EXT
+#define GL_COMPRESSED_RGB_S3TC_DXT1_EXT 0x83F0
+#endif
+#ifndef GL_COMPRESSED_RGBA_S3TC_DXT5_EXT
+#define GL_COMPRESSED_RGBA_S3TC_DXT5_EXT 0x83F3
+#endif
+
+namespace {
+
+// file layout: header, then every mip level from the largest one, each compressedSize bytes (a multiple of 8,
+// so the levels stay aligned in the mapped file)
+const char MAGIC[8] = {'B', 'C', 'T', 'E', 'X', '0', '0', '1'};
+
+struct FileHeader {
+    char magic[8];
+    std::uint64_t key;
+    std::uint32_t format;
+    std::uint32_t width, height;
+    std::uint32_t levels;
+};
+
+const GLenum glFormats[] = {GL_COMPRESSED_RGB_S3TC_DXT1_EXT, GL_COMPRESSED_RGBA_S3TC_DXT5_EXT,
+                            GL_COMPRESSED_RED_RGTC1, GL_COMPRESSED_RG_RGTC2};
+
+// what the options ask for before the image is decoded: a format, or "BC1 or BC3 by alpha"
+const std::uint32_t COLOR_BY_ALPHA = 4;
+
+// a read only view of a whole file: mapped where the system can, read into memory otherwise
+class FileView {
+public:
+    explicit FileView(const std::string &path){
+#ifdef _WIN32
+        FILE *file = std::fopen(path.c_str(), "rb");
+        if (!file)
+            return;
+        std::fseek(file, 0, SEEK_END);
+        long size = std::ftell(file);
+        std::fseek(file, 0, SEEK_SET);
+        contents.resize(size > 0 ? (size_t) size : 0);
+        if (size > 0 && std::fread(contents.data(), 1, contents.size(), file) == contents.size()) {
+            bytes = contents.data();
+            length = contents.size();
+        }
+        std::fclose(file);
+#else
+        int file = open(path.c_str(), O_RDONLY);
+        if (file < 0)
+            return;
+        struct stat status;
+        if (fstat(file, &status) == 0 && status.st_size > 0) {
+            void *mapped = mmap(nullptr, (size_t) status.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+            if (mapped != MAP_FAILED) {
+                bytes = (const unsigned char *) mapped;
+                length = (size_t) status.st_size;
+            }
+        }
+        close(file);
+#endif
+    }
+
+    ~FileView(){
+#ifndef _WIN32
+        if (bytes)
+            munmap((void *) bytes, length);
+#endif
+    }
+
+    FileView(const FileView &) = delete;
+    FileView &operator=(const FileView &) = delete;
+
+    const unsigned char *data() const { return bytes; }
+    size_t size() const { return length; }
+
+private:
+    const unsigned char *bytes = nullptr;
+    size_t length = 0;
+#ifdef _WIN32
+    std::vector<unsigned char> contents;
+#endif
+};
+
+bool readFile(const std::string &path, std::vector<unsigned char> &contents){
+    FILE *file = std::fopen(path.c_str(), "rb");
+    if (!file)
+        return false;
+    std::fseek(file, 0, SEEK_END);
+    long size = std::ftell(file);
+    std::fseek(file, 0, SEEK_SET);
+    contents.resize(size > 0 ? (size_t) size : 0);
+    bool succeeded = size > 0 && std::fread(contents.data(), 1, contents.size(), file) == contents.size();
+    std::fclose(file);
+    return succeeded;
+}
+
+// FNV-1a over 8 bytes at a time: the whole source file is hashed on every load, so it has to be quick
+std::uint64_t hashContents(const std::vector<unsigned char> &contents, std::uint64_t hash){
+    size_t i = 0;
+    for (; i + 8 <= contents.size(); i += 8) {
+        std::uint64_t word;
+        std::memcpy(&word, contents.data() + i, 8);
+        hash ^= word;
+        hash *= 1099511628211ull;
+    }
+    for (; i < contents.size(); i++) {
+        hash ^= contents[i];
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+int mipLevels(int width, int height){
+    int levels = 1;
+    while (width > 1 || height > 1) {
+        width = std::max(1, width / 2);
+        height = std::max(1, height / 2);
+        ++levels;
+    }
+    return levels;
+}
+
+size_t chainSize(BlockFormat format, int width, int height, int levels){
+    size_t size = 0;
+    for (int level = 0; level < levels; level++)
+        size += compressedSize(format, std::max(1, width >> level), std::max(1, height >> level));
+    return size;
+}
+
+// the header of a complete entry stored under key, or false
+bool validEntry(const FileView &view, std::uint64_t key, FileHeader &header){
+    if (view.size() < sizeof(header))
+        return false;
+    std::memcpy(&header, view.data(), sizeof(header));
+    return std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) == 0 && header.key == key && header.format <= BC5 &&
+           header.width > 0 && header.height > 0 && header.width <= 65536 && header.height <= 65536 &&
+           (header.levels == 1 || (int) header.levels == mipLevels(header.width, header.height)) &&
+           view.size() == sizeof(header) + chainSize((BlockFormat) header.format, header.width, header.height,
+                                                     header.levels);
+}
+
+// the format the file name asks for, or COLOR_BY_ALPHA
+std::uint32_t formatByName(const std::string &path){
+    size_t start = path.find_last_of("/\\");
+    std::string name = path.substr(start == std::string::npos ? 0 : start + 1);
+    name = name.substr(0, name.find_last_of('.'));
+    // the last word of the name: after a separator or where lower case turns to upper case ("BodyAo",
+    // "Misc_AO"), so that "Cacao" is not an ambient occlusion map
+    size_t wordStart = name.size();
+    while (wordStart > 0) {
+        unsigned char c = (unsigned char) name[wordStart - 1];
+        if (c == '_' || c == '-' || c == ' ' || c == '.')
+            break;
+        if (std::isupper(c) && wordStart > 1 && std::islower((unsigned char) name[wordStart - 2])) {
+            --wordStart;
+            break;
+        }
+        --wordStart;
+    }
+    std::string word = name.substr(wordStart);
+    std::transform(word.begin(), word.end(), word.begin(), [](unsigned char c){ return (char) std::tolower(c); });
+    if (word == "normal")
+        return BC5;
+    if (word == "ao" || word == "metalness" || word == "roughness")
+        return BC4;
+    return COLOR_BY_ALPHA;
+}
+
+// the next mip level of an rgba8 image (sizes halved rounding down), every pixel the average of a 2x2 box;
+// normal maps are normalized again
+void halve(const unsigned char *rgba, int width, int height, bool normals, std::vector<unsigned char> &out){
+    int halfWidth = std::max(1, width / 2), halfHeight = std::max(1, height / 2);
+    out.resize((size_t) halfWidth * halfHeight * 4);
+    for (int y = 0; y < halfHeight; y++) {
+        int y0 = std::min(2 * y, height - 1), y1 = std::min(2 * y + 1, height - 1);
+        for (int x = 0; x < halfWidth; x++) {
+            int x0 = std::min(2 * x, width - 1), x1 = std::min(2 * x + 1, width - 1);
+            const unsigned char *p[4] = {rgba + ((size_t) y0 * width + x0) * 4, rgba + ((size_t) y0 * width + x1) * 4,
+                                         rgba + ((size_t) y1 * width + x0) * 4, rgba + ((size_t) y1 * width + x1) * 4};
+            unsigned char *o = &out[((size_t) y * halfWidth + x) * 4];
+            for (int k = 0; k < 4; k++)
+                o[k] = (unsigned char) ((p[0][k] + p[1][k] + p[2][k] + p[3][k] + 2) / 4);
+            if (normals) {
+                float n[3], length = 0.0f;
+                for (int k = 0; k < 3; k++) {
+                    n[k] = o[k] / 127.5f - 1.0f;
+                    length += n[k] * n[k];
+                }
+                length = std::sqrt(length);
+                if (length > 1e-3f)
+                    for (int k = 0; k < 3; k++)
+                        o[k] = (unsigned char) std::min(255.0f, (n[k] / length + 1.0f) * 127.5f + 0.5f);
+            }
+        }
+    }
+}
+
+} // namespace
+
+
+CompressedTextureCache::CompressedTextureCache(const std::string &directory)
+: directory(directory){
+#ifdef _WIN32
+    _mkdir(directory.c_str());
+#else
+    mkdir(directory.c_str(), 0755);
+#endif
+}
+
+
+bool CompressedTextureCache::prepare(const std::string &path, const Options &options){
+    std::uint64_t key;
+    return !entry(path, options, key).empty();
+}
+
+
+GLuint CompressedTextureCache::load(const std::string &path, const Options &options){
+    std::uint64_t key;
+    std::string file = entry(path, options, key);
+    if (file.empty())
+        return 0;
+
+    FileView view(file);
+    FileHeader header;
+    if (!validEntry(view, key, header)) {
+        std::cout << "ERROR::COMPRESSED_TEXTURE::CACHE_UNREADABLE\n" << file << std::endl;
+        return 0;
+    }
+    if (s3tcSupported < 0)
+        s3tcSupported = hasGLExtension("GL_EXT_texture_compression_s3tc") ? 1 : 0;
+    if ((header.format == BC1 || header.format == BC3) && !s3tcSupported) {
+        std::cout << "ERROR::COMPRESSED_TEXTURE::FORMAT_NOT_SUPPORTED\n" << path << ": no S3TC" << std::endl;
+        return 0;
+    }
+
+    GLint boundTexture = 0;
+    glGetIntegerv(GL_TEXTURE_BINDING_2D, &boundTexture);
+    GLuint id;
+    glGenTextures(1, &id);
+    glBindTexture(GL_TEXTURE_2D, id);
+    // a bound unpack buffer would turn the pointers into offsets
+    GLState::current().bindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    BlockFormat format = (BlockFormat) header.format;
+    const unsigned char *data = view.data() + sizeof(header);
+    for (GLint level = 0; level < (GLint) header.levels; level++) {
+        int width = std::max(1, (int) header.width >> level), height = std::max(1, (int) header.height >> level);
+        size_t size = compressedSize(format, width, height);
+        glCompressedTexImage2D(GL_TEXTURE_2D, level, glFormats[format], width, height, 0, (GLsizei) size, data);
+        data += size;
+    }
+    if (format == BC4) {
+        const GLint swizzle[] = {GL_RED, GL_RED, GL_RED, GL_ONE};
+        glTexParameteriv(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_RGBA, swizzle);
+    }
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, (GLint) header.levels - 1);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, header.levels > 1 ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glBindTexture(GL_TEXTURE_2D, boundTexture);
+    return id;
+}
+
+
+std::string CompressedTextureCache::entry(const std::string &path, const Options &options, std::uint64_t &key){
+    std::vector<unsigned char> source;
+    if (!readFile(path, source)) {
+        std::cout << "ERROR::COMPRESSED_TEXTURE::LOADING_FAILED\n" << path << ": cannot read the file" << std::endl;
+        return std::string();
+    }
+
+    // everything the compressed result depends on
+    std::uint32_t requested = options.chooseFormat ? formatByName(path) : (std::uint32_t) options.format;
+    std::uint32_t settings[3] = {requested, options.flipVertically, options.mipmaps};
+    key = hashContents(source, 14695981039346656037ull);
+    for (std::uint32_t setting : settings) {
+        key ^= setting;
+        key *= 1099511628211ull;
+    }
+    std::string file = this->path(key);
+
+    bool exists;
+    {
+        FileView view(file);
+        FileHeader header;
+        exists = view.data() != nullptr;
+        if (exists && validEntry(view, key, header)) {
+            ++hitCount;
+            return file;
+        }
+    }
+    if (exists)
+        ++invalidatedCount;
+    ++missCount;
+
+    BlockFormat format = requested == COLOR_BY_ALPHA ? BC1 : (BlockFormat) requested;
+    return compress(path, source, format, options, key, file) ? file : std::string();
+}
+
+
+bool CompressedTextureCache::compress(const std::string &path, const std::vector<unsigned char> &source,
+                                      BlockFormat format, const Options &options, std::uint64_t key,
+                                      const std::string &file){
+    stbi_options decodeOptions;
+    stbi_options_init(&decodeOptions);
+    decodeOptions.flip_vertically = options.flipVertically;
+    int width, height, channels;
+    unsigned char *pixels = stbi_load_from_memory_ex(&decodeOptions, source.data(), (int) source.size(), &width,
+                                                     &height, &channels, 4);
+    if (!pixels) {
+        std::cout << "ERROR::COMPRESSED_TEXTURE::LOADING_FAILED\n" << path << ": "
+                  << (decodeOptions.failure_reason ? decodeOptions.failure_reason : "unknown error") << std::endl;
+        return false;
+    }
+    // color maps with any transparency need the alpha of BC3
+    if (options.chooseFormat && format == BC1 && (channels == 2 || channels == 4)) {
+        size_t pixelCount = (size_t) width * height;
+        for (size_t i = 0; i < pixelCount && format == BC1; i++)
+            if (pixels[i * 4 + 3] != 255)
+                format = BC3;
+    }
+
+    FileHeader header;
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.key = key;
+    header.format = format;
+    header.width = (std::uint32_t) width;
+    header.height = (std::uint32_t) height;
+    header.levels = options.mipmaps ? (std::uint32_t) mipLevels(width, height) : 1;
+
+    std::vector<unsigned char> data(sizeof(header) + chainSize(format, width, height, header.levels));
+    std::memcpy(data.data(), &header, sizeof(header));
+    unsigned char *out = data.data() + sizeof(header);
+    std::vector<unsigned char> level, next;
+    const unsigned char *rgba = pixels;
+    for (std::uint32_t i = 0; i < header.levels; i++) {
+        if (i > 0) {
+            halve(rgba, width, height, format == BC5, next);
+            level.swap(next);
+            rgba = level.data();
+            width = std::max(1, width / 2);
+            height = std::max(1, height / 2);
+        }
+        compressBlocks(format, rgba, width, height, out);
+        out += compressedSize(format, width, height);
+    }
+    stbi_image_free(pixels);
+
+    // write next to the final file and rename, so a crash never leaves half an entry behind; the workers
+    // may be compressing the same image at once, each into its own temporary file
+    std::string temporary = file + "." + std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id())) +
+                            ".tmp";
+    FILE *outFile = std::fopen(temporary.c_str(), "wb");
+    bool ok = outFile && std::fwrite(data.data(), 1, data.size(), outFile) == data.size();
+    ok = outFile && std::fclose(outFile) == 0 && ok;
+    if (ok) {
+        std::remove(file.c_str());
+        ok = std::rename(temporary.c_str(), file.c_str()) == 0;
+    }
+    if (!ok) {
+        std::remove(temporary.c_str());
+        std::cout << "ERROR::COMPRESSED_TEXTURE::CACHE_NOT_WRITTEN\n" << file << std::endl;
+    }
+    return ok;
+}
+
+
+std::string CompressedTextureCache::path(std::uint64_t key) const{
+    char name[32];
+    std::snprintf(name, sizeof(name), "%016llx.bctex", (unsigned long long) key);
+    return directory + "/" + name;
+}
@@ -0,0 +1,192 @@
+#include <renderer/cubemap_loader.h>
+#include <renderer/gl_extensions.h>
+#include <renderer/gl_state.h>
+
+#include <stb_image.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <thread>
+
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+double millisecondsSince(Clock::time_point start){
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+const int FACE_COUNT = 6;
+
+// a full chain down to 1x1
+GLsizei mipLevels(int size){
+    GLsizei levels = 1;
+    while (size > 1) {
+        size /= 2;
+        levels++;
+    }
+    return levels;
+}
+
+} // namespace
+
+
+CubemapLoader::CubemapLoader(GLADloadproc load, unsigned workerCount)
+: workerCount(workerCount), staging(GL_PIXEL_UNPACK_BUFFER){
+    if (this->workerCount == 0)
+        this->workerCount = std::max(1u, std::thread::hardware_concurrency());
+
+    GLint major = 0, minor = 0;
+    glGetIntegerv(GL_MAJOR_VERSION, &major);
+    glGetIntegerv(GL_MINOR_VERSION, &minor);
+    if (major > 4 || (major == 4 && minor >= 2) || hasGLExtension("GL_ARB_texture_storage"))
+        texStorage2D = (PFNCUBEMAPLOADERTEXSTORAGE2DPROC) load("glTexStorage2D");
+}
+
+
+GLuint CubemapLoader::load(const std::vector<std::string> &faces, const Options &options){
+    stats = Stats();
+    if (faces.size() != FACE_COUNT) {
+        std::cout << "ERROR::CUBEMAP::LOADING_FAILED\n" << faces.size() << " faces instead of 6" << std::endl;
+        return 0;
+    }
+
+    // the size and channels of every face from its header, before anything is decoded
+    int size = 0, channels = 3;
+    for (const std::string &face : faces) {
+        stbi_options probe;
+        stbi_options_init(&probe);
+        int width, height, comp;
+        if (!stbi_info_ex(&probe, face.c_str(), &width, &height, &comp)) {
+            std::cout << "ERROR::CUBEMAP::LOADING_FAILED\n" << face << ": "
+                      << (probe.failure_reason ? probe.failure_reason : "cannot read the file") << std::endl;
+            return 0;
+        }
+        if (width != height || (size && width != size)) {
+            std::cout << "ERROR::CUBEMAP::FACE_SIZE_MISMATCH\n" << face << ": " << width << "x" << height
+                      << ", the faces must be square and of one size" << std::endl;
+            return 0;
+        }
+        size = width;
+        if (comp == 2 || comp == 4)
+            channels = 4;
+    }
+
+    size_t faceSize = (size_t) size * size * channels;
+    size_t totalSize = faceSize * FACE_COUNT;
+
+    // new storage for every load, so mapping it never waits for the uploads of the previous one
+    staging.setData(nullptr, (GLsizeiptr) totalSize, GL_STREAM_DRAW);
+    staging.bind();
+    unsigned char *pixels = (unsigned char *) glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, (GLsizeiptr) totalSize,
+                                                               GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+    if (!pixels) {
+        std::cout << "ERROR::CUBEMAP::STAGING_NOT_MAPPED\n" << totalSize << " bytes" << std::endl;
+        GLState::current().bindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        return 0;
+    }
+
+    Clock::time_point start = Clock::now();
+    std::string failure;
+    bool decoded = decode(faces, options, size, channels, pixels, failure);
+    stats.decodeMilliseconds = millisecondsSince(start);
+
+    // the contents are undefined if the buffer was lost while mapped (e.g. a mode switch)
+    bool unmapped = glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER) == GL_TRUE;
+    if (!decoded || !unmapped) {
+        std::cout << "ERROR::CUBEMAP::LOADING_FAILED\n" << (decoded ? "staging buffer lost" : failure) << std::endl;
+        GLState::current().bindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        return 0;
+    }
+
+    start = Clock::now();
+    GLint boundTexture = 0;
+    glGetIntegerv(GL_TEXTURE_BINDING_CUBE_MAP, &boundTexture);
+    GLuint id;
+    glGenTextures(1, &id);
+    glBindTexture(GL_TEXTURE_CUBE_MAP, id);
+
+    GLenum format = channels == 4 ? GL_RGBA : GL_RGB;
+    GLenum internalFormat = channels == 4 ? GL_RGBA8 : GL_RGB8;
+    GLsizei levels = options.mipmaps ? mipLevels(size) : 1;
+    if ((size * channels) % 4 != 0)
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    if (texStorage2D) {
+        texStorage2D(GL_TEXTURE_CUBE_MAP, levels, internalFormat, size, size);
+        for (int face = 0; face < FACE_COUNT; face++)
+            glTexSubImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + face, 0, 0, 0, size, size, format, GL_UNSIGNED_BYTE,
+                            (const void *) (face * faceSize));
+    } else {
+        // allocated face by face, the lower levels by glGenerateMipmap
+        for (int face = 0; face < FACE_COUNT; face++)
+            glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + face, 0, internalFormat, size, size, 0, format,
+                         GL_UNSIGNED_BYTE, (const void *) (face * faceSize));
+    }
+    if ((size * channels) % 4 != 0)
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    // the unpack buffer would turn the pointer of every later glTexImage2D into an offset
+    GLState::current().bindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAX_LEVEL, levels - 1);
+    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, levels > 1 ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    if (levels > 1)
+        glGenerateMipmap(GL_TEXTURE_CUBE_MAP);
+    glBindTexture(GL_TEXTURE_CUBE_MAP, boundTexture);
+
+    stats.uploadMilliseconds = millisecondsSince(start);
+    stats.uploadedBytes = totalSize;
+    return id;
+}
+
+
+bool CubemapLoader::decode(const std::vector<std::string> &faces, const Options &options, int size, int channels,
+                           unsigned char *pixels, std::string &failure){
+    size_t faceSize = (size_t) size * size * channels;
+    std::vector<std::string> failures(FACE_COUNT);
+    // the faces are claimed one at a time, so a slow one does not hold up the others
+    std::atomic<int> next{0};
+    auto work = [&](){
+        // stb_image reads its output back (flipping, swapping channels, copying rows), which the write only
+        // mapping does not allow and is slow on write-combined memory: decode into a buffer of the worker
+        // and copy each face into the mapping in one go
+        std::vector<unsigned char> scratch;
+        for (int face = next++; face < FACE_COUNT; face = next++) {
+            scratch.resize(faceSize);
+            stbi_options decodeOptions;
+            stbi_options_init(&decodeOptions);
+            decodeOptions.flip_vertically = options.flipVertically;
+            decodeOptions.output = scratch.data();
+            decodeOptions.output_size = faceSize;
+            int width, height, comp;
+            if (!stbi_load_ex(&decodeOptions, faces[face].c_str(), &width, &height, &comp, channels))
+                failures[face] = decodeOptions.failure_reason ? decodeOptions.failure_reason : "unknown error";
+            // changed on disk since its header was read
+            else if (width != size || height != size)
+                failures[face] = "face size changed";
+            else
+                std::memcpy(pixels + face * faceSize, scratch.data(), faceSize);
+        }
+    };
+
+    std::vector<std::thread> workers;
+    for (unsigned i = 1; i < std::min<unsigned>(workerCount, FACE_COUNT); i++)
+        workers.emplace_back(work);
+    work();
+    for (std::thread &worker : workers)
+        worker.join();
+
+    for (int face = 0; face < FACE_COUNT; face++)
+        if (!failures[face].empty()) {
+            failure = faces[face] + ": " + failures[face];
+            return false;
+        }
+    return true;
+}
@@ -0,0 +1,281 @@
+#include <renderer/geometry.h>
+
+#include <glm/gtc/constants.hpp>
+
+#include <algorithm>
+#include <iomanip>
+
+
+const int Geometry::FLOATS_PER_VERTEX;
+const int Geometry::NORMAL_OFFSET;
+const int Geometry::UV_OFFSET;
+
+
+namespace {
+
+// write one vertex at v, return where the next one goes
+float *putVertex(float *v, float x, float y, float z, float nx, float ny, float nz, float s, float t){
+    v[0] = x; v[1] = y; v[2] = z;
+    v[3] = nx; v[4] = ny; v[5] = nz;
+    v[6] = s; v[7] = t;
+    return v + Geometry::FLOATS_PER_VERTEX;
+}
+
+// two counter-clockwise triangles a b c, a c d
+template<typename Index>
+Index *putQuad(Index *out, size_t a, size_t b, size_t c, size_t d){
+    out[0] = (Index) a; out[1] = (Index) b; out[2] = (Index) c;
+    out[3] = (Index) a; out[4] = (Index) c; out[5] = (Index) d;
+    return out + 6;
+}
+
+template<typename Index>
+Index *putTriangle(Index *out, size_t a, size_t b, size_t c){
+    out[0] = (Index) a; out[1] = (Index) b; out[2] = (Index) c;
+    return out + 3;
+}
+
+// size the indices of geometry (its vertices must be there already) and let write fill them,
+// with 16 bit indices when they can reach every vertex
+template<typename Write>
+void writeIndices(Geometry &geometry, size_t indexCount, Write write){
+    if (geometry.vertexCount() <= 65536) {
+        geometry.indexType = GL_UNSIGNED_SHORT;
+        geometry.indices16.resize(indexCount);
+        write(geometry.indices16.data());
+    } else {
+        geometry.indexType = GL_UNSIGNED_INT;
+        geometry.indices32.resize(indexCount);
+        write(geometry.indices32.data());
+    }
+}
+
+// indices of a (columns + 1) x (rows + 1) vertex lattice, row after row, one quad per cell
+template<typename Index>
+Index *putLattice(Index *out, size_t columns, size_t rows){
+    for (size_t row = 0; row < rows; row++)
+        for (size_t column = 0; column < columns; column++) {
+            size_t first = row * (columns + 1) + column;
+            out = putQuad(out, first, first + 1, first + columns + 2, first + columns + 1);
+        }
+    return out;
+}
+
+} // namespace
+
+
+const void *Geometry::indexData() const{
+    return indexType == GL_UNSIGNED_SHORT ? (const void *) indices16.data() : (const void *) indices32.data();
+}
+
+
+size_t Geometry::indexDataSize() const{
+    return indexType == GL_UNSIGNED_SHORT ? indices16.size() * sizeof(GLushort) : indices32.size() * sizeof(GLuint);
+}
+
+
+void sinCos(size_t count, float start, float step, float *sines, float *cosines){
+    // x = q * pi/2 + r with |r| <= pi/4, pi/2 split in three so q * pi/2 is exact (Cody-Waite),
+    // then the minimax polynomials of cephes' sinf/cosf on r
+    const float twoOverPi = 0.636619772367581f;
+    const float pi2a = 1.5703125f, pi2b = 4.837512969970703125e-4f, pi2c = 7.54978995489188216e-8f;
+    for (size_t i = 0; i < count; i++) {
+        // through int: size_t to float does not vectorize
+        float x = start + (float) (int) i * step;
+        int q = (int) (x * twoOverPi + (x >= 0.0f ? 0.5f : -0.5f));
+        float r = ((x - q * pi2a) - q * pi2b) - q * pi2c;
+        float z = r * r;
+        float s = r + r * z * (-1.6666654611e-1f + z * (8.3321608736e-3f + z * -1.9515295891e-4f));
+        float c = 1.0f - 0.5f * z + z * z * (4.166664568298827e-2f + z * (-1.388731625493765e-3f +
+                                                                         z * 2.443315711809948e-5f));
+        // sin(r + q pi/2) and cos(r + q pi/2) by quadrant
+        bool swap = (q & 1) != 0;
+        float sine = swap ? c : s;
+        float cosine = swap ? s : c;
+        sines[i] = (q & 2) ? -sine : sine;
+        cosines[i] = ((q + 1) & 2) ? -cosine : cosine;
+    }
+}
+
+
+Geometry makePolygon(int sides, float radius, float angle){
+    sides = std::max(sides, 3);
+    Geometry geometry;
+    std::vector<float> sines(sides), cosines(sides);
+    sinCos(sides, angle, 2 * glm::pi<float>() / (float) sides, sines.data(), cosines.data());
+
+    geometry.vertices.resize((sides + 1) * Geometry::FLOATS_PER_VERTEX);
+    float *v = putVertex(geometry.vertices.data(), 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.5f, 0.5f);
+    for (int i = 0; i < sides; i++)
+        v = putVertex(v, cosines[i] * radius, sines[i] * radius, 0.0f, 0.0f, 0.0f, 1.0f,
+                      cosines[i] / 2 + 0.5f, sines[i] / 2 + 0.5f);
+
+    writeIndices(geometry, sides * 3, [sides](auto *out){
+        for (int i = 0; i < sides; i++)
+            out = putTriangle(out, 0, i + 1, (i + 1) % sides + 1);
+    });
+    return geometry;
+}
+
+
+Geometry makeGrid(int columns, int rows, float width, float height){
+    columns = std::max(columns, 1);
+    rows = std::max(rows, 1);
+    Geometry geometry;
+    geometry.vertices.resize((columns + 1) * (rows + 1) * Geometry::FLOATS_PER_VERTEX);
+    float *v = geometry.vertices.data();
+    for (int row = 0; row <= rows; row++) {
+        float t = (float) row / (float) rows;
+        for (int column = 0; column <= columns; column++) {
+            float s = (float) column / (float) columns;
+            v = putVertex(v, (s - 0.5f) * width, (t - 0.5f) * height, 0.0f, 0.0f, 0.0f, 1.0f, s, t);
+        }
+    }
+
+    writeIndices(geometry, columns * rows * 6, [columns, rows](auto *out){
+        putLattice(out, columns, rows);
+    });
+    return geometry;
+}
+
+
+Geometry makeSphere(int slices, int stacks, float radius){
+    slices = std::max(slices, 3);
+    stacks = std::max(stacks, 2);
+    Geometry geometry;
+    // the first and last slice are the same meridian, with u 0 and 1
+    std::vector<float> slicesSin(slices + 1), slicesCos(slices + 1), stacksSin(stacks + 1), stacksCos(stacks + 1);
+    sinCos(slices + 1, 0.0f, 2 * glm::pi<float>() / (float) slices, slicesSin.data(), slicesCos.data());
+    sinCos(stacks + 1, 0.0f, glm::pi<float>() / (float) stacks, stacksSin.data(), stacksCos.data());
+
+    geometry.vertices.resize((slices + 1) * (stacks + 1) * Geometry::FLOATS_PER_VERTEX);
+    float *v = geometry.vertices.data();
+    for (int stack = 0; stack <= stacks; stack++) {
+        float t = 1.0f - (float) stack / (float) stacks;
+        for (int slice = 0; slice <= slices; slice++) {
+            float nx = stacksSin[stack] * slicesCos[slice];
+            float ny = stacksCos[stack];
+            float nz = -stacksSin[stack] * slicesSin[slice];
+            v = putVertex(v, nx * radius, ny * radius, nz * radius, nx, ny, nz, (float) slice / (float) slices, t);
+        }
+    }
+
+    // the quads touching a pole are a single triangle
+    writeIndices(geometry, slices * (stacks - 1) * 6, [slices, stacks](auto *out){
+        size_t rowLength = slices + 1;
+        for (int stack = 0; stack < stacks; stack++)
+            for (int slice = 0; slice < slices; slice++) {
+                size_t a = stack * rowLength + slice, b = a + rowLength, c = b + 1, d = a + 1;
+                if (stack > 0)
+                    out = putTriangle(out, a, b, d);
+                if (stack < stacks - 1)
+                    out = putTriangle(out, d, b, c);
+            }
+    });
+    return geometry;
+}
+
+
+Geometry makeTorus(int rings, int sides, float radius, float tubeRadius){
+    rings = std::max(rings, 3);
+    sides = std::max(sides, 3);
+    Geometry geometry;
+    std::vector<float> ringsSin(rings + 1), ringsCos(rings + 1), sidesSin(sides + 1), sidesCos(sides + 1);
+    sinCos(rings + 1, 0.0f, 2 * glm::pi<float>() / (float) rings, ringsSin.data(), ringsCos.data());
+    sinCos(sides + 1, 0.0f, 2 * glm::pi<float>() / (float) sides, sidesSin.data(), sidesCos.data());
+
+    geometry.vertices.resize((rings + 1) * (sides + 1) * Geometry::FLOATS_PER_VERTEX);
+    float *v = geometry.vertices.data();
+    for (int side = 0; side <= sides; side++) {
+        float t = (float) side / (float) sides;
+        for (int ring = 0; ring <= rings; ring++) {
+            float nx = sidesCos[side] * ringsCos[ring];
+            float ny = sidesSin[side];
+            float nz = -sidesCos[side] * ringsSin[ring];
+            float x = radius * ringsCos[ring] + tubeRadius * nx;
+            float z = -radius * ringsSin[ring] + tubeRadius * nz;
+            v = putVertex(v, x, tubeRadius * ny, z, nx, ny, nz, (float) ring / (float) rings, t);
+        }
+    }
+
+    writeIndices(geometry, rings * sides * 6, [rings, sides](auto *out){
+        putLattice(out, rings, sides);
+    });
+    return geometry;
+}
+
+
+void printGeometry(const Geometry &geometry, std::ostream &out){
+    std::ios::fmtflags flags = out.flags();
+    std::streamsize precision = out.precision();
+    out << std::setprecision(2) << std::fixed;
+
+    out << "------------- vertices ----------------" << std::endl;
+    for (size_t i = 0; i < geometry.vertexCount(); i++) {
+        const float *v = &geometry.vertices[i * Geometry::FLOATS_PER_VERTEX];
+        out << " " << i << ": " << v[0] << " " << v[1] << " " << v[2] << "  n " << v[3] << " " << v[4] << " "
+            << v[5] << "  uv " << v[6] << " " << v[7] << "\n";
+    }
+    out << "------------- indices -----------------" << std::endl;
+    for (size_t i = 0; i < geometry.indexCount(); i += 3) {
+        for (size_t k = i; k < i + 3; k++)
+            out << " " << (geometry.indexType == GL_UNSIGNED_SHORT ? geometry.indices16[k] : geometry.indices32[k]);
+        out << "\n";
+    }
+    out << std::flush;
+
+    out.flags(flags);
+    out.precision(precision);
+}
+
+
+size_t GeometryCache::KeyHash::operator()(const Key &key) const{
+    // FNV-1a over the fields (not the struct, its padding is not initialized)
+    size_t hash = 14695981039346656037ull;
+    auto mix = [&hash](const void *data, size_t size){
+        const unsigned char *bytes = (const unsigned char *) data;
+        for (size_t i = 0; i < size; i++) {
+            hash ^= bytes[i];
+            hash *= 1099511628211ull;
+        }
+    };
+    mix(&key.type, sizeof(key.type));
+    mix(&key.a, sizeof(key.a));
+    mix(&key.b, sizeof(key.b));
+    mix(&key.x, sizeof(key.x));
+    mix(&key.y, sizeof(key.y));
+    return hash;
+}
+
+
+template<typename Build>
+const Geometry &GeometryCache::get(const Key &key, Build build){
+    auto it = shapes.find(key);
+    if (it != shapes.end()) {
+        ++hitCount;
+        return it->second;
+    }
+    ++missCount;
+    return shapes.emplace(key, build()).first->second;
+}
+
+
+const Geometry &GeometryCache::polygon(int sides, float radius, float angle){
+    return get(Key{POLYGON, sides, 0, radius, angle}, [=](){ return makePolygon(sides, radius, angle); });
+}
+
+
+const Geometry &GeometryCache::grid(int columns, int rows, float width, float height){
+    return get(Key{GRID, columns, rows, width, height}, [=](){ return makeGrid(columns, rows, width, height); });
+}
+
+
+const Geometry &GeometryCache::sphere(int slices, int stacks, float radius){
+    return get(Key{SPHERE, slices, stacks, radius, 0.0f}, [=](){ return makeSphere(slices, stacks, radius); });
+}
+
+
+const Geometry &GeometryCache::torus(int rings, int sides, float radius, float tubeRadius){
+    return get(Key{TORUS, rings, sides, radius, tubeRadius},
+               [=](){ return makeTorus(rings, sides, radius, tubeRadius); });
+}
@@ -0,0 +1,17 @@
+#include <renderer/gl_extensions.h>
+
+#include <glad/glad.h>
+
+#include <cstring>
+
+
+bool hasGLExtension(const char *name){
+    GLint extensionCount = 0;
+    glGetIntegerv(GL_NUM_EXTENSIONS, &extensionCount);
+    for (GLint i = 0; i < extensionCount; i++) {
+        const GLubyte *extension = glGetStringi(GL_EXTENSIONS, i);
+        if (extension && std::strcmp((const char *) extension, name) == 0)
+            return true;
+    }
+    return false;
+}
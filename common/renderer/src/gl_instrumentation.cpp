@@ -0,0 +1,315 @@
+#include <renderer/gl_instrumentation.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+
+// glad's own post call callback (checks glGetError after every call), put back when instrumentation is off
+extern "C" void _post_call_callback_default(const char *name, void *funcptr, int len_args, ...);
+
+namespace {
+
+enum CallKind {
+    OTHER_CALL,
+    BIND_BUFFER,
+    BIND_BUFFER_INDEXED,
+    BIND_VERTEX_ARRAY,
+    USE_PROGRAM,
+    ACTIVE_TEXTURE,
+    BIND_TEXTURE,
+    BIND_FRAMEBUFFER,
+    ENABLE,
+    DISABLE,
+    BUFFER_DATA,
+    DELETE_BUFFERS,
+    READ_PIXELS,
+    MAP_BUFFER,
+    MAP_BUFFER_RANGE,
+    GET_ERROR,
+    GET_QUERY,
+    GET_READBACK,
+    FINISH,
+    CLIENT_WAIT_SYNC
+};
+
+double now(){
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void ignoreCall(const char *, void *, int, ...){
+}
+
+bool startsWith(const char *text, const char *prefix){
+    return std::strncmp(text, prefix, std::strlen(prefix)) == 0;
+}
+
+} // namespace
+
+
+GLInstrumentation &GLInstrumentation::instance(){
+    static GLInstrumentation instrumentation;
+    return instrumentation;
+}
+
+
+void GLInstrumentation::setEnabled(bool enabled){
+    if (this->enabled == enabled)
+        return;
+    this->enabled = enabled;
+    glad_set_pre_callback(enabled ? preCall : ignoreCall);
+    glad_set_post_callback(enabled ? postCall : _post_call_callback_default);
+
+    // whatever happened while we were not looking, the shadowed state cannot be trusted anymore
+    activeTexture = 0;
+    program = vertexArray = drawFramebuffer = readFramebuffer = Binding();
+    buffers.clear();
+    textures.clear();
+    capabilities.clear();
+    specifiedBuffers.clear();
+    entryPoints.clear();
+    stallReasons.clear();
+    thrashing = 0;
+    orphans = 0;
+}
+
+
+void GLInstrumentation::endFrame(){
+    frameStats = GLFrameStats();
+    for (const auto &entry : entryPoints) {
+        const EntryPoint &entryPoint = entry.second;
+        frameStats.entryPoints.push_back({entry.first, entryPoint.calls, entryPoint.milliseconds, entryPoint.redundant});
+        frameStats.calls += entryPoint.calls;
+        frameStats.milliseconds += entryPoint.milliseconds;
+        frameStats.redundant += entryPoint.redundant;
+    }
+    std::sort(frameStats.entryPoints.begin(), frameStats.entryPoints.end(),
+              [](const GLCallStats &a, const GLCallStats &b){ return a.calls > b.calls; });
+
+    for (const auto &reason : stallReasons) {
+        frameStats.stallReasons.emplace_back(reason.first, reason.second);
+        frameStats.stalls += reason.second;
+    }
+    std::sort(frameStats.stallReasons.begin(), frameStats.stallReasons.end(),
+              [](const std::pair<std::string, unsigned long> &a, const std::pair<std::string, unsigned long> &b){
+                  return a.second > b.second;
+              });
+    frameStats.thrashing = thrashing;
+    frameStats.orphans = orphans;
+
+    entryPoints.clear();
+    stallReasons.clear();
+    thrashing = 0;
+    orphans = 0;
+}
+
+
+void GLInstrumentation::preCall(const char *name, void *, int argCount, ...){
+    GLInstrumentation &instrumentation = instance();
+    va_list args;
+    va_start(args, argCount);
+    instrumentation.analyze(name, args);
+    va_end(args);
+    instrumentation.callStart = now();
+}
+
+
+void GLInstrumentation::postCall(const char *name, void *, int, ...){
+    GLInstrumentation &instrumentation = instance();
+    double milliseconds = now() - instrumentation.callStart;
+    if (instrumentation.paused)
+        return;
+    EntryPoint &entryPoint = instrumentation.entryPoints[name];
+    ++entryPoint.calls;
+    entryPoint.milliseconds += milliseconds;
+}
+
+
+bool GLInstrumentation::bind(Binding &binding, GLuint value){
+    if (binding.current == value)
+        return true;
+    if (binding.previous == value && !paused)
+        ++thrashing;
+    binding.previous = binding.current;
+    binding.current = value;
+    return false;
+}
+
+
+GLInstrumentation::Binding &GLInstrumentation::bufferBinding(GLenum target){
+    return buffers[target];
+}
+
+
+void GLInstrumentation::stall(const char *reason){
+    if (!paused)
+        ++stallReasons[reason];
+}
+
+
+int GLInstrumentation::callKind(const char *name){
+    auto it = callKinds.find(name);
+    if (it != callKinds.end())
+        return it->second;
+
+    static const struct { const char *name; CallKind kind; } known[] = {
+            {"glBindBuffer", BIND_BUFFER},
+            {"glBindBufferBase", BIND_BUFFER_INDEXED},
+            {"glBindBufferRange", BIND_BUFFER_INDEXED},
+            {"glBindVertexArray", BIND_VERTEX_ARRAY},
+            {"glUseProgram", USE_PROGRAM},
+            {"glActiveTexture", ACTIVE_TEXTURE},
+            {"glBindTexture", BIND_TEXTURE},
+            {"glBindFramebuffer", BIND_FRAMEBUFFER},
+            {"glEnable", ENABLE},
+            {"glDisable", DISABLE},
+            {"glBufferData", BUFFER_DATA},
+            {"glDeleteBuffers", DELETE_BUFFERS},
+            {"glReadPixels", READ_PIXELS},
+            {"glMapBuffer", MAP_BUFFER},
+            {"glMapBufferRange", MAP_BUFFER_RANGE},
+            {"glGetError", GET_ERROR},
+            {"glGetBufferSubData", GET_READBACK},
+            {"glGetTexImage", GET_READBACK},
+            {"glGetCompressedTexImage", GET_READBACK},
+            {"glFinish", FINISH},
+            {"glClientWaitSync", CLIENT_WAIT_SYNC}
+    };
+    CallKind kind = OTHER_CALL;
+    for (const auto &entry : known)
+        if (std::strcmp(name, entry.name) == 0)
+            kind = entry.kind;
+    if (kind == OTHER_CALL && startsWith(name, "glGetQueryObject"))
+        kind = GET_READBACK;
+    else if (kind == OTHER_CALL && startsWith(name, "glGet"))
+        kind = GET_QUERY;
+
+    callKinds.emplace(name, kind);
+    return kind;
+}
+
+
+// look at the call before it is made: update the shadowed state, count redundant binds and stalls
+// -----------------------------------------------------------------------------------------------
+void GLInstrumentation::analyze(const char *name, va_list args){
+    bool redundant = false;
+
+    switch (callKind(name)) {
+        case BIND_BUFFER: {
+            GLenum target = va_arg(args, GLenum);
+            GLuint buffer = va_arg(args, GLuint);
+            redundant = bind(bufferBinding(target), buffer);
+            break;
+        }
+        case BIND_BUFFER_INDEXED: {
+            // also binds the buffer to the generic binding point of target
+            GLenum target = va_arg(args, GLenum);
+            va_arg(args, GLuint);
+            GLuint buffer = va_arg(args, GLuint);
+            bind(bufferBinding(target), buffer);
+            break;
+        }
+        case BIND_VERTEX_ARRAY: {
+            redundant = bind(vertexArray, va_arg(args, GLuint));
+            // the element buffer is part of the vertex array
+            if (!redundant)
+                bufferBinding(GL_ELEMENT_ARRAY_BUFFER) = Binding();
+            break;
+        }
+        case USE_PROGRAM:
+            redundant = bind(program, va_arg(args, GLuint));
+            break;
+        case ACTIVE_TEXTURE: {
+            GLenum unit = va_arg(args, GLenum);
+            redundant = unit == activeTexture;
+            activeTexture = unit;
+            break;
+        }
+        case BIND_TEXTURE: {
+            GLenum target = va_arg(args, GLenum);
+            GLuint texture = va_arg(args, GLuint);
+            redundant = bind(textures[((unsigned long long) activeTexture << 32) | target], texture);
+            break;
+        }
+        case BIND_FRAMEBUFFER: {
+            GLenum target = va_arg(args, GLenum);
+            GLuint framebuffer = va_arg(args, GLuint);
+            if (target == GL_FRAMEBUFFER) {
+                bool drawRedundant = bind(drawFramebuffer, framebuffer);
+                redundant = bind(readFramebuffer, framebuffer) && drawRedundant;
+            }
+            else
+                redundant = bind(target == GL_READ_FRAMEBUFFER ? readFramebuffer : drawFramebuffer, framebuffer);
+            break;
+        }
+        case ENABLE:
+            redundant = bind(capabilities[va_arg(args, GLenum)], 1);
+            break;
+        case DISABLE:
+            redundant = bind(capabilities[va_arg(args, GLenum)], 0);
+            break;
+        case BUFFER_DATA: {
+            GLuint buffer = bufferBinding(va_arg(args, GLenum)).current;
+            GLsizeiptr size = va_arg(args, GLsizeiptr);
+            auto specified = specifiedBuffers.find(buffer);
+            if (specified == specifiedBuffers.end())
+                specifiedBuffers.emplace(buffer, size);
+            // the same size again, with data or without, is renamed by the driver rather than waited for
+            else if (specified->second == size)
+                ++orphans;
+            else {
+                specified->second = size;
+                stall("buffer re-specification (glBufferData)");
+            }
+            break;
+        }
+        case DELETE_BUFFERS: {
+            GLsizei count = va_arg(args, GLsizei);
+            const GLuint *names = va_arg(args, const GLuint *);
+            for (GLsizei i = 0; i < count; i++) {
+                specifiedBuffers.erase(names[i]);
+                // bindings of a deleted buffer go back to 0
+                for (auto &binding : buffers)
+                    if (binding.second.current == names[i])
+                        binding.second.current = 0;
+            }
+            break;
+        }
+        case READ_PIXELS:
+            if (bufferBinding(GL_PIXEL_PACK_BUFFER).current == 0 || bufferBinding(GL_PIXEL_PACK_BUFFER).current == ~0u)
+                stall("glReadPixels to client memory");
+            break;
+        case MAP_BUFFER:
+            stall("synchronized buffer mapping");
+            break;
+        case MAP_BUFFER_RANGE: {
+            va_arg(args, GLenum);
+            va_arg(args, GLintptr);
+            va_arg(args, GLsizeiptr);
+            GLbitfield access = va_arg(args, GLbitfield);
+            if (!(access & GL_MAP_UNSYNCHRONIZED_BIT))
+                stall("synchronized buffer mapping");
+            break;
+        }
+        case GET_ERROR:
+            stall("glGetError");
+            break;
+        case GET_QUERY:
+            stall("glGet* query round trip");
+            break;
+        case GET_READBACK:
+            stall("GPU readback (glGetBufferSubData, glGetTexImage, glGetQueryObject)");
+            break;
+        case FINISH:
+            stall("glFinish");
+            break;
+        case CLIENT_WAIT_SYNC:
+            stall("glClientWaitSync");
+            break;
+        default:
+            break;
+    }
+
+    if (redundant && !paused)
+        ++entryPoints[name].redundant;
+}
@@ -0,0 +1,53 @@
+#include <renderer/gl_instrumentation.h>
+
+#include <imgui.h>
+
+#include <algorithm>
+
+
+void drawGLInstrumentationOverlay(GLInstrumentation &instrumentation, unsigned int maxEntryPoints){
+    ImGui::Begin("GL calls");
+
+    bool enabled = instrumentation.isEnabled();
+    if (ImGui::Checkbox("instrument GL calls", &enabled))
+        instrumentation.setEnabled(enabled);
+    if (!enabled) {
+        ImGui::End();
+        return;
+    }
+
+    const GLFrameStats &frame = instrumentation.lastFrame();
+    ImGui::Text("%lu calls, %.3f ms in GL", frame.calls, frame.milliseconds);
+    ImGui::Text("%lu redundant, %lu thrashing binds", frame.redundant, frame.thrashing);
+    if (frame.orphans > 0)
+        ImGui::Text("%lu buffers orphaned", frame.orphans);
+    if (frame.stalls > 0)
+        ImGui::TextColored(ImVec4(1.0f, 0.4f, 0.3f, 1.0f), "%lu stalls", frame.stalls);
+    else
+        ImGui::Text("no stalls");
+
+    if (ImGui::CollapsingHeader("entry points", ImGuiTreeNodeFlags_DefaultOpen)) {
+        ImGui::Columns(4, "entry points");
+        ImGui::Text("function"); ImGui::NextColumn();
+        ImGui::Text("calls"); ImGui::NextColumn();
+        ImGui::Text("ms"); ImGui::NextColumn();
+        ImGui::Text("redundant"); ImGui::NextColumn();
+        ImGui::Separator();
+        size_t count = std::min<size_t>(maxEntryPoints, frame.entryPoints.size());
+        for (size_t i = 0; i < count; i++) {
+            const GLCallStats &entryPoint = frame.entryPoints[i];
+            ImGui::Text("%s", entryPoint.name); ImGui::NextColumn();
+            ImGui::Text("%lu", entryPoint.calls); ImGui::NextColumn();
+            ImGui::Text("%.3f", entryPoint.milliseconds); ImGui::NextColumn();
+            ImGui::Text("%lu", entryPoint.redundant); ImGui::NextColumn();
+        }
+        ImGui::Columns(1);
+    }
+
+    if (!frame.stallReasons.empty() && ImGui::CollapsingHeader("stalls", ImGuiTreeNodeFlags_DefaultOpen)) {
+        for (const auto &reason : frame.stallReasons)
+            ImGui::BulletText("%lu x %s", reason.second, reason.first.c_str());
+    }
+
+    ImGui::End();
+}
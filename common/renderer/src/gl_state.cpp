@@ -0,0 +1,143 @@
+#include <renderer/gl_state.h>
+
+#include <cstring>
+
+
+GLState &GLState::current(){
+    static GLState state;
+    return state;
+}
+
+
+void GLState::useProgram(GLuint program){
+    if (change(this->program, program))
+        glUseProgram(program);
+}
+
+
+void GLState::bindVertexArray(GLuint vertexArray){
+    if (change(this->vertexArray, vertexArray)) {
+        glBindVertexArray(vertexArray);
+        elementBuffer = UNKNOWN;
+    }
+}
+
+
+void GLState::bindBuffer(GLenum target, GLuint buffer){
+    GLuint *cached = target == GL_ELEMENT_ARRAY_BUFFER ? &elementBuffer : bufferBinding(target);
+    if (!cached) {
+        // a target we do not track, always forward it
+        ++issued;
+        glBindBuffer(target, buffer);
+        return;
+    }
+    if (change(*cached, buffer))
+        glBindBuffer(target, buffer);
+}
+
+
+void GLState::enable(GLenum capability){
+    auto it = capabilities.find(capability);
+    if (it != capabilities.end() && it->second) {
+        ++redundant;
+        return;
+    }
+    capabilities[capability] = true;
+    ++issued;
+    glEnable(capability);
+}
+
+
+void GLState::disable(GLenum capability){
+    auto it = capabilities.find(capability);
+    if (it != capabilities.end() && !it->second) {
+        ++redundant;
+        return;
+    }
+    capabilities[capability] = false;
+    ++issued;
+    glDisable(capability);
+}
+
+
+void GLState::clearColor(float red, float green, float blue, float alpha){
+    const float value[4] = {red, green, blue, alpha};
+    if (std::memcmp(clearColorValue, value, sizeof(value)) == 0) {
+        ++redundant;
+        return;
+    }
+    std::memcpy(clearColorValue, value, sizeof(value));
+    ++issued;
+    glClearColor(red, green, blue, alpha);
+}
+
+
+void GLState::viewport(GLint x, GLint y, GLsizei width, GLsizei height){
+    const GLint value[4] = {x, y, width, height};
+    if (std::memcmp(viewportValue, value, sizeof(value)) == 0) {
+        ++redundant;
+        return;
+    }
+    std::memcpy(viewportValue, value, sizeof(value));
+    ++issued;
+    glViewport(x, y, width, height);
+}
+
+
+void GLState::programDeleted(GLuint program){
+    // a deleted program stays in use until another one is bound, but its name can be handed out
+    // again to a new program afterwards, so it can no longer be trusted
+    if (this->program == program)
+        this->program = UNKNOWN;
+}
+
+
+void GLState::vertexArrayDeleted(GLuint vertexArray){
+    if (this->vertexArray == vertexArray) {
+        this->vertexArray = 0;
+        elementBuffer = UNKNOWN;
+    }
+}
+
+
+void GLState::bufferDeleted(GLuint buffer){
+    GLuint *bindings[] = {&elementBuffer, &arrayBuffer, &copyReadBuffer, &copyWriteBuffer,
+                          &uniformBuffer, &pixelPackBuffer, &pixelUnpackBuffer};
+    for (GLuint *binding : bindings)
+        if (*binding == buffer)
+            *binding = 0;
+    // the buffer may still be the element buffer of vertex arrays that are not bound right now,
+    // those are not cached so there is nothing else to reset
+}
+
+
+void GLState::invalidate(){
+    program = vertexArray = elementBuffer = UNKNOWN;
+    arrayBuffer = copyReadBuffer = copyWriteBuffer = uniformBuffer = UNKNOWN;
+    pixelPackBuffer = pixelUnpackBuffer = UNKNOWN;
+    capabilities.clear();
+    for (int i = 0; i < 4; i++) {
+        clearColorValue[i] = -1.0f;
+        viewportValue[i] = -1;
+    }
+}
+
+
+GLuint *GLState::bufferBinding(GLenum target){
+    switch (target) {
+        case GL_ARRAY_BUFFER:
+            return &arrayBuffer;
+        case GL_COPY_READ_BUFFER:
+            return &copyReadBuffer;
+        case GL_COPY_WRITE_BUFFER:
+            return &copyWriteBuffer;
+        case GL_UNIFORM_BUFFER:
+            return &uniformBuffer;
+        case GL_PIXEL_PACK_BUFFER:
+            return &pixelPackBuffer;
+        case GL_PIXEL_UNPACK_BUFFER:
+            return &pixelUnpackBuffer;
+        default:
+            return nullptr;
+    }
+}
@@ -0,0 +1,201 @@
+#include <renderer/gpu_profiler.h>
+#include <renderer/gl_instrumentation.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+
+
+namespace {
+
+double now(){
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+template<typename F>
+GpuProfiler::Percentiles percentiles(const std::deque<GpuProfiler::FrameTiming> &frames, F value){
+    GpuProfiler::Percentiles result = {0.0, 0.0, 0.0};
+    if (frames.empty())
+        return result;
+
+    std::vector<double> values;
+    for (const GpuProfiler::FrameTiming &frame : frames)
+        values.push_back(value(frame));
+    std::sort(values.begin(), values.end());
+    auto rank = [&values](double p){
+        size_t index = (size_t) std::ceil(p * values.size());
+        return values[index > 0 ? index - 1 : 0];
+    };
+    result.p50 = rank(0.50);
+    result.p95 = rank(0.95);
+    result.p99 = rank(0.99);
+    return result;
+}
+
+} // namespace
+
+
+GpuProfiler::FrameCallback GpuProfiler::frameCallback = nullptr;
+
+
+GpuProfiler::GpuProfiler(size_t historySize, size_t maxPendingFrames)
+: historySize(historySize), maxPendingFrames(maxPendingFrames){
+}
+
+
+GpuProfiler::~GpuProfiler(){
+    for (const PendingFrame &frame : pending)
+        release(frame);
+    if (inFrame)
+        release(current);
+    if (!freeQueries.empty())
+        glDeleteQueries((GLsizei) freeQueries.size(), freeQueries.data());
+}
+
+
+void GpuProfiler::beginFrame(){
+    collect();
+
+    current = PendingFrame();
+    current.frame = frameCount++;
+    current.cpuStart = now();
+    current.beginQuery = timestamp();
+    inFrame = true;
+    openScopes.clear();
+}
+
+
+void GpuProfiler::endFrame(){
+    if (!inFrame)
+        return;
+    while (!openScopes.empty())
+        endScope();
+
+    current.endQuery = timestamp();
+    current.cpuEnd = now();
+    pending.push_back(std::move(current));
+    inFrame = false;
+
+    // never wait for the GPU, give up on the oldest frame instead
+    while (pending.size() > maxPendingFrames) {
+        release(pending.front());
+        pending.pop_front();
+        ++dropped;
+    }
+}
+
+
+void GpuProfiler::beginScope(const char *name){
+    if (!inFrame)
+        return;
+    PendingScope scope;
+    scope.name = name;
+    scope.depth = (int) openScopes.size();
+    scope.cpuStart = now();
+    scope.beginQuery = timestamp();
+    scope.cpuEnd = scope.cpuStart;
+    scope.endQuery = 0;
+    openScopes.push_back(current.scopes.size());
+    current.scopes.push_back(scope);
+}
+
+
+void GpuProfiler::endScope(){
+    if (!inFrame || openScopes.empty())
+        return;
+    PendingScope &scope = current.scopes[openScopes.back()];
+    openScopes.pop_back();
+    scope.endQuery = timestamp();
+    scope.cpuEnd = now();
+}
+
+
+GpuProfiler::Percentiles GpuProfiler::cpuPercentiles() const{
+    return percentiles(frames, [](const FrameTiming &frame){ return frame.cpuMilliseconds; });
+}
+
+
+GpuProfiler::Percentiles GpuProfiler::gpuPercentiles() const{
+    return percentiles(frames, [](const FrameTiming &frame){ return frame.gpuMilliseconds; });
+}
+
+
+bool GpuProfiler::writeCsv(const std::string &path) const{
+    FILE *file = std::fopen(path.c_str(), "w");
+    if (!file)
+        return false;
+    std::fprintf(file, "frame,scope,depth,cpu_start_ms,cpu_ms,gpu_start_ms,gpu_ms\n");
+    for (const FrameTiming &frame : frames) {
+        std::fprintf(file, "%lu,frame,0,0,%.4f,0,%.4f\n", frame.frame, frame.cpuMilliseconds, frame.gpuMilliseconds);
+        for (const ScopeTiming &scope : frame.scopes)
+            std::fprintf(file, "%lu,\"%s\",%d,%.4f,%.4f,%.4f,%.4f\n", frame.frame, scope.name, scope.depth + 1,
+                         scope.cpuStart, scope.cpuMilliseconds, scope.gpuStart, scope.gpuMilliseconds);
+    }
+    return std::fclose(file) == 0;
+}
+
+
+GLuint GpuProfiler::timestamp(){
+    if (freeQueries.empty()) {
+        freeQueries.resize(64);
+        glGenQueries((GLsizei) freeQueries.size(), freeQueries.data());
+    }
+    GLuint query = freeQueries.back();
+    freeQueries.pop_back();
+    glQueryCounter(query, GL_TIMESTAMP);
+    return query;
+}
+
+
+void GpuProfiler::release(const PendingFrame &frame){
+    freeQueries.push_back(frame.beginQuery);
+    freeQueries.push_back(frame.endQuery);
+    for (const PendingScope &scope : frame.scopes) {
+        freeQueries.push_back(scope.beginQuery);
+        if (scope.endQuery)
+            freeQueries.push_back(scope.endQuery);
+    }
+}
+
+
+void GpuProfiler::collect(){
+    // polling the profiler's own queries is not what the instrumentation is there to measure
+    GLInstrumentation::Pause pause;
+
+    while (!pending.empty()) {
+        const PendingFrame &frame = pending.front();
+        // timestamps complete in order, once the last one of the frame is available all of them are
+        GLint available = 0;
+        glGetQueryObjectiv(frame.endQuery, GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available)
+            break;
+
+        auto gpuTime = [](GLuint query){
+            GLuint64 nanoseconds = 0;
+            glGetQueryObjectui64v(query, GL_QUERY_RESULT, &nanoseconds);
+            return nanoseconds;
+        };
+        GLuint64 frameStart = gpuTime(frame.beginQuery);
+
+        FrameTiming timing;
+        timing.frame = frame.frame;
+        timing.cpuMilliseconds = frame.cpuEnd - frame.cpuStart;
+        timing.gpuMilliseconds = (gpuTime(frame.endQuery) - frameStart) / 1e6;
+        for (const PendingScope &scope : frame.scopes) {
+            GLuint64 begin = gpuTime(scope.beginQuery);
+            GLuint64 end = gpuTime(scope.endQuery);
+            timing.scopes.push_back({scope.name, scope.depth,
+                                     scope.cpuStart - frame.cpuStart, scope.cpuEnd - scope.cpuStart,
+                                     (begin - frameStart) / 1e6, (end - begin) / 1e6});
+        }
+
+        frames.push_back(std::move(timing));
+        if (frameCallback)
+            frameCallback(*this, frames.back());
+        if (frames.size() > historySize)
+            frames.pop_front();
+        release(frame);
+        pending.pop_front();
+    }
+}
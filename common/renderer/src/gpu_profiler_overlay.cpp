@@ -0,0 +1,105 @@
+#include <renderer/gpu_profiler.h>
+
+#include <imgui.h>
+
+#include <algorithm>
+#include <functional>
+#include <string>
+
+
+// a stable color per scope name, so a scope keeps its color from frame to frame
+// ------------------------------------------------------------------------------
+static ImU32 scopeColor(const char *name){
+    size_t hash = std::hash<std::string>()(name);
+    float hue = (hash % 360) / 360.0f;
+    float r, g, b;
+    ImGui::ColorConvertHSVtoRGB(hue, 0.55f, 0.85f, r, g, b);
+    return ImGui::GetColorU32(ImVec4(r, g, b, 1.0f));
+}
+
+
+// one lane of the timeline: a bar per scope, nested scopes one row below their parent
+// ------------------------------------------------------------------------------------
+static void drawLane(const GpuProfiler::FrameTiming &frame, bool gpu, ImVec2 origin, float scale, float rowHeight){
+    ImDrawList *drawList = ImGui::GetWindowDrawList();
+    for (const GpuProfiler::ScopeTiming &scope : frame.scopes) {
+        double start = gpu ? scope.gpuStart : scope.cpuStart;
+        double duration = gpu ? scope.gpuMilliseconds : scope.cpuMilliseconds;
+        ImVec2 min(origin.x + (float) start * scale, origin.y + scope.depth * rowHeight);
+        ImVec2 max(min.x + std::max(1.0f, (float) duration * scale), min.y + rowHeight - 1.0f);
+        drawList->AddRectFilled(min, max, scopeColor(scope.name));
+
+        // the name only if it fits in the bar
+        if (ImGui::CalcTextSize(scope.name).x < max.x - min.x - 4.0f)
+            drawList->AddText(ImVec2(min.x + 2.0f, min.y), IM_COL32(0, 0, 0, 255), scope.name);
+
+        if (ImGui::IsMouseHoveringRect(min, max))
+            ImGui::SetTooltip("%s\nCPU %.3f ms\nGPU %.3f ms", scope.name, scope.cpuMilliseconds, scope.gpuMilliseconds);
+    }
+}
+
+
+void drawGpuProfilerOverlay(GpuProfiler &profiler){
+    ImGui::Begin("GPU profiler");
+
+    const std::deque<GpuProfiler::FrameTiming> &history = profiler.history();
+    if (history.empty()) {
+        ImGui::Text("waiting for the first GPU results");
+        ImGui::End();
+        return;
+    }
+
+    GpuProfiler::Percentiles cpu = profiler.cpuPercentiles();
+    GpuProfiler::Percentiles gpu = profiler.gpuPercentiles();
+    ImGui::Text("last %d frames   p50      p95      p99", (int) history.size());
+    ImGui::Text("CPU ms          %7.3f  %7.3f  %7.3f", cpu.p50, cpu.p95, cpu.p99);
+    ImGui::Text("GPU ms          %7.3f  %7.3f  %7.3f", gpu.p50, gpu.p95, gpu.p99);
+    if (profiler.droppedFrames() > 0)
+        ImGui::Text("%lu frames dropped (results not ready in time)", profiler.droppedFrames());
+
+    // timeline of the last finished frame, CPU lane above the GPU lane, on the same time scale
+    const GpuProfiler::FrameTiming &frame = history.back();
+    int depth = 1;
+    for (const GpuProfiler::ScopeTiming &scope : frame.scopes)
+        depth = std::max(depth, scope.depth + 1);
+    float rowHeight = ImGui::GetTextLineHeight() + 2.0f;
+    float labelWidth = ImGui::CalcTextSize("GPU ").x;
+    float width = std::max(50.0f, ImGui::GetContentRegionAvail().x - labelWidth);
+    float scale = width / (float) std::max(1e-3, std::max(frame.cpuMilliseconds, frame.gpuMilliseconds));
+
+    ImGui::Separator();
+    ImGui::Text("frame %lu: CPU %.3f ms, GPU %.3f ms", frame.frame, frame.cpuMilliseconds, frame.gpuMilliseconds);
+    ImVec2 origin = ImGui::GetCursorScreenPos();
+    ImDrawList *drawList = ImGui::GetWindowDrawList();
+    drawList->AddText(origin, ImGui::GetColorU32(ImGuiCol_Text), "CPU");
+    drawLane(frame, false, ImVec2(origin.x + labelWidth, origin.y), scale, rowHeight);
+    ImVec2 gpuOrigin(origin.x, origin.y + depth * rowHeight + rowHeight * 0.5f);
+    drawList->AddText(gpuOrigin, ImGui::GetColorU32(ImGuiCol_Text), "GPU");
+    drawLane(frame, true, ImVec2(gpuOrigin.x + labelWidth, gpuOrigin.y), scale, rowHeight);
+    ImGui::Dummy(ImVec2(labelWidth + width, 2 * depth * rowHeight + rowHeight * 0.5f));
+
+    if (ImGui::CollapsingHeader("scopes")) {
+        ImGui::Columns(3, "scopes");
+        ImGui::Text("scope"); ImGui::NextColumn();
+        ImGui::Text("CPU ms"); ImGui::NextColumn();
+        ImGui::Text("GPU ms"); ImGui::NextColumn();
+        ImGui::Separator();
+        for (const GpuProfiler::ScopeTiming &scope : frame.scopes) {
+            ImGui::Text("%*s%s", scope.depth * 2, "", scope.name); ImGui::NextColumn();
+            ImGui::Text("%.3f", scope.cpuMilliseconds); ImGui::NextColumn();
+            ImGui::Text("%.3f", scope.gpuMilliseconds); ImGui::NextColumn();
+        }
+        ImGui::Columns(1);
+    }
+
+    static char csvPath[256] = "gpu_profile.csv";
+    static const char *exportStatus = "";
+    ImGui::InputText("##csv", csvPath, sizeof(csvPath));
+    ImGui::SameLine();
+    if (ImGui::Button("export CSV"))
+        exportStatus = profiler.writeCsv(csvPath) ? "written" : "could not write the file";
+    ImGui::SameLine();
+    ImGui::Text("%s", exportStatus);
+
+    ImGui::End();
+}
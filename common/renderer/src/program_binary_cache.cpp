@@ -0,0 +1,191 @@
+#include <renderer/program_binary_cache.h>
+#include <renderer/gl_extensions.h>
+
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#ifdef _WIN32
+#include <direct.h>
+#else
+#include <sys/stat.h>
+#endif
+
+
+#ifndef GL_PROGRAM_BINARY_RETRIEVABLE_HINT
+#define GL_PROGRAM_BINARY_RETRIEVABLE_HINT 0x8257
+#endif
+#ifndef GL_NUM_PROGRAM_BINARY_FORMATS
+#define GL_NUM_PROGRAM_BINARY_FORMATS 0x87FE
+#endif
+
+namespace {
+
+// file layout: header, driver string, binary
+const char MAGIC[8] = {'G', 'L', 'P', 'B', 'I', 'N', '0', '1'};
+
+struct FileHeader {
+    char magic[8];
+    std::uint64_t sourceHash;
+    std::uint32_t binaryFormat;
+    std::uint32_t driverLength;
+    std::uint32_t binaryLength;
+};
+
+std::uint64_t fnv1a(const void *data, size_t size, std::uint64_t hash = 14695981039346656037ull){
+    const unsigned char *bytes = (const unsigned char *) data;
+    for (size_t i = 0; i < size; i++) {
+        hash ^= bytes[i];
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+std::string glString(GLenum name){
+    const GLubyte *value = glGetString(name);
+    return value ? (const char *) value : "";
+}
+
+} // namespace
+
+
+ProgramBinaryCache::ProgramBinaryCache(const std::string &directory, GLADloadproc load)
+: directory(directory){
+#ifdef _WIN32
+    _mkdir(directory.c_str());
+#else
+    mkdir(directory.c_str(), 0755);
+#endif
+
+    GLint major = 0, minor = 0;
+    glGetIntegerv(GL_MAJOR_VERSION, &major);
+    glGetIntegerv(GL_MINOR_VERSION, &minor);
+    driver = glString(GL_VENDOR) + "|" + glString(GL_RENDERER) + "|" + glString(GL_VERSION) + "|" +
+             std::to_string(major) + "." + std::to_string(minor);
+
+    bool available = major > 4 || (major == 4 && minor >= 1) || hasGLExtension("GL_ARB_get_program_binary");
+
+    GLint formatCount = 0;
+    if (available) {
+        getProgramBinary = (PFNPROGRAMBINARYCACHEGETPROC) load("glGetProgramBinary");
+        programBinary = (PFNPROGRAMBINARYCACHELOADPROC) load("glProgramBinary");
+        programParameteri = (PFNPROGRAMBINARYCACHEPARAMETERIPROC) load("glProgramParameteri");
+        glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formatCount);
+    }
+    // a driver may support the functions but no format to save binaries in
+    supported = getProgramBinary && programBinary && programParameteri && formatCount > 0;
+}
+
+
+GLuint ProgramBinaryCache::load(const char *vertexSource, const char *fragmentSource){
+    if (!supported) {
+        ++missCount;
+        return 0;
+    }
+
+    std::uint64_t hash = sourceHash(vertexSource, fragmentSource);
+    std::string file = path(hash);
+    FILE *in = std::fopen(file.c_str(), "rb");
+    if (!in) {
+        ++missCount;
+        return 0;
+    }
+
+    FileHeader header;
+    std::string fileDriver;
+    std::vector<char> binary;
+    bool valid = std::fread(&header, sizeof(header), 1, in) == 1 &&
+                 std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) == 0 && header.sourceHash == hash;
+    if (valid) {
+        fileDriver.resize(header.driverLength);
+        binary.resize(header.binaryLength);
+        valid = std::fread(&fileDriver[0], 1, fileDriver.size(), in) == fileDriver.size() &&
+                std::fread(binary.data(), 1, binary.size(), in) == binary.size() &&
+                fileDriver == driver && !binary.empty();
+    }
+    std::fclose(in);
+
+    GLuint program = 0;
+    if (valid) {
+        program = glCreateProgram();
+        programBinary(program, header.binaryFormat, binary.data(), (GLsizei) binary.size());
+        // the driver may still refuse it (e.g. after an update that kept the version string)
+        GLint linked = GL_FALSE;
+        glGetProgramiv(program, GL_LINK_STATUS, &linked);
+        if (!linked) {
+            glDeleteProgram(program);
+            program = 0;
+        }
+    }
+
+    if (!program) {
+        std::remove(file.c_str());
+        ++invalidatedCount;
+        ++missCount;
+        return 0;
+    }
+    ++hitCount;
+    return program;
+}
+
+
+void ProgramBinaryCache::prepare(GLuint program){
+    if (supported)
+        programParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+}
+
+
+void ProgramBinaryCache::store(const char *vertexSource, const char *fragmentSource, GLuint program){
+    if (!supported)
+        return;
+
+    GLint length = 0;
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0)
+        return;
+    std::vector<char> binary(length);
+    GLenum binaryFormat = 0;
+    GLsizei written = 0;
+    getProgramBinary(program, length, &written, &binaryFormat, binary.data());
+    if (written <= 0)
+        return;
+
+    FileHeader header;
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.sourceHash = sourceHash(vertexSource, fragmentSource);
+    header.binaryFormat = binaryFormat;
+    header.driverLength = (std::uint32_t) driver.size();
+    header.binaryLength = (std::uint32_t) written;
+
+    // write next to the final file and rename, so a crash never leaves half a binary behind
+    std::string file = path(header.sourceHash);
+    std::string temporary = file + ".tmp";
+    FILE *out = std::fopen(temporary.c_str(), "wb");
+    if (!out)
+        return;
+    bool ok = std::fwrite(&header, sizeof(header), 1, out) == 1 &&
+              std::fwrite(driver.data(), 1, driver.size(), out) == driver.size() &&
+              std::fwrite(binary.data(), 1, written, out) == (size_t) written;
+    ok = std::fclose(out) == 0 && ok;
+    if (ok) {
+        std::remove(file.c_str());
+        ok = std::rename(temporary.c_str(), file.c_str()) == 0;
+    }
+    if (!ok)
+        std::remove(temporary.c_str());
+}
+
+
+std::uint64_t ProgramBinaryCache::sourceHash(const char *vertexSource, const char *fragmentSource) const{
+    // the terminating zeros keep "ab" + "c" apart from "a" + "bc"
+    std::uint64_t hash = fnv1a(vertexSource, std::strlen(vertexSource) + 1);
+    hash = fnv1a(fragmentSource, std::strlen(fragmentSource) + 1, hash);
+    return fnv1a(driver.data(), driver.size(), hash);
+}
+
+
+std::string ProgramBinaryCache::path(std::uint64_t hash) const{
+    char name[32];
+    std::snprintf(name, sizeof(name), "%016llx.bin", (unsigned long long) hash);
+    return directory + "/" + name;
+}
@@ -0,0 +1,166 @@
+#include <renderer/shader_manager.h>
+#include <renderer/gl_extensions.h>
+#include <renderer/program_binary_cache.h>
+
+
+#ifndef GL_COMPLETION_STATUS_KHR
+#define GL_COMPLETION_STATUS_KHR 0x91B1
+#endif
+
+namespace {
+
+// drawn instead of programs that are not ready: attribute 0 as the position, in magenta
+const char *placeholderVertexSource = "#version 330 core\n"
+    "layout (location = 0) in vec3 aPos;\n"
+    "void main()\n"
+    "{\n"
+    "   gl_Position = vec4(aPos, 1.0);\n"
+    "}\0";
+const char *placeholderFragmentSource = "#version 330 core\n"
+    "out vec4 FragColor;\n"
+    "void main()\n"
+    "{\n"
+    "   FragColor = vec4(1.0f, 0.0f, 1.0f, 1.0f);\n"
+    "}\n\0";
+
+} // namespace
+
+
+ShaderManager::ShaderManager(GLADloadproc load, ProgramBinaryCache *cache)
+: cache(cache), fallback(placeholderVertexSource, placeholderFragmentSource){
+    PFNSHADERMANAGERMAXTHREADSPROC maxShaderCompilerThreads = nullptr;
+    if (hasGLExtension("GL_KHR_parallel_shader_compile"))
+        maxShaderCompilerThreads = (PFNSHADERMANAGERMAXTHREADSPROC) load("glMaxShaderCompilerThreadsKHR");
+    else if (hasGLExtension("GL_ARB_parallel_shader_compile"))
+        maxShaderCompilerThreads = (PFNSHADERMANAGERMAXTHREADSPROC) load("glMaxShaderCompilerThreadsARB");
+    parallel = maxShaderCompilerThreads != nullptr;
+    // the default count is implementation defined, 0xFFFFFFFF lets the driver use as many as it likes
+    if (parallel)
+        maxShaderCompilerThreads(0xFFFFFFFFu);
+}
+
+
+ShaderManager::~ShaderManager(){
+    for (Entry &entry : entries)
+        release(entry);
+}
+
+
+ShaderManager::Handle ShaderManager::submit(const char *vertexSource, const char *fragmentSource){
+    entries.emplace_back();
+    Entry &entry = entries.back();
+
+    // a cached binary is ready right away
+    if (cache) {
+        GLuint program = cache->load(vertexSource, fragmentSource);
+        if (program) {
+            entry.program = ShaderProgram(program);
+            entry.state = READY;
+            return entries.size() - 1;
+        }
+    }
+
+    entry.vertexSource = vertexSource;
+    entry.fragmentSource = fragmentSource;
+
+    const char *vertex = entry.vertexSource.c_str();
+    const char *fragment = entry.fragmentSource.c_str();
+    entry.vertexShader = glCreateShader(GL_VERTEX_SHADER);
+    glShaderSource(entry.vertexShader, 1, &vertex, NULL);
+    glCompileShader(entry.vertexShader);
+    entry.fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
+    glShaderSource(entry.fragmentShader, 1, &fragment, NULL);
+    glCompileShader(entry.fragmentShader);
+
+    // linking does not need the compile status, a failed compile just fails the link
+    entry.building = glCreateProgram();
+    glAttachShader(entry.building, entry.vertexShader);
+    glAttachShader(entry.building, entry.fragmentShader);
+    if (cache)
+        cache->prepare(entry.building);
+    glLinkProgram(entry.building);
+
+    ++pending;
+    return entries.size() - 1;
+}
+
+
+size_t ShaderManager::poll(size_t budget){
+    size_t finished = 0;
+    for (Entry &entry : entries) {
+        if (entry.state != BUILDING)
+            continue;
+        if (parallel) {
+            GLint done = GL_FALSE;
+            glGetProgramiv(entry.building, GL_COMPLETION_STATUS_KHR, &done);
+            if (!done)
+                continue;
+        } else if (finished >= budget) {
+            break;
+        }
+        finish(entry);
+        ++finished;
+    }
+    return finished;
+}
+
+
+void ShaderManager::finishAll(){
+    for (Entry &entry : entries)
+        if (entry.state == BUILDING)
+            finish(entry);
+}
+
+
+const ShaderProgram &ShaderManager::program(Handle handle) const{
+    const Entry &entry = entries[handle];
+    return entry.state == READY ? entry.program : fallback;
+}
+
+
+void ShaderManager::finish(Entry &entry){
+    GLint linked = GL_FALSE;
+    glGetProgramiv(entry.building, GL_LINK_STATUS, &linked);
+    glDetachShader(entry.building, entry.vertexShader);
+    glDetachShader(entry.building, entry.fragmentShader);
+    if (linked) {
+        if (cache)
+            cache->store(entry.vertexSource.c_str(), entry.fragmentSource.c_str(), entry.building);
+        entry.program = ShaderProgram(entry.building);
+        entry.state = READY;
+    } else {
+        // the compile logs say more than the link log when a shader is at fault
+        GLint compiled = GL_FALSE;
+        glGetShaderiv(entry.vertexShader, GL_COMPILE_STATUS, &compiled);
+        if (!compiled)
+            printShaderInfoLog(entry.vertexShader, "VERTEX");
+        glGetShaderiv(entry.fragmentShader, GL_COMPILE_STATUS, &compiled);
+        if (!compiled)
+            printShaderInfoLog(entry.fragmentShader, "FRAGMENT");
+        printProgramInfoLog(entry.building);
+        glDeleteProgram(entry.building);
+        entry.state = FAILED;
+    }
+    entry.building = 0;
+
+    // the program keeps what it needs, the shader objects can go
+    glDeleteShader(entry.vertexShader);
+    glDeleteShader(entry.fragmentShader);
+    entry.vertexShader = 0;
+    entry.fragmentShader = 0;
+    // the sources are only kept to store the binary
+    entry.vertexSource = std::string();
+    entry.fragmentSource = std::string();
+    --pending;
+}
+
+
+void ShaderManager::release(Entry &entry){
+    // the ready programs are deleted by their ShaderProgram
+    if (entry.building)
+        glDeleteProgram(entry.building);
+    if (entry.vertexShader)
+        glDeleteShader(entry.vertexShader);
+    if (entry.fragmentShader)
+        glDeleteShader(entry.fragmentShader);
+}
@@ -0,0 +1,185 @@
+#include <renderer/shader_program.h>
+#include <renderer/gl_state.h>
+#include <renderer/program_binary_cache.h>
+
+#include <glm/gtc/type_ptr.hpp>
+
+#include <iostream>
+#include <vector>
+
+
+// compile a shader of the given type, print the whole info log if it fails
+// ------------------------------------------------------------------------
+static GLuint compileShader(GLenum type, const char *source, const char *typeName){
+    GLuint shader = glCreateShader(type);
+    glShaderSource(shader, 1, &source, NULL);
+    glCompileShader(shader);
+
+    int success;
+    glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
+    if (!success)
+        printShaderInfoLog(shader, typeName);
+    return shader;
+}
+
+
+void printShaderInfoLog(GLuint shader, const char *typeName){
+    int logLength = 0;
+    glGetShaderiv(shader, GL_INFO_LOG_LENGTH, &logLength);
+    std::vector<char> infoLog(logLength > 0 ? logLength : 1, '\0');
+    glGetShaderInfoLog(shader, (GLsizei) infoLog.size(), NULL, infoLog.data());
+    std::cout << "ERROR::SHADER::" << typeName << "::COMPILATION_FAILED\n" << infoLog.data() << std::endl;
+}
+
+
+void printProgramInfoLog(GLuint program){
+    int logLength = 0;
+    glGetProgramiv(program, GL_INFO_LOG_LENGTH, &logLength);
+    std::vector<char> infoLog(logLength > 0 ? logLength : 1, '\0');
+    glGetProgramInfoLog(program, (GLsizei) infoLog.size(), NULL, infoLog.data());
+    std::cout << "ERROR::SHADER::PROGRAM::LINKING_FAILED\n" << infoLog.data() << std::endl;
+}
+
+
+ShaderProgram::ShaderProgram(const char *vertexSource, const char *fragmentSource){
+    build(vertexSource, fragmentSource, nullptr);
+}
+
+
+ShaderProgram::ShaderProgram(const char *vertexSource, const char *fragmentSource, ProgramBinaryCache &cache){
+    program = cache.load(vertexSource, fragmentSource);
+    if (program)
+        linked = true;
+    else
+        build(vertexSource, fragmentSource, &cache);
+}
+
+
+ShaderProgram::ShaderProgram(GLuint linkedProgram)
+: program(linkedProgram), linked(linkedProgram != 0){
+}
+
+
+ShaderProgram::~ShaderProgram(){
+    release();
+}
+
+
+void ShaderProgram::build(const char *vertexSource, const char *fragmentSource, ProgramBinaryCache *cache){
+    GLuint vertexShader = compileShader(GL_VERTEX_SHADER, vertexSource, "VERTEX");
+    GLuint fragmentShader = compileShader(GL_FRAGMENT_SHADER, fragmentSource, "FRAGMENT");
+
+    program = glCreateProgram();
+    glAttachShader(program, vertexShader);
+    glAttachShader(program, fragmentShader);
+    if (cache)
+        cache->prepare(program);
+    glLinkProgram(program);
+
+    int success;
+    glGetProgramiv(program, GL_LINK_STATUS, &success);
+    linked = success != 0;
+    if (!linked)
+        printProgramInfoLog(program);
+
+    // the program keeps what it needs, the shader objects can go
+    glDetachShader(program, vertexShader);
+    glDetachShader(program, fragmentShader);
+    glDeleteShader(vertexShader);
+    glDeleteShader(fragmentShader);
+
+    if (cache && linked)
+        cache->store(vertexSource, fragmentSource, program);
+}
+
+
+ShaderProgram::ShaderProgram(ShaderProgram &&other) noexcept
+: program(other.program), linked(other.linked),
+  attributeLocations(std::move(other.attributeLocations)), uniformLocations(std::move(other.uniformLocations)){
+    other.program = 0;
+    other.linked = false;
+}
+
+
+ShaderProgram &ShaderProgram::operator=(ShaderProgram &&other) noexcept{
+    if (this != &other) {
+        release();
+        program = other.program;
+        linked = other.linked;
+        attributeLocations = std::move(other.attributeLocations);
+        uniformLocations = std::move(other.uniformLocations);
+        other.program = 0;
+        other.linked = false;
+    }
+    return *this;
+}
+
+
+void ShaderProgram::use() const{
+    GLState::current().useProgram(program);
+}
+
+
+GLint ShaderProgram::attributeLocation(const std::string &name) const{
+    auto it = attributeLocations.find(name);
+    if (it != attributeLocations.end())
+        return it->second;
+    GLint location = glGetAttribLocation(program, name.c_str());
+    attributeLocations.emplace(name, location);
+    return location;
+}
+
+
+GLint ShaderProgram::uniformLocation(const std::string &name) const{
+    auto it = uniformLocations.find(name);
+    if (it != uniformLocations.end())
+        return it->second;
+    GLint location = glGetUniformLocation(program, name.c_str());
+    uniformLocations.emplace(name, location);
+    return location;
+}
+
+
+void ShaderProgram::setInt(const std::string &name, int value) const{
+    use();
+    glUniform1i(uniformLocation(name), value);
+}
+
+
+void ShaderProgram::setFloat(const std::string &name, float value) const{
+    use();
+    glUniform1f(uniformLocation(name), value);
+}
+
+
+void ShaderProgram::setVec2(const std::string &name, const glm::vec2 &value) const{
+    use();
+    glUniform2fv(uniformLocation(name), 1, glm::value_ptr(value));
+}
+
+
+void ShaderProgram::setVec3(const std::string &name, const glm::vec3 &value) const{
+    use();
+    glUniform3fv(uniformLocation(name), 1, glm::value_ptr(value));
+}
+
+
+void ShaderProgram::setVec4(const std::string &name, const glm::vec4 &value) const{
+    use();
+    glUniform4fv(uniformLocation(name), 1, glm::value_ptr(value));
+}
+
+
+void ShaderProgram::setMat4(const std::string &name, const glm::mat4 &value) const{
+    use();
+    glUniformMatrix4fv(uniformLocation(name), 1, GL_FALSE, glm::value_ptr(value));
+}
+
+
+void ShaderProgram::release(){
+    if (program) {
+        GLState::current().programDeleted(program);
+        glDeleteProgram(program);
+        program = 0;
+    }
+}
@@ -0,0 +1,152 @@
+#include <renderer/shape_batch.h>
+
+#include <glm/gtc/constants.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+
+
+namespace {
+
+// the per-instance attributes have fixed locations, set with setAttribute(location, ...)
+const char *shapeVertexSource = "#version 330 core\n"
+    "layout (location = 0) in vec2 aPos;\n"
+    "layout (location = 1) in vec2 iPosition;\n"
+    "layout (location = 2) in vec2 iScale;\n"
+    "layout (location = 3) in float iRotation;\n"
+    "layout (location = 4) in vec4 iColor;\n"
+    "uniform mat4 projection;\n"
+    "out vec4 vtxColor;\n"
+    "void main()\n"
+    "{\n"
+    "   float c = cos(iRotation), s = sin(iRotation);\n"
+    "   vec2 pos = aPos * iScale;\n"
+    "   pos = vec2(c * pos.x - s * pos.y, s * pos.x + c * pos.y) + iPosition;\n"
+    "   gl_Position = projection * vec4(pos, 0.0, 1.0);\n"
+    "   vtxColor = iColor;\n"
+    "}\0";
+const char *shapeFragmentSource = "#version 330 core\n"
+    "out vec4 FragColor;\n"
+    "in  vec4 vtxColor;\n"
+    "void main()\n"
+    "{\n"
+    "   FragColor = vtxColor;\n"
+    "}\n\0";
+
+// the circle's vertices (its center and ring) come before the 4 of the square and the 4 of the triangle,
+// all indexed with GLushort
+const int maxCircleSegments = 65536 - 1 - 4 - 4;
+
+// a fan around the center of sides vertices on the circle of radius 0.5, starting at angle
+// ----------------------------------------------------------------------------------------
+void addPolygon(int sides, float angle, std::vector<float> &vertexData, std::vector<GLushort> &vertexIndices){
+    GLushort center = (GLushort) (vertexData.size() / 2);
+    vertexData.push_back(0.0f);
+    vertexData.push_back(0.0f);
+    float angleInterval = 2 * glm::pi<float>() / (float) sides;
+    for (int i = 0; i < sides; i++) {
+        vertexData.push_back(std::cos(angle + i * angleInterval) / 2);
+        vertexData.push_back(std::sin(angle + i * angleInterval) / 2);
+    }
+    for (int i = 0; i < sides; i++) {
+        vertexIndices.push_back(center);
+        vertexIndices.push_back((GLushort) (center + 1 + i));
+        vertexIndices.push_back((GLushort) (center + 1 + (i + 1) % sides));
+    }
+}
+
+} // namespace
+
+
+ShapeBatch::ShapeBatch(int circleSegments)
+: shaderProgram(shapeVertexSource, shapeFragmentSource), indices(GL_ELEMENT_ARRAY_BUFFER){
+    std::vector<float> vertexData;
+    std::vector<GLushort> vertexIndices;
+
+    // fewer than 3 is no polygon, more would wrap the indices
+    circleSegments = std::min(std::max(circleSegments, 3), maxCircleSegments);
+
+    // the unit meshes one after the other
+    meshes[CIRCLE].firstIndex = (GLsizei) vertexIndices.size();
+    addPolygon(circleSegments, 0.0f, vertexData, vertexIndices);
+    meshes[CIRCLE].indexCount = (GLsizei) vertexIndices.size() - meshes[CIRCLE].firstIndex;
+
+    meshes[SQUARE].firstIndex = (GLsizei) vertexIndices.size();
+    GLushort corner = (GLushort) (vertexData.size() / 2);
+    const float squareCorners[] = {-.5f, -.5f, .5f, -.5f, .5f, .5f, -.5f, .5f};
+    vertexData.insert(vertexData.end(), squareCorners, squareCorners + 8);
+    const GLushort squareIndices[] = {0, 1, 2, 0, 2, 3};
+    for (GLushort index : squareIndices)
+        vertexIndices.push_back((GLushort) (corner + index));
+    meshes[SQUARE].indexCount = (GLsizei) vertexIndices.size() - meshes[SQUARE].firstIndex;
+
+    // pointing up, the fan around its center is only one triangle more
+    meshes[TRIANGLE].firstIndex = (GLsizei) vertexIndices.size();
+    addPolygon(3, glm::half_pi<float>(), vertexData, vertexIndices);
+    meshes[TRIANGLE].indexCount = (GLsizei) vertexIndices.size() - meshes[TRIANGLE].firstIndex;
+
+    vertices.setData(vertexData);
+    indices.setData(vertexIndices);
+
+    // every kind of shape reads the shared mesh and its own instances
+    const GLsizei stride = sizeof(Instance);
+    for (int shape = 0; shape < SHAPE_COUNT; shape++) {
+        VertexArray &vertexArray = vertexArrays[shape];
+        const Buffer &instanceBuffer = instanceBuffers[shape];
+        vertexArray.setAttribute(0, vertices, 2);
+        vertexArray.setAttribute(1, instanceBuffer, 2, GL_FLOAT, false, stride, offsetof(Instance, position));
+        vertexArray.setAttribute(2, instanceBuffer, 2, GL_FLOAT, false, stride, offsetof(Instance, scale));
+        vertexArray.setAttribute(3, instanceBuffer, 1, GL_FLOAT, false, stride, offsetof(Instance, rotation));
+        vertexArray.setAttribute(4, instanceBuffer, 4, GL_UNSIGNED_BYTE, true, stride, offsetof(Instance, color));
+        for (GLint location = 1; location <= 4; location++)
+            vertexArray.setAttributeDivisor(location, 1);
+        vertexArray.setElementBuffer(indices, GL_UNSIGNED_SHORT);
+    }
+}
+
+
+void ShapeBatch::clear(){
+    for (std::vector<Instance> &shapeInstances : instances)
+        shapeInstances.clear();
+}
+
+
+void ShapeBatch::add(Shape shape, const glm::vec2 &position, const glm::vec2 &scale, float rotation,
+                     const glm::vec4 &color){
+    glm::vec4 bytes = glm::clamp(color, 0.0f, 1.0f) * 255.0f + 0.5f;
+    Instance instance;
+    instance.position = position;
+    instance.scale = scale;
+    instance.rotation = rotation;
+    for (int i = 0; i < 4; i++)
+        instance.color[i] = (GLubyte) bytes[i];
+    instances[shape].push_back(instance);
+}
+
+
+size_t ShapeBatch::size() const{
+    size_t count = 0;
+    for (const std::vector<Instance> &shapeInstances : instances)
+        count += shapeInstances.size();
+    return count;
+}
+
+
+void ShapeBatch::draw(const glm::mat4 &projection){
+    drawCount = 0;
+    if (size() == 0)
+        return;
+
+    shaderProgram.setMat4("projection", projection);
+    for (int shape = 0; shape < SHAPE_COUNT; shape++) {
+        if (instances[shape].empty())
+            continue;
+        // glBufferData with new storage every frame: the driver hands out a fresh block instead of waiting
+        // for the draws of the previous frame still reading the old one
+        instanceBuffers[shape].setData(instances[shape], GL_STREAM_DRAW);
+        vertexArrays[shape].drawElementsInstanced(GL_TRIANGLES, meshes[shape].indexCount,
+                                                  (GLsizei) instances[shape].size(), meshes[shape].firstIndex);
+        ++drawCount;
+    }
+}
@@ -0,0 +1,3 @@
+// the one translation unit with the stb_image implementation
+#define STB_IMAGE_IMPLEMENTATION
+#include <stb_image.h>
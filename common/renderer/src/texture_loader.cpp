@@ -0,0 +1,338 @@
+#include <renderer/texture_loader.h>
+#include <renderer/gl_state.h>
+
+#include <stb_image.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <iostream>
+
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+double millisecondsSince(Clock::time_point start){
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+bool readFile(const std::string &path, std::vector<unsigned char> &contents){
+    FILE *file = std::fopen(path.c_str(), "rb");
+    if (!file)
+        return false;
+    std::fseek(file, 0, SEEK_END);
+    long size = std::ftell(file);
+    std::fseek(file, 0, SEEK_SET);
+    contents.resize(size > 0 ? (size_t) size : 0);
+    bool succeeded = size > 0 && std::fread(contents.data(), 1, contents.size(), file) == contents.size();
+    std::fclose(file);
+    return succeeded;
+}
+
+// pixel format and internal format by channel count, grey (and alpha) are swizzled back to rgb(a)
+const GLenum pixelFormats[] = {0, GL_RED, GL_RG, GL_RGB, GL_RGBA};
+const GLint internalFormats[] = {0, GL_R8, GL_RG8, GL_RGB8, GL_RGBA8};
+
+} // namespace
+
+
+TextureLoader::TextureLoader(unsigned workerCount, size_t uploadBudget)
+: uploadBudget(uploadBudget), staging(GL_PIXEL_UNPACK_BUFFER), created(Clock::now()){
+    if (workerCount == 0)
+        workerCount = std::max(1u, std::thread::hardware_concurrency());
+    parallelDecode = workerCount > 1;
+    for (unsigned i = 0; i < workerCount; i++)
+        workers.emplace_back(&TextureLoader::work, this);
+}
+
+
+TextureLoader::~TextureLoader(){
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    jobAdded.notify_all();
+    for (std::thread &worker : workers)
+        worker.join();
+
+    for (Decoded &image : decoded)
+        stbi_image_free(image.pixels);
+    for (Decoded &image : uploads)
+        stbi_image_free(image.pixels);
+    for (Entry &entry : entries)
+        if (entry.id)
+            glDeleteTextures(1, &entry.id);
+    for (auto &placeholder : placeholders)
+        glDeleteTextures(1, &placeholder.second);
+}
+
+
+TextureLoader::Handle TextureLoader::load(const std::string &path, const Options &options){
+    Entry entry;
+    entry.path = path;
+    entry.options = options;
+    entry.placeholder = placeholderTexture(options.placeholder);
+    entries.push_back(entry);
+    Handle handle = entries.size() - 1;
+    ++stats.requested;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        jobs.push_back(Job{handle, path, options.flipVertically});
+    }
+    jobAdded.notify_one();
+    return handle;
+}
+
+
+size_t TextureLoader::update(){
+    Clock::time_point start = Clock::now();
+    size_t finishedCount = 0;
+
+    std::vector<Decoded> arrived;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        arrived.swap(decoded);
+        stats.readMilliseconds = readTotal;
+        stats.decodeMilliseconds = decodeTotal;
+    }
+    for (Decoded &image : arrived) {
+        Entry &entry = entries[image.handle];
+        if (image.pixels) {
+            entry.state = UPLOADING;
+            uploads.push_back(image);
+        } else {
+            std::cout << "ERROR::TEXTURE::LOADING_FAILED\n" << entry.path << ": " << image.failure << std::endl;
+            finish(entry, false);
+            ++finishedCount;
+        }
+    }
+    if (uploads.empty())
+        return finishedCount;
+
+    GLint boundTexture = 0;
+    glGetIntegerv(GL_TEXTURE_BINDING_2D, &boundTexture);
+    size_t remaining = uploadBudget;
+    while (!uploads.empty() && remaining > 0) {
+        bool finished = false;
+        remaining -= std::min(remaining, upload(remaining, finished));
+        if (finished)
+            ++finishedCount;
+    }
+    // the unpack buffer would turn the pointer of every later glTexImage2D into an offset
+    GLState::current().bindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    glBindTexture(GL_TEXTURE_2D, boundTexture);
+
+    stats.uploadMilliseconds += millisecondsSince(start);
+    return finishedCount;
+}
+
+
+void TextureLoader::finishAll(){
+    while (pendingCount() > 0) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            decodeFinished.wait(lock, [this](){ return !decoded.empty() || !uploads.empty(); });
+        }
+        size_t budget = uploadBudget;
+        uploadBudget = SIZE_MAX;
+        update();
+        uploadBudget = budget;
+    }
+}
+
+
+GLuint TextureLoader::texture(Handle handle) const{
+    const Entry &entry = entries[handle];
+    return entry.state == READY ? entry.id : entry.placeholder;
+}
+
+
+void TextureLoader::work(){
+    for (;;) {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            jobAdded.wait(lock, [this](){ return stopping || !jobs.empty() || !batches.empty(); });
+            if (stopping)
+                return;
+            // help with an image already being decoded before starting on another one
+            if (!batches.empty()) {
+                runBatchTask(lock);
+                continue;
+            }
+            job = jobs.front();
+            jobs.pop_front();
+        }
+        decode(job);
+    }
+}
+
+
+void TextureLoader::runParallel(void *loader, stbi_parallel_task *task, void *data, int count){
+    TextureLoader *self = static_cast<TextureLoader *>(loader);
+    Batch batch;
+    batch.task = task;
+    batch.data = data;
+    batch.count = count;
+
+    std::unique_lock<std::mutex> lock(self->mutex);
+    self->batches.push_back(&batch);
+    self->jobAdded.notify_all();
+    while (batch.claimed < batch.count)
+        self->runBatchTask(lock);
+    self->batchFinished.wait(lock, [&batch](){ return batch.finished == batch.count; });
+}
+
+
+void TextureLoader::runBatchTask(std::unique_lock<std::mutex> &lock){
+    Batch *batch = batches.front();
+    int index = batch->claimed++;
+    if (batch->claimed == batch->count)
+        batches.pop_front();
+
+    lock.unlock();
+    batch->task(batch->data, index);
+    lock.lock();
+
+    if (++batch->finished == batch->count)
+        batchFinished.notify_all();
+}
+
+
+void TextureLoader::decode(const Job &job){
+    Decoded image{job.handle, nullptr, 0, 0, 0, std::string()};
+
+    Clock::time_point start = Clock::now();
+    std::vector<unsigned char> contents;
+    bool read = readFile(job.path, contents);
+    double readTime = millisecondsSince(start);
+
+    start = Clock::now();
+    if (read) {
+        stbi_options options;
+        stbi_options_init(&options);
+        options.flip_vertically = job.flipVertically;
+        if (parallelDecode) {
+            options.parallel_for = &TextureLoader::runParallel;
+            options.parallel_user = this;
+        }
+        image.pixels = stbi_load_from_memory_ex(&options, contents.data(), (int) contents.size(), &image.width,
+                                                &image.height, &image.channels, 0);
+        if (!image.pixels)
+            image.failure = options.failure_reason ? options.failure_reason : "unknown error";
+        else if (image.channels < 1 || image.channels > 4) {
+            stbi_image_free(image.pixels);
+            image.pixels = nullptr;
+            image.failure = "unsupported channel count";
+        }
+    } else
+        image.failure = "cannot read the file";
+    double decodeTime = millisecondsSince(start);
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        decoded.push_back(image);
+        readTotal += readTime;
+        decodeTotal += decodeTime;
+    }
+    decodeFinished.notify_all();
+}
+
+
+size_t TextureLoader::upload(size_t budget, bool &finished){
+    Decoded &image = uploads.front();
+    Entry &entry = entries[image.handle];
+    GLenum format = pixelFormats[image.channels];
+    size_t rowSize = (size_t) image.width * image.channels;
+
+    if (uploadedRows == 0) {
+        // allocate only, with nothing bound to read from
+        GLState::current().bindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        glGenTextures(1, &entry.id);
+        glBindTexture(GL_TEXTURE_2D, entry.id);
+        glTexImage2D(GL_TEXTURE_2D, 0, internalFormats[image.channels], image.width, image.height, 0, format,
+                     GL_UNSIGNED_BYTE, nullptr);
+        if (image.channels <= 2) {
+            GLint alpha = image.channels == 2 ? GL_GREEN : GL_ONE;
+            const GLint swizzle[] = {GL_RED, GL_RED, GL_RED, alpha};
+            glTexParameteriv(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_RGBA, swizzle);
+        }
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+        GLint minFilter = entry.options.mipmaps ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR;
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, minFilter);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    } else
+        glBindTexture(GL_TEXTURE_2D, entry.id);
+
+    // as many whole rows as the budget allows, but at least one so that every update makes progress
+    int rows = (int) std::max<size_t>(1, std::min<size_t>(budget / rowSize, image.height - uploadedRows));
+    size_t size = rows * rowSize;
+
+    // new storage for every band: the driver does not have to wait for the previous copy out of it,
+    // and glTexSubImage2D reads from the buffer without stalling the render thread
+    staging.setData(image.pixels + uploadedRows * rowSize, size, GL_STREAM_DRAW);
+    staging.bind();
+    if (rowSize % 4 != 0)
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, uploadedRows, image.width, rows, format, GL_UNSIGNED_BYTE, nullptr);
+    if (rowSize % 4 != 0)
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    uploadedRows += rows;
+    stats.uploadedBytes += size;
+
+    finished = uploadedRows == image.height;
+    if (finished) {
+        if (entry.options.mipmaps)
+            glGenerateMipmap(GL_TEXTURE_2D);
+        stbi_image_free(image.pixels);
+        uploads.pop_front();
+        uploadedRows = 0;
+        finish(entry, true);
+    }
+    return size;
+}
+
+
+void TextureLoader::finish(Entry &entry, bool succeeded){
+    entry.state = succeeded ? READY : FAILED;
+    if (succeeded) {
+        ++stats.ready;
+        if (stats.ready == 1)
+            stats.firstReadyMilliseconds = elapsed();
+    } else
+        ++stats.failed;
+    if (pendingCount() == 0)
+        stats.allReadyMilliseconds = elapsed();
+}
+
+
+GLuint TextureLoader::placeholderTexture(const glm::vec4 &color){
+    glm::vec4 bytes = glm::clamp(color, 0.0f, 1.0f) * 255.0f + 0.5f;
+    GLubyte pixel[4];
+    for (int i = 0; i < 4; i++)
+        pixel[i] = (GLubyte) bytes[i];
+    unsigned key = pixel[0] | pixel[1] << 8 | pixel[2] << 16 | (unsigned) pixel[3] << 24;
+    auto it = placeholders.find(key);
+    if (it != placeholders.end())
+        return it->second;
+
+    GLint boundTexture = 0;
+    glGetIntegerv(GL_TEXTURE_BINDING_2D, &boundTexture);
+    GLuint id;
+    glGenTextures(1, &id);
+    glBindTexture(GL_TEXTURE_2D, id);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixel);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glBindTexture(GL_TEXTURE_2D, boundTexture);
+    placeholders[key] = id;
+    return id;
+}
+
+
+double TextureLoader::elapsed() const{
+    return millisecondsSince(created);
+}
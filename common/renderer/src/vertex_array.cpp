@@ -0,0 +1,100 @@
+#include <renderer/vertex_array.h>
+#include <renderer/gl_state.h>
+
+
+VertexArray::VertexArray(){
+    glGenVertexArrays(1, &VAO);
+}
+
+
+VertexArray::~VertexArray(){
+    release();
+}
+
+
+VertexArray::VertexArray(VertexArray &&other) noexcept
+: VAO(other.VAO), indexType(other.indexType){
+    other.VAO = 0;
+}
+
+
+VertexArray &VertexArray::operator=(VertexArray &&other) noexcept{
+    if (this != &other) {
+        release();
+        VAO = other.VAO;
+        indexType = other.indexType;
+        other.VAO = 0;
+    }
+    return *this;
+}
+
+
+void VertexArray::bind() const{
+    GLState::current().bindVertexArray(VAO);
+}
+
+
+void VertexArray::setAttribute(GLint location, const Buffer &buffer, GLint size, GLenum type,
+                               bool normalized, GLsizei stride, GLintptr offset){
+    bind();
+    // glVertexAttribPointer records the buffer bound to GL_ARRAY_BUFFER, whatever the buffer's own target
+    GLState::current().bindBuffer(GL_ARRAY_BUFFER, buffer.id());
+    glEnableVertexAttribArray(location);
+    glVertexAttribPointer(location, size, type, normalized ? GL_TRUE : GL_FALSE, stride, (void *) offset);
+}
+
+
+bool VertexArray::setAttribute(const ShaderProgram &shaderProgram, const std::string &name, const Buffer &buffer,
+                               GLint size, GLenum type, bool normalized, GLsizei stride, GLintptr offset){
+    GLint location = shaderProgram.attributeLocation(name);
+    if (location < 0)
+        return false;
+    setAttribute(location, buffer, size, type, normalized, stride, offset);
+    return true;
+}
+
+
+void VertexArray::setAttributeDivisor(GLint location, GLuint divisor){
+    bind();
+    glVertexAttribDivisor(location, divisor);
+}
+
+
+void VertexArray::setElementBuffer(const Buffer &buffer, GLenum type){
+    bind();
+    GLState::current().bindBuffer(GL_ELEMENT_ARRAY_BUFFER, buffer.id());
+    indexType = type;
+}
+
+
+void VertexArray::draw(GLenum mode, GLint first, GLsizei count) const{
+    bind();
+    glDrawArrays(mode, first, count);
+}
+
+
+void VertexArray::drawElements(GLenum mode, GLsizei count, GLsizei first) const{
+    bind();
+    glDrawElements(mode, count, indexType, indexOffset(first));
+}
+
+
+void VertexArray::drawElementsInstanced(GLenum mode, GLsizei count, GLsizei instanceCount, GLsizei first) const{
+    bind();
+    glDrawElementsInstanced(mode, count, indexType, indexOffset(first), instanceCount);
+}
+
+
+void *VertexArray::indexOffset(GLsizei first) const{
+    GLsizei indexSize = indexType == GL_UNSIGNED_BYTE ? 1 : indexType == GL_UNSIGNED_SHORT ? 2 : 4;
+    return (void *) ((GLintptr) first * indexSize);
+}
+
+
+void VertexArray::release(){
+    if (VAO) {
+        GLState::current().vertexArrayDeleted(VAO);
+        glDeleteVertexArrays(1, &VAO);
+        VAO = 0;
+    }
+}
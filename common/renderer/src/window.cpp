@@ -0,0 +1,45 @@
+#include <renderer/window.h>
+#include <renderer/gl_state.h>
+
+#include <iostream>
+
+
+// make sure the viewport matches the new window dimensions; note that width and
+// height will be significantly larger than specified on retina displays.
+// -------------------------------------------------------------------------------
+static void framebufferSizeCallback(GLFWwindow* /*window*/, int width, int height){
+    GLState::current().viewport(0, 0, width, height);
+}
+
+
+GLFWwindow *createWindow(int width, int height, const char *title){
+    // glfw: initialize and configure
+    glfwInit();
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+#ifdef __APPLE__
+    glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
+#endif
+
+    // glfw window creation
+    GLFWwindow* window = glfwCreateWindow(width, height, title, NULL, NULL);
+    if (window == NULL) {
+        std::cout << "Failed to create GLFW window" << std::endl;
+        glfwTerminate();
+        return nullptr;
+    }
+    glfwMakeContextCurrent(window);
+    glfwSetFramebufferSizeCallback(window, framebufferSizeCallback);
+
+    // glad: load all OpenGL function pointers
+    if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress)) {
+        std::cout << "Failed to initialize GLAD" << std::endl;
+        glfwTerminate();
+        return nullptr;
+    }
+
+    // a fresh context, nothing the cache may have recorded before applies to it
+    GLState::current().invalidate();
+    return window;
+}
@@ -175,6 +175,58 @@
 //
 // ===========================================================================
 //
+// THREAD SAFETY:
+//
+//   stbi_failure_reason() and the stbi_set_* / stbi_convert_iphone_png_to_rgb
+//   settings are process globals. To decode on several threads at once, use
+//   the *_ex variants of the load and info functions: they take a
+//   stbi_options the caller owns (one per thread or per call), holding the
+//   settings and the failure reason of that call. The other entry points are
+//   wrappers that fill a stbi_options from the global settings.
+//   The failure reason reaches its stbi_options through a thread-local
+//   pointer (STBI_THREAD_LOCAL); without compiler support for one, the *_ex
+//   functions are only safe on one thread at a time.
+//
+//   A single JPEG decode can also use several threads: set parallel_for in
+//   its stbi_options to a function running tasks on the caller's thread pool.
+//   Baseline scans with restart intervals (DRI) are entropy decoded in runs
+//   of intervals, when the whole scan is in memory (the *_from_memory_ex
+//   functions), and the upsampling and color conversion of every JPEG run in
+//   bands of rows. The result is the same as decoding on one thread.
+//
+// ===========================================================================
+//
+// REGIONS AND SCALING:
+//
+//   The *_ex load functions can return a smaller image, for low mip levels
+//   and thumbnails: scale_log2 in their stbi_options divides both sizes by
+//   2, 4 or 8 (rounding up), and first_row / row_count pick a range of rows
+//   of that scaled image. *x and *y are the size actually returned, and the
+//   *_ex info functions report the same size.
+//
+//   JPEGs are scaled while decoding: a reduced IDCT turns each 8x8 block
+//   into 4x4, 2x2 or 1x1 pixels (only its lowest frequencies, 1x1 is the
+//   block average), so the intermediate buffers shrink as well. Blocks
+//   outside the rows are not transformed, and a baseline JPEG with a single
+//   scan stops decoding after the last one it needs. Every other format is
+//   decoded whole and then cut and scaled by averaging boxes of pixels
+//   (partial boxes at the right and bottom edges average what there is).
+//   stbi_load_gif_* ignore both settings.
+//
+// ===========================================================================
+//
+// CALLER-OWNED OUTPUT:
+//
+//   The 8-bit *_ex load functions can decode into a buffer of the caller,
+//   e.g. part of a mapped pixel buffer holding several images, instead of
+//   allocating the result: set output and output_size in their stbi_options.
+//   They then return output (never free it with stbi_image_free), or fail
+//   with "output too small" when the image does not fit. TGAs are decoded
+//   straight into it (unless converted to another channel count or cut to a
+//   region); the other formats are decoded as usual and copied there.
+//
+// ===========================================================================
+//
 // Philosophy
 //
 // stb libraries are designed with the following priorities:
@@ -433,7 +485,7 @@ extern "C" {
     
     
     // get a VERY brief reason for failure
-    // NOT THREADSAFE
+    // NOT THREADSAFE, the *_ex functions report it in their stbi_options
     STBIDEF const char *stbi_failure_reason  (void);
     
     // free the loaded image -- this is just free()
@@ -466,6 +518,67 @@ extern "C" {
     // flip the image vertically, so the first pixel in the output array is the bottom left
     STBIDEF void stbi_set_flip_vertically_on_load(int flag_true_if_should_flip);
     
+    ////////////////////////////////////
+    //
+    // reentrant interface (see THREAD SAFETY above)
+    //
+    
+    // runs task(task_data, 0) to task(task_data, count - 1) in any order, on any threads (the calling
+    // one included), and returns once all of them have
+    typedef void stbi_parallel_task(void *task_data, int index);
+    typedef void stbi_parallel_for(void *user, stbi_parallel_task *task, void *task_data, int count);
+    
+    typedef struct
+    {
+        int flip_vertically;         // as stbi_set_flip_vertically_on_load
+        int unpremultiply;           // as stbi_set_unpremultiply_on_load
+        int convert_iphone_png;      // as stbi_convert_iphone_png_to_rgb
+        const char *failure_reason;  // why the call failed, only meaningful when it did
+        // when set, JPEG decoding is split across parallel_for (see THREAD SAFETY), NULL decodes
+        // on the calling thread only
+        stbi_parallel_for *parallel_for;
+        void *parallel_user;         // passed to parallel_for
+        // decode at 1/2, 1/4 or 1/8 of the size (scale_log2 1 to 3) in each direction, rounding up,
+        // and return only the rows first_row to first_row + row_count - 1 of it (as stored, before
+        // flip_vertically; row_count 0 for all the rest). See REGIONS AND SCALING
+        int scale_log2;
+        int first_row, row_count;
+        // 8-bit loads only: decode into this buffer of output_size bytes instead of allocating the result
+        // (see CALLER-OWNED OUTPUT), NULL to allocate
+        stbi_uc *output;
+        size_t output_size;
+    } stbi_options;
+    
+    // every setting off, the defaults of the global ones
+    STBIDEF void     stbi_options_init         (stbi_options *options);
+    
+    STBIDEF stbi_uc *stbi_load_from_memory_ex    (stbi_options *options, stbi_uc const *buffer, int len, int *x, int *y, int *channels_in_file, int desired_channels);
+    STBIDEF stbi_uc *stbi_load_from_callbacks_ex (stbi_options *options, stbi_io_callbacks const *clbk, void *user, int *x, int *y, int *channels_in_file, int desired_channels);
+    STBIDEF stbi_us *stbi_load_16_from_memory_ex (stbi_options *options, stbi_uc const *buffer, int len, int *x, int *y, int *channels_in_file, int desired_channels);
+    STBIDEF stbi_us *stbi_load_16_from_callbacks_ex(stbi_options *options, stbi_io_callbacks const *clbk, void *user, int *x, int *y, int *channels_in_file, int desired_channels);
+    STBIDEF int      stbi_info_from_memory_ex    (stbi_options *options, stbi_uc const *buffer, int len, int *x, int *y, int *comp);
+    STBIDEF int      stbi_info_from_callbacks_ex (stbi_options *options, stbi_io_callbacks const *clbk, void *user, int *x, int *y, int *comp);
+#ifndef STBI_NO_GIF
+    STBIDEF stbi_uc *stbi_load_gif_from_memory_ex(stbi_options *options, stbi_uc const *buffer, int len, int **delays, int *x, int *y, int *z, int *comp, int req_comp);
+#endif
+#ifndef STBI_NO_LINEAR
+    STBIDEF float   *stbi_loadf_from_memory_ex   (stbi_options *options, stbi_uc const *buffer, int len, int *x, int *y, int *channels_in_file, int desired_channels);
+    STBIDEF float   *stbi_loadf_from_callbacks_ex(stbi_options *options, stbi_io_callbacks const *clbk, void *user, int *x, int *y, int *channels_in_file, int desired_channels);
+#endif
+    
+#ifndef STBI_NO_STDIO
+    STBIDEF stbi_uc *stbi_load_ex                (stbi_options *options, char const *filename, int *x, int *y, int *channels_in_file, int desired_channels);
+    STBIDEF stbi_uc *stbi_load_from_file_ex      (stbi_options *options, FILE *f, int *x, int *y, int *channels_in_file, int desired_channels);
+    STBIDEF stbi_us *stbi_load_16_ex             (stbi_options *options, char const *filename, int *x, int *y, int *channels_in_file, int desired_channels);
+    STBIDEF stbi_us *stbi_load_from_file_16_ex   (stbi_options *options, FILE *f, int *x, int *y, int *channels_in_file, int desired_channels);
+    STBIDEF int      stbi_info_ex                (stbi_options *options, char const *filename, int *x, int *y, int *comp);
+    STBIDEF int      stbi_info_from_file_ex      (stbi_options *options, FILE *f, int *x, int *y, int *comp);
+#ifndef STBI_NO_LINEAR
+    STBIDEF float   *stbi_loadf_ex               (stbi_options *options, char const *filename, int *x, int *y, int *channels_in_file, int desired_channels);
+    STBIDEF float   *stbi_loadf_from_file_ex     (stbi_options *options, FILE *f, int *x, int *y, int *channels_in_file, int desired_channels);
+#endif
+#endif
+    
     // ZLIB client - used by PNG, available for other purposes
     
     STBIDEF char *stbi_zlib_decode_malloc_guesssize(const char *buffer, int len, int initial_size, int *outlen);
@@ -675,7 +788,7 @@ static int stbi__cpuid3(void)
 
 #define STBI_SIMD_ALIGN(type, name) __declspec(align(16)) type name
 
-#if !defined(STBI_NO_JPEG) && defined(STBI_SSE2)
+#if (!defined(STBI_NO_JPEG) || !defined(STBI_NO_PNG) || !defined(STBI_NO_TGA)) && defined(STBI_SSE2)
 static int stbi__sse2_available(void)
 {
     int info3 = stbi__cpuid3();
@@ -686,7 +799,7 @@ static int stbi__sse2_available(void)
 #else // assume GCC-style if not VC++
 #define STBI_SIMD_ALIGN(type, name) type name __attribute__((aligned(16)))
 
-#if !defined(STBI_NO_JPEG) && defined(STBI_SSE2)
+#if (!defined(STBI_NO_JPEG) || !defined(STBI_NO_PNG) || !defined(STBI_NO_TGA)) && defined(STBI_SSE2)
 static int stbi__sse2_available(void)
 {
     // If we're even attempting to compile this on GCC/Clang, that means
@@ -734,6 +847,13 @@ typedef struct
     
     stbi_uc *img_buffer, *img_buffer_end;
     stbi_uc *img_buffer_original, *img_buffer_original_end;
+    
+    // settings of the *_ex call decoding this, NULL for the global ones
+    stbi_options *options;
+    // the buffer of the caller a decoder may write its result to (options->output of an 8-bit load), NULL
+    // if it has to allocate one
+    stbi_uc *output;
+    size_t output_size;
 } stbi__context;
 
 
@@ -744,6 +864,9 @@ static void stbi__start_mem(stbi__context *s, stbi_uc const *buffer, int len)
 {
     s->io.read = NULL;
     s->read_from_callbacks = 0;
+    s->options = NULL;
+    s->output = NULL;
+    s->output_size = 0;
     s->img_buffer = s->img_buffer_original = (stbi_uc *) buffer;
     s->img_buffer_end = s->img_buffer_original_end = (stbi_uc *) buffer+len;
 }
@@ -753,6 +876,9 @@ static void stbi__start_callbacks(stbi__context *s, stbi_io_callbacks *c, void *
 {
     s->io = *c;
     s->io_user_data = user;
+    s->options = NULL;
+    s->output = NULL;
+    s->output_size = 0;
     s->buflen = sizeof(s->buffer_start);
     s->read_from_callbacks = 1;
     s->img_buffer_original = s->buffer_start;
@@ -813,6 +939,7 @@ typedef struct
     int bits_per_channel;
     int num_channels;
     int channel_order;
+    int region_done;  // the decoder already scaled and cut the image to the region of the options
 } stbi__result_info;
 
 #ifndef STBI_NO_JPEG
@@ -872,9 +999,29 @@ static void    *stbi__pnm_load(stbi__context *s, int *x, int *y, int *comp, int
 static int      stbi__pnm_info(stbi__context *s, int *x, int *y, int *comp);
 #endif
 
-// this is not threadsafe
+#ifndef STBI_THREAD_LOCAL
+#if defined(__cplusplus) && __cplusplus >= 201103L
+#define STBI_THREAD_LOCAL       thread_local
+#elif defined(__GNUC__) && __GNUC__ < 5
+#define STBI_THREAD_LOCAL       __thread
+#elif defined(_MSC_VER)
+#define STBI_THREAD_LOCAL       __declspec(thread)
+#elif defined(__STDC_VERSION__) && __STDC_VERSION__ >= 201112L && !defined(__STDC_NO_THREADS__)
+#define STBI_THREAD_LOCAL       _Thread_local
+#elif defined(__GNUC__)
+#define STBI_THREAD_LOCAL       __thread
+#else
+#define STBI_THREAD_LOCAL
+#endif
+#endif
+
+// this is not threadsafe, the *_ex functions do not touch it
 static const char *stbi__g_failure_reason;
 
+// options of the *_ex call running on this thread, if any; failures are
+// reported there. nothing below stbi__err has the stbi__context at hand
+static STBI_THREAD_LOCAL stbi_options *stbi__t_options;
+
 STBIDEF const char *stbi_failure_reason(void)
 {
     return stbi__g_failure_reason;
@@ -882,10 +1029,43 @@ STBIDEF const char *stbi_failure_reason(void)
 
 static int stbi__err(const char *str)
 {
-    stbi__g_failure_reason = str;
+    if (stbi__t_options)
+        stbi__t_options->failure_reason = str;
+    else
+        stbi__g_failure_reason = str;
     return 0;
 }
 
+STBIDEF void stbi_options_init(stbi_options *options)
+{
+    options->flip_vertically = 0;
+    options->unpremultiply = 0;
+    options->convert_iphone_png = 0;
+    options->failure_reason = NULL;
+    options->parallel_for = NULL;
+    options->parallel_user = NULL;
+    options->scale_log2 = 0;
+    options->first_row = 0;
+    options->row_count = 0;
+    options->output = NULL;
+    options->output_size = 0;
+}
+
+// route the failures to options for the duration of a *_ex call, returns
+// the options of the call it is nested in (stbi_load_ex -> stbi_load_from_file_ex)
+static stbi_options *stbi__begin_ex(stbi_options *options)
+{
+    stbi_options *outer = stbi__t_options;
+    options->failure_reason = NULL;
+    stbi__t_options = options;
+    return outer;
+}
+
+static void stbi__end_ex(stbi_options *outer)
+{
+    stbi__t_options = outer;
+}
+
 static void *stbi__malloc(size_t size)
 {
     return STBI_MALLOC(size);
@@ -1001,6 +1181,126 @@ STBIDEF void stbi_set_flip_vertically_on_load(int flag_true_if_should_flip)
     stbi__vertically_flip_on_load = flag_true_if_should_flip;
 }
 
+static int stbi__unpremultiply_on_load = 0;
+static int stbi__de_iphone_flag = 0;
+
+STBIDEF void stbi_set_unpremultiply_on_load(int flag_true_if_should_unpremultiply)
+{
+    stbi__unpremultiply_on_load = flag_true_if_should_unpremultiply;
+}
+
+STBIDEF void stbi_convert_iphone_png_to_rgb(int flag_true_if_should_convert)
+{
+    stbi__de_iphone_flag = flag_true_if_should_convert;
+}
+
+// the settings of the *_ex call decoding s, the global ones otherwise
+#define stbi__flip_vertically(s)     ((s)->options ? (s)->options->flip_vertically : stbi__vertically_flip_on_load)
+#define stbi__unpremultiply(s)       ((s)->options ? (s)->options->unpremultiply : stbi__unpremultiply_on_load)
+#define stbi__convert_iphone_png(s)  ((s)->options ? (s)->options->convert_iphone_png : stbi__de_iphone_flag)
+
+// the global settings as a stbi_options, for the entry points wrapping a *_ex one
+static void stbi__global_options(stbi_options *options)
+{
+    stbi_options_init(options);
+    options->flip_vertically = stbi__vertically_flip_on_load;
+    options->unpremultiply = stbi__unpremultiply_on_load;
+    options->convert_iphone_png = stbi__de_iphone_flag;
+}
+
+// hand the failure of the wrapped call on to stbi_failure_reason()
+static void stbi__global_failure(stbi_options *options)
+{
+    if (options->failure_reason)
+        stbi__g_failure_reason = options->failure_reason;
+}
+
+// whether the *_ex options ask for part of the image, or a smaller one
+static int stbi__region_requested(stbi__context *s)
+{
+    return s->options && (s->options->scale_log2 || s->options->first_row || s->options->row_count);
+}
+
+static int stbi__region_check(stbi__context *s)
+{
+    stbi_options *o = s->options;
+    if (stbi__region_requested(s) && (o->scale_log2 < 0 || o->scale_log2 > 3 || o->first_row < 0 || o->row_count < 0))
+        return stbi__err("bad region", "Invalid scale or rows in stbi_options");
+    return 1;
+}
+
+// the size of the image the *_ex call returns for a w x h one, scaled and cut to the rows asked for
+static int stbi__region_size(stbi__context *s, int *w, int *h)
+{
+    stbi_options *o = s->options;
+    int rows;
+    if (!stbi__region_requested(s)) return 1;
+    if (!stbi__region_check(s)) return 0;
+    *w = (int) (((unsigned int) *w + (1u << o->scale_log2) - 1) >> o->scale_log2);
+    *h = (int) (((unsigned int) *h + (1u << o->scale_log2) - 1) >> o->scale_log2);
+    if (o->first_row >= *h) return stbi__err("bad region", "First row past the end of the image");
+    rows = *h - o->first_row;
+    if (o->row_count && o->row_count < rows) rows = o->row_count;
+    *h = rows;
+    return 1;
+}
+
+// cut and scale a decoded image to what the *_ex options ask for, in place, for the formats that do not
+// do it while decoding. samples are 8 or 16 bit, or float when sample_size is 4. every pixel averages
+// its box of pixels, or the part of the box inside the image
+static void *stbi__region(stbi__context *s, void *image, int *x, int *y, int channels, int sample_size)
+{
+    int w = *x, h = *y, shift, first, i, j, k;
+    size_t out_row, in_row;
+    void *shrunk;
+    if (!stbi__region_requested(s)) return image;
+    if (!stbi__region_size(s, &w, &h)) { STBI_FREE(image); return NULL; }
+    shift = s->options->scale_log2;
+    first = s->options->first_row;
+    out_row = (size_t) w * channels;
+    in_row = (size_t) *x * channels;
+    
+    if (shift == 0) {
+        memmove(image, (stbi_uc *) image + in_row * sample_size * first, out_row * sample_size * h);
+    } else {
+        // out row j goes over in rows the boxes above it have already read
+        unsigned int *isum = (unsigned int *) stbi__malloc_mad2(w, channels * 4, 0);
+        float *fsum = (float *) isum;
+        if (!isum) { STBI_FREE(image); return stbi__errpuc("outofmem", "Out of memory"); }
+        for (j=0; j < h; ++j) {
+            int y0 = (first + j) << shift, y1 = y0 + (1 << shift) < *y ? y0 + (1 << shift) : *y, yy;
+            memset(isum, 0, out_row * 4);
+            for (yy=y0; yy < y1; ++yy) {
+                size_t at = (size_t) yy * in_row;
+                for (i=0; i < *x; ++i) {
+                    size_t to = (size_t) (i >> shift) * channels;
+                    for (k=0; k < channels; ++k, ++at) {
+                        if (sample_size == 4)      fsum[to+k] += ((float *) image)[at];
+                        else if (sample_size == 2) isum[to+k] += ((stbi__uint16 *) image)[at];
+                        else                       isum[to+k] += ((stbi_uc *) image)[at];
+                    }
+                }
+            }
+            for (i=0; i < w; ++i) {
+                int x0 = i << shift, x1 = x0 + (1 << shift) < *x ? x0 + (1 << shift) : *x;
+                unsigned int count = (unsigned int) ((x1 - x0) * (y1 - y0));
+                size_t at = (size_t) j * out_row + (size_t) i * channels, from = (size_t) i * channels;
+                for (k=0; k < channels; ++k) {
+                    if (sample_size == 4)      ((float *) image)[at+k] = fsum[from+k] / (float) count;
+                    else if (sample_size == 2) ((stbi__uint16 *) image)[at+k] = (stbi__uint16) ((isum[from+k] + count/2) / count);
+                    else                       ((stbi_uc *) image)[at+k] = (stbi_uc) ((isum[from+k] + count/2) / count);
+                }
+            }
+        }
+        STBI_FREE(isum);
+    }
+    
+    shrunk = STBI_REALLOC_SIZED(image, in_row * sample_size * *y, out_row * sample_size * h);
+    *x = w;
+    *y = h;
+    return shrunk ? shrunk : image;
+}
+
 static void *stbi__load_main(stbi__context *s, int *x, int *y, int *comp, int req_comp, stbi__result_info *ri, int bpc)
 {
     memset(ri, 0, sizeof(*ri)); // make sure it's initialized if we add new fields
@@ -1008,6 +1308,8 @@ static void *stbi__load_main(stbi__context *s, int *x, int *y, int *comp, int re
     ri->channel_order = STBI_ORDER_RGB; // all current input & output are this, but this is here so we can add BGR order
     ri->num_channels = 0;
     
+    if (!stbi__region_check(s)) return NULL;
+    
 #ifndef STBI_NO_JPEG
     if (stbi__jpeg_test(s)) return stbi__jpeg_load(s,x,y,comp,req_comp, ri);
 #endif
@@ -1124,6 +1426,12 @@ static unsigned char *stbi__load_and_postprocess_8bit(stbi__context *s, int *x,
     if (result == NULL)
         return NULL;
     
+    if (!ri.region_done) {
+        result = stbi__region(s, result, x, y, req_comp ? req_comp : *comp, ri.bits_per_channel / 8);
+        if (result == NULL)
+            return NULL;
+    }
+    
     if (ri.bits_per_channel != 8) {
         STBI_ASSERT(ri.bits_per_channel == 16);
         result = stbi__convert_16_to_8((stbi__uint16 *) result, *x, *y, req_comp == 0 ? *comp : req_comp);
@@ -1132,7 +1440,7 @@ static unsigned char *stbi__load_and_postprocess_8bit(stbi__context *s, int *x,
     
     // @TODO: move stbi__convert_format to here
     
-    if (stbi__vertically_flip_on_load) {
+    if (stbi__flip_vertically(s)) {
         int channels = req_comp ? req_comp : *comp;
         stbi__vertical_flip(result, *x, *y, channels * sizeof(stbi_uc));
     }
@@ -1140,6 +1448,31 @@ static unsigned char *stbi__load_and_postprocess_8bit(stbi__context *s, int *x,
     return (unsigned char *) result;
 }
 
+// stbi__load_and_postprocess_8bit for the 8-bit *_ex loads, into options->output if the caller gave one:
+// decoders that can write there directly find it in s->output, the results of the others are copied
+static unsigned char *stbi__load_8bit_ex(stbi__context *s, int *x, int *y, int *comp, int req_comp)
+{
+    unsigned char *result;
+    size_t size;
+    if (!s->options || !s->options->output)
+        return stbi__load_and_postprocess_8bit(s, x, y, comp, req_comp);
+    
+    s->output = s->options->output;
+    s->output_size = s->options->output_size;
+    result = stbi__load_and_postprocess_8bit(s, x, y, comp, req_comp);
+    if (result == NULL || result == s->output)
+        return result;
+    
+    size = (size_t) *x * *y * (req_comp ? req_comp : *comp);
+    if (size > s->output_size) {
+        STBI_FREE(result);
+        return stbi__errpuc("output too small", "Image does not fit the output buffer");
+    }
+    memcpy(s->output, result, size);
+    STBI_FREE(result);
+    return s->output;
+}
+
 static stbi__uint16 *stbi__load_and_postprocess_16bit(stbi__context *s, int *x, int *y, int *comp, int req_comp)
 {
     stbi__result_info ri;
@@ -1148,6 +1481,12 @@ static stbi__uint16 *stbi__load_and_postprocess_16bit(stbi__context *s, int *x,
     if (result == NULL)
         return NULL;
     
+    if (!ri.region_done) {
+        result = stbi__region(s, result, x, y, req_comp ? req_comp : *comp, ri.bits_per_channel / 8);
+        if (result == NULL)
+            return NULL;
+    }
+    
     if (ri.bits_per_channel != 16) {
         STBI_ASSERT(ri.bits_per_channel == 8);
         result = stbi__convert_8_to_16((stbi_uc *) result, *x, *y, req_comp == 0 ? *comp : req_comp);
@@ -1157,7 +1496,7 @@ static stbi__uint16 *stbi__load_and_postprocess_16bit(stbi__context *s, int *x,
     // @TODO: move stbi__convert_format16 to here
     // @TODO: special case RGB-to-Y (and RGBA-to-YA) for 8-bit-to-16-bit case to keep more precision
     
-    if (stbi__vertically_flip_on_load) {
+    if (stbi__flip_vertically(s)) {
         int channels = req_comp ? req_comp : *comp;
         stbi__vertical_flip(result, *x, *y, channels * sizeof(stbi__uint16));
     }
@@ -1166,9 +1505,9 @@ static stbi__uint16 *stbi__load_and_postprocess_16bit(stbi__context *s, int *x,
 }
 
 #if !defined(STBI_NO_HDR) && !defined(STBI_NO_LINEAR)
-static void stbi__float_postprocess(float *result, int *x, int *y, int *comp, int req_comp)
+static void stbi__float_postprocess(stbi__context *s, float *result, int *x, int *y, int *comp, int req_comp)
 {
-    if (stbi__vertically_flip_on_load && result != NULL) {
+    if (stbi__flip_vertically(s) && result != NULL) {
         int channels = req_comp ? req_comp : *comp;
         stbi__vertical_flip(result, *x, *y, channels * sizeof(float));
     }
@@ -1218,95 +1557,224 @@ static FILE *stbi__fopen(char const *filename, char const *mode)
 }
 
 
-STBIDEF stbi_uc *stbi_load(char const *filename, int *x, int *y, int *comp, int req_comp)
+STBIDEF stbi_uc *stbi_load_ex(stbi_options *options, char const *filename, int *x, int *y, int *comp, int req_comp)
 {
+    stbi_options *outer = stbi__begin_ex(options);
     FILE *f = stbi__fopen(filename, "rb");
     unsigned char *result;
-    if (!f) return stbi__errpuc("can't fopen", "Unable to open file");
-    result = stbi_load_from_file(f,x,y,comp,req_comp);
-    fclose(f);
+    if (!f) {
+        result = stbi__errpuc("can't fopen", "Unable to open file");
+    } else {
+        result = stbi_load_from_file_ex(options,f,x,y,comp,req_comp);
+        fclose(f);
+    }
+    stbi__end_ex(outer);
     return result;
 }
 
-STBIDEF stbi_uc *stbi_load_from_file(FILE *f, int *x, int *y, int *comp, int req_comp)
+STBIDEF stbi_uc *stbi_load_from_file_ex(stbi_options *options, FILE *f, int *x, int *y, int *comp, int req_comp)
 {
+    stbi_options *outer = stbi__begin_ex(options);
     unsigned char *result;
     stbi__context s;
     stbi__start_file(&s,f);
-    result = stbi__load_and_postprocess_8bit(&s,x,y,comp,req_comp);
+    s.options = options;
+    result = stbi__load_8bit_ex(&s,x,y,comp,req_comp);
     if (result) {
         // need to 'unget' all the characters in the IO buffer
         fseek(f, - (int) (s.img_buffer_end - s.img_buffer), SEEK_CUR);
     }
+    stbi__end_ex(outer);
     return result;
 }
 
-STBIDEF stbi__uint16 *stbi_load_from_file_16(FILE *f, int *x, int *y, int *comp, int req_comp)
+STBIDEF stbi__uint16 *stbi_load_from_file_16_ex(stbi_options *options, FILE *f, int *x, int *y, int *comp, int req_comp)
 {
+    stbi_options *outer = stbi__begin_ex(options);
     stbi__uint16 *result;
     stbi__context s;
     stbi__start_file(&s,f);
+    s.options = options;
     result = stbi__load_and_postprocess_16bit(&s,x,y,comp,req_comp);
     if (result) {
         // need to 'unget' all the characters in the IO buffer
         fseek(f, - (int) (s.img_buffer_end - s.img_buffer), SEEK_CUR);
     }
+    stbi__end_ex(outer);
     return result;
 }
 
-STBIDEF stbi_us *stbi_load_16(char const *filename, int *x, int *y, int *comp, int req_comp)
+STBIDEF stbi_us *stbi_load_16_ex(stbi_options *options, char const *filename, int *x, int *y, int *comp, int req_comp)
 {
+    stbi_options *outer = stbi__begin_ex(options);
     FILE *f = stbi__fopen(filename, "rb");
     stbi__uint16 *result;
-    if (!f) return (stbi_us *) stbi__errpuc("can't fopen", "Unable to open file");
-    result = stbi_load_from_file_16(f,x,y,comp,req_comp);
-    fclose(f);
+    if (!f) {
+        result = (stbi_us *) stbi__errpuc("can't fopen", "Unable to open file");
+    } else {
+        result = stbi_load_from_file_16_ex(options,f,x,y,comp,req_comp);
+        fclose(f);
+    }
+    stbi__end_ex(outer);
+    return result;
+}
+
+STBIDEF stbi_uc *stbi_load(char const *filename, int *x, int *y, int *comp, int req_comp)
+{
+    stbi_options options;
+    unsigned char *result;
+    stbi__global_options(&options);
+    result = stbi_load_ex(&options,filename,x,y,comp,req_comp);
+    stbi__global_failure(&options);
+    return result;
+}
+
+STBIDEF stbi_uc *stbi_load_from_file(FILE *f, int *x, int *y, int *comp, int req_comp)
+{
+    stbi_options options;
+    unsigned char *result;
+    stbi__global_options(&options);
+    result = stbi_load_from_file_ex(&options,f,x,y,comp,req_comp);
+    stbi__global_failure(&options);
+    return result;
+}
+
+STBIDEF stbi__uint16 *stbi_load_from_file_16(FILE *f, int *x, int *y, int *comp, int req_comp)
+{
+    stbi_options options;
+    stbi__uint16 *result;
+    stbi__global_options(&options);
+    result = stbi_load_from_file_16_ex(&options,f,x,y,comp,req_comp);
+    stbi__global_failure(&options);
+    return result;
+}
+
+STBIDEF stbi_us *stbi_load_16(char const *filename, int *x, int *y, int *comp, int req_comp)
+{
+    stbi_options options;
+    stbi__uint16 *result;
+    stbi__global_options(&options);
+    result = stbi_load_16_ex(&options,filename,x,y,comp,req_comp);
+    stbi__global_failure(&options);
     return result;
 }
 
 
 #endif //!STBI_NO_STDIO
 
-STBIDEF stbi_us *stbi_load_16_from_memory(stbi_uc const *buffer, int len, int *x, int *y, int *channels_in_file, int desired_channels)
+STBIDEF stbi_us *stbi_load_16_from_memory_ex(stbi_options *options, stbi_uc const *buffer, int len, int *x, int *y, int *channels_in_file, int desired_channels)
 {
+    stbi_options *outer = stbi__begin_ex(options);
+    stbi__uint16 *result;
     stbi__context s;
     stbi__start_mem(&s,buffer,len);
-    return stbi__load_and_postprocess_16bit(&s,x,y,channels_in_file,desired_channels);
+    s.options = options;
+    result = stbi__load_and_postprocess_16bit(&s,x,y,channels_in_file,desired_channels);
+    stbi__end_ex(outer);
+    return result;
 }
 
-STBIDEF stbi_us *stbi_load_16_from_callbacks(stbi_io_callbacks const *clbk, void *user, int *x, int *y, int *channels_in_file, int desired_channels)
+STBIDEF stbi_us *stbi_load_16_from_callbacks_ex(stbi_options *options, stbi_io_callbacks const *clbk, void *user, int *x, int *y, int *channels_in_file, int desired_channels)
 {
+    stbi_options *outer = stbi__begin_ex(options);
+    stbi__uint16 *result;
     stbi__context s;
     stbi__start_callbacks(&s, (stbi_io_callbacks *)clbk, user);
-    return stbi__load_and_postprocess_16bit(&s,x,y,channels_in_file,desired_channels);
+    s.options = options;
+    result = stbi__load_and_postprocess_16bit(&s,x,y,channels_in_file,desired_channels);
+    stbi__end_ex(outer);
+    return result;
 }
 
-STBIDEF stbi_uc *stbi_load_from_memory(stbi_uc const *buffer, int len, int *x, int *y, int *comp, int req_comp)
+STBIDEF stbi_uc *stbi_load_from_memory_ex(stbi_options *options, stbi_uc const *buffer, int len, int *x, int *y, int *comp, int req_comp)
 {
+    stbi_options *outer = stbi__begin_ex(options);
+    unsigned char *result;
     stbi__context s;
     stbi__start_mem(&s,buffer,len);
-    return stbi__load_and_postprocess_8bit(&s,x,y,comp,req_comp);
+    s.options = options;
+    result = stbi__load_8bit_ex(&s,x,y,comp,req_comp);
+    stbi__end_ex(outer);
+    return result;
 }
 
-STBIDEF stbi_uc *stbi_load_from_callbacks(stbi_io_callbacks const *clbk, void *user, int *x, int *y, int *comp, int req_comp)
+STBIDEF stbi_uc *stbi_load_from_callbacks_ex(stbi_options *options, stbi_io_callbacks const *clbk, void *user, int *x, int *y, int *comp, int req_comp)
 {
+    stbi_options *outer = stbi__begin_ex(options);
+    unsigned char *result;
     stbi__context s;
     stbi__start_callbacks(&s, (stbi_io_callbacks *) clbk, user);
-    return stbi__load_and_postprocess_8bit(&s,x,y,comp,req_comp);
+    s.options = options;
+    result = stbi__load_8bit_ex(&s,x,y,comp,req_comp);
+    stbi__end_ex(outer);
+    return result;
+}
+
+STBIDEF stbi_us *stbi_load_16_from_memory(stbi_uc const *buffer, int len, int *x, int *y, int *channels_in_file, int desired_channels)
+{
+    stbi_options options;
+    stbi__uint16 *result;
+    stbi__global_options(&options);
+    result = stbi_load_16_from_memory_ex(&options,buffer,len,x,y,channels_in_file,desired_channels);
+    stbi__global_failure(&options);
+    return result;
+}
+
+STBIDEF stbi_us *stbi_load_16_from_callbacks(stbi_io_callbacks const *clbk, void *user, int *x, int *y, int *channels_in_file, int desired_channels)
+{
+    stbi_options options;
+    stbi__uint16 *result;
+    stbi__global_options(&options);
+    result = stbi_load_16_from_callbacks_ex(&options,clbk,user,x,y,channels_in_file,desired_channels);
+    stbi__global_failure(&options);
+    return result;
+}
+
+STBIDEF stbi_uc *stbi_load_from_memory(stbi_uc const *buffer, int len, int *x, int *y, int *comp, int req_comp)
+{
+    stbi_options options;
+    unsigned char *result;
+    stbi__global_options(&options);
+    result = stbi_load_from_memory_ex(&options,buffer,len,x,y,comp,req_comp);
+    stbi__global_failure(&options);
+    return result;
+}
+
+STBIDEF stbi_uc *stbi_load_from_callbacks(stbi_io_callbacks const *clbk, void *user, int *x, int *y, int *comp, int req_comp)
+{
+    stbi_options options;
+    unsigned char *result;
+    stbi__global_options(&options);
+    result = stbi_load_from_callbacks_ex(&options,clbk,user,x,y,comp,req_comp);
+    stbi__global_failure(&options);
+    return result;
 }
 
 #ifndef STBI_NO_GIF
-STBIDEF stbi_uc *stbi_load_gif_from_memory(stbi_uc const *buffer, int len, int **delays, int *x, int *y, int *z, int *comp, int req_comp)
+STBIDEF stbi_uc *stbi_load_gif_from_memory_ex(stbi_options *options, stbi_uc const *buffer, int len, int **delays, int *x, int *y, int *z, int *comp, int req_comp)
 {
+    stbi_options *outer = stbi__begin_ex(options);
     unsigned char *result;
     stbi__context s;
     stbi__start_mem(&s,buffer,len);
+    s.options = options;
     
     result = (unsigned char*) stbi__load_gif_main(&s, delays, x, y, z, comp, req_comp);
-    if (stbi__vertically_flip_on_load) {
+    if (stbi__flip_vertically(&s)) {
         stbi__vertical_flip_slices( result, *x, *y, *z, *comp );
     }
     
+    stbi__end_ex(outer);
+    return result;
+}
+
+STBIDEF stbi_uc *stbi_load_gif_from_memory(stbi_uc const *buffer, int len, int **delays, int *x, int *y, int *z, int *comp, int req_comp)
+{
+    stbi_options options;
+    unsigned char *result;
+    stbi__global_options(&options);
+    result = stbi_load_gif_from_memory_ex(&options,buffer,len,delays,x,y,z,comp,req_comp);
+    stbi__global_failure(&options);
     return result;
 }
 #endif
@@ -1318,9 +1786,13 @@ static float *stbi__loadf_main(stbi__context *s, int *x, int *y, int *comp, int
 #ifndef STBI_NO_HDR
     if (stbi__hdr_test(s)) {
         stbi__result_info ri;
-        float *hdr_data = stbi__hdr_load(s,x,y,comp,req_comp, &ri);
+        float *hdr_data;
+        if (!stbi__region_check(s)) return NULL;
+        hdr_data = stbi__hdr_load(s,x,y,comp,req_comp, &ri);
         if (hdr_data)
-            stbi__float_postprocess(hdr_data,x,y,comp,req_comp);
+            hdr_data = (float *) stbi__region(s, hdr_data, x, y, req_comp ? req_comp : *comp, sizeof(float));
+        if (hdr_data)
+            stbi__float_postprocess(s,hdr_data,x,y,comp,req_comp);
         return hdr_data;
     }
 #endif
@@ -1330,36 +1802,96 @@ static float *stbi__loadf_main(stbi__context *s, int *x, int *y, int *comp, int
     return stbi__errpf("unknown image type", "Image not of any known type, or corrupt");
 }
 
-STBIDEF float *stbi_loadf_from_memory(stbi_uc const *buffer, int len, int *x, int *y, int *comp, int req_comp)
+STBIDEF float *stbi_loadf_from_memory_ex(stbi_options *options, stbi_uc const *buffer, int len, int *x, int *y, int *comp, int req_comp)
 {
+    stbi_options *outer = stbi__begin_ex(options);
+    float *result;
     stbi__context s;
     stbi__start_mem(&s,buffer,len);
-    return stbi__loadf_main(&s,x,y,comp,req_comp);
+    s.options = options;
+    result = stbi__loadf_main(&s,x,y,comp,req_comp);
+    stbi__end_ex(outer);
+    return result;
 }
 
-STBIDEF float *stbi_loadf_from_callbacks(stbi_io_callbacks const *clbk, void *user, int *x, int *y, int *comp, int req_comp)
+STBIDEF float *stbi_loadf_from_callbacks_ex(stbi_options *options, stbi_io_callbacks const *clbk, void *user, int *x, int *y, int *comp, int req_comp)
 {
+    stbi_options *outer = stbi__begin_ex(options);
+    float *result;
     stbi__context s;
     stbi__start_callbacks(&s, (stbi_io_callbacks *) clbk, user);
-    return stbi__loadf_main(&s,x,y,comp,req_comp);
+    s.options = options;
+    result = stbi__loadf_main(&s,x,y,comp,req_comp);
+    stbi__end_ex(outer);
+    return result;
+}
+
+STBIDEF float *stbi_loadf_from_memory(stbi_uc const *buffer, int len, int *x, int *y, int *comp, int req_comp)
+{
+    stbi_options options;
+    float *result;
+    stbi__global_options(&options);
+    result = stbi_loadf_from_memory_ex(&options,buffer,len,x,y,comp,req_comp);
+    stbi__global_failure(&options);
+    return result;
+}
+
+STBIDEF float *stbi_loadf_from_callbacks(stbi_io_callbacks const *clbk, void *user, int *x, int *y, int *comp, int req_comp)
+{
+    stbi_options options;
+    float *result;
+    stbi__global_options(&options);
+    result = stbi_loadf_from_callbacks_ex(&options,clbk,user,x,y,comp,req_comp);
+    stbi__global_failure(&options);
+    return result;
 }
 
 #ifndef STBI_NO_STDIO
-STBIDEF float *stbi_loadf(char const *filename, int *x, int *y, int *comp, int req_comp)
+STBIDEF float *stbi_loadf_ex(stbi_options *options, char const *filename, int *x, int *y, int *comp, int req_comp)
 {
+    stbi_options *outer = stbi__begin_ex(options);
     float *result;
     FILE *f = stbi__fopen(filename, "rb");
-    if (!f) return stbi__errpf("can't fopen", "Unable to open file");
-    result = stbi_loadf_from_file(f,x,y,comp,req_comp);
-    fclose(f);
+    if (!f) {
+        result = stbi__errpf("can't fopen", "Unable to open file");
+    } else {
+        result = stbi_loadf_from_file_ex(options,f,x,y,comp,req_comp);
+        fclose(f);
+    }
+    stbi__end_ex(outer);
     return result;
 }
 
-STBIDEF float *stbi_loadf_from_file(FILE *f, int *x, int *y, int *comp, int req_comp)
+STBIDEF float *stbi_loadf_from_file_ex(stbi_options *options, FILE *f, int *x, int *y, int *comp, int req_comp)
 {
+    stbi_options *outer = stbi__begin_ex(options);
+    float *result;
     stbi__context s;
     stbi__start_file(&s,f);
-    return stbi__loadf_main(&s,x,y,comp,req_comp);
+    s.options = options;
+    result = stbi__loadf_main(&s,x,y,comp,req_comp);
+    stbi__end_ex(outer);
+    return result;
+}
+
+STBIDEF float *stbi_loadf(char const *filename, int *x, int *y, int *comp, int req_comp)
+{
+    stbi_options options;
+    float *result;
+    stbi__global_options(&options);
+    result = stbi_loadf_ex(&options,filename,x,y,comp,req_comp);
+    stbi__global_failure(&options);
+    return result;
+}
+
+STBIDEF float *stbi_loadf_from_file(FILE *f, int *x, int *y, int *comp, int req_comp)
+{
+    stbi_options options;
+    float *result;
+    stbi__global_options(&options);
+    result = stbi_loadf_from_file_ex(&options,f,x,y,comp,req_comp);
+    stbi__global_failure(&options);
+    return result;
 }
 #endif // !STBI_NO_STDIO
 
@@ -1811,6 +2343,13 @@ typedef struct
     int scan_n, order[4];
     int restart_interval, todo;
     
+    // the region of the *_ex options: blocks come out (8 >> scale_log2) pixels wide, only the ones
+    // in MCU rows mcu_row_begin..mcu_row_end-1 are transformed, and scan_cut is set when a single
+    // baseline scan stopped decoding after mcu_row_end
+    int scale_log2;
+    int mcu_row_begin, mcu_row_end;
+    int scan_cut;
+    
     // kernels
     void (*idct_block_kernel)(stbi_uc *out, int out_stride, short data[64]);
     void (*YCbCr_to_RGB_kernel)(stbi_uc *out, const stbi_uc *y, const stbi_uc *pcb, const stbi_uc *pcr, int count, int step);
@@ -2326,6 +2865,56 @@ static void stbi__idct_block(stbi_uc *out, int out_stride, short data[64])
     }
 }
 
+// reduced IDCTs, for scaled decodes: the lowest n x n frequencies of the block make n x n
+// pixels, with basis[u*n+x] the cosine of frequency u at pixel x (times 4096, like stbi__f2f)
+static void stbi__idct_reduced(stbi_uc *out, int out_stride, short data[64], const int *basis, int n)
+{
+    int i,j,k,t,tmp[16];
+    // rows, keeping one more bit than the pixels have
+    for (j=0; j < n; ++j) {
+        for (i=0; i < n; ++i) {
+            for (t=0,k=0; k < n; ++k)
+                t += basis[k*n+i] * data[j*8+k];
+            tmp[j*n+i] = (t + (1 << 10)) >> 11;
+        }
+    }
+    // columns, then bias by 128 and round
+    for (j=0; j < n; ++j, out += out_stride) {
+        for (i=0; i < n; ++i) {
+            for (t=0,k=0; k < n; ++k)
+                t += basis[k*n+j] * tmp[k*n+i];
+            out[i] = stbi__clamp((t + (1 << 12) + (128 << 13)) >> 13);
+        }
+    }
+}
+
+static void stbi__idct_4x4(stbi_uc *out, int out_stride, short data[64])
+{
+    static const int basis[16] = {
+        1448,  1448,  1448,  1448,
+        1892,   784,  -784, -1892,
+        1448, -1448, -1448,  1448,
+         784, -1892,  1892,  -784
+    };
+    stbi__idct_reduced(out, out_stride, data, basis, 4);
+}
+
+static void stbi__idct_2x2(stbi_uc *out, int out_stride, short data[64])
+{
+    static const int basis[4] = {
+        1448,  1448,
+        1448, -1448
+    };
+    stbi__idct_reduced(out, out_stride, data, basis, 2);
+}
+
+// the block average
+static void stbi__idct_1x1(stbi_uc *out, int out_stride, short data[64])
+{
+    STBI_NOTUSED(out_stride);
+    out[0] = stbi__clamp((data[0] + 4 + (128 << 3)) >> 3);
+}
+
 #ifdef STBI_SSE2
 // sse2 integer IDCT. not the fastest possible implementation but it
 // produces bit-identical results to the generic C version so it's
@@ -2749,67 +3338,223 @@ static void stbi__jpeg_reset(stbi__jpeg *j)
     // since we don't even allow 1<<30 pixels
 }
 
-static int stbi__parse_entropy_coded_data(stbi__jpeg *z)
-{
-    stbi__jpeg_reset(z);
-    if (!z->progressive) {
-        if (z->scan_n == 1) {
-            int i,j;
-            STBI_SIMD_ALIGN(short, data[64]);
-            int n = z->order[0];
-            // non-interleaved data, we just need to process one block at a time,
-            // in trivial scanline order
-            // number of blocks to do just depends on how many actual "pixels" this
-            // component has, independent of interleaved MCU blocking and such
-            int w = (z->img_comp[n].x+7) >> 3;
-            int h = (z->img_comp[n].y+7) >> 3;
-            for (j=0; j < h; ++j) {
-                for (i=0; i < w; ++i) {
-                    int ha = z->img_comp[n].ha;
-                    if (!stbi__jpeg_decode_block(z, data, z->huff_dc+z->img_comp[n].hd, z->huff_ac+ha, z->fast_ac[ha], n, z->dequant[z->img_comp[n].tq])) return 0;
-                    z->idct_block_kernel(z->img_comp[n].data+z->img_comp[n].w2*j*8+i*8, z->img_comp[n].w2, data);
-                    // every data block is an MCU, so countdown the restart interval
-                    if (--z->todo <= 0) {
-                        if (z->code_bits < 24) stbi__grow_buffer_unsafe(z);
-                        // if it's NOT a restart, then just bail, so we get corrupt data
-                        // rather than no data
-                        if (!STBI__RESTART(z->marker)) return 1;
-                        stbi__jpeg_reset(z);
-                    }
-                }
+// number of MCUs in the current scan; a non-interleaved one has one per data block
+static int stbi__jpeg_scan_mcus(stbi__jpeg *z)
+{
+    if (z->scan_n == 1) {
+        int n = z->order[0];
+        return ((z->img_comp[n].x+7) >> 3) * ((z->img_comp[n].y+7) >> 3);
+    }
+    return z->img_mcu_x * z->img_mcu_y;
+}
+
+// whether block row j of component n is in the MCU rows the region needs
+static int stbi__jpeg_block_wanted(stbi__jpeg *z, int n, int j)
+{
+    j /= z->img_comp[n].v;
+    return j >= z->mcu_row_begin && j < z->mcu_row_end;
+}
+
+// decode the MCUs first to end-1 of a baseline scan, counting down the restart interval.
+// returns 0 on an error, 2 when an interval did not end at a restart marker (we then
+// bail, so we get corrupt data rather than no data) and 1 otherwise
+static int stbi__jpeg_decode_baseline_mcus(stbi__jpeg *z, int first, int end)
+{
+    int m, b = 8 >> z->scale_log2;
+    STBI_SIMD_ALIGN(short, data[64]);
+    if (z->scan_n == 1) {
+        int n = z->order[0];
+        // non-interleaved data, we just need to process one block at a time,
+        // in trivial scanline order
+        // number of blocks to do just depends on how many actual "pixels" this
+        // component has, independent of interleaved MCU blocking and such
+        int w = (z->img_comp[n].x+7) >> 3;
+        int i = first % w, j = first / w;
+        int ha = z->img_comp[n].ha;
+        for (m=first; m < end; ++m) {
+            if (!stbi__jpeg_decode_block(z, data, z->huff_dc+z->img_comp[n].hd, z->huff_ac+ha, z->fast_ac[ha], n, z->dequant[z->img_comp[n].tq])) return 0;
+            if (stbi__jpeg_block_wanted(z, n, j))
+                z->idct_block_kernel(z->img_comp[n].data+(z->img_comp[n].w2*j+i)*b, z->img_comp[n].w2, data);
+            // every data block is an MCU, so countdown the restart interval
+            if (--z->todo <= 0) {
+                if (z->code_bits < 24) stbi__grow_buffer_unsafe(z);
+                // if it's NOT a restart, then just bail, so we get corrupt data
+                // rather than no data
+                if (!STBI__RESTART(z->marker)) return 2;
+                stbi__jpeg_reset(z);
             }
-            return 1;
-        } else { // interleaved
-            int i,j,k,x,y;
-            STBI_SIMD_ALIGN(short, data[64]);
-            for (j=0; j < z->img_mcu_y; ++j) {
-                for (i=0; i < z->img_mcu_x; ++i) {
-                    // scan an interleaved mcu... process scan_n components in order
-                    for (k=0; k < z->scan_n; ++k) {
-                        int n = z->order[k];
-                        // scan out an mcu's worth of this component; that's just determined
-                        // by the basic H and V specified for the component
-                        for (y=0; y < z->img_comp[n].v; ++y) {
-                            for (x=0; x < z->img_comp[n].h; ++x) {
-                                int x2 = (i*z->img_comp[n].h + x)*8;
-                                int y2 = (j*z->img_comp[n].v + y)*8;
-                                int ha = z->img_comp[n].ha;
-                                if (!stbi__jpeg_decode_block(z, data, z->huff_dc+z->img_comp[n].hd, z->huff_ac+ha, z->fast_ac[ha], n, z->dequant[z->img_comp[n].tq])) return 0;
-                                z->idct_block_kernel(z->img_comp[n].data+z->img_comp[n].w2*y2+x2, z->img_comp[n].w2, data);
-                            }
-                        }
-                    }
-                    // after all interleaved components, that's an interleaved MCU,
-                    // so now count down the restart interval
-                    if (--z->todo <= 0) {
-                        if (z->code_bits < 24) stbi__grow_buffer_unsafe(z);
-                        if (!STBI__RESTART(z->marker)) return 1;
-                        stbi__jpeg_reset(z);
+            if (++i == w) { i = 0; ++j; }
+        }
+    } else { // interleaved
+        int i = first % z->img_mcu_x, j = first / z->img_mcu_x;
+        int k,x,y;
+        for (m=first; m < end; ++m) {
+            // scan an interleaved mcu... process scan_n components in order
+            for (k=0; k < z->scan_n; ++k) {
+                int n = z->order[k];
+                // scan out an mcu's worth of this component; that's just determined
+                // by the basic H and V specified for the component
+                for (y=0; y < z->img_comp[n].v; ++y) {
+                    for (x=0; x < z->img_comp[n].h; ++x) {
+                        int x2 = (i*z->img_comp[n].h + x)*b;
+                        int y2 = (j*z->img_comp[n].v + y)*b;
+                        int ha = z->img_comp[n].ha;
+                        if (!stbi__jpeg_decode_block(z, data, z->huff_dc+z->img_comp[n].hd, z->huff_ac+ha, z->fast_ac[ha], n, z->dequant[z->img_comp[n].tq])) return 0;
+                        if (j >= z->mcu_row_begin && j < z->mcu_row_end)
+                            z->idct_block_kernel(z->img_comp[n].data+z->img_comp[n].w2*y2+x2, z->img_comp[n].w2, data);
                     }
                 }
             }
-            return 1;
+            // after all interleaved components, that's an interleaved MCU,
+            // so now count down the restart interval
+            if (--z->todo <= 0) {
+                if (z->code_bits < 24) stbi__grow_buffer_unsafe(z);
+                if (!STBI__RESTART(z->marker)) return 2;
+                stbi__jpeg_reset(z);
+            }
+            if (++i == z->img_mcu_x) { i = 0; ++j; }
+        }
+    }
+    return 1;
+}
+
+// most tasks handed to parallel_for at once, fewer when there is less to split
+#define STBI__JPEG_MAX_TASKS  64
+
+// restart intervals of a baseline scan, split across tasks: each task decodes a run of
+// them with its own copy of the decoder, reading the scan data through its own context
+typedef struct
+{
+    stbi__jpeg *z;
+    stbi_uc **starts;   // where each interval begins, just past the restart marker before it
+    int intervals, mcus, tasks;
+    struct {
+        stbi__jpeg *decoder;  // kept for the last task, the state the scan ends in
+        stbi__context s;
+        int result;
+    } task[STBI__JPEG_MAX_TASKS];
+} stbi__jpeg_scan_split;
+
+static void stbi__jpeg_decode_intervals(void *data, int t)
+{
+    stbi__jpeg_scan_split *split = (stbi__jpeg_scan_split *) data;
+    int per = split->intervals / split->tasks, extra = split->intervals % split->tasks;
+    int first = t*per + (t < extra ? t : extra);
+    int end = first + per + (t < extra);
+    stbi__context *s = &split->task[t].s;
+    stbi__jpeg *z = (stbi__jpeg *) stbi__malloc(sizeof(stbi__jpeg));
+    stbi_options options, *outer;
+    int i, result = 0;
+    if (!z) { split->task[t].result = 0; return; }
+    // this runs on a thread of the caller's pool, which may be in a call of its own
+    stbi_options_init(&options);
+    outer = stbi__begin_ex(&options);
+    *s = *split->z->s;
+    *z = *split->z;
+    z->s = s;
+    for (i=first; i < end; ++i) {
+        int mcu = i * z->restart_interval, last = mcu + z->restart_interval;
+        s->img_buffer = split->starts[i];
+        s->img_buffer_end = i+1 < split->intervals ? split->starts[i+1] : split->z->s->img_buffer_end;
+        stbi__jpeg_reset(z);
+        result = stbi__jpeg_decode_baseline_mcus(z, mcu, last < split->mcus ? last : split->mcus);
+        // no restart marker follows the last interval, everywhere else the serial decoder bails
+        if (result == 2 && i+1 < split->intervals)
+            result = 0;
+        if (!result)
+            break;
+    }
+    stbi__end_ex(outer);
+    split->task[t].result = result;
+    if (t == split->tasks-1 && result)
+        split->task[t].decoder = z;
+    else
+        STBI_FREE(z);
+}
+
+// decode a baseline scan with restart intervals through parallel_for. returns -1 when it
+// cannot, and the scan was not touched: the scan data is not all in memory, the restart
+// markers are not where the intervals should end, or an interval fails to decode (so the
+// serial decoder gets to report it, or to bail out exactly where it would have)
+static int stbi__jpeg_decode_scan_parallel(stbi__jpeg *z, int mcus)
+{
+    stbi__context *s = z->s;
+    stbi_uc *p = s->img_buffer, *end = s->img_buffer_end;
+    stbi__jpeg_scan_split *split;
+    int intervals = (mcus + z->restart_interval - 1) / z->restart_interval;
+    int found = 1, result = 1, t;
+    
+    if (intervals < 2 || s->read_from_callbacks)
+        return -1;
+    split = (stbi__jpeg_scan_split *) stbi__malloc(sizeof(stbi__jpeg_scan_split));
+    if (!split) return -1;
+    split->starts = (stbi_uc **) stbi__malloc_mad2(intervals, sizeof(stbi_uc *), 0);
+    if (!split->starts) { STBI_FREE(split); return -1; }
+    
+    // the restart markers are the only markers inside entropy-coded data; any
+    // other 0xff is followed by a stuffed 0 (after fill bytes of 0xff, maybe)
+    split->starts[0] = p;
+    while (found < intervals) {
+        stbi_uc *q;
+        p = (stbi_uc *) memchr(p, 0xff, end - p);
+        if (!p) break;
+        for (q = p+1; q < end && *q == 0xff; ++q)
+            ;
+        if (q == end) break;
+        if (*q == 0) { p = q+1; continue; }
+        if (!STBI__RESTART(*q)) break;
+        split->starts[found++] = p = q+1;
+    }
+    if (found < intervals) {
+        STBI_FREE(split->starts);
+        STBI_FREE(split);
+        return -1;
+    }
+    
+    split->z = z;
+    split->intervals = intervals;
+    split->mcus = mcus;
+    split->tasks = intervals < STBI__JPEG_MAX_TASKS ? intervals : STBI__JPEG_MAX_TASKS;
+    for (t=0; t < split->tasks; ++t)
+        split->task[t].decoder = NULL;
+    s->options->parallel_for(s->options->parallel_user, stbi__jpeg_decode_intervals, split, split->tasks);
+    
+    for (t=0; t < split->tasks; ++t)
+        if (!split->task[t].result)
+            result = -1;
+    if (result == 1) {
+        // carry on after the scan from where the last interval ended, as the serial decoder would
+        t = split->tasks-1;
+        *z = *split->task[t].decoder;
+        z->s = s;
+        s->img_buffer = split->task[t].s.img_buffer;
+    }
+    if (split->task[split->tasks-1].decoder)
+        STBI_FREE(split->task[split->tasks-1].decoder);
+    STBI_FREE(split->starts);
+    STBI_FREE(split);
+    return result;
+}
+
+static int stbi__parse_entropy_coded_data(stbi__jpeg *z)
+{
+    stbi__jpeg_reset(z);
+    if (!z->progressive) {
+        int mcus = stbi__jpeg_scan_mcus(z);
+        // the only scan has every component, nothing below the region is needed from it
+        if (z->scan_n == z->s->img_n && z->mcu_row_end < z->img_mcu_y) {
+            int cut = z->scan_n == 1 ? ((z->img_comp[z->order[0]].x+7) >> 3) * z->mcu_row_end * z->img_comp[z->order[0]].v
+                                     : z->img_mcu_x * z->mcu_row_end;
+            if (cut < mcus) {
+                mcus = cut;
+                z->scan_cut = 1;
+            }
+        }
+        if (z->restart_interval && z->s->options && z->s->options->parallel_for) {
+            int result = stbi__jpeg_decode_scan_parallel(z, mcus);
+            if (result >= 0) return result;
         }
+        return stbi__jpeg_decode_baseline_mcus(z, 0, mcus) != 0;
     } else {
         if (z->scan_n == 1) {
             int i,j;
@@ -2884,15 +3629,16 @@ static void stbi__jpeg_finish(stbi__jpeg *z)
 {
     if (z->progressive) {
         // dequantize and idct the data
-        int i,j,n;
+        int i,j,n,b = 8 >> z->scale_log2;
         for (n=0; n < z->s->img_n; ++n) {
             int w = (z->img_comp[n].x+7) >> 3;
             int h = (z->img_comp[n].y+7) >> 3;
             for (j=0; j < h; ++j) {
+                if (!stbi__jpeg_block_wanted(z, n, j)) continue;
                 for (i=0; i < w; ++i) {
                     short *data = z->img_comp[n].coeff + 64 * (i + j * z->img_comp[n].coeff_w);
                     stbi__jpeg_dequantize(data, z->dequant[z->img_comp[n].tq]);
-                    z->idct_block_kernel(z->img_comp[n].data+z->img_comp[n].w2*j*8+i*8, z->img_comp[n].w2, data);
+                    z->idct_block_kernel(z->img_comp[n].data+(z->img_comp[n].w2*j+i)*b, z->img_comp[n].w2, data);
                 }
             }
         }
@@ -3111,6 +3857,18 @@ static int stbi__process_frame_header(stbi__jpeg *z, int scan)
     z->img_mcu_x = (s->img_x + z->img_mcu_w-1) / z->img_mcu_w;
     z->img_mcu_y = (s->img_y + z->img_mcu_h-1) / z->img_mcu_h;
     
+    // the MCU rows under the rows of the region, and one more on each side for upsampling
+    z->mcu_row_begin = 0;
+    z->mcu_row_end = z->img_mcu_y;
+    z->scan_cut = 0;
+    if (s->options && (s->options->first_row || s->options->row_count)) {
+        int mcu_h = z->img_mcu_h >> z->scale_log2;
+        int first = s->options->first_row / mcu_h, count = s->options->row_count / mcu_h;
+        z->mcu_row_begin = first > 0 ? first - 1 : 0;
+        if (s->options->row_count && count + 3 < z->img_mcu_y - first)
+            z->mcu_row_end = first + count + 3;
+    }
+    
     for (i=0; i < s->img_n; ++i) {
         // number of effective pixels (e.g. for non-interleaved MCU)
         z->img_comp[i].x = (s->img_x * z->img_comp[i].h + h_max-1) / h_max;
@@ -3122,8 +3880,8 @@ static int stbi__process_frame_header(stbi__jpeg *z, int scan)
         //
         // img_mcu_x, img_mcu_y: <=17 bits; comp[i].h and .v are <=4 (checked earlier)
         // so these muls can't overflow with 32-bit ints (which we require)
-        z->img_comp[i].w2 = z->img_mcu_x * z->img_comp[i].h * 8;
-        z->img_comp[i].h2 = z->img_mcu_y * z->img_comp[i].v * 8;
+        z->img_comp[i].w2 = z->img_mcu_x * z->img_comp[i].h * (8 >> z->scale_log2);
+        z->img_comp[i].h2 = z->img_mcu_y * z->img_comp[i].v * (8 >> z->scale_log2);
         z->img_comp[i].coeff = 0;
         z->img_comp[i].raw_coeff = 0;
         z->img_comp[i].linebuf = NULL;
@@ -3133,10 +3891,10 @@ static int stbi__process_frame_header(stbi__jpeg *z, int scan)
         // align blocks for idct using mmx/sse
         z->img_comp[i].data = (stbi_uc*) (((size_t) z->img_comp[i].raw_data + 15) & ~15);
         if (z->progressive) {
-            // w2, h2 are multiples of 8 (see above)
-            z->img_comp[i].coeff_w = z->img_comp[i].w2 / 8;
-            z->img_comp[i].coeff_h = z->img_comp[i].h2 / 8;
-            z->img_comp[i].raw_coeff = stbi__malloc_mad3(z->img_comp[i].w2, z->img_comp[i].h2, sizeof(short), 15);
+            // the coefficients of every block, whatever size it comes out
+            z->img_comp[i].coeff_w = z->img_mcu_x * z->img_comp[i].h;
+            z->img_comp[i].coeff_h = z->img_mcu_y * z->img_comp[i].v;
+            z->img_comp[i].raw_coeff = stbi__malloc_mad3(z->img_comp[i].coeff_w * 8, z->img_comp[i].coeff_h * 8, sizeof(short), 15);
             if (z->img_comp[i].raw_coeff == NULL)
                 return stbi__free_jpeg_components(z, i+1, stbi__err("outofmem", "Out of memory"));
             z->img_comp[i].coeff = (short*) (((size_t) z->img_comp[i].raw_coeff + 15) & ~15);
@@ -3194,6 +3952,7 @@ static int stbi__decode_jpeg_image(stbi__jpeg *j)
         if (stbi__SOS(m)) {
             if (!stbi__process_scan_header(j)) return 0;
             if (!stbi__parse_entropy_coded_data(j)) return 0;
+            if (j->scan_cut) return 1;
             if (j->marker == STBI__MARKER_none ) {
                 // handle 0s at the end of image data from IP Kamera 9060
                 while (!stbi__at_eof(j->s)) {
@@ -3636,9 +4395,157 @@ static stbi_uc stbi__blinn_8x8(stbi_uc x, stbi_uc y)
     return (stbi_uc) ((t + (t >>8)) >> 8);
 }
 
-static stbi_uc *load_jpeg_image(stbi__jpeg *z, int *out_x, int *out_y, int *comp, int req_comp)
+// what load_jpeg_image resamples and color converts, in one go or in bands of rows
+typedef struct
 {
+    stbi__jpeg *z;
+    stbi_uc *output;
     int n, decode_n, is_rgb;
+    stbi__resample res_comp[4];  // as they are before the first row
+    int rows;                    // of the output, the rows of the region
+    stbi_uc *linebuf;            // per band, decode_n line buffers and a row of output
+    int bands;
+} stbi__jpeg_convert;
+
+static void stbi__resample_next_row(stbi__resample *r, int comp_y, int comp_w2)
+{
+    if (++r->ystep >= r->vs) {
+        r->ystep = 0;
+        r->line0 = r->line1;
+        if (++r->ypos < comp_y)
+            r->line1 += comp_w2;
+    }
+}
+
+// resample and color convert the next row of res_comp into out, upsampling into linebuf.
+// with 3 components out, one byte past the row is written as well
+static void stbi__jpeg_convert_row(stbi__jpeg_convert *c, stbi__resample *res_comp, stbi_uc *linebuf[4], stbi_uc *out)
+{
+    stbi__jpeg *z = c->z;
+    int k, n = c->n, is_rgb = c->is_rgb;
+    unsigned int i;
+    stbi_uc *coutput[4] = { NULL, NULL, NULL, NULL };
+    for (k=0; k < c->decode_n; ++k) {
+        stbi__resample *r = &res_comp[k];
+        int y_bot = r->ystep >= (r->vs >> 1);
+        coutput[k] = r->resample(linebuf[k],
+                                 y_bot ? r->line1 : r->line0,
+                                 y_bot ? r->line0 : r->line1,
+                                 r->w_lores, r->hs);
+        stbi__resample_next_row(r, z->img_comp[k].y, z->img_comp[k].w2);
+    }
+    if (n >= 3) {
+        stbi_uc *y = coutput[0];
+        if (z->s->img_n == 3) {
+            if (is_rgb) {
+                for (i=0; i < z->s->img_x; ++i) {
+                    out[0] = y[i];
+                    out[1] = coutput[1][i];
+                    out[2] = coutput[2][i];
+                    out[3] = 255;
+                    out += n;
+                }
+            } else {
+                z->YCbCr_to_RGB_kernel(out, y, coutput[1], coutput[2], z->s->img_x, n);
+            }
+        } else if (z->s->img_n == 4) {
+            if (z->app14_color_transform == 0) { // CMYK
+                for (i=0; i < z->s->img_x; ++i) {
+                    stbi_uc m = coutput[3][i];
+                    out[0] = stbi__blinn_8x8(coutput[0][i], m);
+                    out[1] = stbi__blinn_8x8(coutput[1][i], m);
+                    out[2] = stbi__blinn_8x8(coutput[2][i], m);
+                    out[3] = 255;
+                    out += n;
+                }
+            } else if (z->app14_color_transform == 2) { // YCCK
+                z->YCbCr_to_RGB_kernel(out, y, coutput[1], coutput[2], z->s->img_x, n);
+                for (i=0; i < z->s->img_x; ++i) {
+                    stbi_uc m = coutput[3][i];
+                    out[0] = stbi__blinn_8x8(255 - out[0], m);
+                    out[1] = stbi__blinn_8x8(255 - out[1], m);
+                    out[2] = stbi__blinn_8x8(255 - out[2], m);
+                    out += n;
+                }
+            } else { // YCbCr + alpha?  Ignore the fourth channel for now
+                z->YCbCr_to_RGB_kernel(out, y, coutput[1], coutput[2], z->s->img_x, n);
+            }
+        } else
+            for (i=0; i < z->s->img_x; ++i) {
+                out[0] = out[1] = out[2] = y[i];
+                out[3] = 255; // not used if n==3
+                out += n;
+            }
+    } else {
+        if (is_rgb) {
+            if (n == 1)
+                for (i=0; i < z->s->img_x; ++i)
+                    *out++ = stbi__compute_y(coutput[0][i], coutput[1][i], coutput[2][i]);
+            else {
+                for (i=0; i < z->s->img_x; ++i, out += 2) {
+                    out[0] = stbi__compute_y(coutput[0][i], coutput[1][i], coutput[2][i]);
+                    out[1] = 255;
+                }
+            }
+        } else if (z->s->img_n == 4 && z->app14_color_transform == 0) {
+            for (i=0; i < z->s->img_x; ++i) {
+                stbi_uc m = coutput[3][i];
+                stbi_uc r = stbi__blinn_8x8(coutput[0][i], m);
+                stbi_uc g = stbi__blinn_8x8(coutput[1][i], m);
+                stbi_uc b = stbi__blinn_8x8(coutput[2][i], m);
+                out[0] = stbi__compute_y(r, g, b);
+                out[1] = 255;
+                out += n;
+            }
+        } else if (z->s->img_n == 4 && z->app14_color_transform == 2) {
+            for (i=0; i < z->s->img_x; ++i) {
+                out[0] = stbi__blinn_8x8(255 - coutput[0][i], coutput[3][i]);
+                out[1] = 255;
+                out += n;
+            }
+        } else {
+            stbi_uc *y = coutput[0];
+            if (n == 1)
+                for (i=0; i < z->s->img_x; ++i) out[i] = y[i];
+            else
+                for (i=0; i < z->s->img_x; ++i) { *out++ = y[i]; *out++ = 255; }
+        }
+    }
+}
+
+static void stbi__jpeg_convert_band(void *data, int band)
+{
+    stbi__jpeg_convert *c = (stbi__jpeg_convert *) data;
+    stbi__jpeg *z = c->z;
+    unsigned int rows = c->rows, per = rows / c->bands, extra = rows % c->bands;
+    unsigned int y0 = per * band + ((unsigned int) band < extra ? (unsigned int) band : extra);
+    unsigned int y1 = y0 + per + ((unsigned int) band < extra), j;
+    size_t row = (size_t) c->n * z->s->img_x;
+    // this band's line buffers, then the row it converts last
+    stbi_uc *band_buf = c->linebuf + (size_t) band * (c->decode_n * (z->s->img_x + 3) + row + 1);
+    stbi_uc *linebuf[4] = { NULL, NULL, NULL, NULL };
+    stbi_uc *last_row = band_buf + (size_t) c->decode_n * (z->s->img_x + 3);
+    stbi__resample res_comp[4];
+    int k;
+    
+    for (k=0; k < c->decode_n; ++k)
+        linebuf[k] = band_buf + (size_t) k * (z->s->img_x + 3);
+    
+    // the resamplers carry state from row to row, step them through the rows above the band
+    memcpy(res_comp, c->res_comp, sizeof(res_comp));
+    for (j=0; j < y0; ++j)
+        for (k=0; k < c->decode_n; ++k)
+            stbi__resample_next_row(&res_comp[k], z->img_comp[k].y, z->img_comp[k].w2);
+    for (j=y0; j+1 < y1; ++j)
+        stbi__jpeg_convert_row(c, res_comp, linebuf, c->output + row * j);
+    // the byte past the last row is in the next band, which may be converting it right now
+    stbi__jpeg_convert_row(c, res_comp, linebuf, last_row);
+    memcpy(c->output + row * j, last_row, row);
+}
+
+static stbi_uc *load_jpeg_image(stbi__jpeg *z, int *out_x, int *out_y, int *comp, int req_comp)
+{
+    int n, decode_n, is_rgb, first_row = 0, rows, row;
     z->s->img_n = 0; // make stbi__cleanup_jpeg safe
     
     // validate req_comp
@@ -3647,6 +4554,18 @@ static stbi_uc *load_jpeg_image(stbi__jpeg *z, int *out_x, int *out_y, int *comp
     // load a jpeg image from whichever source, but leave in YCbCr format
     if (!stbi__decode_jpeg_image(z)) { stbi__cleanup_jpeg(z); return NULL; }
     
+    // the image is as big as the reduced IDCT made it, and we convert only the rows of the region
+    {
+        int w = z->s->img_x, k;
+        rows = z->s->img_y;
+        if (!stbi__region_size(z->s, &w, &rows)) { stbi__cleanup_jpeg(z); return NULL; }
+        if (stbi__region_requested(z->s)) first_row = z->s->options->first_row;
+        z->s->img_x = (z->s->img_x + (1 << z->scale_log2) - 1) >> z->scale_log2;
+        z->s->img_y = (z->s->img_y + (1 << z->scale_log2) - 1) >> z->scale_log2;
+        for (k=0; k < z->s->img_n; ++k)
+            z->img_comp[k].y = (z->img_comp[k].y + (1 << z->scale_log2) - 1) >> z->scale_log2;
+    }
+    
     // determine actual number of components to generate
     n = req_comp ? req_comp : z->s->img_n >= 3 ? 3 : 1;
     
@@ -3660,14 +4579,12 @@ static stbi_uc *load_jpeg_image(stbi__jpeg *z, int *out_x, int *out_y, int *comp
     // resample and color-convert
     {
         int k;
-        unsigned int i,j;
         stbi_uc *output;
-        stbi_uc *coutput[4] = { NULL, NULL, NULL, NULL };
-        
-        stbi__resample res_comp[4];
+        stbi_uc *linebuf[4];
+        stbi__jpeg_convert convert;
         
         for (k=0; k < decode_n; ++k) {
-            stbi__resample *r = &res_comp[k];
+            stbi__resample *r = &convert.res_comp[k];
             
             // allocate line buffer big enough for upsampling off the edges
             // with upsample factor of 4
@@ -3689,107 +4606,44 @@ static stbi_uc *load_jpeg_image(stbi__jpeg *z, int *out_x, int *out_y, int *comp
         }
         
         // can't error after this so, this is safe
-        output = (stbi_uc *) stbi__malloc_mad3(n, z->s->img_x, z->s->img_y, 1);
+        output = (stbi_uc *) stbi__malloc_mad3(n, z->s->img_x, rows, 1);
         if (!output) { stbi__cleanup_jpeg(z); return stbi__errpuc("outofmem", "Out of memory"); }
         
-        // now go ahead and resample
-        for (j=0; j < z->s->img_y; ++j) {
-            stbi_uc *out = output + n * z->s->img_x * j;
-            for (k=0; k < decode_n; ++k) {
-                stbi__resample *r = &res_comp[k];
-                int y_bot = r->ystep >= (r->vs >> 1);
-                coutput[k] = r->resample(z->img_comp[k].linebuf,
-                                         y_bot ? r->line1 : r->line0,
-                                         y_bot ? r->line0 : r->line1,
-                                         r->w_lores, r->hs);
-                if (++r->ystep >= r->vs) {
-                    r->ystep = 0;
-                    r->line0 = r->line1;
-                    if (++r->ypos < z->img_comp[k].y)
-                        r->line1 += z->img_comp[k].w2;
-                }
-            }
-            if (n >= 3) {
-                stbi_uc *y = coutput[0];
-                if (z->s->img_n == 3) {
-                    if (is_rgb) {
-                        for (i=0; i < z->s->img_x; ++i) {
-                            out[0] = y[i];
-                            out[1] = coutput[1][i];
-                            out[2] = coutput[2][i];
-                            out[3] = 255;
-                            out += n;
-                        }
-                    } else {
-                        z->YCbCr_to_RGB_kernel(out, y, coutput[1], coutput[2], z->s->img_x, n);
-                    }
-                } else if (z->s->img_n == 4) {
-                    if (z->app14_color_transform == 0) { // CMYK
-                        for (i=0; i < z->s->img_x; ++i) {
-                            stbi_uc m = coutput[3][i];
-                            out[0] = stbi__blinn_8x8(coutput[0][i], m);
-                            out[1] = stbi__blinn_8x8(coutput[1][i], m);
-                            out[2] = stbi__blinn_8x8(coutput[2][i], m);
-                            out[3] = 255;
-                            out += n;
-                        }
-                    } else if (z->app14_color_transform == 2) { // YCCK
-                        z->YCbCr_to_RGB_kernel(out, y, coutput[1], coutput[2], z->s->img_x, n);
-                        for (i=0; i < z->s->img_x; ++i) {
-                            stbi_uc m = coutput[3][i];
-                            out[0] = stbi__blinn_8x8(255 - out[0], m);
-                            out[1] = stbi__blinn_8x8(255 - out[1], m);
-                            out[2] = stbi__blinn_8x8(255 - out[2], m);
-                            out += n;
-                        }
-                    } else { // YCbCr + alpha?  Ignore the fourth channel for now
-                        z->YCbCr_to_RGB_kernel(out, y, coutput[1], coutput[2], z->s->img_x, n);
-                    }
-                } else
-                    for (i=0; i < z->s->img_x; ++i) {
-                        out[0] = out[1] = out[2] = y[i];
-                        out[3] = 255; // not used if n==3
-                        out += n;
-                    }
-            } else {
-                if (is_rgb) {
-                    if (n == 1)
-                        for (i=0; i < z->s->img_x; ++i)
-                            *out++ = stbi__compute_y(coutput[0][i], coutput[1][i], coutput[2][i]);
-                    else {
-                        for (i=0; i < z->s->img_x; ++i, out += 2) {
-                            out[0] = stbi__compute_y(coutput[0][i], coutput[1][i], coutput[2][i]);
-                            out[1] = 255;
-                        }
-                    }
-                } else if (z->s->img_n == 4 && z->app14_color_transform == 0) {
-                    for (i=0; i < z->s->img_x; ++i) {
-                        stbi_uc m = coutput[3][i];
-                        stbi_uc r = stbi__blinn_8x8(coutput[0][i], m);
-                        stbi_uc g = stbi__blinn_8x8(coutput[1][i], m);
-                        stbi_uc b = stbi__blinn_8x8(coutput[2][i], m);
-                        out[0] = stbi__compute_y(r, g, b);
-                        out[1] = 255;
-                        out += n;
-                    }
-                } else if (z->s->img_n == 4 && z->app14_color_transform == 2) {
-                    for (i=0; i < z->s->img_x; ++i) {
-                        out[0] = stbi__blinn_8x8(255 - coutput[0][i], coutput[3][i]);
-                        out[1] = 255;
-                        out += n;
-                    }
-                } else {
-                    stbi_uc *y = coutput[0];
-                    if (n == 1)
-                        for (i=0; i < z->s->img_x; ++i) out[i] = y[i];
-                    else
-                        for (i=0; i < z->s->img_x; ++i) { *out++ = y[i]; *out++ = 255; }
-                }
-            }
+        // step the resamplers through the rows above the region
+        for (row=0; row < first_row; ++row)
+            for (k=0; k < decode_n; ++k)
+                stbi__resample_next_row(&convert.res_comp[k], z->img_comp[k].y, z->img_comp[k].w2);
+        
+        // now go ahead and resample, in bands of at least 32 rows when the caller gives us threads
+        convert.z = z;
+        convert.output = output;
+        convert.n = n;
+        convert.decode_n = decode_n;
+        convert.is_rgb = is_rgb;
+        convert.rows = rows;
+        convert.bands = 1;
+        if (z->s->options && z->s->options->parallel_for) {
+            convert.bands = rows / 32 < STBI__JPEG_MAX_TASKS ? rows / 32 : STBI__JPEG_MAX_TASKS;
+            // without the memory for the bands we convert on our own
+            if (convert.bands >= 2 && stbi__mad2sizes_valid(decode_n, z->s->img_x + 3, n * z->s->img_x + 1))
+                convert.linebuf = (stbi_uc *) stbi__malloc_mad2(convert.bands, decode_n * (z->s->img_x + 3) + n * z->s->img_x + 1, 0);
+            else
+                convert.linebuf = NULL;
+            if (!convert.linebuf) convert.bands = 1;
+        }
+        if (convert.bands >= 2) {
+            z->s->options->parallel_for(z->s->options->parallel_user, stbi__jpeg_convert_band, &convert, convert.bands);
+            STBI_FREE(convert.linebuf);
+        } else {
+            unsigned int j;
+            for (k=0; k < decode_n; ++k)
+                linebuf[k] = z->img_comp[k].linebuf;
+            for (j=0; j < (unsigned int) rows; ++j)
+                stbi__jpeg_convert_row(&convert, convert.res_comp, linebuf, output + n * z->s->img_x * j);
         }
         stbi__cleanup_jpeg(z);
         *out_x = z->s->img_x;
-        *out_y = z->s->img_y;
+        *out_y = rows;
         if (comp) *comp = z->s->img_n >= 3 ? 3 : 1; // report original components, not output
         return output;
     }
@@ -3799,10 +4653,15 @@ static void *stbi__jpeg_load(stbi__context *s, int *x, int *y, int *comp, int re
 {
     unsigned char* result;
     stbi__jpeg* j = (stbi__jpeg*) stbi__malloc(sizeof(stbi__jpeg));
-    STBI_NOTUSED(ri);
     j->s = s;
     stbi__setup_jpeg(j);
+    // the reduced IDCT scales while decoding (stbi__load_main checked the options)
+    j->scale_log2 = s->options ? s->options->scale_log2 : 0;
+    if      (j->scale_log2 == 1) j->idct_block_kernel = stbi__idct_4x4;
+    else if (j->scale_log2 == 2) j->idct_block_kernel = stbi__idct_2x2;
+    else if (j->scale_log2 == 3) j->idct_block_kernel = stbi__idct_1x1;
     result = load_jpeg_image(j, x,y,comp,req_comp);
+    ri->region_done = 1;
     STBI_FREE(j);
     return result;
 }
@@ -3852,14 +4711,20 @@ static int stbi__jpeg_info(stbi__context *s, int *x, int *y, int *comp)
 #ifndef STBI_NO_ZLIB
 
 // fast-way is faster to check than jpeg huffman, but slow way is slower
-#define STBI__ZFAST_BITS  9 // accelerate all cases in default tables
+#define STBI__ZFAST_BITS  11 // accelerate all cases in default tables, and most in the dynamic ones
 #define STBI__ZFAST_MASK  ((1 << STBI__ZFAST_BITS) - 1)
 
+// fast table entries: bits 0-8 symbol, 9-12 code size, and for two literals whose codes fit in
+// STBI__ZFAST_BITS together, bits 16-23 the second literal and 24-27 the size of both codes
+#define STBI__ZFAST_SYMBOL(b)    ((b) & 511)
+#define STBI__ZFAST_SIZE(b)      (((b) >> 9) & 15)
+#define STBI__ZFAST_PAIR_SIZE(b) ((b) >> 24)
+
 // zlib-style huffman encoding
 // (jpegs packs from left, zlib from right, so can't share code)
 typedef struct
 {
-    stbi__uint16 fast[1 << STBI__ZFAST_BITS];
+    stbi__uint32 fast[1 << STBI__ZFAST_BITS];
     stbi__uint16 firstcode[16];
     int maxcode[17];
     stbi__uint16 firstsymbol[16];
@@ -3915,7 +4780,7 @@ static int stbi__zbuild_huffman(stbi__zhuffman *z, const stbi_uc *sizelist, int
         int s = sizelist[i];
         if (s) {
             int c = next_code[s] - z->firstcode[s] + z->firstsymbol[s];
-            stbi__uint16 fastv = (stbi__uint16) ((s << 9) | i);
+            stbi__uint32 fastv = (stbi__uint32) ((s << 9) | i);
             z->size [c] = (stbi_uc     ) s;
             z->value[c] = (stbi__uint16) i;
             if (s <= STBI__ZFAST_BITS) {
@@ -3931,17 +4796,39 @@ static int stbi__zbuild_huffman(stbi__zhuffman *z, const stbi_uc *sizelist, int
     return 1;
 }
 
+// let the fast entries of a literal/length table decode two literals at once when both codes fit
+static void stbi__zbuild_literal_pairs(stbi__zhuffman *z)
+{
+    int j;
+    for (j=0; j < (1 << STBI__ZFAST_BITS); ++j) {
+        stbi__uint32 first = z->fast[j], second;
+        int s1 = STBI__ZFAST_SIZE(first), s2;
+        if (!first || STBI__ZFAST_SYMBOL(first) >= 256) continue;
+        // the bits after the first code; the entries before j are already paired, only take their first code
+        second = z->fast[j >> s1] & 0xffff;
+        s2 = STBI__ZFAST_SIZE(second);
+        if (second && STBI__ZFAST_SYMBOL(second) < 256 && s1 + s2 <= STBI__ZFAST_BITS)
+            z->fast[j] = first | (STBI__ZFAST_SYMBOL(second) << 16) | ((stbi__uint32) (s1 + s2) << 24);
+    }
+}
+
 // zlib-from-memory implementation for PNG reading
 //    because PNG allows splitting the zlib stream arbitrarily,
 //    and it's annoying structurally to have PNG call ZLIB call PNG,
 //    we require PNG read all the IDATs and combine them into a single
 //    memory buffer
 
+// the bit buffer is as wide as a register: on 64-bit targets one refill covers a whole length/distance pair
+typedef size_t stbi__zbits;
+#define STBI__ZBITS_WIDTH ((int) sizeof(stbi__zbits) * 8)
+
 typedef struct
 {
     stbi_uc *zbuffer, *zbuffer_end;
     int num_bits;
-    stbi__uint32 code_buffer;
+    stbi__zbits code_buffer;
+    // zero bits added past the end of the input, and whether a corrupt stream went on decoding them
+    int padding_bits, overrun;
     
     char *zout;
     char *zout_start;
@@ -3959,18 +4846,35 @@ stbi_inline static stbi_uc stbi__zget8(stbi__zbuf *z)
 
 static void stbi__fill_bits(stbi__zbuf *z)
 {
+#if defined(STBI__X86_TARGET) || defined(STBI__X64_TARGET)
+    // little endian with unaligned loads: add a whole word, then count the bytes that fit. The bits above
+    // num_bits are the bytes the next refill adds again, so they are left in place
+    if (z->zbuffer_end - z->zbuffer >= (ptrdiff_t) sizeof(stbi__zbits)) {
+        stbi__zbits word;
+        memcpy(&word, z->zbuffer, sizeof(word));
+        z->code_buffer |= word << z->num_bits;
+        z->zbuffer += (STBI__ZBITS_WIDTH - 1 - z->num_bits) >> 3;
+        z->num_bits |= STBI__ZBITS_WIDTH - 8;
+        return;
+    }
+    // the bits above num_bits are set by the word refills, clear them before adding bytes there
+    z->code_buffer &= ((stbi__zbits) 1 << z->num_bits) - 1;
+#endif
+    // decoding may look ahead of the end, but never uses the padding
+    if (z->padding_bits > z->num_bits) z->overrun = 1;
     do {
-        STBI_ASSERT(z->code_buffer < (1U << z->num_bits));
-        z->code_buffer |= (unsigned int) stbi__zget8(z) << z->num_bits;
+        STBI_ASSERT(z->code_buffer < ((stbi__zbits) 1 << z->num_bits));
+        if (z->zbuffer >= z->zbuffer_end) z->padding_bits += 8;
+        z->code_buffer |= (stbi__zbits) stbi__zget8(z) << z->num_bits;
         z->num_bits += 8;
-    } while (z->num_bits <= 24);
+    } while (z->num_bits <= STBI__ZBITS_WIDTH - 8);
 }
 
 stbi_inline static unsigned int stbi__zreceive(stbi__zbuf *z, int n)
 {
     unsigned int k;
     if (z->num_bits < n) stbi__fill_bits(z);
-    k = z->code_buffer & ((1 << n) - 1);
+    k = (unsigned int) (z->code_buffer & ((1 << n) - 1));
     z->code_buffer >>= n;
     z->num_bits -= n;
     return k;
@@ -3981,7 +4885,7 @@ static int stbi__zhuffman_decode_slowpath(stbi__zbuf *a, stbi__zhuffman *z)
     int b,s,k;
     // not resolved by fast table, so compute it the slow way
     // use jpeg approach, which requires MSbits at top
-    k = stbi__bit_reverse(a->code_buffer, 16);
+    k = stbi__bit_reverse((int) (a->code_buffer & 0xffff), 16);
     for (s=STBI__ZFAST_BITS+1; ; ++s)
         if (k < z->maxcode[s])
             break;
@@ -4000,10 +4904,10 @@ stbi_inline static int stbi__zhuffman_decode(stbi__zbuf *a, stbi__zhuffman *z)
     if (a->num_bits < 16) stbi__fill_bits(a);
     b = z->fast[a->code_buffer & STBI__ZFAST_MASK];
     if (b) {
-        s = b >> 9;
+        s = STBI__ZFAST_SIZE(b);
         a->code_buffer >>= s;
         a->num_bits -= s;
-        return b & 511;
+        return STBI__ZFAST_SYMBOL(b);
     }
     return stbi__zhuffman_decode_slowpath(a, z);
 }
@@ -4045,7 +4949,27 @@ static int stbi__parse_huffman_block(stbi__zbuf *a)
 {
     char *zout = a->zout;
     for(;;) {
-        int z = stbi__zhuffman_decode(a, &a->z_length);
+        int z;
+        stbi__uint32 b;
+        if (a->num_bits < 16) {
+            stbi__fill_bits(a);
+            // without this, a truncated stream could decode zeros until the output no longer fits in memory
+            if (a->overrun) return stbi__err("unexpected end","Corrupt PNG");
+        }
+        b = a->z_length.fast[a->code_buffer & STBI__ZFAST_MASK];
+        if (STBI__ZFAST_PAIR_SIZE(b)) {
+            if (a->zout_end - zout < 2) {
+                if (!stbi__zexpand(a, zout, 2)) return 0;
+                zout = a->zout;
+            }
+            zout[0] = (char) b;
+            zout[1] = (char) (b >> 16);
+            zout += 2;
+            a->code_buffer >>= STBI__ZFAST_PAIR_SIZE(b);
+            a->num_bits -= STBI__ZFAST_PAIR_SIZE(b);
+            continue;
+        }
+        z = stbi__zhuffman_decode(a, &a->z_length);
         if (z < 256) {
             if (z < 0) return stbi__err("bad huffman code","Corrupt PNG"); // error in huffman codes
             if (zout >= a->zout_end) {
@@ -4068,14 +4992,26 @@ static int stbi__parse_huffman_block(stbi__zbuf *a)
             dist = stbi__zdist_base[z];
             if (stbi__zdist_extra[z]) dist += stbi__zreceive(a, stbi__zdist_extra[z]);
             if (zout - a->zout_start < dist) return stbi__err("bad dist","Corrupt PNG");
+            // matches refill the bits themselves, so check here too
+            if (a->overrun) return stbi__err("unexpected end","Corrupt PNG");
             if (zout + len > a->zout_end) {
                 if (!stbi__zexpand(a, zout, len)) return 0;
                 zout = a->zout;
             }
             p = (stbi_uc *) (zout - dist);
             if (dist == 1) { // run of one byte; common in images.
-                stbi_uc v = *p;
-                if (len) { do *zout++ = v; while (--len); }
+                memset(zout, *p, len);
+                zout += len;
+            } else if (dist >= 8 && a->zout_end - zout >= len + 7) {
+                // 8 bytes at a time: with dist >= 8 every word is read before it is written over,
+                // the up to 7 bytes written past the match are overwritten by what follows
+                char *end = zout + len;
+                do {
+                    memcpy(zout, p, 8);
+                    zout += 8;
+                    p += 8;
+                } while (zout < end);
+                zout = end;
             } else {
                 if (len) { do *zout++ = *p++; while (--len); }
             }
@@ -4140,24 +5076,32 @@ static int stbi__parse_uncompressed_block(stbi__zbuf *a)
         stbi__zreceive(a, a->num_bits & 7); // discard
     // drain the bit-packed data into header
     k = 0;
-    while (a->num_bits > 0) {
+    while (a->num_bits > 0 && k < 4) {
         header[k++] = (stbi_uc) (a->code_buffer & 255); // suppress MSVC run-time check
         a->code_buffer >>= 8;
         a->num_bits -= 8;
     }
-    STBI_ASSERT(a->num_bits == 0);
     // now fill header the normal way
     while (k < 4)
         header[k++] = stbi__zget8(a);
     len  = header[1] * 256 + header[0];
     nlen = header[3] * 256 + header[2];
     if (nlen != (len ^ 0xffff)) return stbi__err("zlib corrupt","Corrupt PNG");
-    if (a->zbuffer + len > a->zbuffer_end) return stbi__err("read past buffer","Corrupt PNG");
     if (a->zout + len > a->zout_end)
         if (!stbi__zexpand(a, a->zout, len)) return 0;
+    // a wide bit buffer may hold the first bytes of the block already
+    while (a->num_bits > 0 && len > 0) {
+        *a->zout++ = (char) (a->code_buffer & 255);
+        a->code_buffer >>= 8;
+        a->num_bits -= 8;
+        --len;
+    }
+    if (a->zbuffer + len > a->zbuffer_end) return stbi__err("read past buffer","Corrupt PNG");
     memcpy(a->zout, a->zbuffer, len);
     a->zbuffer += len;
     a->zout += len;
+    // the refill keeps the bytes after num_bits in the bit buffer, those are not next anymore
+    a->code_buffer &= ((stbi__zbits) 1 << a->num_bits) - 1;
     return 1;
 }
 
@@ -4210,6 +5154,8 @@ static int stbi__parse_zlib(stbi__zbuf *a, int parse_header)
         if (!stbi__parse_zlib_header(a)) return 0;
     a->num_bits = 0;
     a->code_buffer = 0;
+    a->padding_bits = 0;
+    a->overrun = 0;
     do {
         final = stbi__zreceive(a,1);
         type = stbi__zreceive(a,2);
@@ -4225,6 +5171,7 @@ static int stbi__parse_zlib(stbi__zbuf *a, int parse_header)
             } else {
                 if (!stbi__compute_huffman_codes(a)) return 0;
             }
+            stbi__zbuild_literal_pairs(&a->z_length);
             if (!stbi__parse_huffman_block(a)) return 0;
         }
     } while (!final);
@@ -4392,6 +5339,157 @@ static int stbi__paeth(int a, int b, int c)
 
 static const stbi_uc stbi__depth_scale_table[9] = { 0, 0xff, 0x55, 0, 0x11, 0,0,0, 0x01 };
 
+#if defined(STBI_SSE2) || defined(STBI_NEON)
+// sub, avg and paeth of 3 and 4 channel 8-bit rows. every pixel depends on the one to its left, but its
+// channels do not depend on each other, so the SIMD code does one pixel per register instead of one byte
+// at a time. cur, raw and prior point at the second pixel of the row, n is 3 or 4. produces the same
+// bytes as the scalar loops; returns 0 for the filters it leaves to them.
+
+// a pixel into the low lanes of an integer and back. except for the last one of a row, 3-channel pixels
+// move 4 bytes, one move instead of two: the extra lane is computed but never used, and the byte it writes
+// is the first of the next pixel, written again right after
+stbi_inline static stbi__uint32 stbi__png_load_pixel(const stbi_uc *p, int n, int last)
+{
+    stbi__uint32 v = 0;
+    if (last) memcpy(&v, p, n);
+    else      memcpy(&v, p, 4);
+    return v;
+}
+
+stbi_inline static void stbi__png_store_pixel(stbi_uc *p, stbi__uint32 v, int n, int last)
+{
+    if (last) memcpy(p, &v, n);
+    else      memcpy(p, &v, 4);
+}
+
+#ifdef STBI_SSE2
+
+#ifdef __SSSE3__
+#include <tmmintrin.h>
+#define stbi__png_abs16(x) _mm_abs_epi16(x)
+#else
+#define stbi__png_abs16(x) _mm_max_epi16((x), _mm_sub_epi16(_mm_setzero_si128(), (x)))
+#endif
+
+stbi_inline static __m128i stbi__png_select(__m128i mask, __m128i a, __m128i b)
+{
+    return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+}
+
+stbi_inline static int stbi__png_unfilter_simd(stbi_uc *cur, const stbi_uc *raw, const stbi_uc *prior, int filter, int n, int pixels)
+{
+    __m128i zero = _mm_setzero_si128();
+    __m128i a = _mm_cvtsi32_si128((int) stbi__png_load_pixel(cur - n, n, 1));
+    int i;
+    switch (filter) {
+        case STBI__F_sub:
+            for (i=0; i < pixels; ++i, raw += n, cur += n) {
+                int last = i == pixels - 1;
+                a = _mm_add_epi8(a, _mm_cvtsi32_si128((int) stbi__png_load_pixel(raw, n, last)));
+                stbi__png_store_pixel(cur, (stbi__uint32) _mm_cvtsi128_si32(a), n, last);
+            }
+            return 1;
+        case STBI__F_avg:
+            for (i=0; i < pixels; ++i, raw += n, cur += n, prior += n) {
+                int last = i == pixels - 1;
+                __m128i b = _mm_cvtsi32_si128((int) stbi__png_load_pixel(prior, n, last));
+                // _mm_avg_epu8 rounds up, (a+b)>>1 rounds down
+                __m128i avg = _mm_sub_epi8(_mm_avg_epu8(a, b), _mm_and_si128(_mm_xor_si128(a, b), _mm_set1_epi8(1)));
+                a = _mm_add_epi8(avg, _mm_cvtsi32_si128((int) stbi__png_load_pixel(raw, n, last)));
+                stbi__png_store_pixel(cur, (stbi__uint32) _mm_cvtsi128_si32(a), n, last);
+            }
+            return 1;
+        case STBI__F_paeth: {
+            // in 16-bit lanes: a left, b up, c up left
+            __m128i a16 = _mm_unpacklo_epi8(a, zero);
+            __m128i c16 = _mm_unpacklo_epi8(_mm_cvtsi32_si128((int) stbi__png_load_pixel(prior - n, n, 1)), zero);
+            for (i=0; i < pixels; ++i, raw += n, cur += n, prior += n) {
+                int last = i == pixels - 1;
+                __m128i b16 = _mm_unpacklo_epi8(_mm_cvtsi32_si128((int) stbi__png_load_pixel(prior, n, last)), zero);
+                __m128i bc = _mm_sub_epi16(b16, c16), ac = _mm_sub_epi16(a16, c16);
+                // the distances of p = a+b-c to a, b and c, ties go to a, then b
+                __m128i pa = stbi__png_abs16(bc), pb = stbi__png_abs16(ac), pc = stbi__png_abs16(_mm_add_epi16(bc, ac));
+                __m128i smallest = _mm_min_epi16(pc, _mm_min_epi16(pa, pb));
+                __m128i nearest = stbi__png_select(_mm_cmpeq_epi16(smallest, pa), a16,
+                                  stbi__png_select(_mm_cmpeq_epi16(smallest, pb), b16, c16));
+                __m128i d = _mm_add_epi8(_mm_packus_epi16(nearest, nearest),
+                                         _mm_cvtsi32_si128((int) stbi__png_load_pixel(raw, n, last)));
+                stbi__png_store_pixel(cur, (stbi__uint32) _mm_cvtsi128_si32(d), n, last);
+                a16 = _mm_unpacklo_epi8(d, zero);
+                c16 = b16;
+            }
+            return 1;
+        }
+    }
+    return 0;
+}
+
+#else // STBI_NEON
+
+stbi_inline static uint8x8_t stbi__png_load_pixel_neon(const stbi_uc *p, int n, int last)
+{
+    return vreinterpret_u8_u32(vdup_n_u32(stbi__png_load_pixel(p, n, last)));
+}
+
+stbi_inline static int stbi__png_unfilter_simd(stbi_uc *cur, const stbi_uc *raw, const stbi_uc *prior, int filter, int n, int pixels)
+{
+    uint8x8_t a = stbi__png_load_pixel_neon(cur - n, n, 1);
+    int i;
+    switch (filter) {
+        case STBI__F_sub:
+            for (i=0; i < pixels; ++i, raw += n, cur += n) {
+                int last = i == pixels - 1;
+                a = vadd_u8(a, stbi__png_load_pixel_neon(raw, n, last));
+                stbi__png_store_pixel(cur, vget_lane_u32(vreinterpret_u32_u8(a), 0), n, last);
+            }
+            return 1;
+        case STBI__F_avg:
+            for (i=0; i < pixels; ++i, raw += n, cur += n, prior += n) {
+                int last = i == pixels - 1;
+                // vhadd rounds down like (a+b)>>1
+                a = vadd_u8(vhadd_u8(a, stbi__png_load_pixel_neon(prior, n, last)), stbi__png_load_pixel_neon(raw, n, last));
+                stbi__png_store_pixel(cur, vget_lane_u32(vreinterpret_u32_u8(a), 0), n, last);
+            }
+            return 1;
+        case STBI__F_paeth: {
+            uint8x8_t c = stbi__png_load_pixel_neon(prior - n, n, 1);
+            for (i=0; i < pixels; ++i, raw += n, cur += n, prior += n) {
+                int last = i == pixels - 1;
+                uint8x8_t b = stbi__png_load_pixel_neon(prior, n, last);
+                // the distances of p = a+b-c to a, b and c, ties go to a, then b
+                uint16x8_t pa = vabdl_u8(b, c), pb = vabdl_u8(a, c);
+                uint16x8_t pc = vabdq_u16(vaddl_u8(a, b), vaddl_u8(c, c));
+                uint8x8_t use_a = vmovn_u16(vandq_u16(vcleq_u16(pa, pb), vcleq_u16(pa, pc)));
+                uint8x8_t use_b = vmovn_u16(vcleq_u16(pb, pc));
+                uint8x8_t nearest = vbsl_u8(use_a, a, vbsl_u8(use_b, b, c));
+                a = vadd_u8(nearest, stbi__png_load_pixel_neon(raw, n, last));
+                stbi__png_store_pixel(cur, vget_lane_u32(vreinterpret_u32_u8(a), 0), n, last);
+                c = b;
+            }
+            return 1;
+        }
+    }
+    return 0;
+}
+
+#endif
+
+// 16-bit samples from big-endian to native, 8 at a time
+static stbi__uint32 stbi__png_swap16_simd(stbi_uc *p, stbi__uint32 count)
+{
+    stbi__uint32 i = 0;
+    for (; i + 8 <= count; i += 8, p += 16) {
+#ifdef STBI_SSE2
+        __m128i v = _mm_loadu_si128((__m128i *) p);
+        _mm_storeu_si128((__m128i *) p, _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8)));
+#else
+        vst1q_u8(p, vrev16q_u8(vld1q_u8(p)));
+#endif
+    }
+    return i;
+}
+#endif // STBI_SSE2 || STBI_NEON
+
 // create the png data from post-deflated data
 static int stbi__create_png_image_raw(stbi__png *a, stbi_uc *raw, stbi__uint32 raw_len, int out_n, stbi__uint32 x, stbi__uint32 y, int depth, int color)
 {
@@ -4405,6 +5503,11 @@ static int stbi__create_png_image_raw(stbi__png *a, stbi_uc *raw, stbi__uint32 r
     int output_bytes = out_n*bytes;
     int filter_bytes = img_n*bytes;
     int width = x;
+#ifdef STBI_SSE2
+    int simd = stbi__sse2_available();
+#elif defined(STBI_NEON)
+    int simd = 1;
+#endif
     
     STBI_ASSERT(out_n == s->img_n || out_n == s->img_n+1);
     a->out = (stbi_uc *) stbi__malloc_mad3(x, y, output_bytes, 0); // extra bytes to write off the end into
@@ -4474,9 +5577,17 @@ static int stbi__create_png_image_raw(stbi__png *a, stbi_uc *raw, stbi__uint32 r
         // this is a little gross, so that we don't switch per-pixel or per-component
         if (depth < 8 || img_n == out_n) {
             int nk = (width - 1)*filter_bytes;
+            int done = 0;
+#if defined(STBI_SSE2) || defined(STBI_NEON)
+            if (simd && depth == 8 && (filter_bytes == 3 || filter_bytes == 4))
+                // with n constant the pixel loads and stores are single moves
+                done = filter_bytes == 4 ? stbi__png_unfilter_simd(cur, raw, prior, filter, 4, width - 1)
+                                         : stbi__png_unfilter_simd(cur, raw, prior, filter, 3, width - 1);
+#endif
 #define STBI__CASE(f) \
 case f:     \
 for (k=0; k < nk; ++k)
+            if (!done)
             switch (filter) {
                     // "none" filter turns into a memcpy here; make that explicit.
                 case STBI__F_none:         memcpy(cur, raw, nk); break;
@@ -4597,7 +5708,15 @@ for (k=0; k < filter_bytes; ++k)
         stbi_uc *cur = a->out;
         stbi__uint16 *cur16 = (stbi__uint16*)cur;
         
-        for(i=0; i < x*y*out_n; ++i,cur16++,cur+=2) {
+        i = 0;
+#if defined(STBI_SSE2) || defined(STBI_NEON)
+        if (simd) {
+            i = stbi__png_swap16_simd(cur, x*y*out_n);
+            cur += i*2;
+            cur16 += i;
+        }
+#endif
+        for(; i < x*y*out_n; ++i,cur16++,cur+=2) {
             *cur16 = (cur[0] << 8) | cur[1];
         }
     }
@@ -4605,6 +5724,28 @@ for (k=0; k < filter_bytes; ++k)
     return 1;
 }
 
+// the adam7 passes: first pixel and spacing of each
+static const int stbi__png_xorig[] = { 0,4,0,2,0,1,0 };
+static const int stbi__png_yorig[] = { 0,0,4,0,2,0,1 };
+static const int stbi__png_xspc[]  = { 8,8,4,4,2,2,1 };
+static const int stbi__png_yspc[]  = { 8,8,8,4,4,2,2 };
+
+// size of the inflated image data, filter bytes included, so it can be allocated once
+static stbi__uint32 stbi__png_raw_size(stbi__uint32 w, stbi__uint32 h, int img_n, int depth, int interlaced)
+{
+    stbi__uint32 raw_len = 0;
+    int p;
+    if (!interlaced)
+        return ((w * depth + 7) / 8) * h * img_n /* pixels */ + h /* filter mode per row */;
+    for (p=0; p < 7; ++p) {
+        stbi__uint32 x = (w - stbi__png_xorig[p] + stbi__png_xspc[p]-1) / stbi__png_xspc[p];
+        stbi__uint32 y = (h - stbi__png_yorig[p] + stbi__png_yspc[p]-1) / stbi__png_yspc[p];
+        if (x && y)
+            raw_len += (((img_n * x * depth) + 7) >> 3) * y + y;
+    }
+    return raw_len;
+}
+
 static int stbi__create_png_image(stbi__png *a, stbi_uc *image_data, stbi__uint32 image_data_len, int out_n, int depth, int color, int interlaced)
 {
     int bytes = (depth == 16 ? 2 : 1);
@@ -4617,10 +5758,8 @@ static int stbi__create_png_image(stbi__png *a, stbi_uc *image_data, stbi__uint3
     // de-interlacing
     final = (stbi_uc *) stbi__malloc_mad3(a->s->img_x, a->s->img_y, out_bytes, 0);
     for (p=0; p < 7; ++p) {
-        int xorig[] = { 0,4,0,2,0,1,0 };
-        int yorig[] = { 0,0,4,0,2,0,1 };
-        int xspc[]  = { 8,8,4,4,2,2,1 };
-        int yspc[]  = { 8,8,8,4,4,2,2 };
+        const int *xorig = stbi__png_xorig, *yorig = stbi__png_yorig;
+        const int *xspc = stbi__png_xspc, *yspc = stbi__png_yspc;
         int i,j,x,y;
         // pass1_x[4] = 0, pass1_x[5] = 1, pass1_x[12] = 1
         x = (a->s->img_x - xorig[p] + xspc[p]-1) / xspc[p];
@@ -4736,19 +5875,6 @@ static int stbi__expand_png_palette(stbi__png *a, stbi_uc *palette, int len, int
     return 1;
 }
 
-static int stbi__unpremultiply_on_load = 0;
-static int stbi__de_iphone_flag = 0;
-
-STBIDEF void stbi_set_unpremultiply_on_load(int flag_true_if_should_unpremultiply)
-{
-    stbi__unpremultiply_on_load = flag_true_if_should_unpremultiply;
-}
-
-STBIDEF void stbi_convert_iphone_png_to_rgb(int flag_true_if_should_convert)
-{
-    stbi__de_iphone_flag = flag_true_if_should_convert;
-}
-
 static void stbi__de_iphone(stbi__png *z)
 {
     stbi__context *s = z->s;
@@ -4764,7 +5890,7 @@ static void stbi__de_iphone(stbi__png *z)
         }
     } else {
         STBI_ASSERT(s->img_out_n == 4);
-        if (stbi__unpremultiply_on_load) {
+        if (stbi__unpremultiply(s)) {
             // convert bgr to rgb and unpremultiply
             for (i=0; i < pixel_count; ++i) {
                 stbi_uc a = p[3];
@@ -4905,13 +6031,12 @@ static int stbi__parse_png_file(stbi__png *z, int scan, int req_comp)
             }
                 
             case STBI__PNG_TYPE('I','E','N','D'): {
-                stbi__uint32 raw_len, bpl;
+                stbi__uint32 raw_len;
                 if (first) return stbi__err("first not IHDR", "Corrupt PNG");
                 if (scan != STBI__SCAN_load) return 1;
                 if (z->idata == NULL) return stbi__err("no IDAT","Corrupt PNG");
-                // initial guess for decoded data size to avoid unnecessary reallocs
-                bpl = (s->img_x * z->depth + 7) / 8; // bytes per line, per component
-                raw_len = bpl * s->img_y * s->img_n /* pixels */ + s->img_y /* filter mode per row */;
+                // the decoded data size is known from the header, allocate it once (a longer stream still grows it)
+                raw_len = stbi__png_raw_size(s->img_x, s->img_y, s->img_n, z->depth, interlace);
                 z->expanded = (stbi_uc *) stbi_zlib_decode_malloc_guesssize_headerflag((char *) z->idata, ioff, raw_len, (int *) &raw_len, !is_iphone);
                 if (z->expanded == NULL) return 0; // zlib should set error
                 STBI_FREE(z->idata); z->idata = NULL;
@@ -4927,7 +6052,7 @@ static int stbi__parse_png_file(stbi__png *z, int scan, int req_comp)
                         if (!stbi__compute_transparency(z, tc, s->img_out_n)) return 0;
                     }
                 }
-                if (is_iphone && stbi__de_iphone_flag && s->img_out_n > 2)
+                if (is_iphone && stbi__convert_iphone_png(s) && s->img_out_n > 2)
                     stbi__de_iphone(z);
                 if (pal_img_n) {
                     // pal_img_n == 3 or 4
@@ -4949,8 +6074,8 @@ static int stbi__parse_png_file(stbi__png *z, int scan, int req_comp)
                 if (first) return stbi__err("first not IHDR", "Corrupt PNG");
                 if ((c.type & (1 << 29)) == 0) {
 #ifndef STBI_NO_FAILURE_STRINGS
-                    // not threadsafe
-                    static char invalid_chunk[] = "XXXX PNG chunk not known";
+                    // one per thread (if STBI_THREAD_LOCAL is), the failure reason points to it
+                    static STBI_THREAD_LOCAL char invalid_chunk[] = "XXXX PNG chunk not known";
                     invalid_chunk[0] = STBI__BYTECAST(c.type >> 24);
                     invalid_chunk[1] = STBI__BYTECAST(c.type >> 16);
                     invalid_chunk[2] = STBI__BYTECAST(c.type >>  8);
@@ -5520,6 +6645,144 @@ static void stbi__tga_read_rgb16(stbi__context *s, stbi_uc* out)
     // so let's treat all 15 and 16bit TGAs as RGB with no alpha.
 }
 
+// n bytes as that many stbi__get8 calls would read them (zeros past the end of the data), copied a buffer
+// at a time
+static void stbi__tga_read(stbi__context *s, stbi_uc *out, int n)
+{
+    while (n > 0) {
+        int available = (int) (s->img_buffer_end - s->img_buffer);
+        if (available == 0) {
+            // refills the buffer from the callbacks, or returns 0 at the end
+            *out++ = stbi__get8(s);
+            --n;
+            continue;
+        }
+        if (available > n) available = n;
+        memcpy(out, s->img_buffer, available);
+        s->img_buffer += available;
+        out += available;
+        n -= available;
+    }
+}
+
+// n copies of a pixel of comp bytes, 16 pixels (3 or 4 registers) at a time with SIMD
+static void stbi__tga_fill(stbi_uc *out, const stbi_uc *pixel, int n, int comp, int simd)
+{
+    int i = 0, k;
+#if defined(STBI_SSE2)
+    if (simd && n >= 16 && (comp == 3 || comp == 4)) {
+        STBI_SIMD_ALIGN(stbi_uc, pattern[64]);
+        __m128i p0, p1, p2, p3;
+        for (k = 0; k < 16 * comp; ++k)
+            pattern[k] = pixel[k % comp];
+        p0 = _mm_load_si128((const __m128i *) pattern);
+        p1 = _mm_load_si128((const __m128i *) (pattern + 16));
+        p2 = _mm_load_si128((const __m128i *) (pattern + 32));
+        p3 = _mm_load_si128((const __m128i *) (pattern + 48));
+        for (; i + 16 <= n; i += 16) {
+            stbi_uc *o = out + i * comp;
+            _mm_storeu_si128((__m128i *) o, p0);
+            _mm_storeu_si128((__m128i *) (o + 16), p1);
+            _mm_storeu_si128((__m128i *) (o + 32), p2);
+            if (comp == 4) _mm_storeu_si128((__m128i *) (o + 48), p3);
+        }
+    }
+#elif defined(STBI_NEON)
+    if (simd && comp == 3) {
+        uint8x16x3_t v;
+        for (k = 0; k < 3; ++k) v.val[k] = vdupq_n_u8(pixel[k]);
+        for (; i + 16 <= n; i += 16) vst3q_u8(out + i * 3, v);
+    } else if (simd && comp == 4) {
+        uint8x16x4_t v;
+        for (k = 0; k < 4; ++k) v.val[k] = vdupq_n_u8(pixel[k]);
+        for (; i + 16 <= n; i += 16) vst4q_u8(out + i * 4, v);
+    }
+#else
+    STBI_NOTUSED(simd);
+#endif
+    for (; i < n; ++i)
+        for (k = 0; k < comp; ++k)
+            out[i * comp + k] = pixel[k];
+}
+
+// the pixels of an RLE TGA without a palette. packets may run across rows, they are cut at the end of each
+// row, which is written where it belongs when the image is stored bottom up (so it needs no flip after)
+static void stbi__tga_decode_rle(stbi__context *s, stbi_uc *out, int w, int h, int comp, int inverted, int simd)
+{
+    stbi_uc pixel[4] = {0};
+    int count = 0, repeating = 0, row, col, n;
+    for (row = 0; row < h; ++row) {
+        stbi_uc *dst = out + (size_t) (inverted ? h - 1 - row : row) * w * comp;
+        for (col = 0; col < w; col += n) {
+            if (count == 0) {
+                int cmd = stbi__get8(s);
+                count = 1 + (cmd & 127);
+                repeating = cmd >> 7;
+                if (repeating) stbi__tga_read(s, pixel, comp);
+            }
+            n = count < w - col ? count : w - col;
+            if (repeating) stbi__tga_fill(dst + col * comp, pixel, n, comp, simd);
+            else stbi__tga_read(s, dst + col * comp, n * comp);
+            count -= n;
+        }
+    }
+}
+
+// BGR(A) to RGB(A) in place
+static void stbi__tga_swap_rb(stbi_uc *p, size_t pixels, int comp, int simd)
+{
+    size_t i = 0;
+#if defined(STBI_SSE2)
+    if (simd && comp == 4) {
+        __m128i ga = _mm_set1_epi32((int) 0xff00ff00);
+        for (; i + 4 <= pixels; i += 4) {
+            __m128i v = _mm_loadu_si128((const __m128i *) (p + i * 4));
+            __m128i rb = _mm_andnot_si128(ga, v);
+            rb = _mm_or_si128(_mm_slli_epi32(rb, 16), _mm_srli_epi32(rb, 16));
+            _mm_storeu_si128((__m128i *) (p + i * 4), _mm_or_si128(_mm_and_si128(v, ga), rb));
+        }
+    } else if (simd && comp == 3) {
+        // 5 pixels (15 bytes) a step: the first byte of each pixel takes the one two to its right, the last
+        // the one two to its left. the 16th byte is kept, and swapped as part of the next 5 pixels
+        __m128i from_right = _mm_setr_epi8(-1,0,0, -1,0,0, -1,0,0, -1,0,0, -1,0,0, 0);
+        __m128i from_left  = _mm_setr_epi8(0,0,-1, 0,0,-1, 0,0,-1, 0,0,-1, 0,0,-1, 0);
+        __m128i keep       = _mm_setr_epi8(0,-1,0, 0,-1,0, 0,-1,0, 0,-1,0, 0,-1,0, -1);
+        for (; i * 3 + 16 <= pixels * 3; i += 5) {
+            __m128i v = _mm_loadu_si128((const __m128i *) (p + i * 3));
+            __m128i swapped = _mm_or_si128(_mm_and_si128(v, keep),
+                              _mm_or_si128(_mm_and_si128(_mm_srli_si128(v, 2), from_right),
+                                           _mm_and_si128(_mm_slli_si128(v, 2), from_left)));
+            _mm_storeu_si128((__m128i *) (p + i * 3), swapped);
+        }
+    }
+#elif defined(STBI_NEON)
+    if (simd && comp == 3) {
+        for (; i + 16 <= pixels; i += 16) {
+            uint8x16x3_t v = vld3q_u8(p + i * 3);
+            uint8x16_t b = v.val[0];
+            v.val[0] = v.val[2];
+            v.val[2] = b;
+            vst3q_u8(p + i * 3, v);
+        }
+    } else if (simd && comp == 4) {
+        for (; i + 16 <= pixels; i += 16) {
+            uint8x16x4_t v = vld4q_u8(p + i * 4);
+            uint8x16_t b = v.val[0];
+            v.val[0] = v.val[2];
+            v.val[2] = b;
+            vst4q_u8(p + i * 4, v);
+        }
+    }
+#else
+    STBI_NOTUSED(simd);
+#endif
+    for (; i < pixels; ++i) {
+        stbi_uc temp = p[i * comp];
+        p[i * comp] = p[i * comp + 2];
+        p[i * comp + 2] = temp;
+    }
+}
+
 static void *stbi__tga_load(stbi__context *s, int *x, int *y, int *comp, int req_comp, stbi__result_info *ri)
 {
     //   read in the TGA header stuff
@@ -5546,7 +6809,13 @@ static void *stbi__tga_load(stbi__context *s, int *x, int *y, int *comp, int req
     int RLE_count = 0;
     int RLE_repeating = 0;
     int read_next_pixel = 1;
+    int simd = 0;
     STBI_NOTUSED(ri);
+#ifdef STBI_SSE2
+    simd = stbi__sse2_available();
+#elif defined(STBI_NEON)
+    simd = 1;
+#endif
     
     //   do a tiny bit of precessing
     if ( tga_image_type >= 8 )
@@ -5571,7 +6840,12 @@ static void *stbi__tga_load(stbi__context *s, int *x, int *y, int *comp, int req
     if (!stbi__mad3sizes_valid(tga_width, tga_height, tga_comp, 0))
         return stbi__errpuc("too large", "Corrupt TGA");
     
-    tga_data = (unsigned char*)stbi__malloc_mad3(tga_width, tga_height, tga_comp, 0);
+    // straight into the buffer of the caller, unless the result gets converted or cut after
+    if (s->output && !stbi__region_requested(s) && (req_comp == 0 || req_comp == tga_comp) &&
+        (size_t) tga_width * tga_height * tga_comp <= s->output_size)
+        tga_data = s->output;
+    else
+        tga_data = (unsigned char*)stbi__malloc_mad3(tga_width, tga_height, tga_comp, 0);
     if (!tga_data) return stbi__errpuc("outofmem", "Out of memory");
     
     // skip to the data's starting position (offset usually = 0)
@@ -5583,6 +6857,8 @@ static void *stbi__tga_load(stbi__context *s, int *x, int *y, int *comp, int req
             stbi_uc *tga_row = tga_data + row*tga_width*tga_comp;
             stbi__getn(s, tga_row, tga_width * tga_comp);
         }
+    } else if ( !tga_indexed && !tga_rgb16 ) {
+        stbi__tga_decode_rle(s, tga_data, tga_width, tga_height, tga_comp, tga_inverted, simd);
     } else  {
         //   do I need to load a palette?
         if ( tga_indexed)
@@ -5592,7 +6868,7 @@ static void *stbi__tga_load(stbi__context *s, int *x, int *y, int *comp, int req
             //   load the palette
             tga_palette = (unsigned char*)stbi__malloc_mad2(tga_palette_len, tga_comp, 0);
             if (!tga_palette) {
-                STBI_FREE(tga_data);
+                if (tga_data != s->output) STBI_FREE(tga_data);
                 return stbi__errpuc("outofmem", "Out of memory");
             }
             if (tga_rgb16) {
@@ -5603,7 +6879,7 @@ static void *stbi__tga_load(stbi__context *s, int *x, int *y, int *comp, int req
                     pal_entry += tga_comp;
                 }
             } else if (!stbi__getn(s, tga_palette, tga_palette_len * tga_comp)) {
-                STBI_FREE(tga_data);
+                if (tga_data != s->output) STBI_FREE(tga_data);
                 STBI_FREE(tga_palette);
                 return stbi__errpuc("bad palette", "Corrupt TGA");
             }
@@ -5691,16 +6967,7 @@ static void *stbi__tga_load(stbi__context *s, int *x, int *y, int *comp, int req
     
     // swap RGB - if the source data was RGB16, it already is in the right order
     if (tga_comp >= 3 && !tga_rgb16)
-    {
-        unsigned char* tga_pixel = tga_data;
-        for (i=0; i < tga_width * tga_height; ++i)
-        {
-            unsigned char temp = tga_pixel[0];
-            tga_pixel[0] = tga_pixel[2];
-            tga_pixel[2] = temp;
-            tga_pixel += tga_comp;
-        }
-    }
+        stbi__tga_swap_rb(tga_data, (size_t) tga_width * tga_height, tga_comp, simd);
     
     // convert to target component count
     if (req_comp && req_comp != tga_comp)
@@ -6248,7 +7515,7 @@ static int stbi__gif_header(stbi__context *s, stbi__gif *g, int *comp, int is_in
     if (version != '7' && version != '9')    return stbi__err("not GIF", "Corrupt GIF");
     if (stbi__get8(s) != 'a')                return stbi__err("not GIF", "Corrupt GIF");
     
-    stbi__g_failure_reason = "";
+    stbi__err("", "");
     g->w = stbi__get16le(s);
     g->h = stbi__get16le(s);
     g->flags = stbi__get8(s);
@@ -6415,7 +7682,7 @@ static stbi_uc *stbi__gif_load_next(stbi__context *s, stbi__gif *g, int *comp, i
     // on first frame, any non-written pixels get the background colour (non-transparent)
     first_frame = 0;
     if (g->out == 0) {
-        if (!stbi__gif_header(s, g, comp,0)) return 0; // stbi__g_failure_reason set by stbi__gif_header
+        if (!stbi__gif_header(s, g, comp,0)) return 0; // failure reason set by stbi__gif_header
         if (!stbi__mad3sizes_valid(4, g->w, g->h, 0))
             return stbi__errpuc("too large", "GIF image is too large");
         pcount = g->w * g->h;
@@ -7191,7 +8458,7 @@ static int      stbi__pnm_info(stbi__context *s, int *x, int *y, int *comp)
 }
 #endif
 
-static int stbi__info_main(stbi__context *s, int *x, int *y, int *comp)
+static int stbi__info_format(stbi__context *s, int *x, int *y, int *comp)
 {
 #ifndef STBI_NO_JPEG
     if (stbi__jpeg_info(s, x, y, comp)) return 1;
@@ -7233,6 +8500,17 @@ static int stbi__info_main(stbi__context *s, int *x, int *y, int *comp)
     return stbi__err("unknown image type", "Image not of any known type, or corrupt");
 }
 
+// the size of the image as the *_ex load functions would return it
+static int stbi__info_main(stbi__context *s, int *x, int *y, int *comp)
+{
+    int w, h;
+    if (!stbi__info_format(s, &w, &h, comp)) return 0;
+    if (!stbi__region_size(s, &w, &h)) return 0;
+    if (x) *x = w;
+    if (y) *y = h;
+    return 1;
+}
+
 static int stbi__is_16_main(stbi__context *s)
 {
 #ifndef STBI_NO_PNG
@@ -7247,27 +8525,55 @@ static int stbi__is_16_main(stbi__context *s)
 }
 
 #ifndef STBI_NO_STDIO
-STBIDEF int stbi_info(char const *filename, int *x, int *y, int *comp)
+STBIDEF int stbi_info_ex(stbi_options *options, char const *filename, int *x, int *y, int *comp)
 {
+    stbi_options *outer = stbi__begin_ex(options);
     FILE *f = stbi__fopen(filename, "rb");
     int result;
-    if (!f) return stbi__err("can't fopen", "Unable to open file");
-    result = stbi_info_from_file(f, x, y, comp);
-    fclose(f);
+    if (!f) {
+        result = stbi__err("can't fopen", "Unable to open file");
+    } else {
+        result = stbi_info_from_file_ex(options, f, x, y, comp);
+        fclose(f);
+    }
+    stbi__end_ex(outer);
     return result;
 }
 
-STBIDEF int stbi_info_from_file(FILE *f, int *x, int *y, int *comp)
+STBIDEF int stbi_info_from_file_ex(stbi_options *options, FILE *f, int *x, int *y, int *comp)
 {
+    stbi_options *outer = stbi__begin_ex(options);
     int r;
     stbi__context s;
     long pos = ftell(f);
     stbi__start_file(&s, f);
+    s.options = options;
     r = stbi__info_main(&s,x,y,comp);
     fseek(f,pos,SEEK_SET);
+    stbi__end_ex(outer);
     return r;
 }
 
+STBIDEF int stbi_info(char const *filename, int *x, int *y, int *comp)
+{
+    stbi_options options;
+    int result;
+    stbi__global_options(&options);
+    result = stbi_info_ex(&options, filename, x, y, comp);
+    stbi__global_failure(&options);
+    return result;
+}
+
+STBIDEF int stbi_info_from_file(FILE *f, int *x, int *y, int *comp)
+{
+    stbi_options options;
+    int result;
+    stbi__global_options(&options);
+    result = stbi_info_from_file_ex(&options, f, x, y, comp);
+    stbi__global_failure(&options);
+    return result;
+}
+
 STBIDEF int stbi_is_16_bit(char const *filename)
 {
     FILE *f = stbi__fopen(filename, "rb");
@@ -7290,18 +8596,48 @@ STBIDEF int stbi_is_16_bit_from_file(FILE *f)
 }
 #endif // !STBI_NO_STDIO
 
-STBIDEF int stbi_info_from_memory(stbi_uc const *buffer, int len, int *x, int *y, int *comp)
+STBIDEF int stbi_info_from_memory_ex(stbi_options *options, stbi_uc const *buffer, int len, int *x, int *y, int *comp)
 {
+    stbi_options *outer = stbi__begin_ex(options);
+    int result;
     stbi__context s;
     stbi__start_mem(&s,buffer,len);
-    return stbi__info_main(&s,x,y,comp);
+    s.options = options;
+    result = stbi__info_main(&s,x,y,comp);
+    stbi__end_ex(outer);
+    return result;
 }
 
-STBIDEF int stbi_info_from_callbacks(stbi_io_callbacks const *c, void *user, int *x, int *y, int *comp)
+STBIDEF int stbi_info_from_callbacks_ex(stbi_options *options, stbi_io_callbacks const *c, void *user, int *x, int *y, int *comp)
 {
+    stbi_options *outer = stbi__begin_ex(options);
+    int result;
     stbi__context s;
     stbi__start_callbacks(&s, (stbi_io_callbacks *) c, user);
-    return stbi__info_main(&s,x,y,comp);
+    s.options = options;
+    result = stbi__info_main(&s,x,y,comp);
+    stbi__end_ex(outer);
+    return result;
+}
+
+STBIDEF int stbi_info_from_memory(stbi_uc const *buffer, int len, int *x, int *y, int *comp)
+{
+    stbi_options options;
+    int result;
+    stbi__global_options(&options);
+    result = stbi_info_from_memory_ex(&options,buffer,len,x,y,comp);
+    stbi__global_failure(&options);
+    return result;
+}
+
+STBIDEF int stbi_info_from_callbacks(stbi_io_callbacks const *c, void *user, int *x, int *y, int *comp)
+{
+    stbi_options options;
+    int result;
+    stbi__global_options(&options);
+    result = stbi_info_from_callbacks_ex(&options,c,user,x,y,comp);
+    stbi__global_failure(&options);
+    return result;
 }
 
 STBIDEF int stbi_is_16_bit_from_memory(stbi_uc const *buffer, int len)
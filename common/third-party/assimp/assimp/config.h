@@ -377,6 +377,156 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  */
 #define AI_CONFIG_PP_ICL_PTCACHE_SIZE "PP_ICL_PTCACHE_SIZE"
 
+// ---------------------------------------------------------------------------
+/** @brief Restrict the #aiProcess_ValidateDataStructure step to structural
+ *    invariants.
+ *
+ * If enabled, the validation step only checks what is required to safely
+ * walk the scene: array pointers vs. their counts, index ranges and string
+ * termination. Semantic checks (unreferenced vertices, bone weight sums,
+ * duplicate names, animation key ordering, material texture keys) are
+ * skipped. Use this to keep validation enabled in production builds.
+ * Property type: bool. Default value: false.
+ */
+#define AI_CONFIG_PP_VDS_STRUCTURAL_ONLY "PP_VDS_STRUCTURAL_ONLY"
+
+// ---------------------------------------------------------------------------
+/** @brief Set the number of threads used by the
+ *    #aiProcess_ValidateDataStructure step.
+ *
+ * Meshes and animations are validated independently of each other. Possible
+ * values are: -1 to use all hardware threads, 0 or 1 to validate on the
+ * calling thread only and any larger number to use at most that many threads.
+ * Property type: integer. Default value: -1.
+ */
+#define AI_CONFIG_PP_VDS_THREADS "PP_VDS_THREADS"
+
+// ---------------------------------------------------------------------------
+/** @brief Set the polygon size above which the #aiProcess_Triangulate step
+ *    switches to the z-order hashed ear clipping triangulator.
+ *
+ * Smaller polygons are handled by the simple ear clipping loop, which has
+ * less overhead but is quadratic in the number of polygon vertices.
+ * @note The default value is AI_TRI_DEFAULT_EARCUT_THRESHOLD
+ * Property type: integer.
+ */
+#define AI_CONFIG_PP_TRI_EARCUT_THRESHOLD "PP_TRI_EARCUT_THRESHOLD"
+
+// default value for AI_CONFIG_PP_TRI_EARCUT_THRESHOLD
+#if (!defined AI_TRI_DEFAULT_EARCUT_THRESHOLD)
+#define AI_TRI_DEFAULT_EARCUT_THRESHOLD 64
+#endif
+
+// ---------------------------------------------------------------------------
+/** @brief Set the number of levels of detail GenLODsProcess generates per mesh.
+ *
+ * Level k aims at the face count of level k-1 times AI_CONFIG_PP_GLOD_RATIO.
+ * The chain ends early once AI_CONFIG_PP_GLOD_MAX_ERROR or
+ * AI_CONFIG_PP_GLOD_MIN_FACES is reached.
+ * @note The default value is AI_GLOD_DEFAULT_LEVELS
+ * Property type: integer.
+ */
+#define AI_CONFIG_PP_GLOD_LEVELS "PP_GLOD_LEVELS"
+
+// default value for AI_CONFIG_PP_GLOD_LEVELS
+#if (!defined AI_GLOD_DEFAULT_LEVELS)
+#define AI_GLOD_DEFAULT_LEVELS 3
+#endif
+
+// ---------------------------------------------------------------------------
+/** @brief Set the face count ratio between two successive levels of detail.
+ *
+ * Must be in ]0,1[.
+ * @note The default value is AI_GLOD_DEFAULT_RATIO
+ * Property type: float.
+ */
+#define AI_CONFIG_PP_GLOD_RATIO "PP_GLOD_RATIO"
+
+// default value for AI_CONFIG_PP_GLOD_RATIO
+#if (!defined AI_GLOD_DEFAULT_RATIO)
+#define AI_GLOD_DEFAULT_RATIO 0.5f
+#endif
+
+// ---------------------------------------------------------------------------
+/** @brief Set the maximum geometric error GenLODsProcess may introduce,
+ *    relative to the diagonal of the bounding box of a mesh.
+ *
+ * @note The default value is AI_GLOD_DEFAULT_MAX_ERROR
+ * Property type: float.
+ */
+#define AI_CONFIG_PP_GLOD_MAX_ERROR "PP_GLOD_MAX_ERROR"
+
+// default value for AI_CONFIG_PP_GLOD_MAX_ERROR
+#if (!defined AI_GLOD_DEFAULT_MAX_ERROR)
+#define AI_GLOD_DEFAULT_MAX_ERROR 0.01f
+#endif
+
+// ---------------------------------------------------------------------------
+/** @brief Set the face count below which GenLODsProcess does not simplify
+ *    a mesh any further.
+ *
+ * @note The default value is AI_GLOD_DEFAULT_MIN_FACES
+ * Property type: integer.
+ */
+#define AI_CONFIG_PP_GLOD_MIN_FACES "PP_GLOD_MIN_FACES"
+
+// default value for AI_CONFIG_PP_GLOD_MIN_FACES
+#if (!defined AI_GLOD_DEFAULT_MIN_FACES)
+#define AI_GLOD_DEFAULT_MIN_FACES 64
+#endif
+
+// ---------------------------------------------------------------------------
+/** @brief Set the maximum number of vertices per meshlet generated by
+ *    GenMeshletsProcess.
+ *
+ * The value is clamped to [3, AI_MAX_MESHLET_VERTICES].
+ * @note The default value is AI_GM_DEFAULT_MAX_VERTICES
+ * Property type: integer.
+ */
+#define AI_CONFIG_PP_GM_MAX_VERTICES "PP_GM_MAX_VERTICES"
+
+// default value for AI_CONFIG_PP_GM_MAX_VERTICES
+#if (!defined AI_GM_DEFAULT_MAX_VERTICES)
+#define AI_GM_DEFAULT_MAX_VERTICES 64
+#endif
+
+// ---------------------------------------------------------------------------
+/** @brief Set the maximum number of triangles per meshlet generated by
+ *    GenMeshletsProcess.
+ *
+ * The value is clamped to [1, AI_MAX_MESHLET_TRIANGLES].
+ * @note The default value is AI_GM_DEFAULT_MAX_TRIANGLES
+ * Property type: integer.
+ */
+#define AI_CONFIG_PP_GM_MAX_TRIANGLES "PP_GM_MAX_TRIANGLES"
+
+// default value for AI_CONFIG_PP_GM_MAX_TRIANGLES
+#if (!defined AI_GM_DEFAULT_MAX_TRIANGLES)
+#define AI_GM_DEFAULT_MAX_TRIANGLES 124
+#endif
+
+// ---------------------------------------------------------------------------
+/** @brief Configures PackVerticesProcess to store all texture coordinates
+ *    as half floats.
+ *
+ * By default, texture coordinate sets inside [0,1] are stored as 16 bit
+ * unorm values, which are more precise there, and all others as half floats.
+ * Property type: bool. Default value: false.
+ */
+#define AI_CONFIG_PP_PV_HALF_UVS "PP_PV_HALF_UVS"
+
+// ---------------------------------------------------------------------------
+/** @brief Configures PackORMTexturesProcess to also take the ambient texture
+ *    as ambient occlusion and the specular texture as metalness.
+ *
+ * OBJ has no slots for PBR maps, so exported materials put them into map_Ka
+ * and map_Ks, as the models in common/models do. The dedicated slots
+ * (aiTextureType_AMBIENT_OCCLUSION, aiTextureType_METALNESS) are preferred
+ * when a material has both.
+ * Property type: bool. Default value: true.
+ */
+#define AI_CONFIG_PP_PORM_LEGACY_SLOTS "PP_PORM_LEGACY_SLOTS"
+
 // ---------------------------------------------------------------------------
 /** @brief Enumerates components of the aiScene and aiMesh data structures
  *  that can be excluded from the import using the #aiProcess_RemoveComponent step.
@@ -0,0 +1,760 @@
+/*
+---------------------------------------------------------------------------
+Open Asset Import Library (assimp)
+---------------------------------------------------------------------------
+
+Copyright (c) 2006-2019, assimp team
+
+
+
+All rights reserved.
+
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the following
+conditions are met:
+
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+
+* Neither the name of the assimp team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the assimp team.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+---------------------------------------------------------------------------
+*/
+
+/** @file  EarCutTriangulator.cpp
+ *  @brief Implementation of the z-order hashed ear clipping triangulator
+ */
+
+#include "EarCutTriangulator.h"
+#include <assimp/ai_assert.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+using namespace Assimp;
+
+typedef EarCutTriangulator::Node Node;
+
+namespace {
+
+// ------------------------------------------------------------------------------------------------
+// Twice the signed area of the triangle p,q,r - positive if it is counter-clockwise
+inline ai_real Area(const Node* p, const Node* q, const Node* r)
+{
+    return (q->x - p->x) * (r->y - p->y) - (q->y - p->y) * (r->x - p->x);
+}
+
+// ------------------------------------------------------------------------------------------------
+inline bool Equals(const Node* a, const Node* b)
+{
+    return a->x == b->x && a->y == b->y;
+}
+
+// ------------------------------------------------------------------------------------------------
+// Point in triangle test including the border, for either winding
+inline bool PointInTriangle(ai_real ax, ai_real ay, ai_real bx, ai_real by,
+    ai_real cx, ai_real cy, ai_real px, ai_real py)
+{
+    const ai_real d1 = (bx - ax) * (py - ay) - (by - ay) * (px - ax);
+    const ai_real d2 = (cx - bx) * (py - by) - (cy - by) * (px - bx);
+    const ai_real d3 = (ax - cx) * (py - cy) - (ay - cy) * (px - cx);
+    const bool neg = d1 < 0 || d2 < 0 || d3 < 0;
+    const bool pos = d1 > 0 || d2 > 0 || d3 > 0;
+    return !(neg && pos);
+}
+
+// ------------------------------------------------------------------------------------------------
+// Same, but a point that coincides with a is not considered to be inside. Bridged holes
+// duplicate vertices, so such points are expected.
+inline bool PointInTriangleExceptFirst(const Node* a, const Node* b, const Node* c, const Node* p)
+{
+    return !(a->x == p->x && a->y == p->y) &&
+        PointInTriangle(a->x, a->y, b->x, b->y, c->x, c->y, p->x, p->y);
+}
+
+// ------------------------------------------------------------------------------------------------
+inline int Sign(ai_real v)
+{
+    return (v > 0) - (v < 0);
+}
+
+// ------------------------------------------------------------------------------------------------
+// For collinear p,q,r: whether q lies on the segment p-r
+inline bool OnSegment(const Node* p, const Node* q, const Node* r)
+{
+    return q->x <= std::max(p->x, r->x) && q->x >= std::min(p->x, r->x) &&
+        q->y <= std::max(p->y, r->y) && q->y >= std::min(p->y, r->y);
+}
+
+// ------------------------------------------------------------------------------------------------
+// Whether the segments p1-q1 and p2-q2 intersect
+bool Intersects(const Node* p1, const Node* q1, const Node* p2, const Node* q2)
+{
+    const int o1 = Sign(Area(p1, q1, p2));
+    const int o2 = Sign(Area(p1, q1, q2));
+    const int o3 = Sign(Area(p2, q2, p1));
+    const int o4 = Sign(Area(p2, q2, q1));
+
+    if (o1 != o2 && o3 != o4) {
+        return true;
+    }
+    return (o1 == 0 && OnSegment(p1, p2, q1)) ||
+        (o2 == 0 && OnSegment(p1, q2, q1)) ||
+        (o3 == 0 && OnSegment(p2, p1, q2)) ||
+        (o4 == 0 && OnSegment(p2, q1, q2));
+}
+
+// ------------------------------------------------------------------------------------------------
+// Whether the diagonal a-b intersects any polygon edge not adjacent to it
+bool IntersectsPolygon(const Node* a, const Node* b)
+{
+    const Node* p = a;
+    do {
+        if (p->i != a->i && p->next->i != a->i && p->i != b->i && p->next->i != b->i &&
+            Intersects(p, p->next, a, b)) {
+            return true;
+        }
+        p = p->next;
+    } while (p != a);
+    return false;
+}
+
+// ------------------------------------------------------------------------------------------------
+// Whether the diagonal a-b starts into the interior of the polygon at a
+bool LocallyInside(const Node* a, const Node* b)
+{
+    return Area(a->prev, a, a->next) > 0 ?
+        Area(a, b, a->next) <= 0 && Area(a, a->prev, b) <= 0 :
+        Area(a, b, a->prev) > 0 || Area(a, a->next, b) > 0;
+}
+
+// ------------------------------------------------------------------------------------------------
+// Whether the midpoint of the diagonal a-b is inside the polygon
+bool MiddleInside(const Node* a, const Node* b)
+{
+    const ai_real px = (a->x + b->x) / 2, py = (a->y + b->y) / 2;
+    const Node* p = a;
+    bool inside = false;
+    do {
+        if (((p->y > py) != (p->next->y > py)) && p->next->y != p->y &&
+            (px < (p->next->x - p->x) * (py - p->y) / (p->next->y - p->y) + p->x)) {
+            inside = !inside;
+        }
+        p = p->next;
+    } while (p != a);
+    return inside;
+}
+
+// ------------------------------------------------------------------------------------------------
+// Whether the sector of p is contained in the sector of m, both sharing the same position
+bool SectorContainsSector(const Node* m, const Node* p)
+{
+    return Area(m->prev, m, p->prev) > 0 && Area(p->next, m, m->next) > 0;
+}
+
+// ------------------------------------------------------------------------------------------------
+// Whether a-b is a diagonal the polygon can be split along
+bool IsValidDiagonal(const Node* a, const Node* b)
+{
+    if (a->next->i == b->i || a->prev->i == b->i || IntersectsPolygon(a, b)) {
+        return false;
+    }
+    if (LocallyInside(a, b) && LocallyInside(b, a) && MiddleInside(a, b)) {
+        // no zero-length or collinear diagonal
+        return Area(a->prev, a, b->prev) != 0 || Area(a, b->prev, b) != 0;
+    }
+    // special zero-length case
+    return Equals(a, b) && Area(a->prev, a, a->next) < 0 && Area(b->prev, b, b->next) < 0;
+}
+
+// ------------------------------------------------------------------------------------------------
+void RemoveNode(Node* p)
+{
+    p->next->prev = p->prev;
+    p->prev->next = p->next;
+
+    if (p->prevZ) {
+        p->prevZ->nextZ = p->nextZ;
+    }
+    if (p->nextZ) {
+        p->nextZ->prevZ = p->prevZ;
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+// Remove duplicate and collinear points between start and end
+Node* FilterPoints(Node* start, Node* end)
+{
+    if (!start) {
+        return start;
+    }
+    if (!end) {
+        end = start;
+    }
+
+    Node* p = start;
+    bool again;
+    do {
+        again = false;
+        if (!p->steiner && (Equals(p, p->next) || Area(p->prev, p, p->next) == 0)) {
+            RemoveNode(p);
+            p = end = p->prev;
+            if (p == p->next) {
+                break;
+            }
+            again = true;
+        } else {
+            p = p->next;
+        }
+    } while (again || p != end);
+
+    return end;
+}
+
+// ------------------------------------------------------------------------------------------------
+Node* GetLeftmost(Node* start)
+{
+    Node* p = start, *leftmost = start;
+    do {
+        if (p->x < leftmost->x || (p->x == leftmost->x && p->y < leftmost->y)) {
+            leftmost = p;
+        }
+        p = p->next;
+    } while (p != start);
+    return leftmost;
+}
+
+// ------------------------------------------------------------------------------------------------
+// Find a vertex of the outer ring the hole can be connected to without crossing an edge
+Node* FindHoleBridge(const Node* hole, Node* outer)
+{
+    const ai_real hx = hole->x, hy = hole->y;
+    ai_real qx = -std::numeric_limits<ai_real>::infinity();
+    Node* p = outer;
+    Node* m = nullptr;
+
+    // find the segment left of the hole point and closest to it,
+    // take its end point with the smaller x as bridge candidate
+    do {
+        if (hy <= p->y && hy >= p->next->y && p->next->y != p->y) {
+            const ai_real x = p->x + (hy - p->y) * (p->next->x - p->x) / (p->next->y - p->y);
+            if (x <= hx && x > qx) {
+                qx = x;
+                m = p->x < p->next->x ? p : p->next;
+                if (x == hx) {
+                    // the hole touches the outer segment
+                    return m;
+                }
+            }
+        }
+        p = p->next;
+    } while (p != outer);
+
+    if (!m) {
+        return nullptr;
+    }
+
+    // look for points inside the triangle of the hole point, the intersection point
+    // and the candidate; take the one with the smallest angle to the ray if any
+    const Node* stop = m;
+    const ai_real mx = m->x, my = m->y;
+    ai_real tanMin = std::numeric_limits<ai_real>::infinity();
+
+    p = m;
+    do {
+        if (hx >= p->x && p->x >= mx && hx != p->x &&
+            PointInTriangle(hy < my ? hx : qx, hy, mx, my, hy < my ? qx : hx, hy, p->x, p->y)) {
+
+            const ai_real tan = std::fabs(hy - p->y) / (hx - p->x);
+            if (LocallyInside(p, hole) && (tan < tanMin || (tan == tanMin &&
+                (p->x > m->x || (p->x == m->x && SectorContainsSector(m, p)))))) {
+                m = p;
+                tanMin = tan;
+            }
+        }
+        p = p->next;
+    } while (p != stop);
+
+    return m;
+}
+
+// ------------------------------------------------------------------------------------------------
+// Sort the z-order list by z value, a bottom-up merge sort on the linked list
+void SortLinked(Node* list)
+{
+    unsigned int inSize = 1, numMerges;
+    do {
+        Node* p = list;
+        Node* tail = nullptr;
+        list = nullptr;
+        numMerges = 0;
+
+        while (p) {
+            ++numMerges;
+            Node* q = p;
+            unsigned int pSize = 0;
+            for (unsigned int i = 0; i < inSize; ++i) {
+                ++pSize;
+                q = q->nextZ;
+                if (!q) {
+                    break;
+                }
+            }
+            unsigned int qSize = inSize;
+
+            while (pSize > 0 || (qSize > 0 && q)) {
+                Node* e;
+                if (pSize != 0 && (qSize == 0 || !q || p->z <= q->z)) {
+                    e = p;
+                    p = p->nextZ;
+                    --pSize;
+                } else {
+                    e = q;
+                    q = q->nextZ;
+                    --qSize;
+                }
+
+                if (tail) {
+                    tail->nextZ = e;
+                } else {
+                    list = e;
+                }
+                e->prevZ = tail;
+                tail = e;
+            }
+            p = q;
+        }
+        tail->nextZ = nullptr;
+        inSize *= 2;
+    } while (numMerges > 1);
+}
+
+} // anonymous namespace
+
+// ------------------------------------------------------------------------------------------------
+EarCutTriangulator::EarCutTriangulator() :
+    mOut(),
+    mMinX(),
+    mMinY(),
+    mInvSize(),
+    mFlip(),
+    mFailed()
+{}
+
+// ------------------------------------------------------------------------------------------------
+EarCutTriangulator::~EarCutTriangulator()
+{}
+
+// ------------------------------------------------------------------------------------------------
+bool EarCutTriangulator::Triangulate(const aiVector2D* points, unsigned int numPoints,
+    const unsigned int* holeStarts, unsigned int numHoles,
+    std::vector<unsigned int>& out)
+{
+    ai_assert(nullptr != points);
+    ai_assert(!numHoles || nullptr != holeStarts);
+
+    out.clear();
+    out.reserve(3 * (static_cast<size_t>(numPoints) + 2 * numHoles));
+    mOut = &out;
+    mFailed = false;
+
+    // Every split along a diagonal duplicates two nodes, as does every bridged hole.
+    // There are less splits than triangles, so this is enough to never reallocate.
+    mNodes.clear();
+    mNodes.reserve(3 * static_cast<size_t>(numPoints) + 6 * static_cast<size_t>(numHoles) + 3);
+
+    const unsigned int outerEnd = numHoles ? holeStarts[0] : numPoints;
+    Node* outer = LinkedList(points, 0, outerEnd, true, &mFlip);
+    if (!outer || outer->next == outer->prev) {
+        mOut = nullptr;
+        return false;
+    }
+
+    if (numHoles) {
+        outer = EliminateHoles(points, numPoints, holeStarts, numHoles, outer);
+    }
+
+    // bounding box of the input, mapped to [0,32767] for the z-order curve
+    ai_real maxX = points[0].x, maxY = points[0].y;
+    mMinX = points[0].x;
+    mMinY = points[0].y;
+    for (unsigned int i = 1; i < numPoints; ++i) {
+        mMinX = std::min(mMinX, points[i].x);
+        mMinY = std::min(mMinY, points[i].y);
+        maxX = std::max(maxX, points[i].x);
+        maxY = std::max(maxY, points[i].y);
+    }
+    const ai_real size = std::max(maxX - mMinX, maxY - mMinY);
+    mInvSize = size != 0 ? static_cast<ai_real>(32767) / size : 0;
+
+    EarcutLinked(outer, 0);
+
+    mOut = nullptr;
+    return !mFailed;
+}
+
+// ------------------------------------------------------------------------------------------------
+Node* EarCutTriangulator::InsertNode(unsigned int i, ai_real x, ai_real y, Node* last)
+{
+    ai_assert(mNodes.size() < mNodes.capacity());
+
+    mNodes.push_back(Node());
+    Node* p = &mNodes.back();
+    p->i = i;
+    p->x = x;
+    p->y = y;
+    p->z = 0;
+    p->prevZ = p->nextZ = nullptr;
+    p->steiner = false;
+
+    if (!last) {
+        p->prev = p->next = p;
+    } else {
+        p->next = last->next;
+        p->prev = last;
+        last->next->prev = p;
+        last->next = p;
+    }
+    return p;
+}
+
+// ------------------------------------------------------------------------------------------------
+// Create a circular linked list from the ring [start,end) with the requested winding
+Node* EarCutTriangulator::LinkedList(const aiVector2D* points, unsigned int start, unsigned int end,
+    bool ccw, bool* reversed)
+{
+    ai_real sum = 0;
+    for (unsigned int i = start, j = end - 1; i < end; j = i++) {
+        sum += points[j].x * points[i].y - points[i].x * points[j].y;
+    }
+
+    Node* last = nullptr;
+    const bool flip = ccw != (sum > 0);
+    if (!flip) {
+        for (unsigned int i = start; i < end; ++i) {
+            last = InsertNode(i, points[i].x, points[i].y, last);
+        }
+    } else {
+        for (unsigned int i = end; i-- > start;) {
+            last = InsertNode(i, points[i].x, points[i].y, last);
+        }
+    }
+
+    if (last && Equals(last, last->next)) {
+        RemoveNode(last);
+        last = last->next;
+    }
+    if (reversed) {
+        *reversed = flip;
+    }
+    return last;
+}
+
+// ------------------------------------------------------------------------------------------------
+// Main ear slicing loop, pass 1 and 2 are fallbacks for polygons the plain search gets stuck on
+void EarCutTriangulator::EarcutLinked(Node* ear, int pass)
+{
+    if (!ear) {
+        return;
+    }
+    if (!pass && mInvSize) {
+        IndexCurve(ear);
+    }
+
+    Node* stop = ear;
+    while (ear->prev != ear->next) {
+        Node* prev = ear->prev;
+        Node* next = ear->next;
+
+        if (mInvSize ? IsEarHashed(ear) : IsEar(ear)) {
+            EmitTriangle(prev, ear, next);
+            RemoveNode(ear);
+
+            // skipping the next vertex leads to less sliver triangles
+            ear = next->next;
+            stop = next->next;
+            continue;
+        }
+
+        ear = next;
+
+        // looped through the whole remaining polygon without finding an ear
+        if (ear == stop) {
+            if (!pass) {
+                // try filtering points and slicing again
+                EarcutLinked(FilterPoints(ear, nullptr), 1);
+            } else if (pass == 1) {
+                // cure small self-intersections
+                ear = CureLocalIntersections(FilterPoints(ear, nullptr));
+                EarcutLinked(ear, 2);
+            } else if (pass == 2) {
+                // as a last resort, split the polygon in two and handle each half
+                SplitEarcut(ear);
+            }
+            break;
+        }
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+bool EarCutTriangulator::IsEar(const Node* ear) const
+{
+    const Node* a = ear->prev, *b = ear, *c = ear->next;
+    if (Area(a, b, c) <= 0) {
+        // reflex, can't be an ear
+        return false;
+    }
+
+    // no reflex point of the polygon may be inside the potential ear
+    for (const Node* p = c->next; p != a; p = p->next) {
+        if (PointInTriangleExceptFirst(a, b, c, p) && Area(p->prev, p, p->next) <= 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// ------------------------------------------------------------------------------------------------
+bool EarCutTriangulator::IsEarHashed(const Node* ear) const
+{
+    const Node* a = ear->prev, *b = ear, *c = ear->next;
+    if (Area(a, b, c) <= 0) {
+        return false;
+    }
+
+    // z-order range of the triangle's bounding box
+    const ai_real x0 = std::min(a->x, std::min(b->x, c->x)), y0 = std::min(a->y, std::min(b->y, c->y));
+    const ai_real x1 = std::max(a->x, std::max(b->x, c->x)), y1 = std::max(a->y, std::max(b->y, c->y));
+    const unsigned int minZ = ZOrder(x0, y0), maxZ = ZOrder(x1, y1);
+
+    const Node* p = ear->prevZ;
+    const Node* n = ear->nextZ;
+
+#define AI_EARCUT_BLOCKS_EAR(q) \
+    ((q)->x >= x0 && (q)->x <= x1 && (q)->y >= y0 && (q)->y <= y1 && (q) != a && (q) != c && \
+        PointInTriangleExceptFirst(a, b, c, (q)) && Area((q)->prev, (q), (q)->next) <= 0)
+
+    // look for points inside the triangle in both directions
+    while (p && p->z >= minZ && n && n->z <= maxZ) {
+        if (AI_EARCUT_BLOCKS_EAR(p)) {
+            return false;
+        }
+        p = p->prevZ;
+
+        if (AI_EARCUT_BLOCKS_EAR(n)) {
+            return false;
+        }
+        n = n->nextZ;
+    }
+    while (p && p->z >= minZ) {
+        if (AI_EARCUT_BLOCKS_EAR(p)) {
+            return false;
+        }
+        p = p->prevZ;
+    }
+    while (n && n->z <= maxZ) {
+        if (AI_EARCUT_BLOCKS_EAR(n)) {
+            return false;
+        }
+        n = n->nextZ;
+    }
+
+#undef AI_EARCUT_BLOCKS_EAR
+    return true;
+}
+
+// ------------------------------------------------------------------------------------------------
+// Go through all polygon nodes and cure small local self-intersections
+Node* EarCutTriangulator::CureLocalIntersections(Node* start)
+{
+    Node* p = start;
+    do {
+        Node* a = p->prev;
+        Node* b = p->next->next;
+
+        if (!Equals(a, b) && Intersects(a, p, p->next, b) && LocallyInside(a, b) && LocallyInside(b, a)) {
+            EmitTriangle(a, p, b);
+
+            // remove the two nodes involved
+            RemoveNode(p);
+            RemoveNode(p->next);
+
+            p = start = b;
+        }
+        p = p->next;
+    } while (p != start);
+
+    return FilterPoints(p, nullptr);
+}
+
+// ------------------------------------------------------------------------------------------------
+// Try splitting the polygon into two along a valid diagonal and triangulate them independently
+void EarCutTriangulator::SplitEarcut(Node* start)
+{
+    Node* a = start;
+    do {
+        Node* b = a->next->next;
+        while (b != a->prev) {
+            if (a->i != b->i && IsValidDiagonal(a, b)) {
+                Node* c = SplitPolygon(a, b);
+
+                a = FilterPoints(a, a->next);
+                c = FilterPoints(c, c->next);
+
+                EarcutLinked(a, 0);
+                EarcutLinked(c, 0);
+                return;
+            }
+            b = b->next;
+        }
+        a = a->next;
+    } while (a != start);
+
+    // no diagonal left, the polygon isn't simple
+    mFailed = true;
+}
+
+// ------------------------------------------------------------------------------------------------
+// Link every hole into the outer ring, producing a single ring without holes
+Node* EarCutTriangulator::EliminateHoles(const aiVector2D* points, unsigned int numPoints,
+    const unsigned int* holeStarts, unsigned int numHoles, Node* outer)
+{
+    mHoleQueue.clear();
+    for (unsigned int h = 0; h < numHoles; ++h) {
+        const unsigned int start = holeStarts[h];
+        const unsigned int end = h + 1 < numHoles ? holeStarts[h + 1] : numPoints;
+
+        Node* list = LinkedList(points, start, end, false, nullptr);
+        if (!list) {
+            continue;
+        }
+        if (list == list->next) {
+            list->steiner = true;
+        }
+        mHoleQueue.push_back(GetLeftmost(list));
+    }
+
+    // process holes from left to right
+    std::sort(mHoleQueue.begin(), mHoleQueue.end(), [](const Node* a, const Node* b) {
+        return a->x < b->x || (a->x == b->x && a->y < b->y);
+    });
+
+    for (Node* hole : mHoleQueue) {
+        outer = EliminateHole(hole, outer);
+    }
+    return outer;
+}
+
+// ------------------------------------------------------------------------------------------------
+Node* EarCutTriangulator::EliminateHole(Node* hole, Node* outer)
+{
+    Node* bridge = FindHoleBridge(hole, outer);
+    if (!bridge) {
+        return outer;
+    }
+
+    Node* bridgeReverse = SplitPolygon(bridge, hole);
+
+    // filter collinear points around the cuts
+    FilterPoints(bridgeReverse, bridgeReverse->next);
+    return FilterPoints(bridge, bridge->next);
+}
+
+// ------------------------------------------------------------------------------------------------
+// Interlink the polygon nodes in z-order
+void EarCutTriangulator::IndexCurve(Node* start)
+{
+    Node* p = start;
+    do {
+        if (0 == p->z) {
+            p->z = ZOrder(p->x, p->y);
+        }
+        p->prevZ = p->prev;
+        p->nextZ = p->next;
+        p = p->next;
+    } while (p != start);
+
+    p->prevZ->nextZ = nullptr;
+    p->prevZ = nullptr;
+
+    SortLinked(p);
+}
+
+// ------------------------------------------------------------------------------------------------
+// z-order of a point given its coordinates, interleaving the bits of the quantized x and y
+unsigned int EarCutTriangulator::ZOrder(ai_real px, ai_real py) const
+{
+    unsigned int x = static_cast<unsigned int>((px - mMinX) * mInvSize);
+    unsigned int y = static_cast<unsigned int>((py - mMinY) * mInvSize);
+
+    x = (x | (x << 8)) & 0x00FF00FF;
+    x = (x | (x << 4)) & 0x0F0F0F0F;
+    x = (x | (x << 2)) & 0x33333333;
+    x = (x | (x << 1)) & 0x55555555;
+
+    y = (y | (y << 8)) & 0x00FF00FF;
+    y = (y | (y << 4)) & 0x0F0F0F0F;
+    y = (y | (y << 2)) & 0x33333333;
+    y = (y | (y << 1)) & 0x55555555;
+
+    return x | (y << 1);
+}
+
+// ------------------------------------------------------------------------------------------------
+// Link a and b with a bridge. If a and b belong to the same ring, this splits it in two; if they
+// belong to different rings, it merges them. Returns the duplicate of b.
+Node* EarCutTriangulator::SplitPolygon(Node* a, Node* b)
+{
+    Node* a2 = InsertNode(a->i, a->x, a->y, nullptr);
+    Node* b2 = InsertNode(b->i, b->x, b->y, nullptr);
+    Node* an = a->next;
+    Node* bp = b->prev;
+
+    a->next = b;
+    b->prev = a;
+
+    a2->next = an;
+    an->prev = a2;
+
+    b2->next = a2;
+    a2->prev = b2;
+
+    bp->next = b2;
+    b2->prev = bp;
+
+    return b2;
+}
+
+// ------------------------------------------------------------------------------------------------
+void EarCutTriangulator::EmitTriangle(const Node* a, const Node* b, const Node* c)
+{
+    mOut->push_back(a->i);
+    if (mFlip) {
+        mOut->push_back(c->i);
+        mOut->push_back(b->i);
+    } else {
+        mOut->push_back(b->i);
+        mOut->push_back(c->i);
+    }
+}
@@ -0,0 +1,137 @@
+/*
+Open Asset Import Library (assimp)
+----------------------------------------------------------------------
+
+Copyright (c) 2006-2019, assimp team
+
+
+All rights reserved.
+
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the
+following conditions are met:
+
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+
+* Neither the name of the assimp team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the assimp team.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+----------------------------------------------------------------------
+*/
+
+/** @file EarCutTriangulator.h
+ *  @brief Ear clipping triangulator for large polygons, accelerated by a
+ *    z-order curve hash.
+ */
+#ifndef AI_EARCUT_TRIANGULATOR_H_INC
+#define AI_EARCUT_TRIANGULATOR_H_INC
+
+#include <assimp/types.h>
+#include <vector>
+
+namespace Assimp {
+
+// --------------------------------------------------------------------------------------------
+/** @brief Triangulates simple polygons with an arbitrary number of holes.
+ *
+ *  This is an ear clipping triangulator in the spirit of Mapbox' earcut. The
+ *  vertices are kept in a circular linked list and additionally sorted along
+ *  a z-order curve, so only the vertices in the bounding box of an ear
+ *  candidate have to be tested against it. Holes are bridged into the outer
+ *  ring before clipping. Polygons the plain ear search gets stuck on are
+ *  cured from local self-intersections and split along valid diagonals.
+ *
+ *  The TriangulateProcess uses it for polygons above
+ *  #AI_CONFIG_PP_TRI_EARCUT_THRESHOLD vertices, where the naive O(n^2)
+ *  ear search becomes too slow. Instances keep their node storage between
+ *  calls, so reuse them for many polygons. */
+// --------------------------------------------------------------------------------------------
+class ASSIMP_API EarCutTriangulator {
+public:
+    EarCutTriangulator();
+    ~EarCutTriangulator();
+
+    // ----------------------------------------------------------------------------
+    /** @brief Triangulate a projected polygon.
+     *  @param points Polygon vertices in the plane. The outer ring comes first,
+     *    followed by the rings of all holes. Orientation doesn't matter.
+     *  @param numPoints Total number of vertices in @c points
+     *  @param holeStarts Index of the first vertex of each hole, ascending.
+     *    May be NULL if there are no holes.
+     *  @param numHoles Number of holes
+     *  @param out Receives the triangles as triples of indices into @c points.
+     *    The triangles have the winding order of the outer ring. The vector
+     *    is cleared first.
+     *  @return false if the polygon could not be triangulated completely,
+     *    @c out contains all triangles found so far then. */
+    bool Triangulate(const aiVector2D* points, unsigned int numPoints,
+        const unsigned int* holeStarts, unsigned int numHoles,
+        std::vector<unsigned int>& out);
+
+    // ----------------------------------------------------------------------------
+    /** @brief Polygon vertex, linked into the polygon ring and the z-order list */
+    struct Node {
+        unsigned int i;         //!< index of the vertex in the input
+        ai_real x, y;
+        unsigned int z;         //!< z-order curve value
+        Node* prev;
+        Node* next;
+        Node* prevZ;
+        Node* nextZ;
+        bool steiner;           //!< single-vertex hole, never filtered
+    };
+
+private:
+    Node* InsertNode(unsigned int i, ai_real x, ai_real y, Node* last);
+    Node* LinkedList(const aiVector2D* points, unsigned int start, unsigned int end,
+        bool ccw, bool* reversed);
+    void EarcutLinked(Node* ear, int pass);
+    bool IsEar(const Node* ear) const;
+    bool IsEarHashed(const Node* ear) const;
+    Node* CureLocalIntersections(Node* start);
+    void SplitEarcut(Node* start);
+    Node* EliminateHoles(const aiVector2D* points, unsigned int numPoints,
+        const unsigned int* holeStarts, unsigned int numHoles, Node* outer);
+    Node* EliminateHole(Node* hole, Node* outer);
+    void IndexCurve(Node* start);
+    unsigned int ZOrder(ai_real x, ai_real y) const;
+    Node* SplitPolygon(Node* a, Node* b);
+    void EmitTriangle(const Node* a, const Node* b, const Node* c);
+
+    /** Node storage, reserved up front so node pointers stay valid */
+    std::vector<Node> mNodes;
+    std::vector<Node*> mHoleQueue;
+    std::vector<unsigned int>* mOut;
+
+    /** Transformation of the bounding box into z-order curve space */
+    ai_real mMinX, mMinY, mInvSize;
+
+    /** Output triangles must be flipped to keep the input winding */
+    bool mFlip;
+    bool mFailed;
+};
+
+} // end of namespace Assimp
+
+#endif // AI_EARCUT_TRIANGULATOR_H_INC
@@ -0,0 +1,250 @@
+/*
+---------------------------------------------------------------------------
+Open Asset Import Library (assimp)
+---------------------------------------------------------------------------
+
+Copyright (c) 2006-2019, assimp team
+
+All rights reserved.
+
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the following
+conditions are met:
+
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+
+* Neither the name of the assimp team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the assimp team.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+---------------------------------------------------------------------------
+*/
+
+/** @file  ImageDecoder.cpp
+ *  @brief Implementation of the image decoding on top of stb_image
+ */
+
+#include "ImageDecoder.h"
+
+#include <assimp/IOStream.hpp>
+
+#include <algorithm>
+#include <climits>
+#include <cstring>
+#include <memory>
+
+// Private copy: the functions are static to this file, and the application
+// may link its own stb_image next to assimp. Most of them go unused here.
+#define STB_IMAGE_STATIC
+#define STB_IMAGE_IMPLEMENTATION
+#define STBI_NO_STDIO
+#ifdef __GNUC__
+#   pragma GCC diagnostic push
+#   pragma GCC diagnostic ignored "-Wunused-function"
+#endif
+#include <stb_image.h>
+#ifdef __GNUC__
+#   pragma GCC diagnostic pop
+#endif
+
+namespace Assimp {
+
+namespace {
+
+// ------------------------------------------------------------------------------------------------
+// stb_image reading callbacks over an IOStream. stb_image asks for 128 bytes at a time; they are
+// served from a read-ahead buffer so the stream sees few large reads, and reads larger than the
+// buffer go straight to the caller. Seeks only happen for skips past the buffered bytes.
+class StreamReader {
+public:
+    static const size_t ReadAhead = 16 * 1024;
+
+    explicit StreamReader(IOStream* stream)
+    : mStream(stream)
+    , mSize(stream->FileSize())
+    , mBufferStart(stream->Tell())
+    , mNext(0)
+    , mEnd(0) {
+        // empty
+    }
+
+    static const stbi_io_callbacks Callbacks;
+
+private:
+    static int Read(void* user, char* data, int size);
+    static void Skip(void* user, int n);
+    static int Eof(void* user);
+
+    IOStream* mStream;
+    size_t mSize;
+    // stream offset of mBuffer[0]; the stream itself is at mBufferStart + mEnd
+    size_t mBufferStart;
+    size_t mNext, mEnd;
+    unsigned char mBuffer[ReadAhead];
+};
+
+const stbi_io_callbacks StreamReader::Callbacks = { &StreamReader::Read, &StreamReader::Skip, &StreamReader::Eof };
+
+// ------------------------------------------------------------------------------------------------
+int StreamReader::Read(void* user, char* data, int size) {
+    StreamReader* reader = static_cast<StreamReader*>(user);
+    size_t copied = 0;
+    while (copied < static_cast<size_t>(size)) {
+        if (reader->mNext == reader->mEnd) {
+            const size_t position = reader->mBufferStart + reader->mEnd;
+            const size_t wanted = static_cast<size_t>(size) - copied;
+            if (wanted >= ReadAhead) {
+                copied += reader->mStream->Read(data + copied, 1, wanted);
+                reader->mBufferStart = reader->mStream->Tell();
+                reader->mNext = reader->mEnd = 0;
+                break;
+            }
+            reader->mBufferStart = position;
+            reader->mNext = 0;
+            reader->mEnd = reader->mStream->Read(reader->mBuffer, 1, ReadAhead);
+            if (0 == reader->mEnd) {
+                break;
+            }
+        }
+        const size_t count = std::min(reader->mEnd - reader->mNext, static_cast<size_t>(size) - copied);
+        ::memcpy(data + copied, reader->mBuffer + reader->mNext, count);
+        reader->mNext += count;
+        copied += count;
+    }
+    return static_cast<int>(copied);
+}
+
+// ------------------------------------------------------------------------------------------------
+void StreamReader::Skip(void* user, int n) {
+    StreamReader* reader = static_cast<StreamReader*>(user);
+    const size_t position = reader->mBufferStart + reader->mNext;
+    size_t target = position;
+    if (n < 0) {
+        // unget, never before the start of the file
+        target = position - std::min(position, static_cast<size_t>(-static_cast<long long>(n)));
+    } else {
+        target = std::min(position + static_cast<size_t>(n), reader->mSize);
+    }
+    if (target >= reader->mBufferStart && target <= reader->mBufferStart + reader->mEnd) {
+        reader->mNext = target - reader->mBufferStart;
+        return;
+    }
+    reader->mStream->Seek(target, aiOrigin_SET);
+    reader->mBufferStart = target;
+    reader->mNext = reader->mEnd = 0;
+}
+
+// ------------------------------------------------------------------------------------------------
+int StreamReader::Eof(void* user) {
+    const StreamReader* reader = static_cast<const StreamReader*>(user);
+    return reader->mNext == reader->mEnd && reader->mBufferStart + reader->mEnd >= reader->mSize;
+}
+
+} // Namespace
+
+// ------------------------------------------------------------------------------------------------
+unsigned char* DecodeImage(const void* data, size_t size, unsigned int channels,
+        unsigned int& width, unsigned int& height, std::string& failure) {
+    if (size > static_cast<size_t>(INT_MAX)) {
+        failure = "file too large";
+        return nullptr;
+    }
+    if (channels < 1 || channels > 4) {
+        failure = "bad channel count";
+        return nullptr;
+    }
+
+    // the reentrant entry point, the failure reason stays with this call
+    stbi_options options;
+    stbi_options_init(&options);
+    int x = 0, y = 0, comp = 0;
+    stbi_uc* texels = stbi_load_from_memory_ex(&options, static_cast<const stbi_uc*>(data), static_cast<int>(size),
+            &x, &y, &comp, static_cast<int>(channels));
+    if (nullptr == texels) {
+        failure = options.failure_reason ? options.failure_reason : "unknown failure";
+        return nullptr;
+    }
+    width = static_cast<unsigned int>(x);
+    height = static_cast<unsigned int>(y);
+    return texels;
+}
+
+// ------------------------------------------------------------------------------------------------
+unsigned char* DecodeImage(IOStream* stream, unsigned int channels,
+        unsigned int& width, unsigned int& height, std::string& failure) {
+    if (channels < 1 || channels > 4) {
+        failure = "bad channel count";
+        return nullptr;
+    }
+
+    // 16 KB, kept off the stack of the calling step
+    std::unique_ptr<StreamReader> reader(new StreamReader(stream));
+    stbi_options options;
+    stbi_options_init(&options);
+    int x = 0, y = 0, comp = 0;
+    stbi_uc* texels = stbi_load_from_callbacks_ex(&options, &StreamReader::Callbacks, reader.get(),
+            &x, &y, &comp, static_cast<int>(channels));
+    if (nullptr == texels) {
+        failure = options.failure_reason ? options.failure_reason : "unknown failure";
+        return nullptr;
+    }
+    width = static_cast<unsigned int>(x);
+    height = static_cast<unsigned int>(y);
+    return texels;
+}
+
+// ------------------------------------------------------------------------------------------------
+bool ProbeImage(IOStream* stream, unsigned int& width, unsigned int& height,
+        unsigned int& channels, std::string& failure) {
+    std::unique_ptr<StreamReader> reader(new StreamReader(stream));
+    stbi_options options;
+    stbi_options_init(&options);
+    int x = 0, y = 0, comp = 0;
+    if (!stbi_info_from_callbacks_ex(&options, &StreamReader::Callbacks, reader.get(), &x, &y, &comp)) {
+        failure = options.failure_reason ? options.failure_reason : "unknown failure";
+        return false;
+    }
+    width = static_cast<unsigned int>(x);
+    height = static_cast<unsigned int>(y);
+    channels = static_cast<unsigned int>(comp);
+    return true;
+}
+
+// ------------------------------------------------------------------------------------------------
+bool IsDecodableImage(const std::string& extension) {
+    static const char* const extensions[] = {
+        "png", "jpg", "jpeg", "tga", "bmp", "psd", "gif", "hdr", "pic", "pnm", "ppm", "pgm"
+    };
+    for (const char* known : extensions) {
+        if (extension == known) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// ------------------------------------------------------------------------------------------------
+void FreeDecodedImage(unsigned char* texels) {
+    stbi_image_free(texels);
+}
+
+} // end of namespace Assimp
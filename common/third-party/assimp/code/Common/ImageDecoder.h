@@ -0,0 +1,115 @@
+/*
+---------------------------------------------------------------------------
+Open Asset Import Library (assimp)
+---------------------------------------------------------------------------
+
+Copyright (c) 2006-2019, assimp team
+
+All rights reserved.
+
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the following
+conditions are met:
+
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+
+* Neither the name of the assimp team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the assimp team.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+---------------------------------------------------------------------------
+*/
+
+/** @file  ImageDecoder.h
+ *  @brief Decoding of image files for the post-processing steps that work
+ *    on texels.
+ */
+#ifndef AI_IMAGE_DECODER_H_INC
+#define AI_IMAGE_DECODER_H_INC
+
+#include <assimp/defs.h>
+
+#include <cstddef>
+#include <string>
+
+namespace Assimp {
+
+class IOStream;
+
+// --------------------------------------------------------------------------------------------
+/** @brief Decode an image file held in memory to 8 bits per channel.
+ *
+ *  Reads whatever stb_image reads: PNG, JPEG, TGA, BMP, PSD, GIF, HDR, PIC
+ *  and PNM. stb_image is compiled privately into ImageDecoder.cpp, so it
+ *  does not clash with the copy an application links itself.
+ *  @param data The file contents
+ *  @param size Size of @c data in bytes
+ *  @param channels Channels per texel of the result, 1 to 4. Images with
+ *    other channel counts are converted, grey from color is the luminance.
+ *  @param width Receives the width in texels
+ *  @param height Receives the height in texels
+ *  @param failure Receives the reason if decoding fails
+ *  @return The texels, top row first, allocated with malloc() and to be
+ *    released with FreeDecodedImage(); nullptr on failure. Safe to call
+ *    from several threads at once. */
+ASSIMP_API unsigned char* DecodeImage(const void* data, size_t size, unsigned int channels,
+        unsigned int& width, unsigned int& height, std::string& failure);
+
+// --------------------------------------------------------------------------------------------
+/** @brief Decode an image file while reading it from a stream.
+ *
+ *  Same as above, but the file is not read into memory first: stb_image
+ *  pulls it through a bounded read-ahead buffer (16 KB), so only the
+ *  decoder's own state and the result are held at once. Formats that need
+ *  their compressed data in one piece (the zlib stream of a PNG) still
+ *  gather it inside stb_image.
+ *  @param stream Read from its current position; left somewhere past the
+ *    image afterwards. Not closed. */
+ASSIMP_API unsigned char* DecodeImage(IOStream* stream, unsigned int channels,
+        unsigned int& width, unsigned int& height, std::string& failure);
+
+// --------------------------------------------------------------------------------------------
+/** @brief Read only the header of an image file from a stream.
+ *
+ *  Reads no more than the read-ahead buffer for most files (a JPEG with
+ *  large metadata in front of its frame header skips over it).
+ *  @param stream Read from its current position, which is left undefined.
+ *  @param width Receives the width in texels
+ *  @param height Receives the height in texels
+ *  @param channels Receives the channels stored in the file, 1 to 4
+ *  @param failure Receives the reason if the header is not understood
+ *  @return false if stb_image does not recognise the file. */
+ASSIMP_API bool ProbeImage(IOStream* stream, unsigned int& width, unsigned int& height,
+        unsigned int& channels, std::string& failure);
+
+// --------------------------------------------------------------------------------------------
+/** @brief Whether stb_image reads files with this extension (lower case,
+ *  without the dot), e.g. "png" but not "dds". */
+ASSIMP_API bool IsDecodableImage(const std::string& extension);
+
+// --------------------------------------------------------------------------------------------
+/** @brief Release the texels returned by DecodeImage(). */
+ASSIMP_API void FreeDecodedImage(unsigned char* texels);
+
+} // end of namespace Assimp
+
+#endif // AI_IMAGE_DECODER_H_INC
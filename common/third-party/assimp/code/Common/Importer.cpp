@@ -1122,6 +1122,15 @@ void Importer::GetMemoryRequirements(aiMemoryInfo& in) const
             }
         }
         in.meshes += (sizeof(aiFace) + 3 * sizeof(unsigned int))*mScene->mMeshes[i]->mNumFaces;
+        if (mScene->mMeshes[i]->HasMeshlets()) {
+            in.meshes += sizeof(aiMeshlet) * mScene->mMeshes[i]->mNumMeshlets;
+            in.meshes += sizeof(unsigned int) * mScene->mMeshes[i]->mNumMeshletVertices;
+            in.meshes += 3 * mScene->mMeshes[i]->mNumFaces;
+        }
+        if (mScene->mMeshes[i]->HasPackedVertices()) {
+            const aiPackedVertices* packed = mScene->mMeshes[i]->mPackedVertices;
+            in.meshes += sizeof(aiPackedVertices) + packed->mNumVertices * packed->mStride;
+        }
     }
     in.total += in.meshes;
 
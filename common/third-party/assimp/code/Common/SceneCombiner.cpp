@@ -1094,6 +1094,16 @@ void SceneCombiner::Copy( aiMesh** _dest, const aiMesh* src ) {
 
     // make a deep copy of all blend shapes
     CopyPtrArray(dest->mAnimMeshes, dest->mAnimMeshes, dest->mNumAnimMeshes);
+
+    // and of the meshlets
+    GetArrayCopy(dest->mMeshlets, dest->mNumMeshlets);
+    GetArrayCopy(dest->mMeshletVertices, dest->mNumMeshletVertices);
+    GetArrayCopy(dest->mMeshletTriangles, dest->mNumFaces * 3);
+
+    // and of the packed vertex stream
+    if (src->mPackedVertices) {
+        dest->mPackedVertices = new aiPackedVertices(*src->mPackedVertices);
+    }
 }
 
 // ------------------------------------------------------------------------------------------------
@@ -51,6 +51,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 
 #include "ConvertToLHProcess.h"
+#include "ProcessHelper.h"
 #include <assimp/scene.h>
 #include <assimp/postprocess.h>
 #include <assimp/DefaultLogger.hpp>
@@ -162,6 +163,8 @@ void MakeLeftHandedProcess::ProcessMesh( aiMesh* pMesh) {
         ASSIMP_LOG_ERROR( "Nullptr to mesh found." );
         return;
     }
+    DropMeshlets(pMesh);
+
     // mirror positions, normals and stuff along the Z axis
     for( size_t a = 0; a < pMesh->mNumVertices; ++a)
     {
@@ -360,6 +363,8 @@ void FlipWindingOrderProcess::Execute( aiScene* pScene)
 // Converts a single mesh
 void FlipWindingOrderProcess::ProcessMesh( aiMesh* pMesh)
 {
+    DropMeshlets(pMesh);
+
     // invert the order of all faces in this mesh
     for( unsigned int a = 0; a < pMesh->mNumFaces; a++)
     {
@@ -41,15 +41,19 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 */
 
 #include "EmbedTexturesProcess.h"
+#include "Common/ImageDecoder.h"
+#include <assimp/IOStream.hpp>
+#include <assimp/IOSystem.hpp>
 #include <assimp/ParsingUtils.h>
 #include "ProcessHelper.h"
 
-#include <fstream>
+#include <algorithm>
 
 using namespace Assimp;
 
 EmbedTexturesProcess::EmbedTexturesProcess()
-: BaseProcess() {
+: BaseProcess()
+, mIOHandler(nullptr) {
 }
 
 EmbedTexturesProcess::~EmbedTexturesProcess() {
@@ -62,6 +66,7 @@ bool EmbedTexturesProcess::IsActive(unsigned int pFlags) const {
 void EmbedTexturesProcess::SetupProperties(const Importer* pImp) {
     mRootPath = pImp->GetPropertyString("sourceFilePath");
     mRootPath = mRootPath.substr(0, mRootPath.find_last_of("\\/") + 1u);
+    mIOHandler = pImp->GetIOHandler();
 }
 
 void EmbedTexturesProcess::Execute(aiScene* pScene) {
@@ -97,31 +102,57 @@ void EmbedTexturesProcess::Execute(aiScene* pScene) {
 }
 
 bool EmbedTexturesProcess::addTexture(aiScene* pScene, std::string path) const {
-    std::streampos imageSize = 0;
-    std::string    imagePath = path;
+    std::string imagePath = path;
 
     // Test path directly
-    std::ifstream file(imagePath, std::ios::binary | std::ios::ate);
-    if ((imageSize = file.tellg()) == std::streampos(-1)) {
+    IOStream* file = mIOHandler->Open(imagePath, "rb");
+    if (nullptr == file) {
         ASSIMP_LOG_WARN_F("EmbedTexturesProcess: Cannot find image: ", imagePath, ". Will try to find it in root folder.");
 
         // Test path in root path
         imagePath = mRootPath + path;
-        file.open(imagePath, std::ios::binary | std::ios::ate);
-        if ((imageSize = file.tellg()) == std::streampos(-1)) {
+        file = mIOHandler->Open(imagePath, "rb");
+        if (nullptr == file) {
             // Test path basename in root path
             imagePath = mRootPath + path.substr(path.find_last_of("\\/") + 1u);
-            file.open(imagePath, std::ios::binary | std::ios::ate);
-            if ((imageSize = file.tellg()) == std::streampos(-1)) {
+            file = mIOHandler->Open(imagePath, "rb");
+            if (nullptr == file) {
                 ASSIMP_LOG_ERROR_F("EmbedTexturesProcess: Unable to embed texture: ", path, ".");
                 return false;
             }
         }
     }
 
-    aiTexel* imageContent = new aiTexel[ 1ul + static_cast<unsigned long>( imageSize ) / sizeof(aiTexel)];
-    file.seekg(0, std::ios::beg);
-    file.read(reinterpret_cast<char*>(imageContent), imageSize);
+    auto extension = path.substr(path.find_last_of('.') + 1u);
+    std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+    if (extension == "jpeg") {
+        extension = "jpg";
+    }
+
+    // Check the header before reading the whole file, formats stb_image does not know are taken as they are
+    if (IsDecodableImage(extension)) {
+        unsigned int width = 0, height = 0, channels = 0;
+        std::string failure;
+        if (!ProbeImage(file, width, height, channels, failure)) {
+            ASSIMP_LOG_ERROR_F("EmbedTexturesProcess: Unable to embed texture: ", imagePath, ", not a valid image (",
+                failure, ").");
+            mIOHandler->Close(file);
+            return false;
+        }
+        ASSIMP_LOG_DEBUG_F("EmbedTexturesProcess: ", imagePath, " is ", width, "x", height, ", ", channels,
+            " channels.");
+        file->Seek(0, aiOrigin_SET);
+    }
+
+    const size_t imageSize = file->FileSize();
+    aiTexel* imageContent = new aiTexel[ 1ul + imageSize / sizeof(aiTexel)];
+    const size_t read = imageSize == 0 ? 0 : file->Read(imageContent, 1, imageSize);
+    mIOHandler->Close(file);
+    if (read != imageSize) {
+        ASSIMP_LOG_ERROR_F("EmbedTexturesProcess: Unable to embed texture: ", imagePath, ", read failed.");
+        delete[] imageContent;
+        return false;
+    }
 
     // Enlarging the textures table
     unsigned int textureId = pScene->mNumTextures++;
@@ -135,12 +166,6 @@ bool EmbedTexturesProcess::addTexture(aiScene* pScene, std::string path) const {
     pTexture->mWidth = static_cast<uint32_t>(imageSize);
     pTexture->pcData = imageContent;
 
-    auto extension = path.substr(path.find_last_of('.') + 1u);
-    std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
-    if (extension == "jpeg") {
-        extension = "jpg";
-    }
-
     size_t len = extension.size();
     if (len > HINTMAXTEXTURELEN -1 ) {
         len = HINTMAXTEXTURELEN - 1;
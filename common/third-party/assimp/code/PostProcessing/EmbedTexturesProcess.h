@@ -50,12 +50,17 @@ struct aiNode;
 
 namespace Assimp {
 
+class IOSystem;
+
 /**
  *  Force embedding of textures (using the path = "*1" convention).
  *  If a texture's file does not exist at the specified path
  *  (due, for instance, to an absolute path generated on another system),
  *  it will check if a file with the same name exists at the root folder
  *  of the imported model. And if so, it uses that.
+ *  Files go through the importer's IOSystem. Images in a format stb_image
+ *  reads are probed first, from their header alone, and not embedded if it
+ *  is not valid.
  */
 class ASSIMP_API EmbedTexturesProcess : public BaseProcess {
 public:
@@ -80,6 +85,7 @@ private:
 
 private:
     std::string mRootPath;
+    IOSystem* mIOHandler;
 };
 
 } // namespace Assimp
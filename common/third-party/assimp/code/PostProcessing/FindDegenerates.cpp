@@ -294,6 +294,9 @@ evil_jump_outside:
         }
     }
 
+    if (deg) {
+        DropMeshlets(mesh);
+    }
     if (deg && !DefaultLogger::isNullLogger()) {
         ASSIMP_LOG_WARN_F( "Found ", deg, " degenerated primitives");
     }
@@ -47,6 +47,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 // internal headers
 #include "FixNormalsStep.h"
+#include "ProcessHelper.h"
 #include <assimp/StringUtils.h>
 #include <assimp/DefaultLogger.hpp>
 #include <assimp/postprocess.h>
@@ -178,6 +179,7 @@ bool FixInfacingNormalsProcess::ProcessMesh( aiMesh* pcMesh, unsigned int index)
             for( unsigned int b = 0; b < face.mNumIndices / 2; b++)
                 std::swap( face.mIndices[b], face.mIndices[ face.mNumIndices - 1 - b]);
         }
+        DropMeshlets(pcMesh);
         return true;
     }
     return false;
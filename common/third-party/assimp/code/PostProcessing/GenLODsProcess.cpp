@@ -0,0 +1,602 @@
+/*
+---------------------------------------------------------------------------
+Open Asset Import Library (assimp)
+---------------------------------------------------------------------------
+
+Copyright (c) 2006-2019, assimp team
+
+All rights reserved.
+
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the following
+conditions are met:
+
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+
+* Neither the name of the assimp team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the assimp team.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+---------------------------------------------------------------------------
+*/
+
+/** @file Implementation of the post-processing step to generate levels of
+ *  detail with the quadric error metric.
+ *  <br>
+ *  The algorithm is roughly based on this paper:
+ *  Garland, Heckbert: Surface Simplification Using Quadric Error Metrics
+ *  .. restricted to half-edge collapses, which keeps the original vertices.
+ */
+
+#ifndef ASSIMP_BUILD_NO_GENLODS_PROCESS
+
+#include "PostProcessing/GenLODsProcess.h"
+#include "Common/VertexTriangleAdjacency.h"
+
+#include <assimp/postprocess.h>
+#include <assimp/scene.h>
+#include <assimp/DefaultLogger.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <string>
+
+namespace Assimp {
+
+namespace {
+
+// ------------------------------------------------------------------------------------------------
+// Symmetric 4x4 error quadric of a set of planes, weighted by triangle area.
+struct Quadric {
+    double a00, a01, a02, a03, a11, a12, a13, a22, a23, a33;
+    double w;
+
+    Quadric()
+    : a00(0.), a01(0.), a02(0.), a03(0.), a11(0.), a12(0.), a13(0.), a22(0.), a23(0.), a33(0.)
+    , w(0.) {
+        // empty
+    }
+
+    void AddPlane(double a, double b, double c, double d, double weight) {
+        a00 += weight * a * a; a01 += weight * a * b; a02 += weight * a * c; a03 += weight * a * d;
+        a11 += weight * b * b; a12 += weight * b * c; a13 += weight * b * d;
+        a22 += weight * c * c; a23 += weight * c * d;
+        a33 += weight * d * d;
+        w += weight;
+    }
+
+    Quadric& operator += (const Quadric& o) {
+        a00 += o.a00; a01 += o.a01; a02 += o.a02; a03 += o.a03;
+        a11 += o.a11; a12 += o.a12; a13 += o.a13;
+        a22 += o.a22; a23 += o.a23;
+        a33 += o.a33;
+        w += o.w;
+        return *this;
+    }
+
+    // Squared distance of p to the planes, averaged by area.
+    double Evaluate(const aiVector3D& p) const {
+        const double x = p.x, y = p.y, z = p.z;
+        const double r = a00 * x * x + 2. * a01 * x * y + 2. * a02 * x * z + 2. * a03 * x
+                       + a11 * y * y + 2. * a12 * y * z + 2. * a13 * y
+                       + a22 * z * z + 2. * a23 * z
+                       + a33;
+        return w > 0. ? std::fabs(r) / w : 0.;
+    }
+};
+
+// ------------------------------------------------------------------------------------------------
+// Collapse of vertex 'from' onto vertex 'to'.
+struct Collapse {
+    unsigned int from, to;
+    double cost;
+
+    bool operator < (const Collapse& o) const {
+        return cost < o.cost;
+    }
+};
+
+// ------------------------------------------------------------------------------------------------
+aiVector3D TriangleNormal(const aiVector3D& a, const aiVector3D& b, const aiVector3D& c) {
+    return (b - a) ^ (c - a);
+}
+
+// ------------------------------------------------------------------------------------------------
+// Progressive half-edge collapse simplifier for one triangle mesh. Triangles
+// around a vertex are found through the adjacency of the input mesh: when
+// 'from' collapses onto 'to', the merge list of 'from' is spliced into the
+// one of 'to', and all live triangles of that list now reference 'to'.
+class MeshSimplifier {
+public:
+    explicit MeshSimplifier(const aiMesh* mesh)
+    : mMesh(mesh)
+    , mAdj(mesh->mFaces, mesh->mNumFaces, mesh->mNumVertices, true)
+    , mIndices(mesh->mNumFaces * 3)
+    , mFaceAlive(mesh->mNumFaces, 1)
+    , mNumLiveFaces(mesh->mNumFaces)
+    , mVertexRemoved(mesh->mNumVertices, 0)
+    , mLocked(mesh->mNumVertices, 0)
+    , mNext(mesh->mNumVertices)
+    , mQuadrics(mesh->mNumVertices)
+    , mStampU(mesh->mNumVertices, 0)
+    , mStampV(mesh->mNumVertices, 0)
+    , mStamp(0)
+    , mError(0.) {
+        for (unsigned int i = 0; i < mesh->mNumFaces; ++i) {
+            const aiFace& face = mesh->mFaces[i];
+            for (unsigned int j = 0; j < 3; ++j) {
+                mIndices[i * 3 + j] = face.mIndices[j];
+            }
+        }
+        for (unsigned int i = 0; i < mesh->mNumVertices; ++i) {
+            mNext[i] = i;
+        }
+        ComputeQuadrics();
+        LockBorders();
+        LockSeams();
+    }
+
+    unsigned int GetNumLiveFaces() const {
+        return mNumLiveFaces;
+    }
+
+    // Largest error of all collapses so far, in scene units.
+    float GetError() const {
+        return static_cast<float>(mError);
+    }
+
+    // Collapses edges in cost order until at most 'target' faces are left
+    // or the next collapse would exceed 'maxError'.
+    void Simplify(unsigned int target, double maxError) {
+        std::vector<Collapse> candidates;
+        std::vector<char> touched(mMesh->mNumVertices);
+        while (mNumLiveFaces > target) {
+            candidates.clear();
+            for (unsigned int t = 0; t < mMesh->mNumFaces; ++t) {
+                if (!mFaceAlive[t]) {
+                    continue;
+                }
+                for (unsigned int e = 0; e < 3; ++e) {
+                    const unsigned int a = mIndices[t * 3 + e], b = mIndices[t * 3 + (e + 1) % 3];
+                    // interior edges are seen from both of their triangles
+                    if (a > b) {
+                        continue;
+                    }
+                    if (!mLocked[a]) {
+                        candidates.push_back({ a, b, Cost(a, b) });
+                    }
+                    if (!mLocked[b]) {
+                        candidates.push_back({ b, a, Cost(b, a) });
+                    }
+                }
+            }
+            std::sort(candidates.begin(), candidates.end());
+
+            // the quadrics of untouched vertices are still the ones the
+            // costs were computed from, so a single sort per pass suffices
+            std::fill(touched.begin(), touched.end(), 0);
+            unsigned int collapsed = 0;
+            for (const Collapse& c : candidates) {
+                if (mNumLiveFaces <= target || c.cost > maxError) {
+                    break;
+                }
+                if (mVertexRemoved[c.from] || mVertexRemoved[c.to] || touched[c.from] || touched[c.to]) {
+                    continue;
+                }
+                if (!CanCollapse(c.from, c.to)) {
+                    continue;
+                }
+                DoCollapse(c.from, c.to);
+                touched[c.from] = touched[c.to] = 1;
+                mError = std::max(mError, c.cost);
+                ++collapsed;
+            }
+            if (!collapsed) {
+                break;
+            }
+        }
+    }
+
+    // Builds a mesh from the current state, keeping only referenced vertices.
+    aiMesh* BuildMesh() const {
+        const unsigned int invalid = std::numeric_limits<unsigned int>::max();
+        std::vector<unsigned int> remap(mMesh->mNumVertices, invalid);
+        std::vector<unsigned int> used;
+        used.reserve(mNumLiveFaces);
+
+        aiMesh* out = new aiMesh();
+        out->mPrimitiveTypes = aiPrimitiveType_TRIANGLE;
+        out->mMaterialIndex = mMesh->mMaterialIndex;
+        out->mNumFaces = mNumLiveFaces;
+        out->mFaces = new aiFace[mNumLiveFaces];
+        for (unsigned int t = 0, f = 0; t < mMesh->mNumFaces; ++t) {
+            if (!mFaceAlive[t]) {
+                continue;
+            }
+            aiFace& face = out->mFaces[f++];
+            face.mNumIndices = 3;
+            face.mIndices = new unsigned int[3];
+            for (unsigned int j = 0; j < 3; ++j) {
+                const unsigned int v = mIndices[t * 3 + j];
+                if (remap[v] == invalid) {
+                    remap[v] = static_cast<unsigned int>(used.size());
+                    used.push_back(v);
+                }
+                face.mIndices[j] = remap[v];
+            }
+        }
+
+        const unsigned int n = static_cast<unsigned int>(used.size());
+        out->mNumVertices = n;
+        out->mVertices = Gather(mMesh->mVertices, used);
+        out->mNormals = Gather(mMesh->mNormals, used);
+        out->mTangents = Gather(mMesh->mTangents, used);
+        out->mBitangents = Gather(mMesh->mBitangents, used);
+        for (unsigned int c = 0; c < AI_MAX_NUMBER_OF_COLOR_SETS; ++c) {
+            out->mColors[c] = Gather(mMesh->mColors[c], used);
+        }
+        for (unsigned int c = 0; c < AI_MAX_NUMBER_OF_TEXTURECOORDS; ++c) {
+            out->mTextureCoords[c] = Gather(mMesh->mTextureCoords[c], used);
+            out->mNumUVComponents[c] = mMesh->mNumUVComponents[c];
+        }
+        return out;
+    }
+
+private:
+    template <typename T>
+    static T* Gather(const T* src, const std::vector<unsigned int>& used) {
+        if (nullptr == src) {
+            return nullptr;
+        }
+        T* dst = new T[used.size()];
+        for (size_t i = 0; i < used.size(); ++i) {
+            dst[i] = src[used[i]];
+        }
+        return dst;
+    }
+
+    void ComputeQuadrics() {
+        const aiVector3D* pos = mMesh->mVertices;
+        for (unsigned int t = 0; t < mMesh->mNumFaces; ++t) {
+            const unsigned int* idx = &mIndices[t * 3];
+            const aiVector3D &a = pos[idx[0]], &b = pos[idx[1]], &c = pos[idx[2]];
+            const aiVector3D n = TriangleNormal(a, b, c);
+            const double len = std::sqrt(double(n.x) * n.x + double(n.y) * n.y + double(n.z) * n.z);
+            if (len <= 0.) {
+                continue;
+            }
+            const double nx = n.x / len, ny = n.y / len, nz = n.z / len;
+            const double d = -(nx * a.x + ny * a.y + nz * a.z);
+            for (unsigned int j = 0; j < 3; ++j) {
+                mQuadrics[idx[j]].AddPlane(nx, ny, nz, d, len * 0.5);
+            }
+        }
+    }
+
+    // An edge used by a single triangle is an open border, either of the
+    // surface or of the material. Its vertices must stay in place.
+    void LockBorders() {
+        std::vector<unsigned int> count(mMesh->mNumVertices, 0), neighbours;
+        for (unsigned int v = 0; v < mMesh->mNumVertices; ++v) {
+            ++mStamp;
+            neighbours.clear();
+            const unsigned int* tris = mAdj.GetAdjacentTriangles(v);
+            for (unsigned int i = 0; i < mAdj.mLiveTriangles[v]; ++i) {
+                const unsigned int* idx = &mIndices[tris[i] * 3];
+                for (unsigned int j = 0; j < 3; ++j) {
+                    const unsigned int w = idx[j];
+                    if (w == v) {
+                        continue;
+                    }
+                    if (mStampU[w] != mStamp) {
+                        mStampU[w] = mStamp;
+                        count[w] = 0;
+                        neighbours.push_back(w);
+                    }
+                    ++count[w];
+                }
+            }
+            for (unsigned int w : neighbours) {
+                if (count[w] == 1) {
+                    mLocked[v] = 1;
+                    break;
+                }
+            }
+        }
+    }
+
+    // Vertices sharing their position with another vertex lie on an UV or
+    // normal seam; moving them would tear the surface apart.
+    void LockSeams() {
+        const aiVector3D* pos = mMesh->mVertices;
+        std::vector<unsigned int> order(mMesh->mNumVertices);
+        for (unsigned int i = 0; i < mMesh->mNumVertices; ++i) {
+            order[i] = i;
+        }
+        std::sort(order.begin(), order.end(), [pos](unsigned int a, unsigned int b) {
+            return pos[a] < pos[b];
+        });
+        for (size_t i = 1; i < order.size(); ++i) {
+            if (pos[order[i - 1]] == pos[order[i]]) {
+                mLocked[order[i - 1]] = mLocked[order[i]] = 1;
+            }
+        }
+    }
+
+    double Cost(unsigned int from, unsigned int to) const {
+        Quadric q = mQuadrics[from];
+        q += mQuadrics[to];
+        return std::sqrt(q.Evaluate(mMesh->mVertices[to]));
+    }
+
+    // Collects the live triangles around v into 'out'.
+    void GetTriangles(unsigned int v, std::vector<unsigned int>& out) const {
+        out.clear();
+        unsigned int w = v;
+        do {
+            const unsigned int* tris = mAdj.GetAdjacentTriangles(w);
+            for (unsigned int i = 0; i < mAdj.mLiveTriangles[w]; ++i) {
+                if (mFaceAlive[tris[i]]) {
+                    out.push_back(tris[i]);
+                }
+            }
+            w = mNext[w];
+        } while (w != v);
+    }
+
+    bool HasVertex(unsigned int t, unsigned int v) const {
+        return mIndices[t * 3] == v || mIndices[t * 3 + 1] == v || mIndices[t * 3 + 2] == v;
+    }
+
+    bool CanCollapse(unsigned int from, unsigned int to) {
+        GetTriangles(to, mTrisV);
+        GetTriangles(from, mTrisU);
+
+        // link condition: the end points may only share the vertices
+        // opposite to the edge, otherwise the collapse is non-manifold
+        ++mStamp;
+        for (unsigned int t : mTrisU) {
+            for (unsigned int j = 0; j < 3; ++j) {
+                mStampU[mIndices[t * 3 + j]] = mStamp;
+            }
+        }
+        unsigned int shared = 0, edgeFaces = 0;
+        for (unsigned int t : mTrisV) {
+            edgeFaces += HasVertex(t, from) ? 1 : 0;
+            for (unsigned int j = 0; j < 3; ++j) {
+                const unsigned int w = mIndices[t * 3 + j];
+                if (w != from && w != to && mStampU[w] == mStamp && mStampV[w] != mStamp) {
+                    mStampV[w] = mStamp;
+                    ++shared;
+                }
+            }
+        }
+        if (shared != edgeFaces) {
+            return false;
+        }
+
+        // reject collapses that flip or degenerate any remaining triangle
+        const aiVector3D* pos = mMesh->mVertices;
+        for (unsigned int t : mTrisU) {
+            if (HasVertex(t, to)) {
+                continue;
+            }
+            const unsigned int* idx = &mIndices[t * 3];
+            aiVector3D p[3] = { pos[idx[0]], pos[idx[1]], pos[idx[2]] };
+            const aiVector3D before = TriangleNormal(p[0], p[1], p[2]);
+            for (unsigned int j = 0; j < 3; ++j) {
+                if (idx[j] == from) {
+                    p[j] = pos[to];
+                }
+            }
+            const aiVector3D after = TriangleNormal(p[0], p[1], p[2]);
+            if (before * after <= 0.25f * before.Length() * after.Length()) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Expects mTrisU to hold the triangles around 'from' (see CanCollapse).
+    void DoCollapse(unsigned int from, unsigned int to) {
+        for (unsigned int t : mTrisU) {
+            if (HasVertex(t, to)) {
+                mFaceAlive[t] = 0;
+                --mNumLiveFaces;
+                continue;
+            }
+            for (unsigned int j = 0; j < 3; ++j) {
+                if (mIndices[t * 3 + j] == from) {
+                    mIndices[t * 3 + j] = to;
+                }
+            }
+        }
+        mQuadrics[to] += mQuadrics[from];
+        mVertexRemoved[from] = 1;
+        std::swap(mNext[from], mNext[to]);
+    }
+
+    const aiMesh* mMesh;
+    VertexTriangleAdjacency mAdj;
+    std::vector<unsigned int> mIndices;
+    std::vector<char> mFaceAlive;
+    unsigned int mNumLiveFaces;
+    std::vector<char> mVertexRemoved;
+    std::vector<char> mLocked;
+    std::vector<unsigned int> mNext;
+    std::vector<Quadric> mQuadrics;
+    std::vector<unsigned int> mStampU, mStampV;
+    unsigned int mStamp;
+    std::vector<unsigned int> mTrisU, mTrisV;
+    double mError;
+};
+
+} // Namespace
+
+// ------------------------------------------------------------------------------------------------
+GenLODsProcess::GenLODsProcess()
+: BaseProcess()
+, mLevels(AI_GLOD_DEFAULT_LEVELS)
+, mRatio(AI_GLOD_DEFAULT_RATIO)
+, mMaxError(AI_GLOD_DEFAULT_MAX_ERROR)
+, mMinFaces(AI_GLOD_DEFAULT_MIN_FACES) {
+    // empty
+}
+
+// ------------------------------------------------------------------------------------------------
+GenLODsProcess::~GenLODsProcess() {
+    // empty
+}
+
+// ------------------------------------------------------------------------------------------------
+bool GenLODsProcess::IsActive(unsigned int /*pFlags*/) const {
+    return false;
+}
+
+// ------------------------------------------------------------------------------------------------
+void GenLODsProcess::SetupProperties(const Importer* pImp) {
+    const int levels = pImp->GetPropertyInteger(AI_CONFIG_PP_GLOD_LEVELS, AI_GLOD_DEFAULT_LEVELS);
+    mLevels = levels > 0 ? static_cast<unsigned int>(levels) : 0;
+
+    mRatio = pImp->GetPropertyFloat(AI_CONFIG_PP_GLOD_RATIO, AI_GLOD_DEFAULT_RATIO);
+    if (!(mRatio > 0.f && mRatio < 1.f)) {
+        ASSIMP_LOG_WARN("GenLODsProcess: AI_CONFIG_PP_GLOD_RATIO must be in ]0,1[, using the default");
+        mRatio = AI_GLOD_DEFAULT_RATIO;
+    }
+
+    mMaxError = std::max(0.f, pImp->GetPropertyFloat(AI_CONFIG_PP_GLOD_MAX_ERROR, AI_GLOD_DEFAULT_MAX_ERROR));
+
+    const int minFaces = pImp->GetPropertyInteger(AI_CONFIG_PP_GLOD_MIN_FACES, AI_GLOD_DEFAULT_MIN_FACES);
+    mMinFaces = minFaces > 1 ? static_cast<unsigned int>(minFaces) : 1;
+}
+
+// ------------------------------------------------------------------------------------------------
+void GenLODsProcess::Execute(aiScene* pScene) {
+    if (!pScene->mNumMeshes || !mLevels) {
+        ASSIMP_LOG_DEBUG("GenLODsProcess skipped");
+        return;
+    }
+
+    ASSIMP_LOG_DEBUG("GenLODsProcess begin");
+
+    std::vector<aiMesh*> newMeshes, lods;
+    std::vector<float> errors;
+    std::vector<std::string> keys;
+    std::vector<int32_t> indices;
+    std::vector<float> keyErrors;
+    for (unsigned int a = 0; a < pScene->mNumMeshes; ++a) {
+        ProcessMesh(pScene->mMeshes[a], lods, errors);
+        for (size_t k = 0; k < lods.size(); ++k) {
+            const std::string level = std::to_string(k + 1);
+            lods[k]->mName = std::string(pScene->mMeshes[a]->mName.C_Str()) + "_LOD" + level;
+            keys.push_back("$lod." + std::to_string(a) + "." + level);
+            indices.push_back(static_cast<int32_t>(pScene->mNumMeshes + newMeshes.size()));
+            keyErrors.push_back(errors[k]);
+            newMeshes.push_back(lods[k]);
+        }
+    }
+
+    if (newMeshes.empty()) {
+        ASSIMP_LOG_DEBUG("GenLODsProcess finished. No mesh could be simplified");
+        return;
+    }
+
+    // append the LOD meshes behind the existing ones
+    const unsigned int numMeshes = pScene->mNumMeshes + static_cast<unsigned int>(newMeshes.size());
+    aiMesh** meshes = new aiMesh*[numMeshes];
+    std::copy(pScene->mMeshes, pScene->mMeshes + pScene->mNumMeshes, meshes);
+    std::copy(newMeshes.begin(), newMeshes.end(), meshes + pScene->mNumMeshes);
+    delete[] pScene->mMeshes;
+    pScene->mMeshes = meshes;
+    pScene->mNumMeshes = numMeshes;
+
+    // and announce them in the scene metadata, moving existing entries over
+    aiMetadata* old = pScene->mMetaData;
+    const unsigned int numOld = old ? old->mNumProperties : 0;
+    aiMetadata* meta = aiMetadata::Alloc(numOld + static_cast<unsigned int>(keys.size()) * 2);
+    for (unsigned int i = 0; i < numOld; ++i) {
+        meta->mKeys[i] = old->mKeys[i];
+        meta->mValues[i] = old->mValues[i];
+        old->mValues[i].mData = nullptr;
+    }
+    delete old;
+    for (size_t i = 0; i < keys.size(); ++i) {
+        const unsigned int slot = numOld + static_cast<unsigned int>(i) * 2;
+        meta->Set(slot, keys[i], indices[i]);
+        meta->Set(slot + 1, keys[i] + ".error", keyErrors[i]);
+    }
+    pScene->mMetaData = meta;
+
+    ASSIMP_LOG_INFO_F("GenLODsProcess finished. Generated ", newMeshes.size(), " LOD meshes");
+}
+
+// ------------------------------------------------------------------------------------------------
+void GenLODsProcess::ProcessMesh(const aiMesh* pMesh, std::vector<aiMesh*>& lods,
+        std::vector<float>& errors) {
+    lods.clear();
+    errors.clear();
+
+    if (!pMesh->HasFaces() || !pMesh->HasPositions() || pMesh->mNumFaces <= mMinFaces) {
+        return;
+    }
+    if (pMesh->mPrimitiveTypes != aiPrimitiveType_TRIANGLE) {
+        ASSIMP_LOG_WARN("GenLODsProcess: This algorithm works on triangle meshes only");
+        return;
+    }
+    if (pMesh->HasBones() || pMesh->mNumAnimMeshes) {
+        ASSIMP_LOG_DEBUG("GenLODsProcess: Skipping skinned or morphed mesh");
+        return;
+    }
+
+    aiVector3D min = pMesh->mVertices[0], max = min;
+    for (unsigned int i = 1; i < pMesh->mNumVertices; ++i) {
+        const aiVector3D &pos = pMesh->mVertices[i];
+        min.x = std::min(min.x, pos.x); min.y = std::min(min.y, pos.y); min.z = std::min(min.z, pos.z);
+        max.x = std::max(max.x, pos.x); max.y = std::max(max.y, pos.y); max.z = std::max(max.z, pos.z);
+    }
+    const double maxError = mMaxError * (max - min).Length();
+
+    MeshSimplifier simplifier(pMesh);
+    unsigned int prev = pMesh->mNumFaces;
+    for (unsigned int level = 0; level < mLevels; ++level) {
+        const unsigned int target = std::max(mMinFaces, static_cast<unsigned int>(prev * mRatio));
+        if (target >= prev) {
+            break;
+        }
+        simplifier.Simplify(target, maxError);
+
+        // stop the chain once the error bound keeps us from getting
+        // reasonably close to the requested face count
+        const unsigned int faces = simplifier.GetNumLiveFaces();
+        if (faces > prev - (prev - target) / 2) {
+            break;
+        }
+        lods.push_back(simplifier.BuildMesh());
+        errors.push_back(simplifier.GetError());
+        prev = faces;
+    }
+}
+
+} // Namespace Assimp
+
+#endif // !! ASSIMP_BUILD_NO_GENLODS_PROCESS
@@ -0,0 +1,124 @@
+/*
+---------------------------------------------------------------------------
+Open Asset Import Library (assimp)
+---------------------------------------------------------------------------
+
+Copyright (c) 2006-2019, assimp team
+
+All rights reserved.
+
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the following
+conditions are met:
+
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+
+* Neither the name of the assimp team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the assimp team.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+---------------------------------------------------------------------------
+*/
+
+
+/** @file Defines a post-processing step to generate a chain of simplified
+ *        levels of detail for all triangle meshes.
+ */
+
+#pragma once
+
+#ifndef AI_GENLODSPROCESS_H_INC
+#define AI_GENLODSPROCESS_H_INC
+
+#ifndef ASSIMP_BUILD_NO_GENLODS_PROCESS
+
+#include "Common/BaseProcess.h"
+
+#include <assimp/types.h>
+#include <vector>
+
+struct aiMesh;
+
+namespace Assimp {
+
+// ---------------------------------------------------------------------------
+/** The GenLODsProcess simplifies every triangle mesh of a scene with the
+ *  quadric error metric and appends the resulting levels of detail to
+ *  aiScene::mMeshes.
+ *
+ *  Edges are collapsed onto one of their end points, so all vertex
+ *  attributes of the simplified meshes are exact copies of the input data.
+ *  Vertices on open borders (which includes material boundaries, as every
+ *  aiMesh has exactly one material) and on UV / normal seams are never
+ *  moved.
+ *
+ *  For each mesh 'name' with index 'm', level 'k' (k >= 1) is stored as
+ *  'name_LODk' and is announced in the scene metadata:
+ *  - "$lod.m.k"       (int32) index of the LOD mesh in aiScene::mMeshes,
+ *  - "$lod.m.k.error" (float) geometric error of the level in scene units.
+ *
+ *  There is no free bit left in #aiPostProcessSteps, so the step is never
+ *  activated by flags. Run it via Importer::ApplyCustomizedPostProcessing()
+ *  and configure it with the AI_CONFIG_PP_GLOD_XXX properties.
+ *
+ *  @note This step expects triangulated input data. Meshes with bones or
+ *  animation meshes are skipped.
+ */
+class ASSIMP_API GenLODsProcess : public BaseProcess {
+public:
+    /// The class constructor.
+    GenLODsProcess();
+    /// The class destructor.
+    ~GenLODsProcess();
+    /// Will always return false, see the class documentation.
+    bool IsActive(unsigned int pFlags) const override;
+    /// The execution callback.
+    void Execute(aiScene* pScene) override;
+    /// Reads the AI_CONFIG_PP_GLOD_XXX properties.
+    void SetupProperties(const Importer* pImp) override;
+
+protected:
+    // -------------------------------------------------------------------
+    /** Simplifies a mesh progressively and returns its levels of detail.
+     *  @param pMesh The mesh to simplify.
+     *  @param lods Receives the new meshes, coarsest last.
+     *  @param errors Receives the geometric error of each new mesh.
+     */
+    void ProcessMesh(const aiMesh* pMesh, std::vector<aiMesh*>& lods,
+        std::vector<float>& errors);
+
+private:
+    /// Number of LOD levels to generate per mesh.
+    unsigned int mLevels;
+    /// Triangle count ratio between two successive levels.
+    float mRatio;
+    /// Maximum geometric error, relative to the bounding box diagonal.
+    float mMaxError;
+    /// Meshes with less triangles are not simplified any further.
+    unsigned int mMinFaces;
+};
+
+} // Namespace Assimp
+
+#endif // #ifndef ASSIMP_BUILD_NO_GENLODS_PROCESS
+
+#endif // AI_GENLODSPROCESS_H_INC
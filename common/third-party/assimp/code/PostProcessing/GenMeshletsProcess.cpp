@@ -0,0 +1,238 @@
+/*
+---------------------------------------------------------------------------
+Open Asset Import Library (assimp)
+---------------------------------------------------------------------------
+
+Copyright (c) 2006-2019, assimp team
+
+All rights reserved.
+
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the following
+conditions are met:
+
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+
+* Neither the name of the assimp team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the assimp team.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+---------------------------------------------------------------------------
+*/
+
+/** @file Implementation of the post-processing step to split meshes into
+ *  meshlets with culling bounds.
+ */
+
+#ifndef ASSIMP_BUILD_NO_GENMESHLETS_PROCESS
+
+#include "PostProcessing/GenMeshletsProcess.h"
+#include "PostProcessing/ProcessHelper.h"
+
+#include <assimp/postprocess.h>
+#include <assimp/scene.h>
+#include <assimp/DefaultLogger.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace Assimp {
+
+namespace {
+
+// ------------------------------------------------------------------------------------------------
+// Computes the bounding sphere and the normal cone of a meshlet.
+void ComputeBounds(const aiMesh* mesh, aiMeshlet& meshlet) {
+    const aiVector3D* pos = mesh->mVertices;
+    const unsigned int* verts = mesh->mMeshletVertices + meshlet.mVertexOffset;
+
+    // the sphere is centered in the bounding box of the meshlet, which is
+    // close enough to the optimum for clusters this small
+    aiVector3D min = pos[verts[0]], max = min;
+    for (unsigned int i = 1; i < meshlet.mNumVertices; ++i) {
+        const aiVector3D& p = pos[verts[i]];
+        min.x = std::min(min.x, p.x); min.y = std::min(min.y, p.y); min.z = std::min(min.z, p.z);
+        max.x = std::max(max.x, p.x); max.y = std::max(max.y, p.y); max.z = std::max(max.z, p.z);
+    }
+    meshlet.mCenter = (min + max) * static_cast<ai_real>(0.5);
+    ai_real radius2 = 0;
+    for (unsigned int i = 0; i < meshlet.mNumVertices; ++i) {
+        radius2 = std::max(radius2, (pos[verts[i]] - meshlet.mCenter).SquareLength());
+    }
+    meshlet.mRadius = std::sqrt(radius2);
+
+    // the cone axis is the area weighted average normal, its spread is
+    // the largest angle between the axis and a triangle normal
+    aiVector3D axis;
+    const aiFace* faces = mesh->mFaces + meshlet.mFirstFace;
+    for (unsigned int i = 0; i < meshlet.mNumFaces; ++i) {
+        const unsigned int* idx = faces[i].mIndices;
+        axis += (pos[idx[1]] - pos[idx[0]]) ^ (pos[idx[2]] - pos[idx[0]]);
+    }
+    meshlet.mConeAxis = aiVector3D();
+    meshlet.mConeCutoff = 1;
+    const ai_real len = axis.Length();
+    if (len <= 0) {
+        return;
+    }
+    axis /= len;
+
+    ai_real minDot = 1;
+    for (unsigned int i = 0; i < meshlet.mNumFaces; ++i) {
+        const unsigned int* idx = faces[i].mIndices;
+        aiVector3D n = (pos[idx[1]] - pos[idx[0]]) ^ (pos[idx[2]] - pos[idx[0]]);
+        const ai_real nlen = n.Length();
+        if (nlen > 0) {
+            minDot = std::min(minDot, (n * axis) / nlen);
+        }
+    }
+
+    // a cone wider than ~84 degrees culls next to nothing
+    if (minDot <= static_cast<ai_real>(0.1)) {
+        return;
+    }
+    meshlet.mConeAxis = axis;
+    meshlet.mConeCutoff = std::sqrt(1 - minDot * minDot);
+}
+
+} // Namespace
+
+// ------------------------------------------------------------------------------------------------
+GenMeshletsProcess::GenMeshletsProcess()
+: BaseProcess()
+, mMaxVertices(AI_GM_DEFAULT_MAX_VERTICES)
+, mMaxTriangles(AI_GM_DEFAULT_MAX_TRIANGLES)
+, mLocalIndex() {
+    // empty
+}
+
+// ------------------------------------------------------------------------------------------------
+GenMeshletsProcess::~GenMeshletsProcess() {
+    // empty
+}
+
+// ------------------------------------------------------------------------------------------------
+bool GenMeshletsProcess::IsActive(unsigned int /*pFlags*/) const {
+    return false;
+}
+
+// ------------------------------------------------------------------------------------------------
+void GenMeshletsProcess::SetupProperties(const Importer* pImp) {
+    const int maxVertices = pImp->GetPropertyInteger(AI_CONFIG_PP_GM_MAX_VERTICES, AI_GM_DEFAULT_MAX_VERTICES);
+    const int maxTriangles = pImp->GetPropertyInteger(AI_CONFIG_PP_GM_MAX_TRIANGLES, AI_GM_DEFAULT_MAX_TRIANGLES);
+    mMaxVertices = static_cast<unsigned int>(std::min(std::max(maxVertices, 3), AI_MAX_MESHLET_VERTICES));
+    mMaxTriangles = static_cast<unsigned int>(std::min(std::max(maxTriangles, 1), AI_MAX_MESHLET_TRIANGLES));
+    if (static_cast<int>(mMaxVertices) != maxVertices || static_cast<int>(mMaxTriangles) != maxTriangles) {
+        ASSIMP_LOG_WARN_F("GenMeshletsProcess: Meshlet limits clamped to ", mMaxVertices,
+            " vertices and ", mMaxTriangles, " triangles");
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+void GenMeshletsProcess::Execute(aiScene* pScene) {
+    ASSIMP_LOG_DEBUG("GenMeshletsProcess begin");
+
+    unsigned int numMeshlets = 0, numFaces = 0;
+    for (unsigned int a = 0; a < pScene->mNumMeshes; ++a) {
+        if (ProcessMesh(pScene->mMeshes[a])) {
+            numMeshlets += pScene->mMeshes[a]->mNumMeshlets;
+            numFaces += pScene->mMeshes[a]->mNumFaces;
+        }
+    }
+    if (numMeshlets) {
+        ASSIMP_LOG_INFO_F("GenMeshletsProcess finished. ", numMeshlets, " meshlets with on average ",
+            static_cast<float>(numFaces) / numMeshlets, " triangles");
+    } else {
+        ASSIMP_LOG_DEBUG("GenMeshletsProcess finished. No meshlets generated");
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+bool GenMeshletsProcess::ProcessMesh(aiMesh* pMesh) {
+    ai_assert(nullptr != pMesh);
+
+    if (!pMesh->HasFaces() || !pMesh->HasPositions()) {
+        return false;
+    }
+    if (pMesh->mPrimitiveTypes != aiPrimitiveType_TRIANGLE) {
+        ASSIMP_LOG_ERROR("GenMeshletsProcess: This algorithm works on triangle meshes only");
+        return false;
+    }
+
+    // drop meshlets of a previous run
+    DropMeshlets(pMesh);
+
+    const unsigned int invalid = std::numeric_limits<unsigned int>::max();
+    mLocalIndex.assign(pMesh->mNumVertices, invalid);
+
+    std::vector<aiMeshlet> meshlets;
+    std::vector<unsigned int> vertices;
+    unsigned char* triangles = pMesh->mMeshletTriangles = new unsigned char[pMesh->mNumFaces * 3];
+
+    aiMeshlet current = aiMeshlet();
+    for (unsigned int f = 0; f < pMesh->mNumFaces; ++f) {
+        const unsigned int* idx = pMesh->mFaces[f].mIndices;
+        unsigned int newVertices = 0;
+        for (unsigned int j = 0; j < 3; ++j) {
+            newVertices += mLocalIndex[idx[j]] == invalid ? 1 : 0;
+        }
+
+        // close the current meshlet if the face doesn't fit anymore
+        if (current.mNumVertices + newVertices > mMaxVertices || current.mNumFaces + 1 > mMaxTriangles) {
+            for (unsigned int i = current.mVertexOffset; i < vertices.size(); ++i) {
+                mLocalIndex[vertices[i]] = invalid;
+            }
+            meshlets.push_back(current);
+            current = aiMeshlet();
+            current.mFirstFace = f;
+            current.mVertexOffset = static_cast<unsigned int>(vertices.size());
+        }
+
+        for (unsigned int j = 0; j < 3; ++j) {
+            unsigned int& local = mLocalIndex[idx[j]];
+            if (local == invalid) {
+                local = current.mNumVertices++;
+                vertices.push_back(idx[j]);
+            }
+            triangles[f * 3 + j] = static_cast<unsigned char>(local);
+        }
+        ++current.mNumFaces;
+    }
+    meshlets.push_back(current);
+
+    pMesh->mNumMeshletVertices = static_cast<unsigned int>(vertices.size());
+    pMesh->mMeshletVertices = new unsigned int[vertices.size()];
+    std::copy(vertices.begin(), vertices.end(), pMesh->mMeshletVertices);
+
+    pMesh->mNumMeshlets = static_cast<unsigned int>(meshlets.size());
+    pMesh->mMeshlets = new aiMeshlet[meshlets.size()];
+    for (unsigned int i = 0; i < pMesh->mNumMeshlets; ++i) {
+        ComputeBounds(pMesh, meshlets[i]);
+        pMesh->mMeshlets[i] = meshlets[i];
+    }
+    return true;
+}
+
+} // Namespace Assimp
+
+#endif // !! ASSIMP_BUILD_NO_GENMESHLETS_PROCESS
@@ -0,0 +1,112 @@
+/*
+---------------------------------------------------------------------------
+Open Asset Import Library (assimp)
+---------------------------------------------------------------------------
+
+Copyright (c) 2006-2019, assimp team
+
+All rights reserved.
+
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the following
+conditions are met:
+
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+
+* Neither the name of the assimp team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the assimp team.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+---------------------------------------------------------------------------
+*/
+
+
+/** @file Defines a post-processing step to split meshes into meshlets.
+ */
+
+#pragma once
+
+#ifndef AI_GENMESHLETSPROCESS_H_INC
+#define AI_GENMESHLETSPROCESS_H_INC
+
+#ifndef ASSIMP_BUILD_NO_GENMESHLETS_PROCESS
+
+#include "Common/BaseProcess.h"
+
+#include <vector>
+
+struct aiMesh;
+
+namespace Assimp {
+
+// ---------------------------------------------------------------------------
+/** The GenMeshletsProcess splits every triangle mesh into meshlets of at
+ *  most AI_CONFIG_PP_GM_MAX_VERTICES vertices and AI_CONFIG_PP_GM_MAX_TRIANGLES
+ *  triangles and computes a bounding sphere and a normal cone for each of
+ *  them, see #aiMeshlet.
+ *
+ *  Meshlets are built from runs of consecutive faces, so the face order is
+ *  kept. Run #aiProcess_ImproveCacheLocality first: its fan-like ordering
+ *  gives meshlets with few vertices and tight bounds.
+ *
+ *  There is no free bit left in #aiPostProcessSteps, so the step is never
+ *  activated by flags. Run it via Importer::ApplyCustomizedPostProcessing()
+ *  as the last step; steps that change faces or transform vertices
+ *  afterwards drop the meshlets of the meshes they touch.
+ *
+ *  @note This step expects triangulated input data.
+ */
+class ASSIMP_API GenMeshletsProcess : public BaseProcess {
+public:
+    /// The class constructor.
+    GenMeshletsProcess();
+    /// The class destructor.
+    ~GenMeshletsProcess();
+    /// Will always return false, see the class documentation.
+    bool IsActive(unsigned int pFlags) const override;
+    /// The execution callback.
+    void Execute(aiScene* pScene) override;
+    /// Reads the AI_CONFIG_PP_GM_XXX properties.
+    void SetupProperties(const Importer* pImp) override;
+
+protected:
+    // -------------------------------------------------------------------
+    /** Generates the meshlets of a single mesh.
+     *  @param pMesh The mesh to process.
+     *  @return true if meshlets were generated.
+     */
+    bool ProcessMesh(aiMesh* pMesh);
+
+private:
+    /// Maximum number of vertices per meshlet.
+    unsigned int mMaxVertices;
+    /// Maximum number of triangles per meshlet.
+    unsigned int mMaxTriangles;
+    /// Local index of each mesh vertex in the current meshlet.
+    std::vector<unsigned int> mLocalIndex;
+};
+
+} // Namespace Assimp
+
+#endif // #ifndef ASSIMP_BUILD_NO_GENMESHLETS_PROCESS
+
+#endif // AI_GENMESHLETSPROCESS_H_INC
@@ -50,6 +50,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 // internal headers
 #include "PostProcessing/ImproveCacheLocality.h"
+#include "PostProcessing/ProcessHelper.h"
 #include "Common/VertexTriangleAdjacency.h"
 
 #include <assimp/StringUtils.h>
@@ -369,6 +370,7 @@ ai_real ImproveCacheLocalityProcess::ProcessMesh( aiMesh* pMesh, unsigned int me
         if (nind > 1) ind[1] = *piCSIter++;
         if (nind > 2) ind[2] = *piCSIter++;
     }
+    DropMeshlets(pMesh);
 
     // delete temporary storage
     delete[] piCachingStamps;
@@ -401,6 +401,7 @@ int JoinVerticesProcess::ProcessMesh( aiMesh* pMesh, unsigned int meshIndex)
             face.mIndices[b] = replaceIndex[face.mIndices[b]] & ~0x80000000;
         }
     }
+    DropMeshlets(pMesh);
 
     // adjust bone vertex weights.
     for( int a = 0; a < (int)pMesh->mNumBones; a++) {
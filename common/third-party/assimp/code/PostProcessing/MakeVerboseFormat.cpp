@@ -45,6 +45,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 
 #include "MakeVerboseFormat.h"
+#include "ProcessHelper.h"
 #include <assimp/scene.h>
 #include <assimp/DefaultLogger.hpp>
 
@@ -222,6 +223,7 @@ bool MakeVerboseFormatProcess::MakeVerboseFormat(aiMesh* pcMesh)
         delete[] pcMesh->mBitangents;
         pcMesh->mBitangents = pvBitangents;
     }
+    DropMeshlets(pcMesh);
     return (pcMesh->mNumVertices != iOldNumVertices);
 }
 
@@ -0,0 +1,416 @@
+/*
+---------------------------------------------------------------------------
+Open Asset Import Library (assimp)
+---------------------------------------------------------------------------
+
+Copyright (c) 2006-2019, assimp team
+
+All rights reserved.
+
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the following
+conditions are met:
+
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+
+* Neither the name of the assimp team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the assimp team.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+---------------------------------------------------------------------------
+*/
+
+/** @file Implementation of the post-processing step to pack the occlusion,
+ *  roughness and metalness maps of each material into one texture.
+ */
+
+#ifndef ASSIMP_BUILD_NO_PACKORMTEXTURES_PROCESS
+
+#include "PostProcessing/PackORMTexturesProcess.h"
+#include "Common/ImageDecoder.h"
+
+#include <assimp/Importer.hpp>
+#include <assimp/IOStream.hpp>
+#include <assimp/IOSystem.hpp>
+#include <assimp/scene.h>
+#include <assimp/StringUtils.h>
+#include <assimp/DefaultLogger.hpp>
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#   include <emmintrin.h>
+#   define AI_PORM_SSE2
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#   include <arm_neon.h>
+#   define AI_PORM_NEON
+#endif
+
+namespace Assimp {
+
+namespace {
+
+// ------------------------------------------------------------------------------------------------
+// Interleaves four planes of count bytes into count texels of four bytes, plane k going to byte k
+// of each texel. A plane that is nullptr is filled with 255.
+void InterleaveChannels(const uint8_t* const planes[4], size_t count, uint8_t* out) {
+    static const uint8_t full[16] = { 255, 255, 255, 255, 255, 255, 255, 255,
+                                      255, 255, 255, 255, 255, 255, 255, 255 };
+    // a missing plane reads the same 16 bytes over and over
+    const uint8_t* src[4];
+    size_t step[4];
+    for (unsigned int k = 0; k < 4; ++k) {
+        src[k] = planes[k] ? planes[k] : full;
+        step[k] = planes[k] ? 1 : 0;
+    }
+
+    size_t i = 0;
+#if defined(AI_PORM_SSE2)
+    for (; i + 16 <= count; i += 16) {
+        const __m128i c0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src[0] + i * step[0]));
+        const __m128i c1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src[1] + i * step[1]));
+        const __m128i c2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src[2] + i * step[2]));
+        const __m128i c3 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src[3] + i * step[3]));
+        // bytes to pairs (01 and 23), pairs to texels
+        const __m128i lo01 = _mm_unpacklo_epi8(c0, c1), hi01 = _mm_unpackhi_epi8(c0, c1);
+        const __m128i lo23 = _mm_unpacklo_epi8(c2, c3), hi23 = _mm_unpackhi_epi8(c2, c3);
+        __m128i* dst = reinterpret_cast<__m128i*>(out + 4 * i);
+        _mm_storeu_si128(dst, _mm_unpacklo_epi16(lo01, lo23));
+        _mm_storeu_si128(dst + 1, _mm_unpackhi_epi16(lo01, lo23));
+        _mm_storeu_si128(dst + 2, _mm_unpacklo_epi16(hi01, hi23));
+        _mm_storeu_si128(dst + 3, _mm_unpackhi_epi16(hi01, hi23));
+    }
+#elif defined(AI_PORM_NEON)
+    for (; i + 16 <= count; i += 16) {
+        uint8x16x4_t texels;
+        for (unsigned int k = 0; k < 4; ++k) {
+            texels.val[k] = vld1q_u8(src[k] + i * step[k]);
+        }
+        vst4q_u8(out + 4 * i, texels);
+    }
+#endif
+    for (; i < count; ++i) {
+        for (unsigned int k = 0; k < 4; ++k) {
+            out[4 * i + k] = src[k][i * step[k]];
+        }
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+// Nearest texel scaling of a single channel image.
+std::vector<uint8_t> Resample(const uint8_t* texels, unsigned int width, unsigned int height,
+        unsigned int newWidth, unsigned int newHeight) {
+    std::vector<uint8_t> out(static_cast<size_t>(newWidth) * newHeight);
+    for (unsigned int y = 0; y < newHeight; ++y) {
+        const uint8_t* row = texels + static_cast<size_t>(y) * height / newHeight * width;
+        for (unsigned int x = 0; x < newWidth; ++x) {
+            out[static_cast<size_t>(y) * newWidth + x] = row[static_cast<size_t>(x) * width / newWidth];
+        }
+    }
+    return out;
+}
+
+// ------------------------------------------------------------------------------------------------
+// Texture properties ($tex.xxx) of a slot other than the file, copied before the slot is removed.
+struct TextureProperty {
+    std::string mKey;
+    aiPropertyTypeInfo mType;
+    std::vector<char> mData;
+};
+
+// ------------------------------------------------------------------------------------------------
+bool IsTextureProperty(const aiMaterialProperty* prop, aiTextureType type) {
+    return prop->mSemantic == static_cast<unsigned int>(type) && prop->mIndex == 0 &&
+            ::strncmp(prop->mKey.C_Str(), "$tex.", 5) == 0;
+}
+
+// ------------------------------------------------------------------------------------------------
+void RemoveTexture(aiMaterial* mat, aiTextureType type) {
+    std::vector<std::string> keys;
+    for (unsigned int i = 0; i < mat->mNumProperties; ++i) {
+        if (IsTextureProperty(mat->mProperties[i], type)) {
+            keys.push_back(mat->mProperties[i]->mKey.C_Str());
+        }
+    }
+    for (const std::string& key : keys) {
+        mat->RemoveProperty(key.c_str(), type, 0);
+    }
+}
+
+// the packed channels, in the order of the texture
+const aiTextureType PbrSlots[3] = {
+    aiTextureType_AMBIENT_OCCLUSION, aiTextureType_DIFFUSE_ROUGHNESS, aiTextureType_METALNESS
+};
+// where OBJ materials keep them, see AI_CONFIG_PP_PORM_LEGACY_SLOTS
+const aiTextureType LegacySlots[3] = {
+    aiTextureType_AMBIENT, aiTextureType_NONE, aiTextureType_SPECULAR
+};
+
+} // Namespace
+
+// ------------------------------------------------------------------------------------------------
+PackORMTexturesProcess::PackORMTexturesProcess()
+: BaseProcess()
+, mLegacySlots(true)
+, mRootPath()
+, mIOHandler(nullptr) {
+    // empty
+}
+
+// ------------------------------------------------------------------------------------------------
+PackORMTexturesProcess::~PackORMTexturesProcess() {
+    // empty
+}
+
+// ------------------------------------------------------------------------------------------------
+bool PackORMTexturesProcess::IsActive(unsigned int /*pFlags*/) const {
+    return false;
+}
+
+// ------------------------------------------------------------------------------------------------
+void PackORMTexturesProcess::SetupProperties(const Importer* pImp) {
+    mLegacySlots = pImp->GetPropertyBool(AI_CONFIG_PP_PORM_LEGACY_SLOTS, true);
+    mRootPath = pImp->GetPropertyString("sourceFilePath");
+    mRootPath = mRootPath.substr(0, mRootPath.find_last_of("\\/") + 1u);
+    mIOHandler = pImp->GetIOHandler();
+}
+
+// ------------------------------------------------------------------------------------------------
+void PackORMTexturesProcess::Execute(aiScene* pScene) {
+    ASSIMP_LOG_DEBUG("PackORMTexturesProcess begin");
+
+    std::map<std::string, unsigned int> packed;
+    unsigned int numMaterials = 0;
+    for (unsigned int a = 0; a < pScene->mNumMaterials; ++a) {
+        if (ProcessMaterial(pScene, pScene->mMaterials[a], packed)) {
+            ++numMaterials;
+        }
+    }
+    if (numMaterials) {
+        ASSIMP_LOG_INFO_F("PackORMTexturesProcess finished. Packed the maps of ", numMaterials, " materials into ",
+            packed.size(), " textures");
+    } else {
+        ASSIMP_LOG_DEBUG("PackORMTexturesProcess finished. Nothing to pack");
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+bool PackORMTexturesProcess::ProcessMaterial(aiScene* pScene, aiMaterial* pMaterial,
+        std::map<std::string, unsigned int>& packed) {
+    ai_assert(nullptr != pMaterial);
+
+    // a slot holding several textures blends them, those are left alone: a channel whose PBR slot is such
+    // a stack is not packed (nor taken from its legacy slot), so the stack is never touched
+    aiTextureType sources[3];
+    std::string paths[3];
+    unsigned int numSources = 0;
+    for (unsigned int c = 0; c < 3; ++c) {
+        sources[c] = aiTextureType_NONE;
+        const unsigned int count = pMaterial->GetTextureCount(PbrSlots[c]);
+        if (count == 1) {
+            sources[c] = PbrSlots[c];
+        } else if (count == 0 && mLegacySlots && LegacySlots[c] != aiTextureType_NONE &&
+                pMaterial->GetTextureCount(LegacySlots[c]) == 1) {
+            sources[c] = LegacySlots[c];
+        }
+        if (sources[c] != aiTextureType_NONE) {
+            aiString path;
+            pMaterial->GetTexture(sources[c], 0, &path);
+            paths[c] = path.C_Str();
+            ++numSources;
+        }
+    }
+    // a single map would not save a binding; this also keeps a packed material (two or more slots
+    // referencing the same texture) from being packed again
+    if (numSources < 2) {
+        return false;
+    }
+    // packed already (by an earlier run, or in the file)
+    for (unsigned int c = 0; c < 3; ++c) {
+        for (unsigned int d = c + 1; d < 3; ++d) {
+            if (sources[c] != aiTextureType_NONE && sources[d] != aiTextureType_NONE && paths[c] == paths[d]) {
+                return false;
+            }
+        }
+    }
+
+    const std::string key = paths[0] + '\n' + paths[1] + '\n' + paths[2];
+    std::map<std::string, unsigned int>::const_iterator it = packed.find(key);
+    unsigned int textureIndex;
+    if (it != packed.end()) {
+        textureIndex = it->second;
+    } else {
+        // decode the maps, the texture takes the size of the largest
+        unsigned char* texels[3] = { nullptr, nullptr, nullptr };
+        unsigned int widths[3] = { 0, 0, 0 }, heights[3] = { 0, 0, 0 };
+        unsigned int width = 0, height = 0;
+        bool failed = false;
+        for (unsigned int c = 0; c < 3 && !failed; ++c) {
+            if (sources[c] == aiTextureType_NONE) {
+                continue;
+            }
+            texels[c] = DecodeMap(pScene, paths[c], widths[c], heights[c]);
+            failed = nullptr == texels[c];
+            width = std::max(width, widths[c]);
+            height = std::max(height, heights[c]);
+        }
+        if (failed) {
+            for (unsigned int c = 0; c < 3; ++c) {
+                FreeDecodedImage(texels[c]);
+            }
+            return false;
+        }
+
+        // aiTexel is b, g, r, a in memory
+        std::vector<uint8_t> scaled[3];
+        const uint8_t* planes[4] = { nullptr, nullptr, nullptr, nullptr };
+        for (unsigned int c = 0; c < 3; ++c) {
+            if (nullptr == texels[c]) {
+                continue;
+            }
+            if (widths[c] != width || heights[c] != height) {
+                scaled[c] = Resample(texels[c], widths[c], heights[c], width, height);
+                planes[2 - c] = scaled[c].data();
+            } else {
+                planes[2 - c] = texels[c];
+            }
+        }
+        aiTexture* texture = new aiTexture;
+        texture->mWidth = width;
+        texture->mHeight = height;
+        texture->pcData = new aiTexel[static_cast<size_t>(width) * height];
+        InterleaveChannels(planes, static_cast<size_t>(width) * height, reinterpret_cast<uint8_t*>(texture->pcData));
+        ::strcpy(texture->achFormatHint, "argb8888");
+        texture->mFilename.Set(std::string(pMaterial->GetName().C_Str()) + "_ORM");
+        for (unsigned int c = 0; c < 3; ++c) {
+            FreeDecodedImage(texels[c]);
+        }
+
+        // Enlarging the textures table
+        textureIndex = pScene->mNumTextures++;
+        aiTexture** oldTextures = pScene->mTextures;
+        pScene->mTextures = new aiTexture*[pScene->mNumTextures];
+        if (textureIndex) {
+            ::memcpy(pScene->mTextures, oldTextures, sizeof(aiTexture*) * textureIndex);
+        }
+        delete[] oldTextures;
+        pScene->mTextures[textureIndex] = texture;
+        packed[key] = textureIndex;
+    }
+
+    // the mapping of the first map (uv channel, wrap modes) is kept for the packed texture
+    std::vector<TextureProperty> mapping;
+    const aiTextureType first = sources[0] != aiTextureType_NONE ? sources[0] :
+            sources[1] != aiTextureType_NONE ? sources[1] : sources[2];
+    for (unsigned int i = 0; i < pMaterial->mNumProperties; ++i) {
+        const aiMaterialProperty* prop = pMaterial->mProperties[i];
+        if (IsTextureProperty(prop, first) && ::strcmp(prop->mKey.C_Str(), _AI_MATKEY_TEXTURE_BASE) != 0) {
+            TextureProperty copy;
+            copy.mKey = prop->mKey.C_Str();
+            copy.mType = prop->mType;
+            copy.mData.assign(prop->mData, prop->mData + prop->mDataLength);
+            mapping.push_back(copy);
+        }
+    }
+
+    // only the slots the texture was packed from are rewritten, the PBR slot of a channel without a map
+    // keeps whatever it holds (nothing, or a stack)
+    for (unsigned int c = 0; c < 3; ++c) {
+        if (sources[c] != aiTextureType_NONE) {
+            RemoveTexture(pMaterial, sources[c]);
+        }
+    }
+    aiString reference;
+    reference.length = static_cast<ai_uint32>(::ai_snprintf(reference.data, MAXLEN, "*%u", textureIndex));
+    for (unsigned int c = 0; c < 3; ++c) {
+        if (sources[c] == aiTextureType_NONE) {
+            continue;
+        }
+        pMaterial->AddProperty(&reference, AI_MATKEY_TEXTURE(PbrSlots[c], 0));
+        for (const TextureProperty& prop : mapping) {
+            pMaterial->AddBinaryProperty(prop.mData.data(), static_cast<unsigned int>(prop.mData.size()),
+                prop.mKey.c_str(), PbrSlots[c], 0, prop.mType);
+        }
+    }
+    return true;
+}
+
+// ------------------------------------------------------------------------------------------------
+unsigned char* PackORMTexturesProcess::DecodeMap(const aiScene* pScene, const std::string& path,
+        unsigned int& width, unsigned int& height) const {
+    if (path.empty()) {
+        ASSIMP_LOG_ERROR("PackORMTexturesProcess: Empty texture path.");
+        return nullptr;
+    }
+    std::string failure;
+    if (path[0] == '*') {
+        const aiTexture* texture = pScene->GetEmbeddedTexture(path.c_str());
+        if (nullptr == texture) {
+            ASSIMP_LOG_ERROR_F("PackORMTexturesProcess: No embedded texture ", path, ".");
+            return nullptr;
+        }
+        if (texture->mHeight == 0) {
+            unsigned char* texels = DecodeImage(texture->pcData, texture->mWidth, 1, width, height, failure);
+            if (nullptr == texels) {
+                ASSIMP_LOG_ERROR_F("PackORMTexturesProcess: Unable to decode embedded texture ", path, ": ",
+                    failure);
+            }
+            return texels;
+        }
+        // uncompressed, the red channel of a grey map
+        width = texture->mWidth;
+        height = texture->mHeight;
+        const size_t count = static_cast<size_t>(width) * height;
+        unsigned char* texels = static_cast<unsigned char*>(::malloc(count));
+        for (size_t i = 0; i < count; ++i) {
+            texels[i] = texture->pcData[i].r;
+        }
+        return texels;
+    }
+
+    // the path as given, relative to the model, and the file name next to the model
+    const std::string candidates[3] = {
+        path, mRootPath + path, mRootPath + path.substr(path.find_last_of("\\/") + 1u)
+    };
+    IOStream* stream = nullptr;
+    for (unsigned int i = 0; i < 3 && nullptr == stream; ++i) {
+        stream = mIOHandler->Open(candidates[i], "rb");
+    }
+    if (nullptr == stream) {
+        ASSIMP_LOG_ERROR_F("PackORMTexturesProcess: Unable to find map ", path, ".");
+        return nullptr;
+    }
+    // decoded while it is read, the file is never held whole next to its texels
+    unsigned char* texels = DecodeImage(stream, 1, width, height, failure);
+    mIOHandler->Close(stream);
+    if (nullptr == texels) {
+        ASSIMP_LOG_ERROR_F("PackORMTexturesProcess: Unable to decode map ", path, ": ", failure);
+    }
+    return texels;
+}
+
+} // Namespace Assimp
+
+#endif // !! ASSIMP_BUILD_NO_PACKORMTEXTURES_PROCESS
@@ -0,0 +1,137 @@
+/*
+---------------------------------------------------------------------------
+Open Asset Import Library (assimp)
+---------------------------------------------------------------------------
+
+Copyright (c) 2006-2019, assimp team
+
+All rights reserved.
+
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the following
+conditions are met:
+
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+
+* Neither the name of the assimp team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the assimp team.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+---------------------------------------------------------------------------
+*/
+
+
+/** @file Defines a post-processing step to pack the occlusion, roughness
+ *  and metalness maps of each material into one texture.
+ */
+
+#pragma once
+
+#ifndef AI_PACKORMTEXTURESPROCESS_H_INC
+#define AI_PACKORMTEXTURESPROCESS_H_INC
+
+#ifndef ASSIMP_BUILD_NO_PACKORMTEXTURES_PROCESS
+
+#include "Common/BaseProcess.h"
+
+#include <map>
+#include <string>
+
+struct aiMaterial;
+
+namespace Assimp {
+
+class IOSystem;
+
+// ---------------------------------------------------------------------------
+/** The PackORMTexturesProcess merges the single channel maps of a material
+ *  into one embedded ORM texture, as glTF lays it out: ambient occlusion in
+ *  red, roughness in green and metalness in blue. The maps are taken from
+ *  - aiTextureType_AMBIENT_OCCLUSION, or aiTextureType_AMBIENT (map_Ka),
+ *  - aiTextureType_DIFFUSE_ROUGHNESS,
+ *  - aiTextureType_METALNESS, or aiTextureType_SPECULAR (map_Ks),
+ *  the legacy slots only with #AI_CONFIG_PP_PORM_LEGACY_SLOTS. A channel
+ *  without a map is 255, so it leaves the factor of the material as it is.
+ *  Maps of different sizes are scaled to the largest one (nearest texel).
+ *
+ *  The packed texture is stored uncompressed in aiScene::mTextures (one
+ *  byte per channel, alpha 255), and the source slots of the material are
+ *  replaced by its "*N" reference in the PBR slots of the channels it was
+ *  packed from, so a renderer binds and samples one texture instead of up
+ *  to three. A PBR slot holding several textures is never rewritten, its
+ *  channel is not packed. Materials sharing the same maps share the
+ *  texture. A material with less than two maps to pack, or whose maps
+ *  cannot be read, is left as it is.
+ *
+ *  Files are read through the IOSystem of the importer and looked up like
+ *  EmbedTexturesProcess does, relative to the model as well. Embedded
+ *  sources are decoded too; they stay in the scene, unreferenced.
+ *
+ *  There is no free bit left in #aiPostProcessSteps, so the step is never
+ *  activated by flags. Run it via Importer::ApplyCustomizedPostProcessing().
+ */
+class ASSIMP_API PackORMTexturesProcess : public BaseProcess {
+public:
+    /// The class constructor.
+    PackORMTexturesProcess();
+    /// The class destructor.
+    ~PackORMTexturesProcess();
+    /// Will always return false, see the class documentation.
+    bool IsActive(unsigned int pFlags) const override;
+    /// The execution callback.
+    void Execute(aiScene* pScene) override;
+    /// Reads the AI_CONFIG_PP_PORM_XXX properties and the file location.
+    void SetupProperties(const Importer* pImp) override;
+
+protected:
+    // -------------------------------------------------------------------
+    /** Packs the maps of a single material and rewrites its slots.
+     *  @param pScene The scene, receives the packed texture.
+     *  @param pMaterial The material to process.
+     *  @param packed Packed textures by their sources, shared between the
+     *    materials.
+     *  @return true if the material references a packed texture now.
+     */
+    bool ProcessMaterial(aiScene* pScene, aiMaterial* pMaterial, std::map<std::string, unsigned int>& packed);
+
+    // -------------------------------------------------------------------
+    /** Decodes a map to one channel (grey), from a file or an embedded
+     *  texture.
+     *  @return The texels (to be released with FreeDecodedImage) or nullptr.
+     */
+    unsigned char* DecodeMap(const aiScene* pScene, const std::string& path,
+            unsigned int& width, unsigned int& height) const;
+
+private:
+    /// Take ambient as occlusion and specular as metalness.
+    bool mLegacySlots;
+    /// Directory of the imported file, with a trailing separator.
+    std::string mRootPath;
+    /// Reads the map files, owned by the importer.
+    IOSystem* mIOHandler;
+};
+
+} // Namespace Assimp
+
+#endif // #ifndef ASSIMP_BUILD_NO_PACKORMTEXTURES_PROCESS
+
+#endif // AI_PACKORMTEXTURESPROCESS_H_INC
@@ -0,0 +1,313 @@
+/*
+---------------------------------------------------------------------------
+Open Asset Import Library (assimp)
+---------------------------------------------------------------------------
+
+Copyright (c) 2006-2019, assimp team
+
+All rights reserved.
+
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the following
+conditions are met:
+
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+
+* Neither the name of the assimp team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the assimp team.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+---------------------------------------------------------------------------
+*/
+
+/** @file Implementation of the post-processing step to build packed GPU
+ *  vertex streams.
+ */
+
+#ifndef ASSIMP_BUILD_NO_PACKVERTICES_PROCESS
+
+#include "PostProcessing/PackVerticesProcess.h"
+
+#include <assimp/postprocess.h>
+#include <assimp/scene.h>
+#include <assimp/DefaultLogger.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace Assimp {
+
+namespace {
+
+// ------------------------------------------------------------------------------------------------
+uint16_t ToUnorm16(ai_real v) {
+    v = std::min(std::max(v, static_cast<ai_real>(0)), static_cast<ai_real>(1));
+    return static_cast<uint16_t>(v * 65535 + static_cast<ai_real>(0.5));
+}
+
+// ------------------------------------------------------------------------------------------------
+int16_t ToSnorm16(ai_real v) {
+    v = std::min(std::max(v, static_cast<ai_real>(-1)), static_cast<ai_real>(1));
+    return static_cast<int16_t>(std::floor(v * 32767 + static_cast<ai_real>(0.5)));
+}
+
+// ------------------------------------------------------------------------------------------------
+uint8_t ToUnorm8(float v) {
+    v = std::min(std::max(v, 0.f), 1.f);
+    return static_cast<uint8_t>(v * 255.f + 0.5f);
+}
+
+// ------------------------------------------------------------------------------------------------
+// IEEE 754 binary16 conversion with round to nearest even. Values too large
+// for a half become infinity, NaNs stay NaNs.
+uint16_t ToHalf(float f) {
+    uint32_t x;
+    ::memcpy(&x, &f, sizeof(x));
+    const uint16_t sign = static_cast<uint16_t>((x >> 16) & 0x8000);
+    const uint32_t absx = x & 0x7fffffff;
+    if (absx >= 0x7f800000) {
+        return sign | (absx > 0x7f800000 ? 0x7e00 : 0x7c00);
+    }
+    if (absx >= 0x477ff000) {
+        return sign | 0x7c00;
+    }
+    if (absx < 0x38800000) {
+        // subnormal half, let the FPU do the rounding
+        float a;
+        ::memcpy(&a, &absx, sizeof(a));
+        return sign | static_cast<uint16_t>(std::nearbyint(a * 16777216.f));
+    }
+    const uint32_t mant = absx + 0xfff + ((absx >> 13) & 1);
+    return sign | static_cast<uint16_t>((mant - 0x38000000) >> 13);
+}
+
+// ------------------------------------------------------------------------------------------------
+// Octahedral encoding of a unit vector into two components in [-1,1].
+void OctEncode(aiVector3D n, int16_t* out) {
+    const ai_real len = std::fabs(n.x) + std::fabs(n.y) + std::fabs(n.z);
+    if (len <= 0) {
+        out[0] = out[1] = 0;
+        return;
+    }
+    n /= len;
+    if (n.z < 0) {
+        const ai_real x = n.x, y = n.y;
+        n.x = (1 - std::fabs(y)) * (x >= 0 ? 1 : -1);
+        n.y = (1 - std::fabs(x)) * (y >= 0 ? 1 : -1);
+    }
+    out[0] = ToSnorm16(n.x);
+    out[1] = ToSnorm16(n.y);
+}
+
+// ------------------------------------------------------------------------------------------------
+void AddAttribute(aiPackedVertices& packed, unsigned int semantic, unsigned int channel,
+        unsigned int numComponents, unsigned int type, unsigned int size) {
+    aiPackedAttribute& attr = packed.mAttributes[packed.mNumAttributes++];
+    attr.mSemantic = semantic;
+    attr.mChannel = channel;
+    attr.mNumComponents = numComponents;
+    attr.mType = type;
+    attr.mNormalized = type != aiPackedComponentType_HALF_FLOAT;
+    attr.mOffset = packed.mStride;
+    // keep all attributes 4 byte aligned
+    packed.mStride += (numComponents * size + 3) & ~3u;
+}
+
+} // Namespace
+
+// ------------------------------------------------------------------------------------------------
+PackVerticesProcess::PackVerticesProcess()
+: BaseProcess()
+, mHalfUVs(false) {
+    // empty
+}
+
+// ------------------------------------------------------------------------------------------------
+PackVerticesProcess::~PackVerticesProcess() {
+    // empty
+}
+
+// ------------------------------------------------------------------------------------------------
+bool PackVerticesProcess::IsActive(unsigned int /*pFlags*/) const {
+    return false;
+}
+
+// ------------------------------------------------------------------------------------------------
+void PackVerticesProcess::SetupProperties(const Importer* pImp) {
+    mHalfUVs = pImp->GetPropertyBool(AI_CONFIG_PP_PV_HALF_UVS, false);
+}
+
+// ------------------------------------------------------------------------------------------------
+void PackVerticesProcess::Execute(aiScene* pScene) {
+    ASSIMP_LOG_DEBUG("PackVerticesProcess begin");
+
+    size_t floatBytes = 0, packedBytes = 0;
+    for (unsigned int a = 0; a < pScene->mNumMeshes; ++a) {
+        aiMesh* mesh = pScene->mMeshes[a];
+        ProcessMesh(mesh);
+        if (!mesh->HasPackedVertices()) {
+            continue;
+        }
+
+        // compare against the tightest float layout of the packed attributes
+        size_t floats = 0;
+        for (unsigned int i = 0; i < mesh->mPackedVertices->mNumAttributes; ++i) {
+            const aiPackedAttribute& attr = mesh->mPackedVertices->mAttributes[i];
+            switch (attr.mSemantic) {
+            case aiPackedSemantic_POSITION: case aiPackedSemantic_NORMAL: floats += 3; break;
+            case aiPackedSemantic_TANGENT: floats += 6; break;
+            default: floats += attr.mNumComponents; break;
+            }
+        }
+        floatBytes += floats * sizeof(float) * mesh->mNumVertices;
+        packedBytes += static_cast<size_t>(mesh->mPackedVertices->mStride) * mesh->mNumVertices;
+    }
+    if (packedBytes) {
+        ASSIMP_LOG_INFO_F("PackVerticesProcess finished. Packed ", floatBytes, " bytes of float vertex data into ",
+            packedBytes, " bytes");
+    } else {
+        ASSIMP_LOG_DEBUG("PackVerticesProcess finished. Nothing to pack");
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+void PackVerticesProcess::ProcessMesh(aiMesh* pMesh) {
+    ai_assert(nullptr != pMesh);
+
+    delete pMesh->mPackedVertices;
+    pMesh->mPackedVertices = nullptr;
+    if (!pMesh->HasPositions()) {
+        return;
+    }
+
+    aiPackedVertices* packed = new aiPackedVertices();
+    packed->mNumVertices = pMesh->mNumVertices;
+
+    // describe the layout first
+    bool unormUV[AI_MAX_NUMBER_OF_TEXTURECOORDS] = {};
+    AddAttribute(*packed, aiPackedSemantic_POSITION, 0, 4, aiPackedComponentType_UNSIGNED_SHORT, 2);
+    if (pMesh->HasNormals()) {
+        AddAttribute(*packed, aiPackedSemantic_NORMAL, 0, 2, aiPackedComponentType_SHORT, 2);
+    }
+    const bool tangents = pMesh->HasNormals() && pMesh->HasTangentsAndBitangents();
+    if (tangents) {
+        AddAttribute(*packed, aiPackedSemantic_TANGENT, 0, 2, aiPackedComponentType_SHORT, 2);
+    }
+    unsigned int dropped = 0;
+    for (unsigned int c = 0; pMesh->HasTextureCoords(c); ++c) {
+        if (packed->mNumAttributes == AI_MAX_PACKED_ATTRIBUTES) {
+            ++dropped;
+            continue;
+        }
+        const unsigned int numComponents = std::max(1u, std::min(3u, pMesh->mNumUVComponents[c]));
+        bool unorm = !mHalfUVs;
+        for (unsigned int i = 0; unorm && i < pMesh->mNumVertices; ++i) {
+            const aiVector3D& uv = pMesh->mTextureCoords[c][i];
+            for (unsigned int j = 0; j < numComponents; ++j) {
+                unorm = unorm && uv[j] >= 0 && uv[j] <= 1;
+            }
+        }
+        unormUV[c] = unorm;
+        AddAttribute(*packed, aiPackedSemantic_TEXCOORD, c, numComponents,
+            unorm ? aiPackedComponentType_UNSIGNED_SHORT : aiPackedComponentType_HALF_FLOAT, 2);
+    }
+    for (unsigned int c = 0; pMesh->HasVertexColors(c); ++c) {
+        if (packed->mNumAttributes == AI_MAX_PACKED_ATTRIBUTES) {
+            ++dropped;
+            continue;
+        }
+        AddAttribute(*packed, aiPackedSemantic_COLOR, c, 4, aiPackedComponentType_UNSIGNED_BYTE, 1);
+    }
+    if (dropped) {
+        ASSIMP_LOG_WARN_F("PackVerticesProcess: ", dropped, " texture coordinate and color sets of mesh ",
+            pMesh->mName.C_Str(), " exceed the ", AI_MAX_PACKED_ATTRIBUTES, " packed attributes, they are not packed");
+    }
+
+    // quantize the positions in the bounding box, reusing the one of
+    // GenBoundingBoxesProcess if it ran before
+    aiVector3D min = pMesh->mAABB.mMin, max = pMesh->mAABB.mMax;
+    if (!(min.x <= max.x && min.y <= max.y && min.z <= max.z) || (min == aiVector3D() && max == aiVector3D())) {
+        min = max = pMesh->mVertices[0];
+        for (unsigned int i = 1; i < pMesh->mNumVertices; ++i) {
+            const aiVector3D& p = pMesh->mVertices[i];
+            min.x = std::min(min.x, p.x); min.y = std::min(min.y, p.y); min.z = std::min(min.z, p.z);
+            max.x = std::max(max.x, p.x); max.y = std::max(max.y, p.y); max.z = std::max(max.z, p.z);
+        }
+    }
+    packed->mPositionOffset = min;
+    packed->mPositionScale = max - min;
+    const aiVector3D& scale = packed->mPositionScale;
+    const aiVector3D invScale(scale.x > 0 ? 1 / scale.x : 0, scale.y > 0 ? 1 / scale.y : 0, scale.z > 0 ? 1 / scale.z : 0);
+
+    packed->mData = new unsigned char[static_cast<size_t>(packed->mNumVertices) * packed->mStride]();
+    for (unsigned int i = 0; i < pMesh->mNumVertices; ++i) {
+        unsigned char* vertex = packed->mData + static_cast<size_t>(i) * packed->mStride;
+        for (unsigned int a = 0; a < packed->mNumAttributes; ++a) {
+            const aiPackedAttribute& attr = packed->mAttributes[a];
+            unsigned char* dst = vertex + attr.mOffset;
+            switch (attr.mSemantic) {
+            case aiPackedSemantic_POSITION: {
+                    const aiVector3D p = (pMesh->mVertices[i] - min).SymMul(invScale);
+                    uint16_t q[4] = { ToUnorm16(p.x), ToUnorm16(p.y), ToUnorm16(p.z), 65535 };
+                    if (tangents) {
+                        const aiVector3D& n = pMesh->mNormals[i];
+                        const aiVector3D& t = pMesh->mTangents[i];
+                        // w = 0 marks a mirrored tangent frame
+                        q[3] = ((n ^ t) * pMesh->mBitangents[i]) < 0 ? 0 : 65535;
+                    }
+                    ::memcpy(dst, q, sizeof(q));
+                }
+                break;
+            case aiPackedSemantic_NORMAL:
+            case aiPackedSemantic_TANGENT: {
+                    int16_t q[2];
+                    OctEncode(attr.mSemantic == aiPackedSemantic_NORMAL ? pMesh->mNormals[i] : pMesh->mTangents[i], q);
+                    ::memcpy(dst, q, sizeof(q));
+                }
+                break;
+            case aiPackedSemantic_TEXCOORD: {
+                    const aiVector3D& uv = pMesh->mTextureCoords[attr.mChannel][i];
+                    uint16_t q[3];
+                    for (unsigned int j = 0; j < attr.mNumComponents; ++j) {
+                        q[j] = unormUV[attr.mChannel] ? ToUnorm16(uv[j]) : ToHalf(static_cast<float>(uv[j]));
+                    }
+                    ::memcpy(dst, q, attr.mNumComponents * sizeof(uint16_t));
+                }
+                break;
+            case aiPackedSemantic_COLOR: {
+                    const aiColor4D& c = pMesh->mColors[attr.mChannel][i];
+                    const uint8_t q[4] = { ToUnorm8(c.r), ToUnorm8(c.g), ToUnorm8(c.b), ToUnorm8(c.a) };
+                    ::memcpy(dst, q, sizeof(q));
+                }
+                break;
+            default:
+                break;
+            }
+        }
+    }
+    pMesh->mPackedVertices = packed;
+}
+
+} // Namespace Assimp
+
+#endif // !! ASSIMP_BUILD_NO_PACKVERTICES_PROCESS
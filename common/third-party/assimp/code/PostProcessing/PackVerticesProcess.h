@@ -0,0 +1,108 @@
+/*
+---------------------------------------------------------------------------
+Open Asset Import Library (assimp)
+---------------------------------------------------------------------------
+
+Copyright (c) 2006-2019, assimp team
+
+All rights reserved.
+
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the following
+conditions are met:
+
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+
+* Neither the name of the assimp team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the assimp team.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+---------------------------------------------------------------------------
+*/
+
+
+/** @file Defines a post-processing step to build packed GPU vertex streams.
+ */
+
+#pragma once
+
+#ifndef AI_PACKVERTICESPROCESS_H_INC
+#define AI_PACKVERTICESPROCESS_H_INC
+
+#ifndef ASSIMP_BUILD_NO_PACKVERTICES_PROCESS
+
+#include "Common/BaseProcess.h"
+
+struct aiMesh;
+
+namespace Assimp {
+
+// ---------------------------------------------------------------------------
+/** The PackVerticesProcess builds an interleaved, quantized vertex stream
+ *  for every mesh and stores it in aiMesh::mPackedVertices:
+ *  - positions as 4 x 16 bit, quantized in the mesh AABB (8 bytes),
+ *  - normals and tangents octahedral encoded in 2 x 16 bit (4 bytes each),
+ *  - texture coordinates as 16 bit unorm if they are inside [0,1] and as
+ *    half floats otherwise (4 bytes for 2D coordinates),
+ *  - vertex colors as 4 x 8 bit unorm (4 bytes).
+ *  Bitangents are not stored, their sign goes into the position w.
+ *  At most #AI_MAX_PACKED_ATTRIBUTES attributes are stored, texture
+ *  coordinate and color sets past it are dropped with a warning.
+ *
+ *  The AABB computed by #aiProcess_GenBoundingBoxes is reused if present.
+ *  The float arrays of the mesh are kept.
+ *
+ *  There is no free bit left in #aiPostProcessSteps, so the step is never
+ *  activated by flags. Run it via Importer::ApplyCustomizedPostProcessing()
+ *  as the last step; steps that change vertices afterwards invalidate the
+ *  packed stream.
+ */
+class ASSIMP_API PackVerticesProcess : public BaseProcess {
+public:
+    /// The class constructor.
+    PackVerticesProcess();
+    /// The class destructor.
+    ~PackVerticesProcess();
+    /// Will always return false, see the class documentation.
+    bool IsActive(unsigned int pFlags) const override;
+    /// The execution callback.
+    void Execute(aiScene* pScene) override;
+    /// Reads the AI_CONFIG_PP_PV_XXX properties.
+    void SetupProperties(const Importer* pImp) override;
+
+protected:
+    // -------------------------------------------------------------------
+    /** Builds the packed vertex stream of a single mesh.
+     *  @param pMesh The mesh to process.
+     */
+    void ProcessMesh(aiMesh* pMesh);
+
+private:
+    /// Store all texture coordinates as half floats.
+    bool mHalfUVs;
+};
+
+} // Namespace Assimp
+
+#endif // #ifndef ASSIMP_BUILD_NO_PACKVERTICES_PROCESS
+
+#endif // AI_PACKVERTICESPROCESS_H_INC
@@ -336,6 +336,8 @@ void PretransformVertices::ApplyTransform(aiMesh* mesh, const aiMatrix4x4& mat)
 {
     // Check whether we need to transform the coordinates at all
     if (!mat.IsIdentity()) {
+        // the meshlet bounds are in mesh space
+        DropMeshlets(mesh);
 
         if (mesh->HasPositions()) {
             for (unsigned int i = 0; i < mesh->mNumVertices; ++i) {
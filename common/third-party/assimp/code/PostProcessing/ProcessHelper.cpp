@@ -440,4 +440,19 @@ aiMesh* MakeSubmesh(const aiMesh *pMesh, const std::vector<unsigned int> &subMes
     return oMesh;
 }
 
+// -------------------------------------------------------------------------------
+void DropMeshlets(aiMesh* pMesh)
+{
+    if (pMesh->mNumMeshlets) {
+        ASSIMP_LOG_DEBUG_F("Dropping the meshlets of mesh ", pMesh->mName.C_Str());
+    }
+    delete [] pMesh->mMeshlets;
+    delete [] pMesh->mMeshletVertices;
+    delete [] pMesh->mMeshletTriangles;
+    pMesh->mMeshlets = nullptr;
+    pMesh->mMeshletVertices = nullptr;
+    pMesh->mMeshletTriangles = nullptr;
+    pMesh->mNumMeshlets = pMesh->mNumMeshletVertices = 0;
+}
+
 } // namespace Assimp
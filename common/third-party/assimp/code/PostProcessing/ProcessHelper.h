@@ -334,6 +334,11 @@ const char* MappingTypeToString(aiTextureMapping in);
 // Split a mesh given a list of faces to be contained in the sub mesh
 aiMesh* MakeSubmesh(const aiMesh *superMesh, const std::vector<unsigned int> &subMeshFaces, unsigned int subFlags);
 
+// -------------------------------------------------------------------------------
+// Drop the meshlets of a mesh, for steps that rewrite its faces or vertices
+// after the GenMeshletsProcess step (and for that step when it runs again)
+void DropMeshlets(aiMesh* pMesh);
+
 // -------------------------------------------------------------------------------
 // Utility postprocess step to share the spatial sort tree between
 // all steps which use it to speedup its computations.
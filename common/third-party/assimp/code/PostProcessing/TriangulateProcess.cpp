@@ -78,6 +78,7 @@ using namespace Assimp;
 // ------------------------------------------------------------------------------------------------
 // Constructor to be privately used by Importer
 TriangulateProcess::TriangulateProcess()
+: mEarCutThreshold(AI_TRI_DEFAULT_EARCUT_THRESHOLD)
 {
     // nothing to do here
 }
@@ -96,6 +97,14 @@ bool TriangulateProcess::IsActive( unsigned int pFlags) const
     return (pFlags & aiProcess_Triangulate) != 0;
 }
 
+// ------------------------------------------------------------------------------------------------
+// Setup properties for the step
+void TriangulateProcess::SetupProperties(const Importer* pImp)
+{
+    const int threshold = pImp->GetPropertyInteger(AI_CONFIG_PP_TRI_EARCUT_THRESHOLD,AI_TRI_DEFAULT_EARCUT_THRESHOLD);
+    mEarCutThreshold = static_cast<unsigned int>(std::max(threshold,4));
+}
+
 // ------------------------------------------------------------------------------------------------
 // Executes the post processing step on the given imported data.
 void TriangulateProcess::Execute( aiScene* pScene)
@@ -356,6 +365,34 @@ bool TriangulateProcess::TriangulateMesh( aiMesh* pMesh)
             fprintf(fout,"\ntriangulation sequence: ");
 #endif
 
+            // Large polygons (e.g. caps of CAD models) go to the z-order hashed ear clipper,
+            // the loop below is quadratic in the number of vertices.
+            if (face.mNumIndices >= mEarCutThreshold) {
+                if (!mEarCut.Triangulate(&temp_verts.front(),max,NULL,0,mEarCutIndices)) {
+                    ASSIMP_LOG_ERROR("Failed to triangulate polygon (no ear found). Probably not a simple polygon?");
+
+#ifdef AI_BUILD_TRIANGULATE_DEBUG_POLYS
+                    fprintf(fout,"critical error here, no ear found! ");
+#endif
+                }
+
+                // never more than max-2 triangles for a single ring, but be paranoid
+                const size_t numTris = std::min(mEarCutIndices.size() / 3, static_cast<size_t>(max - 2));
+                for (size_t t = 0; t < numTris; ++t) {
+                    aiFace& nface = *curOut++;
+                    nface.mNumIndices = 3;
+                    if (!nface.mIndices) {
+                        nface.mIndices = new unsigned int[3];
+                    }
+                    nface.mIndices[0] = mEarCutIndices[t*3];
+                    nface.mIndices[1] = mEarCutIndices[t*3+1];
+                    nface.mIndices[2] = mEarCutIndices[t*3+2];
+                }
+
+                // nothing left for the simple ear clipping loop
+                num = 0;
+            }
+
             //
             // FIXME: currently this is the slow O(kn) variant with a worst case
             // complexity of O(n^2) (I think). Can be done in O(n).
@@ -524,6 +561,7 @@ bool TriangulateProcess::TriangulateMesh( aiMesh* pMesh)
     // ... and store the new ones
     pMesh->mFaces    = out;
     pMesh->mNumFaces = (unsigned int)(curOut-out); /* not necessarily equal to numOut */
+    DropMeshlets(pMesh);
     return true;
 }
 
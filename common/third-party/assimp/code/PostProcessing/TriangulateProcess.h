@@ -47,6 +47,9 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define AI_TRIANGULATEPROCESS_H_INC
 
 #include "Common/BaseProcess.h"
+#include "Common/EarCutTriangulator.h"
+
+#include <vector>
 
 struct aiMesh;
 
@@ -79,11 +82,27 @@ public:
     */
     void Execute( aiScene* pScene);
 
+    // -------------------------------------------------------------------
+    /** Called prior to ExecuteOnScene().
+    * The function is a request to the process to update its configuration
+    * basing on the Importer's configuration property list.
+    */
+    void SetupProperties(const Importer* pImp);
+
     // -------------------------------------------------------------------
     /** Triangulates the given mesh.
      * @param pMesh The mesh to triangulate.
      */
     bool TriangulateMesh( aiMesh* pMesh);
+
+private:
+    /** Polygons with at least this many vertices go to mEarCut */
+    unsigned int mEarCutThreshold;
+
+    /** Triangulator for large polygons and its output buffer,
+     *  kept to reuse their storage for all polygons */
+    EarCutTriangulator mEarCut;
+    std::vector<unsigned int> mEarCutIndices;
 };
 
 } // end of namespace Assimp
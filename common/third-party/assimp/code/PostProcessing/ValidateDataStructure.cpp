@@ -52,16 +52,38 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <assimp/fast_atof.h>
 #include "ProcessHelper.h"
 #include <memory>
+#include <atomic>
+#include <thread>
 
 // CRT headers
 #include <stdarg.h>
 
 using namespace Assimp;
 
+namespace {
+
+// Minimum amount of work (faces, vertices, keys) before worker threads are spawned
+const size_t MinParallelWork = 1 << 16;
+
+// Outcome of validating a single mesh or animation on a worker thread
+struct JobReport {
+    std::vector<std::string> mWarnings;
+    std::string mError;
+    bool mFailed = false;
+};
+
+// Warnings raised on a worker thread are collected here and logged in scene
+// order once all workers are done, so the logger is never used concurrently.
+thread_local std::vector<std::string>* gWarningSink = nullptr;
+
+}
+
 // ------------------------------------------------------------------------------------------------
 // Constructor to be privately used by Importer
 ValidateDSProcess::ValidateDSProcess() :
-    mScene()
+    mScene(),
+    mStructuralOnly(false),
+    mNumThreads(-1)
 {}
 
 // ------------------------------------------------------------------------------------------------
@@ -75,6 +97,14 @@ bool ValidateDSProcess::IsActive( unsigned int pFlags) const
 {
     return (pFlags & aiProcess_ValidateDataStructure) != 0;
 }
+
+// ------------------------------------------------------------------------------------------------
+// Setup configuration properties for the step
+void ValidateDSProcess::SetupProperties(const Importer* pImp)
+{
+    mStructuralOnly = pImp->GetPropertyBool(AI_CONFIG_PP_VDS_STRUCTURAL_ONLY,false);
+    mNumThreads = pImp->GetPropertyInteger(AI_CONFIG_PP_VDS_THREADS,-1);
+}
 // ------------------------------------------------------------------------------------------------
 AI_WONT_RETURN void ValidateDSProcess::ReportError(const char* msg,...)
 {
@@ -104,6 +134,10 @@ void ValidateDSProcess::ReportWarning(const char* msg,...)
     ai_assert(iLen > 0);
 
     va_end(args);
+    if (gWarningSink) {
+        gWarningSink->push_back("Validation warning: " + std::string(szBuffer,iLen));
+        return;
+    }
     ASSIMP_LOG_WARN("Validation warning: " + std::string(szBuffer,iLen));
 }
 
@@ -162,6 +196,10 @@ inline void ValidateDSProcess::DoValidationEx(T** parray, unsigned int size,
             }
             Validate(parray[i]);
 
+            if (mStructuralOnly) {
+                continue;
+            }
+
             // check whether there are duplicate names
             for (unsigned int a = i+1; a < size;++a)
             {
@@ -182,6 +220,9 @@ void ValidateDSProcess::DoValidationWithNameCheck(T** array, unsigned int size,
         const char* secondName) {
     // validate all entries
     DoValidationEx(array,size,firstName,secondName);
+    if (mStructuralOnly) {
+        return;
+    }
 
     for (unsigned int i = 0; i < size;++i) {
         int res = HasNameMatch(array[i]->mName,mScene->mRootNode);
@@ -197,6 +238,126 @@ void ValidateDSProcess::DoValidationWithNameCheck(T** array, unsigned int size,
     }
 }
 
+// ------------------------------------------------------------------------------------------------
+template <typename T>
+void ValidateDSProcess::ParallelValidate(unsigned int num, size_t work, T job)
+{
+    unsigned int numThreads = 1;
+    if (mNumThreads < 0) {
+        numThreads = std::max(1u, std::thread::hardware_concurrency());
+    } else if (mNumThreads > 1) {
+        numThreads = static_cast<unsigned int>(mNumThreads);
+    }
+    numThreads = std::min(numThreads, num);
+
+    if (numThreads <= 1 || work < MinParallelWork) {
+        for (unsigned int i = 0; i < num; ++i) {
+            job(i, mScratch);
+        }
+        return;
+    }
+
+    // Jobs are handed out in ascending order. Once a job failed no new ones
+    // are started, but all jobs with a lower index have already been taken
+    // and run to completion - so the first error in scene order is the one
+    // reported, exactly as in the serial loop.
+    std::vector<JobReport> reports(num);
+    std::vector<Scratch> scratch(numThreads - 1);
+    std::atomic<unsigned int> next(0);
+    std::atomic<bool> failed(false);
+
+    auto worker = [&](Scratch& localScratch) {
+        while (!failed) {
+            const unsigned int i = next++;
+            if (i >= num) {
+                break;
+            }
+            JobReport& report = reports[i];
+            gWarningSink = &report.mWarnings;
+            try {
+                job(i, localScratch);
+            } catch (const std::exception& e) {
+                report.mError = e.what();
+                report.mFailed = true;
+                failed = true;
+            }
+            gWarningSink = nullptr;
+        }
+    };
+
+    std::vector<std::thread> threads;
+    threads.reserve(numThreads - 1);
+    try {
+        for (unsigned int t = 0; t < numThreads - 1; ++t) {
+            threads.emplace_back(worker, std::ref(scratch[t]));
+        }
+    } catch (const std::system_error&) {
+        // couldn't start all threads, go on with the ones we have
+    }
+    worker(mScratch);
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+
+    for (unsigned int i = 0; i < num; ++i) {
+        for (const std::string& warning : reports[i].mWarnings) {
+            ASSIMP_LOG_WARN(warning);
+        }
+        if (reports[i].mFailed) {
+            throw DeadlyImportError(reports[i].mError);
+        }
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+void ValidateDSProcess::ValidateMeshes()
+{
+    if (!mScene->mMeshes) {
+        ReportError("aiScene::mMeshes is NULL (aiScene::mNumMeshes is %i)",
+            mScene->mNumMeshes);
+    }
+    size_t work = 0;
+    for (unsigned int i = 0; i < mScene->mNumMeshes; ++i) {
+        const aiMesh* mesh = mScene->mMeshes[i];
+        if (!mesh) {
+            ReportError("aiScene::mMeshes[%i] is NULL (aiScene::mNumMeshes is %i)",
+                i, mScene->mNumMeshes);
+        }
+        work += mesh->mNumFaces + mesh->mNumVertices;
+    }
+
+    ParallelValidate(mScene->mNumMeshes, work, [this](unsigned int i, Scratch& scratch) {
+        Validate(mScene->mMeshes[i], scratch);
+    });
+}
+
+// ------------------------------------------------------------------------------------------------
+void ValidateDSProcess::ValidateAnimations()
+{
+    if (!mScene->mAnimations) {
+        ReportError("aiScene::mAnimations is NULL (aiScene::mNumAnimations is %i)",
+            mScene->mNumAnimations);
+    }
+    size_t work = 0;
+    for (unsigned int i = 0; i < mScene->mNumAnimations; ++i) {
+        const aiAnimation* anim = mScene->mAnimations[i];
+        if (!anim) {
+            ReportError("aiScene::mAnimations[%i] is NULL (aiScene::mNumAnimations is %i)",
+                i, mScene->mNumAnimations);
+        }
+        for (unsigned int a = 0; anim->mChannels && a < anim->mNumChannels; ++a) {
+            const aiNodeAnim* channel = anim->mChannels[a];
+            if (channel) {
+                work += channel->mNumPositionKeys + channel->mNumRotationKeys + channel->mNumScalingKeys;
+            }
+        }
+    }
+
+    ParallelValidate(mScene->mNumAnimations, work, [this](unsigned int i, Scratch&) {
+        Validate(mScene->mAnimations[i]);
+    });
+}
+
 // ------------------------------------------------------------------------------------------------
 // Executes the post processing step on the given imported data.
 void ValidateDSProcess::Execute( aiScene* pScene) {
@@ -204,11 +365,12 @@ void ValidateDSProcess::Execute( aiScene* pScene) {
     ASSIMP_LOG_DEBUG("ValidateDataStructureProcess begin");
 
     // validate the node graph of the scene
+    mScratch.ResetBits(pScene->mNumMeshes);
     Validate(pScene->mRootNode);
 
     // validate all meshes
     if (pScene->mNumMeshes) {
-        DoValidation(pScene->mMeshes,pScene->mNumMeshes,"mMeshes","mNumMeshes");
+        ValidateMeshes();
     }
     else if (!(mScene->mFlags & AI_SCENE_FLAGS_INCOMPLETE)) {
         ReportError("aiScene::mNumMeshes is 0. At least one mesh must be there");
@@ -219,8 +381,7 @@ void ValidateDSProcess::Execute( aiScene* pScene) {
 
     // validate all animations
     if (pScene->mNumAnimations) {
-        DoValidation(pScene->mAnimations,pScene->mNumAnimations,
-            "mAnimations","mNumAnimations");
+        ValidateAnimations();
     }
     else if (pScene->mAnimations)   {
         ReportError("aiScene::mAnimations is non-null although there are no animations");
@@ -306,7 +467,7 @@ void ValidateDSProcess::Validate( const aiCamera* pCamera)
 }
 
 // ------------------------------------------------------------------------------------------------
-void ValidateDSProcess::Validate( const aiMesh* pMesh)
+void ValidateDSProcess::Validate( const aiMesh* pMesh, Scratch& scratch)
 {
     // validate the material index of the mesh
     if (mScene->mNumMaterials && pMesh->mMaterialIndex >= mScene->mNumMaterials)
@@ -387,8 +548,9 @@ void ValidateDSProcess::Validate( const aiMesh* pMesh)
 
     // now check whether the face indexing layout is correct:
     // unique vertices, pseudo-indexed.
-    std::vector<bool> abRefList;
-    abRefList.resize(pMesh->mNumVertices,false);
+    if (!mStructuralOnly) {
+        scratch.ResetBits(pMesh->mNumVertices);
+    }
     for (unsigned int i = 0; i < pMesh->mNumFaces;++i)
     {
         aiFace& face = pMesh->mFaces[i];
@@ -410,18 +572,24 @@ void ValidateDSProcess::Validate( const aiMesh* pMesh)
                 ReportError("aiMesh::mVertices[%i] is referenced twice - second "
                     "time by aiMesh::mFaces[%i]::mIndices[%i]",face.mIndices[a],i,a);
             }*/
-            abRefList[face.mIndices[a]] = true;
+            if (!mStructuralOnly) {
+                scratch.SetBit(face.mIndices[a]);
+            }
         }
     }
 
     // check whether there are vertices that aren't referenced by a face
-    bool b = false;
-    for (unsigned int i = 0; i < pMesh->mNumVertices;++i)   {
-        if (!abRefList[i])b = true;
-    }
-    abRefList.clear();
-    if (b) {
-    	ReportWarning("There are unreferenced vertices");
+    if (!mStructuralOnly) {
+        bool b = false;
+        for (unsigned int i = 0; i < pMesh->mNumVertices;++i)   {
+            if (!scratch.TestBit(i)) {
+                b = true;
+                break;
+            }
+        }
+        if (b) {
+            ReportWarning("There are unreferenced vertices");
+        }
     }
 
     // texture channel 2 may not be set if channel 1 is zero ...
@@ -453,6 +621,81 @@ void ValidateDSProcess::Validate( const aiMesh* pMesh)
             }
     }
 
+    // the meshlets must cover all faces in order
+    if (pMesh->mNumMeshlets)
+    {
+        if (!pMesh->mMeshlets || !pMesh->mMeshletVertices || !pMesh->mMeshletTriangles)
+        {
+            ReportError("aiMesh::mMeshlets, mMeshletVertices or mMeshletTriangles is NULL "
+                "(aiMesh::mNumMeshlets is %i)",pMesh->mNumMeshlets);
+        }
+        unsigned int face = 0;
+        for (unsigned int i = 0; i < pMesh->mNumMeshlets;++i)
+        {
+            const aiMeshlet& meshlet = pMesh->mMeshlets[i];
+            if (meshlet.mFirstFace != face || meshlet.mNumFaces > pMesh->mNumFaces - face ||
+                meshlet.mNumFaces > AI_MAX_MESHLET_TRIANGLES)
+            {
+                ReportError("aiMesh::mMeshlets[%i] has an invalid face range",i);
+            }
+            if (meshlet.mNumVertices > AI_MAX_MESHLET_VERTICES || meshlet.mVertexOffset > pMesh->mNumMeshletVertices ||
+                meshlet.mNumVertices > pMesh->mNumMeshletVertices - meshlet.mVertexOffset)
+            {
+                ReportError("aiMesh::mMeshlets[%i] has an invalid vertex range",i);
+            }
+            face += meshlet.mNumFaces;
+            for (unsigned int a = meshlet.mFirstFace; a < face;++a)
+            {
+                // the local indices are three per face, stale if the faces were changed afterwards
+                if (pMesh->mFaces[a].mNumIndices != 3)
+                {
+                    ReportError("aiMesh::mMeshlets[%i] contains aiMesh::mFaces[%i], which is no triangle",i,a);
+                }
+            }
+            for (unsigned int a = meshlet.mFirstFace * 3; a < face * 3;++a)
+            {
+                if (pMesh->mMeshletTriangles[a] >= meshlet.mNumVertices)
+                {
+                    ReportError("aiMesh::mMeshletTriangles[%i] is out of range",a);
+                }
+            }
+        }
+        if (face != pMesh->mNumFaces)
+        {
+            ReportError("aiMesh::mMeshlets don't cover all faces");
+        }
+        for (unsigned int i = 0; i < pMesh->mNumMeshletVertices;++i)
+        {
+            if (pMesh->mMeshletVertices[i] >= pMesh->mNumVertices)
+            {
+                ReportError("aiMesh::mMeshletVertices[%i] is out of range",i);
+            }
+        }
+    }
+
+    // the packed vertex stream must match the vertex count and hold all attributes
+    if (pMesh->mPackedVertices)
+    {
+        const aiPackedVertices* packed = pMesh->mPackedVertices;
+        if (!packed->mData || packed->mNumVertices != pMesh->mNumVertices)
+        {
+            ReportError("aiMesh::mPackedVertices doesn't match aiMesh::mNumVertices");
+        }
+        if (packed->mNumAttributes > AI_MAX_PACKED_ATTRIBUTES)
+        {
+            ReportError("aiMesh::mPackedVertices has too many attributes (%i)",packed->mNumAttributes);
+        }
+        for (unsigned int i = 0; i < packed->mNumAttributes;++i)
+        {
+            const aiPackedAttribute& attr = packed->mAttributes[i];
+            const unsigned int size = attr.mType == aiPackedComponentType_UNSIGNED_BYTE ? 1 : 2;
+            if (!attr.mNumComponents || attr.mNumComponents > 4 || attr.mOffset + attr.mNumComponents * size > packed->mStride)
+            {
+                ReportError("aiMesh::mPackedVertices::mAttributes[%i] exceeds the vertex stride",i);
+            }
+        }
+    }
+
 
     // now validate all bones
     if (pMesh->mNumBones)
@@ -462,13 +705,8 @@ void ValidateDSProcess::Validate( const aiMesh* pMesh)
             ReportError("aiMesh::mBones is NULL (aiMesh::mNumBones is %i)",
                 pMesh->mNumBones);
         }
-        std::unique_ptr<float[]> afSum(nullptr);
-        if (pMesh->mNumVertices)
-        {
-            afSum.reset(new float[pMesh->mNumVertices]);
-            for (unsigned int i = 0; i < pMesh->mNumVertices;++i)
-                afSum[i] = 0.0f;
-        }
+        std::vector<float>& afSum = scratch.mWeightSums;
+        afSum.assign(pMesh->mNumVertices,0.0f);
 
         // check whether there are duplicate bone names
         for (unsigned int i = 0; i < pMesh->mNumBones;++i)
@@ -483,7 +721,10 @@ void ValidateDSProcess::Validate( const aiMesh* pMesh)
                 ReportError("aiMesh::mBones[%i] is NULL (aiMesh::mNumBones is %i)",
                     i,pMesh->mNumBones);
             }
-            Validate(pMesh,pMesh->mBones[i],afSum.get());
+            Validate(pMesh,pMesh->mBones[i],afSum.data());
+            if (mStructuralOnly) {
+                continue;
+            }
 
             for (unsigned int a = i+1; a < pMesh->mNumBones;++a)
             {
@@ -499,7 +740,7 @@ void ValidateDSProcess::Validate( const aiMesh* pMesh)
             }
         }
         // check whether all bone weights for a vertex sum to 1.0 ...
-        for (unsigned int i = 0; i < pMesh->mNumVertices;++i)
+        for (unsigned int i = 0; !mStructuralOnly && i < pMesh->mNumVertices;++i)
         {
             if (afSum[i] && (afSum[i] <= 0.94 || afSum[i] >= 1.05)) {
                 ReportWarning("aiMesh::mVertices[%i]: bone weight sum != 1.0 (sum is %f)",i,afSum[i]);
@@ -526,7 +767,7 @@ void ValidateDSProcess::Validate( const aiMesh* pMesh, const aiBone* pBone,float
         if (pBone->mWeights[i].mVertexId >= pMesh->mNumVertices)    {
             ReportError("aiBone::mWeights[%i].mVertexId is out of range",i);
         }
-        else if (!pBone->mWeights[i].mWeight || pBone->mWeights[i].mWeight > 1.0f)  {
+        else if (!mStructuralOnly && (!pBone->mWeights[i].mWeight || pBone->mWeights[i].mWeight > 1.0f))  {
             ReportWarning("aiBone::mWeights[%i].mWeight has an invalid value",i);
         }
         afSum[pBone->mWeights[i].mVertexId] += pBone->mWeights[i].mWeight;
@@ -732,6 +973,10 @@ void ValidateDSProcess::Validate( const aiMaterial* pMaterial)
         // TODO: check whether there is a key with an unknown name ...
     }
 
+    if (mStructuralOnly) {
+        return;
+    }
+
     // make some more specific tests
     ai_real fTemp;
     int iShading;
@@ -831,7 +1076,7 @@ void ValidateDSProcess::Validate( const aiAnimation* pAnimation,
                 pNodeAnim->mNumPositionKeys);
         }
         double dLast = -10e10;
-        for (unsigned int i = 0; i < pNodeAnim->mNumPositionKeys;++i)
+        for (unsigned int i = 0; !mStructuralOnly && i < pNodeAnim->mNumPositionKeys;++i)
         {
             // ScenePreprocessor will compute the duration if still the default value
             // (Aramis) Add small epsilon, comparison tended to fail if max_time == duration,
@@ -862,7 +1107,7 @@ void ValidateDSProcess::Validate( const aiAnimation* pAnimation,
                 pNodeAnim->mNumRotationKeys);
         }
         double dLast = -10e10;
-        for (unsigned int i = 0; i < pNodeAnim->mNumRotationKeys;++i)
+        for (unsigned int i = 0; !mStructuralOnly && i < pNodeAnim->mNumRotationKeys;++i)
         {
             if (pAnimation->mDuration > 0. && pNodeAnim->mRotationKeys[i].mTime > pAnimation->mDuration+0.001)
             {
@@ -889,7 +1134,7 @@ void ValidateDSProcess::Validate( const aiAnimation* pAnimation,
                 pNodeAnim->mNumScalingKeys);
         }
         double dLast = -10e10;
-        for (unsigned int i = 0; i < pNodeAnim->mNumScalingKeys;++i)
+        for (unsigned int i = 0; !mStructuralOnly && i < pNodeAnim->mNumScalingKeys;++i)
         {
             if (pAnimation->mDuration > 0. && pNodeAnim->mScalingKeys[i].mTime > pAnimation->mDuration+0.001)
             {
@@ -934,7 +1179,7 @@ void ValidateDSProcess::Validate( const aiAnimation* pAnimation,
                 pMeshMorphAnim->mNumKeys);
         }
         double dLast = -10e10;
-        for (unsigned int i = 0; i < pMeshMorphAnim->mNumKeys;++i)
+        for (unsigned int i = 0; !mStructuralOnly && i < pMeshMorphAnim->mNumKeys;++i)
         {
             // ScenePreprocessor will compute the duration if still the default value
             // (Aramis) Add small epsilon, comparison tended to fail if max_time == duration,
@@ -979,8 +1224,8 @@ void ValidateDSProcess::Validate( const aiNode* pNode)
             ReportError("aiNode::mMeshes is NULL for node %s (aiNode::mNumMeshes is %i)",
             		  nodeName, pNode->mNumMeshes);
         }
-        std::vector<bool> abHadMesh;
-        abHadMesh.resize(mScene->mNumMeshes,false);
+        // mScratch holds one bit per scene mesh, all of them are cleared
+        // again before returning so child nodes can reuse the buffer
         for (unsigned int i = 0; i < pNode->mNumMeshes;++i)
         {
             if (pNode->mMeshes[i] >= mScene->mNumMeshes)
@@ -988,12 +1233,15 @@ void ValidateDSProcess::Validate( const aiNode* pNode)
                 ReportError("aiNode::mMeshes[%i] is out of range for node %s (maximum is %i)",
                     pNode->mMeshes[i], nodeName, mScene->mNumMeshes-1);
             }
-            if (abHadMesh[pNode->mMeshes[i]])
+            if (mScratch.TestBit(pNode->mMeshes[i]))
             {
                 ReportError("aiNode::mMeshes[%i] is already referenced by this node %s (value: %i)",
                     i, nodeName, pNode->mMeshes[i]);
             }
-            abHadMesh[pNode->mMeshes[i]] = true;
+            mScratch.SetBit(pNode->mMeshes[i]);
+        }
+        for (unsigned int i = 0; i < pNode->mNumMeshes;++i) {
+            mScratch.ClearBit(pNode->mMeshes[i]);
         }
     }
     if (pNode->mNumChildren)
@@ -51,6 +51,9 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "Common/BaseProcess.h"
 
+#include <vector>
+#include <stdint.h>
+
 struct aiBone;
 struct aiMesh;
 struct aiAnimation;
@@ -83,8 +86,37 @@ public:
     // -------------------------------------------------------------------
     void Execute( aiScene* pScene);
 
+    // -------------------------------------------------------------------
+    void SetupProperties(const Importer* pImp);
+
 protected:
 
+    // -------------------------------------------------------------------
+    /** Scratch storage for the per-mesh checks. Every worker thread owns
+     *  one instance which is reused for all meshes it validates, so the
+     *  steady state does not allocate. */
+    struct Scratch
+    {
+        /** One bit per vertex/mesh, cleared by ResetBits() */
+        std::vector<uint64_t> mBits;
+
+        /** Sum of bone weights per vertex */
+        std::vector<float> mWeightSums;
+
+        void ResetBits(unsigned int num) {
+            mBits.assign((num + 63) / 64, 0);
+        }
+        bool TestBit(unsigned int i) const {
+            return (mBits[i >> 6] >> (i & 63)) & 1;
+        }
+        void SetBit(unsigned int i) {
+            mBits[i >> 6] |= uint64_t(1) << (i & 63);
+        }
+        void ClearBit(unsigned int i) {
+            mBits[i >> 6] &= ~(uint64_t(1) << (i & 63));
+        }
+    };
+
     // -------------------------------------------------------------------
     /** Report a validation error. This will throw an exception,
      *  control won't return.
@@ -101,8 +133,9 @@ protected:
 
     // -------------------------------------------------------------------
     /** Validates a mesh
-     * @param pMesh Input mesh*/
-    void Validate( const aiMesh* pMesh);
+     * @param pMesh Input mesh
+     * @param scratch Scratch buffers of the calling thread*/
+    void Validate( const aiMesh* pMesh, Scratch& scratch);
 
     // -------------------------------------------------------------------
     /** Validates a bone
@@ -170,6 +203,18 @@ protected:
 
 private:
 
+    // validates all meshes, in parallel if enabled
+    void ValidateMeshes();
+
+    // validates all animations, in parallel if enabled
+    void ValidateAnimations();
+
+    // runs job(index, scratch) for [0,num) on up to mNumThreads threads if
+    // there is enough work, reports the first failing index just like a
+    // serial loop would
+    template <typename T>
+    void ParallelValidate(unsigned int num, size_t work, T job);
+
     // template to validate one of the aiScene::mXXX arrays
     template <typename T>
     inline void DoValidation(T** array, unsigned int size,
@@ -187,6 +232,15 @@ private:
         const char* firstName, const char* secondName);
 
     aiScene* mScene;
+
+    /** Configuration option: only check structural invariants */
+    bool mStructuralOnly;
+
+    /** Configuration option: maximum number of worker threads */
+    int mNumThreads;
+
+    /** Scratch buffers used on the calling thread */
+    Scratch mScratch;
 };
 
 
@@ -107,6 +107,21 @@ extern "C" {
 #   define AI_MAX_NUMBER_OF_TEXTURECOORDS 0x8
 #endif // !! AI_MAX_NUMBER_OF_TEXTURECOORDS
 
+/** @def AI_MAX_MESHLET_VERTICES
+ *  Maximum number of vertices per meshlet. Local meshlet indices are
+ *  stored as bytes, so this must not exceed 256. */
+
+#ifndef AI_MAX_MESHLET_VERTICES
+#   define AI_MAX_MESHLET_VERTICES 0x100
+#endif // !! AI_MAX_MESHLET_VERTICES
+
+/** @def AI_MAX_MESHLET_TRIANGLES
+ *  Maximum number of triangles per meshlet. */
+
+#ifndef AI_MAX_MESHLET_TRIANGLES
+#   define AI_MAX_MESHLET_TRIANGLES 0x200
+#endif // !! AI_MAX_MESHLET_TRIANGLES
+
 // ---------------------------------------------------------------------------
 /** @brief A single face in a mesh, referring to multiple vertices.
  *
@@ -566,6 +581,206 @@ enum aiMorphingMethod
 #endif
 }; //! enum aiMorphingMethod
 
+// ---------------------------------------------------------------------------
+/** @brief A small cluster of consecutive triangles of a mesh.
+ *
+ *  Meshlets are generated by the GenMeshletsProcess step. The triangles of a
+ *  meshlet are the faces [mFirstFace, mFirstFace + mNumFaces) of its mesh,
+ *  so a meshlet can be drawn as a range of the regular index buffer. For
+ *  mesh shaders, the meshlet also references mNumVertices entries of
+ *  aiMesh::mMeshletVertices, starting at mVertexOffset, and the faces are
+ *  available as local indices in aiMesh::mMeshletTriangles.
+ *
+ *  All bounds are given in mesh space. A meshlet is completely back-facing
+ *  for a camera at position 'eye' if
+ *  @code
+ *  dot(mCenter - eye, mConeAxis) >= mConeCutoff * length(mCenter - eye) + mRadius
+ *  @endcode
+ */
+struct aiMeshlet
+{
+    //! Index of the first face of the meshlet in aiMesh::mFaces.
+    unsigned int mFirstFace;
+
+    //! Number of faces (triangles) of the meshlet.
+    unsigned int mNumFaces;
+
+    //! Index of the first vertex of the meshlet in aiMesh::mMeshletVertices.
+    unsigned int mVertexOffset;
+
+    //! Number of vertices referenced by the meshlet.
+    unsigned int mNumVertices;
+
+    //! Center of the bounding sphere.
+    C_STRUCT aiVector3D mCenter;
+
+    //! Radius of the bounding sphere.
+    ai_real mRadius;
+
+    //! Average normal of the meshlet triangles.
+    C_STRUCT aiVector3D mConeAxis;
+
+    //! Sine of the normal cone spread, 1 if the cone can't be used for culling.
+    ai_real mConeCutoff;
+};
+
+// ---------------------------------------------------------------------------
+/** @brief Semantics of the attributes of an #aiPackedVertices stream.
+ */
+enum aiPackedSemantic
+{
+    /** Position, 4 unsigned normalized shorts. xyz are quantized in the
+     *  bounding box of the mesh, see aiPackedVertices::mPositionOffset.
+     *  w is 0 if the bitangent is cross(tangent, normal), else 1. */
+    aiPackedSemantic_POSITION   = 0x0,
+
+    /** Normal, octahedral encoded in 2 signed normalized shorts. */
+    aiPackedSemantic_NORMAL     = 0x1,
+
+    /** Tangent, octahedral encoded in 2 signed normalized shorts. */
+    aiPackedSemantic_TANGENT    = 0x2,
+
+    /** Texture coordinates, unsigned normalized shorts or half floats. */
+    aiPackedSemantic_TEXCOORD   = 0x3,
+
+    /** Vertex color, 4 unsigned normalized bytes. */
+    aiPackedSemantic_COLOR      = 0x4,
+
+#ifndef SWIG
+    _aiPackedSemantic_Force32Bit = INT_MAX
+#endif
+}; //! enum aiPackedSemantic
+
+// ---------------------------------------------------------------------------
+/** @brief Component types of packed vertex attributes. The values are the
+ *  ones of the matching OpenGL enums, so they can be passed to
+ *  glVertexAttribPointer() as they are.
+ */
+enum aiPackedComponentType
+{
+    aiPackedComponentType_UNSIGNED_BYTE     = 0x1401,
+    aiPackedComponentType_SHORT             = 0x1402,
+    aiPackedComponentType_UNSIGNED_SHORT    = 0x1403,
+    aiPackedComponentType_HALF_FLOAT        = 0x140B,
+
+#ifndef SWIG
+    _aiPackedComponentType_Force32Bit = INT_MAX
+#endif
+}; //! enum aiPackedComponentType
+
+/** @def AI_MAX_PACKED_ATTRIBUTES
+ *  Maximum number of attributes of a packed vertex stream. This is the
+ *  minimum of GL_MAX_VERTEX_ATTRIBS, so every packed layout can be bound
+ *  on any conforming GL implementation. */
+#define AI_MAX_PACKED_ATTRIBUTES 16
+
+// ---------------------------------------------------------------------------
+/** @brief Describes one attribute of an #aiPackedVertices stream.
+ */
+struct aiPackedAttribute
+{
+    //! One of the #aiPackedSemantic values.
+    unsigned int mSemantic;
+
+    //! Texture coordinate or color set index, 0 for the other semantics.
+    unsigned int mChannel;
+
+    //! Number of components, 1 to 4.
+    unsigned int mNumComponents;
+
+    //! One of the #aiPackedComponentType values.
+    unsigned int mType;
+
+    //! Nonzero if the integer components map to [0,1] or [-1,1].
+    unsigned int mNormalized;
+
+    //! Byte offset of the attribute inside a vertex.
+    unsigned int mOffset;
+};
+
+// ---------------------------------------------------------------------------
+/** @brief Interleaved, quantized copy of the vertex data of a mesh.
+ *
+ *  Generated by the PackVerticesProcess step, the stream can be uploaded to
+ *  a GPU vertex buffer as it is. Positions are reconstructed as
+ *  @code
+ *  position = mPositionOffset + aPos.xyz * mPositionScale
+ *  @endcode
+ *  where aPos is the normalized attribute as read by the GPU.
+ */
+struct aiPackedVertices
+{
+    //! Number of vertices, the same as aiMesh::mNumVertices.
+    unsigned int mNumVertices;
+
+    //! Size of a vertex in bytes, a multiple of 4.
+    unsigned int mStride;
+
+    //! Number of valid entries in mAttributes.
+    unsigned int mNumAttributes;
+
+    //! The attributes of a vertex, ordered by offset.
+    C_STRUCT aiPackedAttribute mAttributes[AI_MAX_PACKED_ATTRIBUTES];
+
+    //! Minimum of the quantization box of the positions.
+    C_STRUCT aiVector3D mPositionOffset;
+
+    //! Extent of the quantization box of the positions.
+    C_STRUCT aiVector3D mPositionScale;
+
+    //! The vertex data, mNumVertices * mStride bytes.
+    unsigned char* mData;
+
+#ifdef __cplusplus
+
+    //! Default constructor
+    aiPackedVertices() AI_NO_EXCEPT
+    : mNumVertices( 0 )
+    , mStride( 0 )
+    , mNumAttributes( 0 )
+    , mAttributes()
+    , mPositionOffset()
+    , mPositionScale()
+    , mData( nullptr ) {
+        // empty
+    }
+
+    //! Copy constructor. Copy the vertex data
+    aiPackedVertices( const aiPackedVertices& o )
+    : mNumVertices( o.mNumVertices )
+    , mStride( o.mStride )
+    , mNumAttributes( o.mNumAttributes )
+    , mAttributes()
+    , mPositionOffset( o.mPositionOffset )
+    , mPositionScale( o.mPositionScale )
+    , mData( nullptr ) {
+        ::memcpy( mAttributes, o.mAttributes, sizeof( mAttributes ) );
+        if (o.mData) {
+            mData = new unsigned char[mNumVertices * mStride];
+            ::memcpy( mData, o.mData, mNumVertices * mStride );
+        }
+    }
+
+    //! Delete the vertex data
+    ~aiPackedVertices() {
+        delete [] mData;
+    }
+
+    //! Returns the attribute for a semantic and channel, nullptr if there is none
+    const aiPackedAttribute* FindAttribute( unsigned int semantic, unsigned int channel = 0 ) const {
+        for (unsigned int i = 0; i < mNumAttributes; ++i) {
+            if (mAttributes[i].mSemantic == semantic && mAttributes[i].mChannel == channel) {
+                return &mAttributes[i];
+            }
+        }
+        return nullptr;
+    }
+
+private:
+    aiPackedVertices& operator = ( const aiPackedVertices& );
+#endif // __cplusplus
+};
+
 // ---------------------------------------------------------------------------
 /** @brief A mesh represents a geometry or model with a single material.
 *
@@ -737,6 +952,28 @@ struct aiMesh
      *
      */
     C_STRUCT aiAABB mAABB;
+
+    /** The number of meshlets in this mesh, see #aiMeshlet.
+     *  This is 0 unless the GenMeshletsProcess step has been applied, and
+     *  reset to 0 by later steps that change the faces. */
+    unsigned int mNumMeshlets;
+
+    /** The meshlets of this mesh. The meshlets cover all faces in order. */
+    C_STRUCT aiMeshlet* mMeshlets;
+
+    /** The number of entries in the mMeshletVertices array. */
+    unsigned int mNumMeshletVertices;
+
+    /** Vertex indices of all meshlets, see aiMeshlet::mVertexOffset. */
+    unsigned int* mMeshletVertices;
+
+    /** Three indices per face into the vertex list of the meshlet owning
+     *  the face. This array has 3 * mNumFaces entries. */
+    unsigned char* mMeshletTriangles;
+
+    /** Packed GPU vertex stream, see #aiPackedVertices.
+     *  This is nullptr unless the PackVerticesProcess step has been applied. */
+    C_STRUCT aiPackedVertices* mPackedVertices;
 	
 #ifdef __cplusplus
 
@@ -759,7 +996,13 @@ struct aiMesh
     , mNumAnimMeshes( 0 )
     , mAnimMeshes(nullptr)
     , mMethod( 0 )
-    , mAABB() {
+    , mAABB()
+    , mNumMeshlets( 0 )
+    , mMeshlets(nullptr)
+    , mNumMeshletVertices( 0 )
+    , mMeshletVertices(nullptr)
+    , mMeshletTriangles(nullptr)
+    , mPackedVertices(nullptr) {
         for( unsigned int a = 0; a < AI_MAX_NUMBER_OF_TEXTURECOORDS; ++a ) {
             mNumUVComponents[a] = 0;
             mTextureCoords[a] = nullptr;
@@ -802,6 +1045,10 @@ struct aiMesh
         }
 
         delete [] mFaces;
+        delete [] mMeshlets;
+        delete [] mMeshletVertices;
+        delete [] mMeshletTriangles;
+        delete mPackedVertices;
     }
 
     //! Check whether the mesh contains positions. Provided no special
@@ -869,6 +1116,16 @@ struct aiMesh
         return mBones != nullptr && mNumBones > 0;
     }
 
+    //! Check whether the mesh has a packed vertex stream
+    bool HasPackedVertices() const {
+        return mPackedVertices != nullptr && mPackedVertices->mData != nullptr;
+    }
+
+    //! Check whether the mesh has been split into meshlets
+    bool HasMeshlets() const {
+        return mMeshlets != nullptr && mNumMeshlets > 0;
+    }
+
 #endif // __cplusplus
 };
 
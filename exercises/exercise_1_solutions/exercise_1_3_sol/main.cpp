@@ -1,5 +1,8 @@
-#include <glad/glad.h>
-#include <GLFW/glfw3.h>
+#include <renderer/window.h>
+#include <renderer/gl_state.h>
+#include <renderer/shader_program.h>
+#include <renderer/buffer.h>
+#include <renderer/vertex_array.h>
 
 #include <iostream>
 #include <vector>
@@ -8,14 +11,13 @@
 
 // function declarations
 // ---------------------
-void createArrayBuffer(const std::vector<float> &array, unsigned int &VBO);
-void setupShape(unsigned int shaderProgram, unsigned int &VAO, unsigned int &vertexCount);
-void draw(unsigned int shaderProgram, unsigned int VAO, unsigned int vertexCount);
+void setupShape(const ShaderProgram &shaderProgram, VertexArray &VAO, Buffer &posVBO, Buffer &colorVBO,
+                unsigned int &vertexCount);
+void draw(const ShaderProgram &shaderProgram, const VertexArray &VAO, unsigned int vertexCount);
 
 
 // glfw functions
 // --------------
-void framebufferSizeCallback(GLFWwindow* window, int width, int height);
 void processInput(GLFWwindow *window);
 
 
@@ -49,110 +51,52 @@ const char *fragmentShaderSource = "#version 330 core\n"
 int main()
 {
 
-    // glfw: initialize and configure
-    // ------------------------------
-    glfwInit();
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
-    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
-
-#ifdef __APPLE__
-    glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE); // uncomment this statement to fix compilation on OS X
-#endif
-
-
-    // glfw window creation
-    // --------------------
-    GLFWwindow* window = glfwCreateWindow(SCR_WIDTH, SCR_HEIGHT, "LearnOpenGL", NULL, NULL);
+    // glfw: initialize and configure, create the window and load OpenGL with glad
+    // ----------------------------------------------------------------------------
+    GLFWwindow* window = createWindow(SCR_WIDTH, SCR_HEIGHT, "LearnOpenGL");
     if (window == NULL)
-    {
-        std::cout << "Failed to create GLFW window" << std::endl;
-        glfwTerminate();
         return -1;
-    }
-    glfwMakeContextCurrent(window);
-    glfwSetFramebufferSizeCallback(window, framebufferSizeCallback);
 
-
-    // glad: load all OpenGL function pointers
-    // ---------------------------------------
-    if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
+    // the OpenGL objects are released when they go out of scope, which has to happen before glfwTerminate
     {
-        std::cout << "Failed to initialize GLAD" << std::endl;
-        return -1;
-    }
-
-
-    // build and compile our shader program
-    // ------------------------------------
-
-    // vertex shader
-    int vertexShader = glCreateShader(GL_VERTEX_SHADER);
-    glShaderSource(vertexShader, 1, &vertexShaderSource, NULL);
-    glCompileShader(vertexShader);
-    // check for shader compile errors
-    int success;
-    char infoLog[512];
-    glGetShaderiv(vertexShader, GL_COMPILE_STATUS, &success);
-    if (!success)
-    {
-        glGetShaderInfoLog(vertexShader, 512, NULL, infoLog);
-        std::cout << "ERROR::SHADER::VERTEX::COMPILATION_FAILED\n" << infoLog << std::endl;
-    }
-
-    // fragment shader
-    int fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
-    glShaderSource(fragmentShader, 1, &fragmentShaderSource, NULL);
-    glCompileShader(fragmentShader);
-    // check for shader compile errors
-    glGetShaderiv(fragmentShader, GL_COMPILE_STATUS, &success);
-    if (!success)
-    {
-        glGetShaderInfoLog(fragmentShader, 512, NULL, infoLog);
-        std::cout << "ERROR::SHADER::FRAGMENT::COMPILATION_FAILED\n" << infoLog << std::endl;
-    }
-
-    // link shaders
-    unsigned int shaderProgram = glCreateProgram();
-    glAttachShader(shaderProgram, vertexShader);
-    glAttachShader(shaderProgram, fragmentShader);
-    glLinkProgram(shaderProgram);
-    // check for linking errors
-    glGetProgramiv(shaderProgram, GL_LINK_STATUS, &success);
-    if (!success) {
-        glGetProgramInfoLog(shaderProgram, 512, NULL, infoLog);
-        std::cout << "ERROR::SHADER::PROGRAM::LINKING_FAILED\n" << infoLog << std::endl;
-    }
-    glDeleteShader(vertexShader);
-    glDeleteShader(fragmentShader);
-
-
-    // setup vertex array object (VAO)
-    // -------------------------------
-    unsigned int VAO, vertexCount;
-    // generate geometry in a vertex array object (VAO), record the number of vertices in the mesh,
-    // tells the shader how to read it
-    setupShape(shaderProgram, VAO, vertexCount);
-
-
-    // render loop
-    // -----------
-    while (!glfwWindowShouldClose(window)) {
-        // input
-        // -----
-        processInput(window);
-
-        // render
-        // ------
-        glClearColor(.2f, .2f, .2f, 1.0f); // background
-        glClear(GL_COLOR_BUFFER_BIT); // clear the framebuffer
-
-        draw(shaderProgram, VAO, vertexCount);
-
-        // glfw: swap buffers and poll IO events (keys pressed/released, mouse moved etc.)
-        // -------------------------------------------------------------------------------
-        glfwSwapBuffers(window); // we normally use 2 frame buffers, a back (to draw on) and a front (to show on the screen)
-        glfwPollEvents();
+        // build and compile our shader program
+        // ------------------------------------
+        ShaderProgram shaderProgram(vertexShaderSource, fragmentShaderSource);
+
+
+        // setup vertex array object (VAO)
+        // -------------------------------
+        VertexArray VAO;
+        Buffer posVBO, colorVBO;
+        unsigned int vertexCount;
+        // generate geometry in a vertex array object (VAO), record the number of vertices in the mesh,
+        // tells the shader how to read it
+        setupShape(shaderProgram, VAO, posVBO, colorVBO, vertexCount);
+
+
+        // render loop
+        // -----------
+        while (!glfwWindowShouldClose(window)) {
+            // input
+            // -----
+            processInput(window);
+
+            // render
+            // ------
+            GLState::current().clearColor(.2f, .2f, .2f, 1.0f); // background
+            glClear(GL_COLOR_BUFFER_BIT); // clear the framebuffer
+
+            draw(shaderProgram, VAO, vertexCount);
+
+            // glfw: swap buffers and poll IO events (keys pressed/released, mouse moved etc.)
+            // -------------------------------------------------------------------------------
+            glfwSwapBuffers(window); // we normally use 2 frame buffers, a back (to draw on) and a front (to show on the screen)
+            glfwPollEvents();
+        }
+
+        // every frame after the first one sets the same state again, the state cache skipped those calls
+        std::cout << "state changes: " << GLState::current().stateChanges() << " sent to OpenGL, "
+                  << GLState::current().redundantChanges() << " redundant ones skipped" << std::endl;
     }
 
     // glfw: terminate, clearing all previously allocated GLFW resources.
@@ -162,24 +106,13 @@ int main()
 }
 
 
-// create a vertex buffer object (VBO) from an array of values, return VBO handle (set as reference)
-// -------------------------------------------------------------------------------------------------
-void createArrayBuffer(const std::vector<float> &array, unsigned int &VBO){
-    // create the VBO on OpenGL and get a handle to it
-    glGenBuffers(1, &VBO);
-    // bind the VBO
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    // set the content of the VBO (type, size, pointer to start, and how it is used)
-    glBufferData(GL_ARRAY_BUFFER, array.size() * sizeof(GLfloat), &array[0], GL_STATIC_DRAW);
-}
-
-
 // create the geometry, a vertex array object representing it, and set how a shader program should read it
 // -------------------------------------------------------------------------------------------------------
-void setupShape(const unsigned int shaderProgram,unsigned int &VAO, unsigned int &vertexCount){
+void setupShape(const ShaderProgram &shaderProgram, VertexArray &VAO, Buffer &posVBO, Buffer &colorVBO,
+                unsigned int &vertexCount){
 
-    unsigned int posVBO, colorVBO;
-    createArrayBuffer(std::vector<float>{
+    // set the content of the VBOs (the data and how it is used)
+    posVBO.setData(std::vector<float>{
             // position
               -0.5f,-0.5f, 0.0f,  // vtx1: x, y, z
              0.5f,-0.5f, 0.0f,  // vtx2: x, y, z
@@ -187,9 +120,9 @@ void setupShape(const unsigned int shaderProgram,unsigned int &VAO, unsigned int
             -0.5f,-0.5f, 0.0f,  // vtx4: x, y, z
              0.5f, 0.5f, 0.0f,  // vtx5: x, y, z
             -0.5f, 0.5f, 0.0f   // vtx6: x, y, z
-    }, posVBO);
+    }, GL_STATIC_DRAW);
 
-    createArrayBuffer( std::vector<float>{
+    colorVBO.setData(std::vector<float>{
             // color
             1.0f,  1.0f, 1.0f,  // col1: r, g, b
             1.0f,  1.0f, 1.0f,  // col2: r, g, b
@@ -197,49 +130,28 @@ void setupShape(const unsigned int shaderProgram,unsigned int &VAO, unsigned int
             1.0f,  0.0f, 0.0f,  // col4: r, g, b
             0.0f,  0.0f, 1.0f,  // col5: r, g, b
             0.0f,  1.0f, 0.0f   // col6: r, g, b
-    }, colorVBO);
+    }, GL_STATIC_DRAW);
 
     // tell how many vertices to draw
     vertexCount = 6;
 
-    // create a vertex array object (VAO) on OpenGL and save a handle to it
-    glGenVertexArrays(1, &VAO);
-
-    // bind vertex array object
-    glBindVertexArray(VAO);
-
-    // set vertex shader attribute "aPos"
-    glBindBuffer(GL_ARRAY_BUFFER, posVBO);
-
+    // set vertex shader attribute "aPos" (the location is looked up once, and cached by the program)
     int posSize = 3;
-    int posAttributeLocation = glGetAttribLocation(shaderProgram, "aPos");
-    std::cout << "should be 0: " << posAttributeLocation << std::endl;
-    glEnableVertexAttribArray(posAttributeLocation);
-    glVertexAttribPointer(posAttributeLocation, posSize, GL_FLOAT, GL_FALSE, 0, 0);
+    VAO.setAttribute(shaderProgram, "aPos", posVBO, posSize);
 
     // set vertex shader attribute "aColor"
-    glBindBuffer(GL_ARRAY_BUFFER, colorVBO);
-
     int colorSize = 3;
-    int colorAttributeLocation = glGetAttribLocation(shaderProgram, "aColor");
-    std::cout << "should be 1: " << colorAttributeLocation << std::endl;
-    glEnableVertexAttribArray(colorAttributeLocation);
-    glVertexAttribPointer(colorAttributeLocation, colorSize, GL_FLOAT, GL_FALSE, 0, 0);
-
-    glBindVertexArray(0);
+    VAO.setAttribute(shaderProgram, "aColor", colorVBO, colorSize);
 }
 
 
 // tell opengl to draw a vertex array object (VAO) using a give shaderProgram
 // --------------------------------------------------------------------------
-void draw(const unsigned int shaderProgram, const unsigned int VAO, const unsigned int vertexCount){
-    // set active shader program
-    glUseProgram(shaderProgram);
-    // bind vertex array object
-    glBindVertexArray(VAO);
-    // draw geometry
-    glDrawArrays(GL_TRIANGLES, 0, vertexCount);
-
+void draw(const ShaderProgram &shaderProgram, const VertexArray &VAO, const unsigned int vertexCount){
+    // set active shader program (skipped if it already is)
+    shaderProgram.use();
+    // bind vertex array object (skipped if it already is) and draw geometry
+    VAO.draw(GL_TRIANGLES, 0, vertexCount);
 }
 
 
@@ -251,13 +163,3 @@ void processInput(GLFWwindow *window)
         glfwSetWindowShouldClose(window, true);
 }
 
-
-// glfw: whenever the window size changed (by OS or user resize) this callback function executes
-// ---------------------------------------------------------------------------------------------
-void framebufferSizeCallback(GLFWwindow* window, int width, int height)
-{
-    // make sure the viewport matches the new window dimensions; note that width and 
-    // height will be significantly larger than specified on retina displays.
-    glViewport(0, 0, width, height);
-}
-
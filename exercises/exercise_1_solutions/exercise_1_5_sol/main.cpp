@@ -5,12 +5,14 @@
 #include <vector>
 #include <cmath>
 
+#include "stream_buffer.h"
+
 
 // function declarations
 // ---------------------
-void createArrayBuffer(const std::vector<float> &array, unsigned int &VBO);
-void setupShape(unsigned int shaderProgram, float time, unsigned int &posVBO, unsigned int &colorVBO, unsigned int &VAO, unsigned int &vertexCount);
-void draw(unsigned int shaderProgram, unsigned int VAO, unsigned int vertexCount);
+void setupVertexArray(unsigned int shaderProgram, const StreamBuffer &streamBuffer, unsigned int &VAO);
+void setupShape(float time, StreamBuffer &streamBuffer, unsigned int &firstVertex, unsigned int &vertexCount);
+void draw(unsigned int shaderProgram, unsigned int VAO, unsigned int firstVertex, unsigned int vertexCount);
 
 
 // glfw functions
@@ -25,6 +27,13 @@ const unsigned int SCR_WIDTH = 800;
 const unsigned int SCR_HEIGHT = 800;
 
 
+// vertex layout, a position followed by a color
+// ---------------------------------------------
+const unsigned int VERTEX_FLOATS = 6;
+const unsigned int VERTEX_SIZE = VERTEX_FLOATS * sizeof(float);
+const unsigned int MAX_VERTICES = 64;
+
+
 // shader programs
 // ---------------
 const char *vertexShaderSource = "#version 330 core\n"
@@ -131,39 +140,50 @@ int main()
     glDeleteShader(fragmentShader);
 
 
-    // setup vertex array object (VAO)
-    // -------------------------------
-    unsigned int VAO =0, vertexCount, posVBO =0 , colorVBO =0;
-    // generate geometry in a vertex array object (VAO), record the number of vertices in the mesh,
-    // tells the shader how to read it
+    // the shape changes every frame, so its vertices are streamed: each frame writes to its own region
+    // of a buffer while the GPU may still be drawing the previous frames (see stream_buffer.h).
+    // The extra scope releases the buffer before the OpenGL context is destroyed
+    {
+        StreamBuffer streamBuffer(MAX_VERTICES * VERTEX_SIZE, (GLADloadproc)glfwGetProcAddress);
+
+        // setup vertex array object (VAO)
+        // -------------------------------
+        unsigned int VAO = 0, firstVertex, vertexCount;
+        // the VAO always reads from the stream buffer, tell the shader how to read it once
+        setupVertexArray(shaderProgram, streamBuffer, VAO);
+
+        float currentTime = 0.0f;
+        setupShape(currentTime, streamBuffer, firstVertex, vertexCount);
 
-    float currentTime = 0.0f;
-    setupShape(shaderProgram, currentTime, posVBO, colorVBO, VAO, vertexCount);
+        // render loop
+        // -----------
+        while (!glfwWindowShouldClose(window)) {
+            // input
+            // -----
+            processInput(window);
 
-    // render loop
-    // -----------
-    while (!glfwWindowShouldClose(window)) {
-        // input
-        // -----
-        processInput(window);
+            // render
+            // ------
+            glClearColor(.2f, .2f, .2f, 1.0f); // background
+            glClear(GL_COLOR_BUFFER_BIT); // clear the framebuffer
 
-        // render
-        // ------
-        glClearColor(.2f, .2f, .2f, 1.0f); // background
-        glClear(GL_COLOR_BUFFER_BIT); // clear the framebuffer
 
+            draw(shaderProgram, VAO, firstVertex, vertexCount);
+            // done with this frame's region of the stream buffer
+            streamBuffer.endFrame();
 
-        draw(shaderProgram, VAO, vertexCount);
 
+            // glfw: swap buffers and poll IO events (keys pressed/released, mouse moved etc.)
+            // -------------------------------------------------------------------------------
+            glfwSwapBuffers(window); // we normally use 2 frame buffers, a back (to draw on) and a front (to show on the screen)
+            glfwPollEvents();
 
-        // glfw: swap buffers and poll IO events (keys pressed/released, mouse moved etc.)
-        // -------------------------------------------------------------------------------
-        glfwSwapBuffers(window); // we normally use 2 frame buffers, a back (to draw on) and a front (to show on the screen)
-        glfwPollEvents();
+            currentTime += 0.01;
+            setupShape(currentTime, streamBuffer, firstVertex, vertexCount);
 
-        currentTime += 0.01;
-        setupShape(shaderProgram, currentTime, posVBO, colorVBO, VAO, vertexCount);
+        }
 
+        glDeleteVertexArrays(1, &VAO);
     }
 
     // glfw: terminate, clearing all previously allocated GLFW resources.
@@ -173,86 +193,79 @@ int main()
 }
 
 
-// create a vertex buffer object (VBO) from an array of values, return VBO handle (set as reference)
-// -------------------------------------------------------------------------------------------------
-void createArrayBuffer(const std::vector<float> &array, unsigned int &VBO){
-    // create the VBO on OpenGL and get a handle to it (if it doesn't exists already)
-    if (VBO == 0)
-        glGenBuffers(1, &VBO);
-
-    // bind the VBO
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    // set the content of the VBO (type, size, pointer to start, and how it is used)
-    glBufferData(GL_ARRAY_BUFFER, array.size() * sizeof(GLfloat), &array[0], GL_STATIC_DRAW);
-}
-
-
-// create the geometry, a vertex array object representing it, and set how a shader program should read it
-// -------------------------------------------------------------------------------------------------------
-void setupShape(const unsigned int shaderProgram, float time, unsigned int &posVBO, unsigned int &colorVBO, unsigned int &VAO, unsigned int &vertexCount){
-
-    std::vector<float> positions;
-    std::vector<float> colors;
-
-    float halfPI = 3.14159265 / 2; // 90 degrees difference
-
-    for (int i = 0; i < 6; i++){
-        int j = i > 2 ? i-1: i;
-        float angle = halfPI * j + time;
-        positions.push_back(cos(angle) / 2); // x
-        positions.push_back(sin(angle) / 2); // y
-        positions.push_back(0.0f); // z
-    }
-
-
-    for(int i = 0; i < positions.size(); i++){
-        colors.push_back(1.0f);
-    }
-    createArrayBuffer(positions, posVBO);
-    createArrayBuffer(colors, colorVBO);
-
-
-    // tell how many vertices to draw
-    vertexCount = positions.size() / 3;
-
+// set how a shader program reads the vertices of the stream buffer, this is done only once
+// ---------------------------------------------------------------------------------------
+void setupVertexArray(const unsigned int shaderProgram, const StreamBuffer &streamBuffer, unsigned int &VAO){
     // create a vertex array object (VAO) on OpenGL and save a handle to it
-    if (VAO == 0)
-        glGenVertexArrays(1, &VAO);
+    glGenVertexArrays(1, &VAO);
 
     // bind vertex array object
     glBindVertexArray(VAO);
 
-    // set vertex shader attribute "aPos"
-    glBindBuffer(GL_ARRAY_BUFFER, posVBO);
+    // both attributes are interleaved in the stream buffer
+    glBindBuffer(GL_ARRAY_BUFFER, streamBuffer.buffer());
 
+    // set vertex shader attribute "aPos"
     int posSize = 3;
     int posAttributeLocation = glGetAttribLocation(shaderProgram, "aPos");
 
     glEnableVertexAttribArray(posAttributeLocation);
-    glVertexAttribPointer(posAttributeLocation, posSize, GL_FLOAT, GL_FALSE, 0, 0);
+    glVertexAttribPointer(posAttributeLocation, posSize, GL_FLOAT, GL_FALSE, VERTEX_SIZE, 0);
 
     // set vertex shader attribute "aColor"
-    glBindBuffer(GL_ARRAY_BUFFER, colorVBO);
-
     int colorSize = 3;
     int colorAttributeLocation = glGetAttribLocation(shaderProgram, "aColor");
 
     glEnableVertexAttribArray(colorAttributeLocation);
-    glVertexAttribPointer(colorAttributeLocation, colorSize, GL_FLOAT, GL_FALSE, 0, 0);
+    glVertexAttribPointer(colorAttributeLocation, colorSize, GL_FLOAT, GL_FALSE, VERTEX_SIZE, (void*)(3 * sizeof(float)));
 
     glBindVertexArray(0);
 }
 
 
+// create the geometry for the current time and write it to the stream buffer, return where it starts
+// and the number of vertices (set as reference)
+// ---------------------------------------------------------------------------------------------------
+void setupShape(float time, StreamBuffer &streamBuffer, unsigned int &firstVertex, unsigned int &vertexCount){
+
+    vertexCount = 6;
+
+    // get memory for this frame's vertices, aligned to the vertex size so the draw call can start there
+    GLintptr offset = 0;
+    float *vertices = (float *) streamBuffer.allocate(vertexCount * VERTEX_SIZE, VERTEX_SIZE, offset);
+    if (!vertices){
+        // the frame's region is full, draw nothing this frame rather than write past it
+        firstVertex = vertexCount = 0;
+        return;
+    }
+    firstVertex = offset / VERTEX_SIZE;
+
+    float halfPI = 3.14159265 / 2; // 90 degrees difference
+
+    for (int i = 0; i < 6; i++){
+        int j = i > 2 ? i-1: i;
+        float angle = halfPI * j + time;
+        float *vertex = vertices + i * VERTEX_FLOATS;
+        vertex[0] = cos(angle) / 2; // x
+        vertex[1] = sin(angle) / 2; // y
+        vertex[2] = 0.0f; // z
+        vertex[3] = vertex[4] = vertex[5] = 1.0f; // color
+    }
+
+    // upload, if the buffer can't be written directly
+    streamBuffer.commit();
+}
+
+
 // tell opengl to draw a vertex array object (VAO) using a give shaderProgram
 // --------------------------------------------------------------------------
-void draw(const unsigned int shaderProgram, const unsigned int VAO, const unsigned int vertexCount){
+void draw(const unsigned int shaderProgram, const unsigned int VAO, const unsigned int firstVertex, const unsigned int vertexCount){
     // set active shader program
     glUseProgram(shaderProgram);
     // bind vertex array object
     glBindVertexArray(VAO);
     // draw geometry
-    glDrawArrays(GL_TRIANGLES, 0, vertexCount);
+    glDrawArrays(GL_TRIANGLES, firstVertex, vertexCount);
 
 }
 
@@ -2,18 +2,15 @@
 #include <GLFW/glfw3.h>
 
 #include <iostream>
-#include <vector>
-#include <cmath>
 
-#include <iostream>
-#include <iomanip>
+#include <renderer/geometry.h>
+#include <renderer/gpu_profiler.h>
 
 // function declarations
 // ---------------------
-void setupShape(unsigned int shaderProgram, unsigned int &VAO, unsigned int &vertexCount);
-void draw(unsigned int shaderProgram, unsigned int VAO, unsigned int vertexCount);
-void createArrayBuffer(const std::vector<float> &array, const std::vector<GLint> &indices,
-                       unsigned int &VBO, unsigned int &EBO);
+void setupShape(unsigned int shaderProgram, unsigned int &VAO, unsigned int &vertexCount, GLenum &indexType);
+void draw(unsigned int shaderProgram, unsigned int VAO, unsigned int vertexCount, GLenum indexType);
+void createArrayBuffer(const Geometry &geometry, unsigned int &VBO, unsigned int &EBO);
 
 
 // glfw functions
@@ -26,18 +23,20 @@ void processInput(GLFWwindow *window);
 // --------
 const unsigned int SCR_WIDTH = 800;
 const unsigned int SCR_HEIGHT = 800;
+// print the vertices and indices of the shape (slow, for debugging)
+const bool PRINT_GEOMETRY = false;
 
 
 // shader programs
 // ---------------
 const char *vertexShaderSource = "#version 330 core\n"
                                  "layout (location = 0) in vec3 aPos;\n"
-                                 "layout (location = 1) in vec3 aColor;\n"
+                                 "layout (location = 1) in vec2 aTexCoord;\n"
                                  "out vec3 vtxColor; // output a color to the fragment shader\n"
                                  "void main()\n"
                                  "{\n"
                                  "   gl_Position = vec4(aPos.x, aPos.y, aPos.z, 1.0);\n"
-                                 "   vtxColor = aColor;\n"
+                                 "   vtxColor = vec3(aTexCoord, 0.5); // the position on the circle as a color\n"
                                  "}\0";
 const char *fragmentShaderSource = "#version 330 core\n"
                                    "out vec4 FragColor;\n"
@@ -133,29 +132,45 @@ int main()
     // setup vertex array object (VAO)
     // -------------------------------
     unsigned int VAO, vertexCount;
+    GLenum indexType;
     // generate geometry in a vertex array object (VAO), record the number of vertices in the mesh,
     // tells the shader how to read it
-    setupShape(shaderProgram, VAO, vertexCount);
-
-
-    // render loop
-    // -----------
-    while (!glfwWindowShouldClose(window)) {
-        // input
-        // -----
-        processInput(window);
+    setupShape(shaderProgram, VAO, vertexCount, indexType);
 
-        // render
-        // ------
-        glClearColor(.2f, .2f, .2f, 1.0f); // background
-        glClear(GL_COLOR_BUFFER_BIT); // clear the framebuffer
 
-        draw(shaderProgram, VAO, vertexCount);
+    // render loop, timed on the CPU and on the GPU
+    // (the profiler owns GL queries, it goes out of scope before the context is destroyed)
+    // -------------------------------------------------------------------------------------
+    {
+        GpuProfiler profiler;
+        while (!glfwWindowShouldClose(window)) {
+            // input
+            // -----
+            processInput(window);
+
+            // render
+            // ------
+            profiler.beginFrame();
+            {
+                GpuProfiler::Scope scope(profiler, "clear");
+                glClearColor(.2f, .2f, .2f, 1.0f); // background
+                glClear(GL_COLOR_BUFFER_BIT); // clear the framebuffer
+            }
+            {
+                GpuProfiler::Scope scope(profiler, "draw");
+                draw(shaderProgram, VAO, vertexCount, indexType);
+            }
+            profiler.endFrame();
+
+            // glfw: swap buffers and poll IO events (keys pressed/released, mouse moved etc.)
+            // -------------------------------------------------------------------------------
+            glfwSwapBuffers(window); // we normally use 2 frame buffers, a back (to draw on) and a front (to show on the screen)
+            glfwPollEvents();
+        }
 
-        // glfw: swap buffers and poll IO events (keys pressed/released, mouse moved etc.)
-        // -------------------------------------------------------------------------------
-        glfwSwapBuffers(window); // we normally use 2 frame buffers, a back (to draw on) and a front (to show on the screen)
-        glfwPollEvents();
+        GpuProfiler::Percentiles cpu = profiler.cpuPercentiles(), gpu = profiler.gpuPercentiles();
+        std::cout << "frame time p50/p95/p99 (ms): CPU " << cpu.p50 << "/" << cpu.p95 << "/" << cpu.p99
+                  << ", GPU " << gpu.p50 << "/" << gpu.p95 << "/" << gpu.p99 << std::endl;
     }
 
     // glfw: terminate, clearing all previously allocated GLFW resources.
@@ -165,10 +180,10 @@ int main()
 }
 
 
-// create a vertex buffer object (VBO) from an array of values, return VBO handle (set as reference)
+// create a vertex buffer object (VBO) and an element buffer object (EBO) from the data of a shape,
+// return their handles (set as reference)
 // -------------------------------------------------------------------------------------------------
-void createArrayBuffer(const std::vector<float> &array, const std::vector<GLint> &indices,
-    unsigned int &VBO, unsigned int &EBO){
+void createArrayBuffer(const Geometry &geometry, unsigned int &VBO, unsigned int &EBO){
     // create the VBO on OpenGL and get a handle to it
     glGenBuffers(1, &VBO);
     glGenBuffers(1, &EBO);
@@ -176,81 +191,33 @@ void createArrayBuffer(const std::vector<float> &array, const std::vector<GLint>
     glBindBuffer(GL_ARRAY_BUFFER, VBO);
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
     // set the content of the VBO (type, size, pointer to start, and how it is used)
-    glBufferData(GL_ARRAY_BUFFER, array.size() * sizeof(GLfloat), &array[0], GL_STATIC_DRAW);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(GLint), &indices[0], GL_STATIC_DRAW);
+    glBufferData(GL_ARRAY_BUFFER, geometry.vertices.size() * sizeof(GLfloat), geometry.vertices.data(), GL_STATIC_DRAW);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, geometry.indexDataSize(), geometry.indexData(), GL_STATIC_DRAW);
 }
 
 
 // create the geometry, a vertex array object representing it, and set how a shader program should read it
 // -------------------------------------------------------------------------------------------------------
-void setupShape(const unsigned int shaderProgram,unsigned int &VAO, unsigned int &vertexCount){
+void setupShape(const unsigned int shaderProgram, unsigned int &VAO, unsigned int &vertexCount, GLenum &indexType){
 
     unsigned int vertexDataVBO, vertexIndicesEBO;
 
-    std::vector<float> vertexData;
-    std::vector<GLint> vertexIndices;
-
+    // a fan of triangleCount triangles around the center, built once per set of parameters
+    static GeometryCache geometryCache;
     int triangleCount = 4;
-    float PI = 3.14159265;
-    float angleInterval = (2*PI) / (float)triangleCount;
-
-    // vertex center
-    vertexData.push_back(0.0f);
-    vertexData.push_back(0.0f);
-    vertexData.push_back(0.0f);
-    // color
-    vertexData.push_back(.5f);
-    vertexData.push_back(.5f);
-    vertexData.push_back(.5f);
-
-    for (int i = 0; i <= triangleCount; i++){
-        float angle = i*angleInterval;
-        // vertex circle at angle i*angleInterval
-        vertexData.push_back(cos(angle) / 2);
-        vertexData.push_back(sin(angle) / 2);
-        vertexData.push_back(0.0f);
-        // color
-        vertexData.push_back(cos(angle) / 2 + .5f);
-        vertexData.push_back(sin(angle) / 2 + .5f);
-        vertexData.push_back(.5f);
-    }
-
-    for (int i = 0; i < triangleCount; i++){
-        vertexIndices.push_back(0);
-        vertexIndices.push_back(i + 1);
-        vertexIndices.push_back(i + 2);
-    }
+    const Geometry &circle = geometryCache.circle(triangleCount);
 
-    int newLine = 0;
-    for (size_t i = 0; i < vertexData.size(); i++)
-    {
-        std::cout << std::setprecision(2) << std::fixed;
-        std::cout << " " << vertexData[i] << " - ";
-        if ((i % (5 + newLine * 6)) == 0 && i != 0) {
-            std::cout << std::endl;
-            newLine++;
-        }
-
-    }
-
-
-    std::cout << "------------- indices -----------------" << std::endl;
-    newLine = 0;
-    for (size_t i = 0; i < vertexIndices.size(); i++)
-    {
-        std::cout << " " << vertexIndices[i];
-        if (i % (2 + newLine * 3) == 0 && i != 0) {
-            std::cout << std::endl;
-            newLine++;
-        }
-    }
+    if (PRINT_GEOMETRY)
+        printGeometry(circle, std::cout);
 
-    createArrayBuffer(vertexData, vertexIndices, vertexDataVBO, vertexIndicesEBO);
+    createArrayBuffer(circle, vertexDataVBO, vertexIndicesEBO);
 
 
     // tell how many vertices to draw,
     // no need to divide by the number of floats per vertex since we now have a list of vertex indices
-    vertexCount = vertexIndices.size();
+    vertexCount = circle.indexCount();
+    // 16 bit indices for small shapes
+    indexType = circle.indexType;
 
     // create a vertex array object (VAO) on OpenGL and save a handle to it
     glGenVertexArrays(1, &VAO);
@@ -262,18 +229,18 @@ void setupShape(const unsigned int shaderProgram,unsigned int &VAO, unsigned int
     glBindBuffer(GL_ARRAY_BUFFER, vertexDataVBO);
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, vertexIndicesEBO);
 
-    int posSize = 3, colorSize = 3;
+    int posSize = 3, texCoordSize = 2;
+    int stride = Geometry::FLOATS_PER_VERTEX * (int) sizeof(float);
     int posAttributeLocation = glGetAttribLocation(shaderProgram, "aPos");
 
     glEnableVertexAttribArray(posAttributeLocation);
-    glVertexAttribPointer(posAttributeLocation, posSize, GL_FLOAT, GL_FALSE,
-                          (posSize + colorSize) * (int) sizeof(float), 0);
+    glVertexAttribPointer(posAttributeLocation, posSize, GL_FLOAT, GL_FALSE, stride, 0);
 
-    int colorAttributeLocation = glGetAttribLocation(shaderProgram, "aColor");
+    int texCoordAttributeLocation = glGetAttribLocation(shaderProgram, "aTexCoord");
 
-    glEnableVertexAttribArray(colorAttributeLocation);
-    glVertexAttribPointer(colorAttributeLocation, colorSize, GL_FLOAT, GL_FALSE,
-                          (posSize + colorSize) * (int) sizeof(float), (void*) (posSize * sizeof(float)));
+    glEnableVertexAttribArray(texCoordAttributeLocation);
+    glVertexAttribPointer(texCoordAttributeLocation, texCoordSize, GL_FLOAT, GL_FALSE, stride,
+                          (void*) Geometry::UV_OFFSET);
 
     glBindVertexArray(0);
 }
@@ -281,13 +248,13 @@ void setupShape(const unsigned int shaderProgram,unsigned int &VAO, unsigned int
 
 // tell opengl to draw a vertex array object (VAO) using a give shaderProgram
 // --------------------------------------------------------------------------
-void draw(const unsigned int shaderProgram, const unsigned int VAO, const unsigned int vertexCount){
+void draw(const unsigned int shaderProgram, const unsigned int VAO, const unsigned int vertexCount, const GLenum indexType){
     // set active shader program
     glUseProgram(shaderProgram);
     // bind vertex array object
     glBindVertexArray(VAO);
     // draw geometry
-    glDrawElements(GL_TRIANGLES, vertexCount, GL_UNSIGNED_INT, 0);
+    glDrawElements(GL_TRIANGLES, vertexCount, indexType, 0);
 }
 
 
@@ -5,11 +5,13 @@
 #include <vector>
 #include <cmath>
 
+#include "gpu_vector.h"
+
 
 // function declarations
 // ---------------------
-void createArrayBuffer(const std::vector<float> &array, unsigned int &VBO);
-void setupShape(const unsigned int shaderProgram, unsigned int &posVBO, unsigned int &VAO, unsigned int &vertexCount);
+void setupShape(const unsigned int shaderProgram, const GpuVector<float> &pointBuffer, unsigned int &VAO);
+void uploadNewPoints(GpuVector<float> &pointBuffer, unsigned int &vertexCount);
 void draw(unsigned int shaderProgram, unsigned int VAO, unsigned int vertexCount);
 
 
@@ -130,37 +132,43 @@ int main()
     glDeleteShader(fragmentShader);
 
 
-    // setup vertex array object (VAO)
-    // -------------------------------
-    unsigned int VBO=0, VAO=0, vertexCount;
-    // generate geometry in a vertex array object (VAO), record the number of vertices in the mesh,
-    // tells the shader how to read it
-    setupShape(shaderProgram, VBO, VAO, vertexCount);
+    // the points live in a vertex buffer that grows as they are added, only new points are uploaded.
+    // The extra scope releases the buffer before the OpenGL context is destroyed
+    {
+        GpuVector<float> pointBuffer;
+
+        // setup vertex array object (VAO)
+        // -------------------------------
+        unsigned int VAO = 0, vertexCount = 0;
+        // the VAO keeps reading from the same buffer when it grows, so we only tell the shader how to read it once
+        setupShape(shaderProgram, pointBuffer, VAO);
+
 
+        glEnable(GL_VERTEX_PROGRAM_POINT_SIZE);
 
-    glEnable(GL_VERTEX_PROGRAM_POINT_SIZE);
+        // render loop
+        // -----------
+        while (!glfwWindowShouldClose(window)) {
+            // input
+            // -----
+            processInput(window);
+            // upload the points added this frame, if any
+            uploadNewPoints(pointBuffer, vertexCount);
 
-    // render loop
-    // -----------
-    while (!glfwWindowShouldClose(window)) {
-        // input
-        // -----
-        int points_count = points.size();
-        processInput(window);
-        if (points_count != points.size()) // updating our buffers is costly, let's only do that when a new point is added
-            setupShape(shaderProgram, VBO, VAO, vertexCount);
+            // render
+            // ------
+            glClearColor(.2f, .2f, .2f, 1.0f); // background
+            glClear(GL_COLOR_BUFFER_BIT); // clear the framebuffer
 
-        // render
-        // ------
-        glClearColor(.2f, .2f, .2f, 1.0f); // background
-        glClear(GL_COLOR_BUFFER_BIT); // clear the framebuffer
+            draw(shaderProgram, VAO, vertexCount);
 
-        draw(shaderProgram, VAO, vertexCount);
+            // glfw: swap buffers and poll IO events (keys pressed/released, mouse moved etc.)
+            // -------------------------------------------------------------------------------
+            glfwSwapBuffers(window); // we normally use 2 frame buffers, a back (to draw on) and a front (to show on the screen)
+            glfwPollEvents();
+        }
 
-        // glfw: swap buffers and poll IO events (keys pressed/released, mouse moved etc.)
-        // -------------------------------------------------------------------------------
-        glfwSwapBuffers(window); // we normally use 2 frame buffers, a back (to draw on) and a front (to show on the screen)
-        glfwPollEvents();
+        glDeleteVertexArrays(1, &VAO);
     }
 
     // glfw: terminate, clearing all previously allocated GLFW resources.
@@ -170,38 +178,18 @@ int main()
 }
 
 
-// create a vertex buffer object (VBO) from an array of values, return VBO handle (set as reference)
+// create a vertex array object representing the points, and set how a shader program should read it
 // -------------------------------------------------------------------------------------------------
-void createArrayBuffer(const std::vector<float> &array, unsigned int &VBO){
-    // create the VBO on OpenGL and get a handle to it (if it doesn't exists already)
-    if (VBO == 0)
-        glGenBuffers(1, &VBO);
-
-    // bind the VBO
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    // set the content of the VBO (type, size, pointer to start, and how it is used)
-    glBufferData(GL_ARRAY_BUFFER, array.size() * sizeof(GLfloat), &array[0], GL_STATIC_DRAW);
-}
-
-
-// create the geometry, a vertex array object representing it, and set how a shader program should read it
-// -------------------------------------------------------------------------------------------------------
-void setupShape(const unsigned int shaderProgram, unsigned int &posVBO, unsigned int &VAO, unsigned int &vertexCount){
-
-    createArrayBuffer(points, posVBO);
-
-    // tell how many vertices to draw
-    vertexCount = points.size() / 3;
+void setupShape(const unsigned int shaderProgram, const GpuVector<float> &pointBuffer, unsigned int &VAO){
 
     // create a vertex array object (VAO) on OpenGL and store a handle to it
-    if (VAO == 0)
-        glGenVertexArrays(1, &VAO);
+    glGenVertexArrays(1, &VAO);
 
     // bind vertex array object
     glBindVertexArray(VAO);
 
-    // associate VBO to vertex shader attribute "aPos"
-    glBindBuffer(GL_ARRAY_BUFFER, posVBO);
+    // associate the point buffer to vertex shader attribute "aPos"
+    glBindBuffer(GL_ARRAY_BUFFER, pointBuffer.buffer());
 
     int posSize = 3;
     int posAttributeLocation = glGetAttribLocation(shaderProgram, "aPos");
@@ -213,6 +201,18 @@ void setupShape(const unsigned int shaderProgram, unsigned int &posVBO, unsigned
     glBindVertexArray(0);
 }
 
+
+// append the points that are not on the GPU yet to the point buffer, return the number of vertices (set as reference)
+// -------------------------------------------------------------------------------------------------------------------
+void uploadNewPoints(GpuVector<float> &pointBuffer, unsigned int &vertexCount){
+    // the cost only depends on the number of new points, not on all the points drawn so far
+    if (points.size() > pointBuffer.size())
+        pointBuffer.append(&points[pointBuffer.size()], points.size() - pointBuffer.size());
+
+    // tell how many vertices to draw
+    vertexCount = pointBuffer.size() / 3;
+}
+
 // tell opengl to draw a vertex array object (VAO) using a give shaderProgram
 // --------------------------------------------------------------------------
 void draw(const unsigned int shaderProgram, const unsigned int VAO, const unsigned int vertexCount){
@@ -0,0 +1,81 @@
+#ifndef GPU_VECTOR_H
+#define GPU_VECTOR_H
+
+#include <glad/glad.h>
+
+#include <cstddef>
+
+
+// Vertex buffer that grows like a std::vector: append only uploads the new elements with glBufferSubData,
+// and when the capacity runs out it doubles, keeping the old contents on the GPU with glCopyBufferSubData.
+// The buffer object stays the same, so vertex array objects that read from it never have to be updated.
+// --------------------------------------------------------------------------------------------------------
+template <typename T>
+class GpuVector {
+public:
+    explicit GpuVector(size_t initialCapacity = 256)
+    : elementCapacity(initialCapacity > 0 ? initialCapacity : 1){
+        glGenBuffers(1, &VBO);
+        glBindBuffer(GL_ARRAY_BUFFER, VBO);
+        glBufferData(GL_ARRAY_BUFFER, elementCapacity * sizeof(T), nullptr, GL_DYNAMIC_DRAW);
+    }
+
+    ~GpuVector(){
+        glDeleteBuffers(1, &VBO);
+    }
+
+    GpuVector(const GpuVector &) = delete;
+    GpuVector &operator=(const GpuVector &) = delete;
+
+    // add count elements at the end, costs O(count) plus an occasional copy on the GPU
+    void append(const T *values, size_t count){
+        if (count == 0)
+            return;
+        if (elementCount + count > elementCapacity)
+            grow(elementCount + count);
+
+        glBindBuffer(GL_COPY_WRITE_BUFFER, VBO);
+        glBufferSubData(GL_COPY_WRITE_BUFFER, elementCount * sizeof(T), count * sizeof(T), values);
+        elementCount += count;
+    }
+
+    void clear(){ elementCount = 0; }
+
+    size_t size() const { return elementCount; }
+    size_t capacity() const { return elementCapacity; }
+    unsigned int buffer() const { return VBO; }
+
+private:
+    void grow(size_t minCapacity){
+        size_t newCapacity = elementCapacity;
+        while (newCapacity < minCapacity)
+            newCapacity *= 2;
+
+        // park the contents in a temporary buffer, reallocate the storage and copy them back,
+        // all on the GPU (the copy bindings leave GL_ARRAY_BUFFER and the VAO state alone)
+        unsigned int temporary = 0;
+        if (elementCount > 0) {
+            glGenBuffers(1, &temporary);
+            glBindBuffer(GL_COPY_WRITE_BUFFER, temporary);
+            glBufferData(GL_COPY_WRITE_BUFFER, elementCount * sizeof(T), nullptr, GL_STREAM_COPY);
+            glBindBuffer(GL_COPY_READ_BUFFER, VBO);
+            glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, elementCount * sizeof(T));
+        }
+
+        glBindBuffer(GL_COPY_WRITE_BUFFER, VBO);
+        glBufferData(GL_COPY_WRITE_BUFFER, newCapacity * sizeof(T), nullptr, GL_DYNAMIC_DRAW);
+        elementCapacity = newCapacity;
+
+        if (temporary != 0) {
+            glBindBuffer(GL_COPY_READ_BUFFER, temporary);
+            glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, elementCount * sizeof(T));
+            glDeleteBuffers(1, &temporary);
+        }
+    }
+
+    unsigned int VBO = 0;
+    size_t elementCount = 0;
+    size_t elementCapacity;
+};
+
+#endif // GPU_VECTOR_H
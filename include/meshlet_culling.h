@@ -0,0 +1,107 @@
+#ifndef MESHLET_CULLING_H
+#define MESHLET_CULLING_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <assimp/mesh.h>
+
+#include <vector>
+
+
+// CPU side cluster culling for meshes split into meshlets by assimp's GenMeshletsProcess.
+// The meshlets of an aiMesh are ranges of its faces, so the visible ones are drawn straight
+// from the regular element buffer with a single glMultiDrawElements call.
+// ---------------------------------------------------------------------------------------
+
+
+// ranges of the element buffer to draw, visible meshlets next to each other are merged
+// ------------------------------------------------------------------------------------
+struct MeshletDrawList {
+    std::vector<GLsizei> counts;
+    std::vector<const void*> offsets;
+    unsigned int visibleMeshlets = 0;
+    unsigned int culledMeshlets = 0;
+};
+
+
+// create an element buffer object (EBO) from the faces of a triangle mesh, return EBO handle (set as reference)
+// ------------------------------------------------------------------------------------------------------------
+inline void createMeshletElementBuffer(const aiMesh &mesh, unsigned int &EBO){
+    std::vector<unsigned int> indices;
+    indices.reserve(mesh.mNumFaces * 3);
+    for (unsigned int i = 0; i < mesh.mNumFaces; i++)
+        indices.insert(indices.end(), mesh.mFaces[i].mIndices, mesh.mFaces[i].mIndices + 3);
+
+    if (EBO == 0)
+        glGenBuffers(1, &EBO);
+    // mind that the element buffer binding is stored in the currently bound VAO
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(GLuint), indices.data(), GL_STATIC_DRAW);
+}
+
+
+// test all meshlets of a mesh against the view frustum and their normal cones, and fill the draw list
+// with the visible ones. The tests run in mesh space, so no meshlet bounds have to be transformed.
+// ---------------------------------------------------------------------------------------------------
+inline void cullMeshlets(const aiMesh &mesh, const glm::mat4 &model, const glm::mat4 &viewProjection,
+                         const glm::vec3 &cameraPosition, MeshletDrawList &drawList){
+    drawList.counts.clear();
+    drawList.offsets.clear();
+    drawList.visibleMeshlets = drawList.culledMeshlets = 0;
+
+    // frustum planes in mesh space, extracted from the rows of the model-view-projection matrix
+    glm::mat4 rows = glm::transpose(viewProjection * model);
+    glm::vec4 planes[6] = { rows[3] + rows[0], rows[3] - rows[0],
+                            rows[3] + rows[1], rows[3] - rows[1],
+                            rows[3] + rows[2], rows[3] - rows[2] };
+    for (glm::vec4 &plane : planes)
+        plane /= glm::length(glm::vec3(plane));
+
+    // camera position in mesh space, for the normal cone test
+    glm::vec3 eye = glm::vec3(glm::inverse(model) * glm::vec4(cameraPosition, 1.0f));
+
+    for (unsigned int i = 0; i < mesh.mNumMeshlets; i++) {
+        const aiMeshlet &meshlet = mesh.mMeshlets[i];
+        glm::vec3 center(meshlet.mCenter.x, meshlet.mCenter.y, meshlet.mCenter.z);
+
+        bool visible = true;
+        for (const glm::vec4 &plane : planes)
+            visible = visible && glm::dot(glm::vec3(plane), center) + plane.w >= -meshlet.mRadius;
+
+        // all triangles face away from the camera
+        if (visible && meshlet.mConeCutoff < 1.0f) {
+            glm::vec3 axis(meshlet.mConeAxis.x, meshlet.mConeAxis.y, meshlet.mConeAxis.z);
+            glm::vec3 toCenter = center - eye;
+            visible = glm::dot(toCenter, axis) < meshlet.mConeCutoff * glm::length(toCenter) + meshlet.mRadius;
+        }
+
+        if (!visible) {
+            drawList.culledMeshlets++;
+            continue;
+        }
+        drawList.visibleMeshlets++;
+
+        GLsizei count = (GLsizei) meshlet.mNumFaces * 3;
+        const char *offset = (const char *) 0 + meshlet.mFirstFace * 3 * sizeof(GLuint);
+        // extend the previous range if this meshlet directly follows it
+        if (!drawList.counts.empty() &&
+            (const char *) drawList.offsets.back() + drawList.counts.back() * sizeof(GLuint) == offset)
+            drawList.counts.back() += count;
+        else {
+            drawList.counts.push_back(count);
+            drawList.offsets.push_back(offset);
+        }
+    }
+}
+
+
+// draw the visible meshlets, expects the VAO holding the element buffer of the mesh to be bound
+// ---------------------------------------------------------------------------------------------
+inline void drawMeshlets(const MeshletDrawList &drawList){
+    if (drawList.counts.empty())
+        return;
+    glMultiDrawElements(GL_TRIANGLES, drawList.counts.data(), GL_UNSIGNED_INT,
+                        drawList.offsets.data(), (GLsizei) drawList.counts.size());
+}
+
+#endif // MESHLET_CULLING_H
@@ -0,0 +1,97 @@
+#ifndef PACKED_VERTICES_H
+#define PACKED_VERTICES_H
+
+#include <glad/glad.h>
+#include <assimp/mesh.h>
+
+
+// Vertex attribute layouts for the packed vertex streams built by assimp's PackVerticesProcess
+// (aiMesh::mPackedVertices). A typical vertex with position, normal and texture coordinates takes
+// 16 bytes instead of 32, the vertex shader decodes the attributes with the functions below.
+// ----------------------------------------------------------------------------------------------
+
+
+// GLSL functions to decode the packed attributes, add them to the vertex shader source after the
+// #version line and set the uniforms with setPackedPositionUniforms
+// ----------------------------------------------------------------------------------------------
+inline const char *packedVertexDecodeGLSL(){
+    return "uniform vec3 uPosOffset;\n"
+           "uniform vec3 uPosScale;\n"
+           "vec3 decodePosition(vec4 aPos)\n"
+           "{\n"
+           "   return uPosOffset + aPos.xyz * uPosScale;\n"
+           "}\n"
+           "vec3 decodeOctahedral(vec2 e)\n" // normals and tangents
+           "{\n"
+           "   vec3 v = vec3(e.xy, 1.0 - abs(e.x) - abs(e.y));\n"
+           "   float t = max(-v.z, 0.0);\n"
+           "   v.xy += vec2(v.x >= 0.0 ? -t : t, v.y >= 0.0 ? -t : t);\n"
+           "   return normalize(v);\n"
+           "}\n"
+           "vec3 decodeBitangent(vec3 normal, vec3 tangent, vec4 aPos)\n" // the sign is stored in the position w
+           "{\n"
+           "   return cross(normal, tangent) * (aPos.w > 0.5 ? 1.0 : -1.0);\n"
+           "}\n";
+}
+
+
+// name of the vertex shader attribute that reads a packed attribute, aTexCoord1, aColor1 etc. for the other sets
+// --------------------------------------------------------------------------------------------------------------
+inline const char *packedAttributeName(const aiPackedAttribute &attribute){
+    static const char *texCoordNames[] = {"aTexCoord", "aTexCoord1", "aTexCoord2", "aTexCoord3",
+                                          "aTexCoord4", "aTexCoord5", "aTexCoord6", "aTexCoord7"};
+    static const char *colorNames[] = {"aColor", "aColor1", "aColor2", "aColor3",
+                                       "aColor4", "aColor5", "aColor6", "aColor7"};
+    switch (attribute.mSemantic) {
+        case aiPackedSemantic_POSITION: return "aPos";
+        case aiPackedSemantic_NORMAL: return "aNormal";
+        case aiPackedSemantic_TANGENT: return "aTangent";
+        case aiPackedSemantic_TEXCOORD: return attribute.mChannel < 8 ? texCoordNames[attribute.mChannel] : nullptr;
+        case aiPackedSemantic_COLOR: return attribute.mChannel < 8 ? colorNames[attribute.mChannel] : nullptr;
+        default: return nullptr;
+    }
+}
+
+
+// upload the packed vertices of a mesh to a VBO and tell the VAO how the shader program reads them
+// ------------------------------------------------------------------------------------------------
+inline void setupPackedVertices(const unsigned int shaderProgram, const aiMesh &mesh, unsigned int &VBO, unsigned int &VAO){
+    const aiPackedVertices &packed = *mesh.mPackedVertices;
+
+    if (VBO == 0)
+        glGenBuffers(1, &VBO);
+    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr) packed.mNumVertices * packed.mStride, packed.mData, GL_STATIC_DRAW);
+
+    if (VAO == 0)
+        glGenVertexArrays(1, &VAO);
+    glBindVertexArray(VAO);
+
+    for (unsigned int i = 0; i < packed.mNumAttributes; i++) {
+        const aiPackedAttribute &attribute = packed.mAttributes[i];
+        const char *name = packedAttributeName(attribute);
+        int location = name ? glGetAttribLocation(shaderProgram, name) : -1;
+        // attributes the shader doesn't use are optimized away
+        if (location < 0)
+            continue;
+        glEnableVertexAttribArray(location);
+        glVertexAttribPointer(location, attribute.mNumComponents, attribute.mType,
+                              attribute.mNormalized ? GL_TRUE : GL_FALSE, packed.mStride,
+                              (const void *) (size_t) attribute.mOffset);
+    }
+
+    glBindVertexArray(0);
+}
+
+
+// set the uniforms decodePosition needs, expects the shader program to be in use
+// ------------------------------------------------------------------------------
+inline void setPackedPositionUniforms(const unsigned int shaderProgram, const aiMesh &mesh){
+    const aiPackedVertices &packed = *mesh.mPackedVertices;
+    glUniform3f(glGetUniformLocation(shaderProgram, "uPosOffset"),
+                packed.mPositionOffset.x, packed.mPositionOffset.y, packed.mPositionOffset.z);
+    glUniform3f(glGetUniformLocation(shaderProgram, "uPosScale"),
+                packed.mPositionScale.x, packed.mPositionScale.y, packed.mPositionScale.z);
+}
+
+#endif // PACKED_VERTICES_H
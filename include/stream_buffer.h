@@ -0,0 +1,150 @@
+#ifndef STREAM_BUFFER_H
+#define STREAM_BUFFER_H
+
+#include <glad/glad.h>
+
+#include <cstring>
+#include <vector>
+
+
+// glBufferStorage is core in OpenGL 4.4 (or ARB_buffer_storage), newer than the generated glad loader
+// ---------------------------------------------------------------------------------------------------
+#ifndef GL_MAP_PERSISTENT_BIT
+#define GL_MAP_PERSISTENT_BIT 0x0040
+#endif
+#ifndef GL_MAP_COHERENT_BIT
+#define GL_MAP_COHERENT_BIT 0x0080
+#endif
+typedef void (APIENTRYP PFNSTREAMBUFFERSTORAGEPROC)(GLenum target, GLsizeiptr size, const void *data, GLbitfield flags);
+
+
+// Vertex buffer for data that is rewritten every frame. The buffer is split in regionCount regions (a ring),
+// the CPU writes the region of the current frame while the GPU may still read the ones of previous frames.
+// With buffer storage, the buffer is mapped once (persistent and coherent) and a fence per region makes sure
+// a region is only overwritten after the GPU is done with it. Without it, data is uploaded with
+// glBufferSubData and the buffer is orphaned every time the ring wraps around, so the driver never stalls.
+// -----------------------------------------------------------------------------------------------------------
+class StreamBuffer {
+public:
+    // regionSize is the maximum number of bytes per frame, load the function loader given to glad
+    StreamBuffer(GLsizeiptr regionSize, GLADloadproc load, unsigned int regionCount = 3)
+    : regionSize(regionSize), regionCount(regionCount), fences(regionCount, nullptr){
+        glGenBuffers(1, &VBO);
+        glBindBuffer(GL_ARRAY_BUFFER, VBO);
+
+        PFNSTREAMBUFFERSTORAGEPROC bufferStorage = nullptr;
+        if (hasBufferStorage())
+            bufferStorage = (PFNSTREAMBUFFERSTORAGEPROC) load("glBufferStorage");
+
+        if (bufferStorage) {
+            GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+            bufferStorage(GL_ARRAY_BUFFER, regionSize * regionCount, nullptr, flags);
+            mapped = (char *) glMapBufferRange(GL_ARRAY_BUFFER, 0, regionSize * regionCount, flags);
+        }
+        if (!mapped)
+            glBufferData(GL_ARRAY_BUFFER, regionSize * regionCount, nullptr, GL_STREAM_DRAW);
+    }
+
+    ~StreamBuffer(){
+        for (GLsync fence : fences)
+            glDeleteSync(fence);
+        if (mapped) {
+            glBindBuffer(GL_ARRAY_BUFFER, VBO);
+            glUnmapBuffer(GL_ARRAY_BUFFER);
+        }
+        glDeleteBuffers(1, &VBO);
+    }
+
+    StreamBuffer(const StreamBuffer &) = delete;
+    StreamBuffer &operator=(const StreamBuffer &) = delete;
+
+    // reserve size bytes in the region of the current frame, aligned to alignment (use the vertex size to draw
+    // with glDrawArrays(mode, offset / vertexSize, count)). Returns where to write them, nullptr if the region
+    // is full, and sets offset to the position of the data in the buffer
+    void *allocate(GLsizeiptr size, GLsizeiptr alignment, GLintptr &offset){
+        if (cursor == 0)
+            waitForRegion();
+
+        GLsizeiptr start = (cursor + alignment - 1) / alignment * alignment;
+        if (start + size > regionSize)
+            return nullptr;
+
+        offset = region * regionSize + start;
+        cursor = start + size;
+        pendingOffset = offset;
+        pendingSize = size;
+        if (mapped)
+            return mapped + offset;
+
+        staging.resize(size);
+        return staging.data();
+    }
+
+    // make the data of the last allocate available to the GPU, only uploads anything without buffer storage
+    void commit(){
+        if (mapped || pendingSize == 0)
+            return;
+        glBindBuffer(GL_ARRAY_BUFFER, VBO);
+        glBufferSubData(GL_ARRAY_BUFFER, pendingOffset, pendingSize, staging.data());
+        pendingSize = 0;
+    }
+
+    // call once per frame, after the draw calls that read this frame's data
+    void endFrame(){
+        if (mapped)
+            fences[region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        region = (region + 1) % regionCount;
+        cursor = 0;
+    }
+
+    unsigned int buffer() const { return VBO; }
+    bool isPersistent() const { return mapped != nullptr; }
+
+private:
+    static bool hasBufferStorage(){
+        int major = 0, minor = 0;
+        glGetIntegerv(GL_MAJOR_VERSION, &major);
+        glGetIntegerv(GL_MINOR_VERSION, &minor);
+        if (major > 4 || (major == 4 && minor >= 4))
+            return true;
+        int extensionCount = 0;
+        glGetIntegerv(GL_NUM_EXTENSIONS, &extensionCount);
+        for (int i = 0; i < extensionCount; i++)
+            if (std::strcmp((const char *) glGetStringi(GL_EXTENSIONS, i), "GL_ARB_buffer_storage") == 0)
+                return true;
+        return false;
+    }
+
+    void waitForRegion(){
+        if (!mapped) {
+            // orphan the storage when the ring wraps around, the GPU keeps reading the old one
+            if (region == 0) {
+                glBindBuffer(GL_ARRAY_BUFFER, VBO);
+                glBufferData(GL_ARRAY_BUFFER, regionSize * regionCount, nullptr, GL_STREAM_DRAW);
+            }
+            return;
+        }
+        GLsync &fence = fences[region];
+        if (!fence)
+            return;
+        // only flush on the first try, after that the fence is known to be submitted
+        GLbitfield flags = GL_SYNC_FLUSH_COMMANDS_BIT;
+        while (glClientWaitSync(fence, flags, 1000000) == GL_TIMEOUT_EXPIRED)
+            flags = 0;
+        glDeleteSync(fence);
+        fence = nullptr;
+    }
+
+    unsigned int VBO = 0;
+    GLsizeiptr regionSize;
+    unsigned int regionCount;
+    unsigned int region = 0;
+    GLsizeiptr cursor = 0;
+    char *mapped = nullptr;
+    std::vector<GLsync> fences;
+    std::vector<char> staging;
+    GLintptr pendingOffset = 0;
+    GLsizeiptr pendingSize = 0;
+};
+
+#endif // STREAM_BUFFER_H